@@ -1511,12 +1511,12 @@ int idAASFileLocal::NumReachabilities() const
 
 /*
 ================
-idAASFileLocal::ReportRoutingEfficiency
+idAASFileLocal::GetRoutingEfficiency
 ================
 */
-void idAASFileLocal::ReportRoutingEfficiency() const
+void idAASFileLocal::GetRoutingEfficiency( int& numReachableAreas, int& numReachabilities, int& maxRoutingCacheKB ) const
 {
-	int numReachableAreas, total, i, n;
+	int total, i, n;
 
 	numReachableAreas = 0;
 	total = 0;
@@ -1528,9 +1528,24 @@ void idAASFileLocal::ReportRoutingEfficiency() const
 	}
 	total += numReachableAreas * portals.Num();
 
+	numReachabilities = NumReachabilities();
+	maxRoutingCacheKB = ( total * 3 ) >> 10;
+}
+
+/*
+================
+idAASFileLocal::ReportRoutingEfficiency
+================
+*/
+void idAASFileLocal::ReportRoutingEfficiency() const
+{
+	int numReachableAreas, numReachabilities, maxRoutingCacheKB;
+
+	GetRoutingEfficiency( numReachableAreas, numReachabilities, maxRoutingCacheKB );
+
 	common->Printf( "%6d reachable areas\n", numReachableAreas );
-	common->Printf( "%6d reachabilities\n", NumReachabilities() );
-	common->Printf( "%6d KB max routing cache\n", ( total * 3 ) >> 10 );
+	common->Printf( "%6d reachabilities\n", numReachabilities );
+	common->Printf( "%6d KB max routing cache\n", maxRoutingCacheKB );
 }
 
 /*
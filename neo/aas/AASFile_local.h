@@ -68,6 +68,7 @@ public:
 
 	int							MemorySize() const;
 	void						ReportRoutingEfficiency() const;
+	void						GetRoutingEfficiency( int& numReachableAreas, int& numReachabilities, int& maxRoutingCacheKB ) const;
 	void						Optimize();
 	void						LinkReversedReachability();
 	void						FinishAreas();
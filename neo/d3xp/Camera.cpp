@@ -872,7 +872,7 @@ void idCameraAnim::gltfLoadAnim( idStr gltfFileName, idStr animName )
 		{
 			gltfItemArray animExtras;
 			GLTFARRAYITEM( animExtras, CameraLensFrames, gltfExtra_CameraLensFrames );
-			idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
+			gltfJsonScanner lexer;
 			lexer.LoadMemory( anim->extras.json, anim->extras.json.Size(), "idCameraAnim_gltfExtra", 0 );
 			animExtras.Parse( &lexer , true );
 
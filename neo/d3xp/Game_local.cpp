@@ -234,6 +234,7 @@ void idGameLocal::Clear()
 	sessionCommand.Clear();
 	locationEntities = NULL;
 	smokeParticles = NULL;
+	physicsJobList = NULL;
 	editEntities = NULL;
 	entityHash.Clear( 1024, MAX_GENTITIES );
 	cinematicSkipTime = 0;
@@ -357,6 +358,8 @@ void idGameLocal::Init()
 
 	smokeParticles = new( TAG_PARTICLE ) idSmokeParticles;
 
+	physicsJobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, 1024, 0, NULL );
+
 	// set up the aas
 	dict = FindEntityDefDict( "aas_types" );
 	if( dict == NULL )
@@ -419,6 +422,12 @@ void idGameLocal::Shutdown()
 	delete smokeParticles;
 	smokeParticles = NULL;
 
+	if( physicsJobList != NULL )
+	{
+		parallelJobManager->FreeJobList( physicsJobList );
+		physicsJobList = NULL;
+	}
+
 	idClass::Shutdown();
 
 	// clear list with forces
@@ -1408,6 +1417,8 @@ bool idGameLocal::InitFromSaveGame( const char* mapName, idRenderWorld* renderWo
 	// load the map needed for this savegame
 	LoadMap( mapName, 0 );
 
+	const int restoreStartTimeMs = Sys_Milliseconds();
+
 	idFile_SaveGamePipelined* pipelineFile = new( TAG_SAVEGAMES ) idFile_SaveGamePipelined();
 	pipelineFile->OpenForReading( saveGameFile );
 	idRestoreGame savegame( pipelineFile, stringTableFile, saveGameVersion );
@@ -1635,6 +1646,8 @@ bool idGameLocal::InitFromSaveGame( const char* mapName, idRenderWorld* renderWo
 
 	savegame.RestoreObjects();
 
+	Printf( "Restore time: %dms\n", Sys_Milliseconds() - restoreStartTimeMs );
+
 	mpGame.Reset();
 	mpGame.Precache();
 
@@ -2773,6 +2786,9 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 				}
 				else
 				{
+					// solve independent articulated figures in parallel before they think
+					idPhysics_AF::PresolveActiveFigures();
+
 					num = 0;
 					for( ent = activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() )
 					{
@@ -2783,10 +2799,15 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 						RunEntityThink( *ent, cmdMgr );
 						num++;
 					}
+
+					idPhysics_AF::ClearPresolvedFigures();
 				}
 			}
 
 			RunTimeGroup2( cmdMgr );
+
+			// put islands of touching rigid bodies to rest together
+			idPhysics_RigidBody::UpdateIslands();
 // jmarshall
 			RunSharedThink();
 // jmarshall end
@@ -333,6 +333,7 @@ public:
 	idMultiplayerGame		mpGame;					// handles rules for standard dm
 
 	idSmokeParticles* 		smokeParticles;			// global smoke trails
+	idParallelJobList* 		physicsJobList;			// jobs for solving independent physics objects in parallel
 	idEditEntities* 		editEntities;			// in game editing
 
 	int						cinematicSkipTime;		// don't allow skipping cinemetics until this time has passed so player doesn't skip out accidently from a firefight
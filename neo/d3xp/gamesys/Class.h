@@ -323,6 +323,9 @@ private:
 	static int					typeNumBits;
 	static int					memused;
 	static int					numobjects;
+
+	friend class idEvent;
+	idLinkList<idEvent>			eventList;				// events scheduled for this object
 };
 
 /***********************************************************************
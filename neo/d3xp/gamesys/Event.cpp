@@ -234,6 +234,201 @@ const idEventDef* idEventDef::FindEvent( const char* name )
 	return NULL;
 }
 
+/***********************************************************************
+
+  idEventHeap
+
+  Binary min heap of the scheduled events. Events are ordered by time and
+  then by the order they were scheduled in, which is the same order the
+  sorted linked lists used to give, but posting and cancelling an event
+  no longer walks all the pending events.
+
+***********************************************************************/
+
+class idEventHeap
+{
+public:
+	idEventHeap() : num( 0 ) {}
+
+	int						Num() const
+	{
+		return num;
+	}
+	bool					IsEmpty() const
+	{
+		return num == 0;
+	}
+	idEvent* 				First() const
+	{
+		return heap[ 0 ];
+	}
+
+	void					Clear();
+	void					Add( idEvent* event );
+	void					Remove( idEvent* event );
+
+	// all events in the order they will be serviced
+	void					GetSorted( idList<idEvent*>& list ) const;
+
+	static bool				Before( const idEvent* a, const idEvent* b )
+	{
+		if( a->time != b->time )
+		{
+			return a->time < b->time;
+		}
+		return ( int )( a->sequence - b->sequence ) < 0;
+	}
+
+private:
+	void					Set( int index, idEvent* event )
+	{
+		heap[ index ] = event;
+		event->queueIndex = index;
+	}
+	void					SiftUp( int index );
+	void					SiftDown( int index );
+
+	idEvent* 				heap[ MAX_EVENTS ];
+	int						num;
+};
+
+class idSort_EventHeap : public idSort_Quick< idEvent*, idSort_EventHeap >
+{
+public:
+	int Compare( idEvent* const& a, idEvent* const& b ) const
+	{
+		if( idEventHeap::Before( a, b ) )
+		{
+			return -1;
+		}
+		return idEventHeap::Before( b, a ) ? 1 : 0;
+	}
+};
+
+/*
+================
+idEventHeap::Clear
+================
+*/
+void idEventHeap::Clear()
+{
+	for( int i = 0; i < num; i++ )
+	{
+		heap[ i ]->queue = NULL;
+	}
+	num = 0;
+}
+
+/*
+================
+idEventHeap::Add
+================
+*/
+void idEventHeap::Add( idEvent* event )
+{
+	assert( event->queue == NULL );
+	assert( num < MAX_EVENTS );
+
+	event->queue = this;
+	Set( num, event );
+	num++;
+	SiftUp( num - 1 );
+}
+
+/*
+================
+idEventHeap::Remove
+================
+*/
+void idEventHeap::Remove( idEvent* event )
+{
+	assert( event->queue == this && heap[ event->queueIndex ] == event );
+
+	const int index = event->queueIndex;
+	event->queue = NULL;
+
+	num--;
+	if( index == num )
+	{
+		return;
+	}
+
+	Set( index, heap[ num ] );
+	if( index > 0 && Before( heap[ index ], heap[( index - 1 ) >> 1 ] ) )
+	{
+		SiftUp( index );
+	}
+	else
+	{
+		SiftDown( index );
+	}
+}
+
+/*
+================
+idEventHeap::SiftUp
+================
+*/
+void idEventHeap::SiftUp( int index )
+{
+	idEvent* event = heap[ index ];
+	while( index > 0 )
+	{
+		const int parent = ( index - 1 ) >> 1;
+		if( !Before( event, heap[ parent ] ) )
+		{
+			break;
+		}
+		Set( index, heap[ parent ] );
+		index = parent;
+	}
+	Set( index, event );
+}
+
+/*
+================
+idEventHeap::SiftDown
+================
+*/
+void idEventHeap::SiftDown( int index )
+{
+	idEvent* event = heap[ index ];
+	for( ;; )
+	{
+		int child = index * 2 + 1;
+		if( child >= num )
+		{
+			break;
+		}
+		if( child + 1 < num && Before( heap[ child + 1 ], heap[ child ] ) )
+		{
+			child++;
+		}
+		if( !Before( heap[ child ], event ) )
+		{
+			break;
+		}
+		Set( index, heap[ child ] );
+		index = child;
+	}
+	Set( index, event );
+}
+
+/*
+================
+idEventHeap::GetSorted
+================
+*/
+void idEventHeap::GetSorted( idList<idEvent*>& list ) const
+{
+	list.SetNum( num );
+	for( int i = 0; i < num; i++ )
+	{
+		list[ i ] = heap[ i ];
+	}
+	list.SortWithTemplate( idSort_EventHeap() );
+}
+
 /***********************************************************************
 
   idEvent
@@ -241,9 +436,10 @@ const idEventDef* idEventDef::FindEvent( const char* name )
 ***********************************************************************/
 
 static idLinkList<idEvent> FreeEvents;
-static idLinkList<idEvent> EventQueue;
-static idLinkList<idEvent> FastEventQueue;
+static idEventHeap EventQueue;
+static idEventHeap FastEventQueue;
 static idEvent EventPool[ MAX_EVENTS ];
+static unsigned int EventSequence = 0;
 
 bool idEvent::initialized = false;
 
@@ -420,6 +616,12 @@ void idEvent::Free()
 		data = NULL;
 	}
 
+	if( queue != NULL )
+	{
+		queue->Remove( this );
+	}
+	objectNode.Remove();
+
 	eventdef	= NULL;
 	time		= 0;
 	object		= NULL;
@@ -436,8 +638,6 @@ idEvent::Schedule
 */
 void idEvent::Schedule( idClass* obj, const idTypeInfo* type, int time )
 {
-	idEvent* event;
-
 	assert( initialized );
 	if( !initialized )
 	{
@@ -452,23 +652,20 @@ void idEvent::Schedule( idClass* obj, const idTypeInfo* type, int time )
 
 	eventNode.Remove();
 
-	if( obj->IsType( idEntity::Type ) && ( ( ( idEntity* )( obj ) )->timeGroup == TIME_GROUP2 ) )
+	if( queue != NULL )
 	{
-		event = FastEventQueue.Next();
-		while( ( event != NULL ) && ( this->time >= event->time ) )
-		{
-			event = event->eventNode.Next();
-		}
+		queue->Remove( this );
+	}
 
-		if( event )
-		{
-			eventNode.InsertBefore( event->eventNode );
-		}
-		else
-		{
-			eventNode.AddToEnd( FastEventQueue );
-		}
+	objectNode.SetOwner( this );
+	objectNode.AddToEnd( obj->eventList );
+
+	// events with the same time are serviced in the order they were scheduled
+	sequence = EventSequence++;
 
+	if( obj->IsType( idEntity::Type ) && ( ( ( idEntity* )( obj ) )->timeGroup == TIME_GROUP2 ) )
+	{
+		FastEventQueue.Add( this );
 		return;
 	}
 	else
@@ -476,20 +673,7 @@ void idEvent::Schedule( idClass* obj, const idTypeInfo* type, int time )
 		this->time = gameLocal.slow.time + time;
 	}
 
-	event = EventQueue.Next();
-	while( ( event != NULL ) && ( this->time >= event->time ) )
-	{
-		event = event->eventNode.Next();
-	}
-
-	if( event )
-	{
-		eventNode.InsertBefore( event->eventNode );
-	}
-	else
-	{
-		eventNode.AddToEnd( EventQueue );
-	}
+	EventQueue.Add( this );
 }
 
 /*
@@ -507,27 +691,12 @@ void idEvent::CancelEvents( const idClass* obj, const idEventDef* evdef )
 		return;
 	}
 
-	for( event = EventQueue.Next(); event != NULL; event = next )
+	for( event = obj->eventList.Next(); event != NULL; event = next )
 	{
-		next = event->eventNode.Next();
-		if( event->object == obj )
+		next = event->objectNode.Next();
+		if( !evdef || ( evdef == event->eventdef ) )
 		{
-			if( !evdef || ( evdef == event->eventdef ) )
-			{
-				event->Free();
-			}
-		}
-	}
-
-	for( event = FastEventQueue.Next(); event != NULL; event = next )
-	{
-		next = event->eventNode.Next();
-		if( event->object == obj )
-		{
-			if( !evdef || ( evdef == event->eventdef ) )
-			{
-				event->Free();
-			}
+			event->Free();
 		}
 	}
 }
@@ -546,6 +715,7 @@ void idEvent::ClearEventList()
 	//
 	FreeEvents.Clear();
 	EventQueue.Clear();
+	FastEventQueue.Clear();
 
 	//
 	// add the events to the free list
@@ -578,9 +748,9 @@ void idEvent::ServiceEvents()
 	const char*  materialName;
 
 	num = 0;
-	while( !EventQueue.IsListEmpty() )
+	while( !EventQueue.IsEmpty() )
 	{
-		event = EventQueue.Next();
+		event = EventQueue.First();
 		assert( event );
 
 		if( event->time > gameLocal.time )
@@ -642,9 +812,13 @@ void idEvent::ServiceEvents()
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from its lists so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		if( event->queue != NULL )
+		{
+			event->queue->Remove( event );
+		}
+		event->objectNode.Remove();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
@@ -692,9 +866,9 @@ void idEvent::ServiceFastEvents()
 	const char*  materialName;
 
 	num = 0;
-	while( !FastEventQueue.IsListEmpty() )
+	while( !FastEventQueue.IsEmpty() )
 	{
-		event = FastEventQueue.Next();
+		event = FastEventQueue.First();
 		assert( event );
 
 		if( event->time > gameLocal.fast.time )
@@ -754,9 +928,13 @@ void idEvent::ServiceFastEvents()
 			}
 		}
 
-		// the event is removed from its list so that if then object
+		// the event is removed from its lists so that if then object
 		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		if( event->queue != NULL )
+		{
+			event->queue->Remove( event );
+		}
+		event->objectNode.Remove();
 		assert( event->object );
 		event->object->ProcessEventArgPtr( ev, args );
 
@@ -842,6 +1020,123 @@ void idEvent::Shutdown()
 	initialized = false;
 }
 
+/*
+================
+idEventBenchmarkTarget
+
+Receives the events posted by the testEventQueue command.
+================
+*/
+class idEventBenchmarkTarget : public idClass
+{
+public:
+	CLASS_PROTOTYPE( idEventBenchmarkTarget );
+
+	static int				numServiced;
+
+private:
+	void					Event_Benchmark()
+	{
+		numServiced++;
+	}
+};
+
+static const idEventDef EV_EventBenchmark( "<eventBenchmark>", NULL );
+
+CLASS_DECLARATION( idClass, idEventBenchmarkTarget )
+EVENT( EV_EventBenchmark,	idEventBenchmarkTarget::Event_Benchmark )
+END_CLASS
+
+int idEventBenchmarkTarget::numServiced = 0;
+
+/*
+================
+idEvent::Benchmark_f
+
+testEventQueue [events] [objects] [rounds]
+
+Posts events with random delays to a number of objects, cancels them one
+object at a time, then posts events that are due and services them.
+================
+*/
+void idEvent::Benchmark_f( const idCmdArgs& args )
+{
+	if( !initialized || gameLocal.GameState() != GAMESTATE_ACTIVE )
+	{
+		common->Printf( "testEventQueue: no map running\n" );
+		return;
+	}
+
+	// leave some room for the events the game posts itself
+	const int maxEvents = Min( FreeEvents.Num() - 256, MAX_EVENTSPERFRAME / 2 );
+	const int numEvents = idMath::ClampInt( 1, Max( maxEvents, 1 ), ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : maxEvents );
+	const int numObjects = idMath::ClampInt( 1, numEvents, ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 64 );
+	const int numRounds = Max( 1, ( args.Argc() > 3 ) ? atoi( args.Argv( 3 ) ) : 100 );
+
+	if( maxEvents <= 0 )
+	{
+		common->Printf( "testEventQueue: not enough free events\n" );
+		return;
+	}
+
+	idList<idEventBenchmarkTarget*> targets;
+	targets.SetNum( numObjects );
+	for( int i = 0; i < numObjects; i++ )
+	{
+		targets[ i ] = new idEventBenchmarkTarget;
+	}
+
+	idRandom random( 0 );
+	uint64_t postTime = 0;
+	uint64_t cancelTime = 0;
+	uint64_t serviceTime = 0;
+	int numCanceled = 0;
+	idEventBenchmarkTarget::numServiced = 0;
+
+	for( int round = 0; round < numRounds; round++ )
+	{
+		uint64_t start = Sys_Microseconds();
+		for( int i = 0; i < numEvents; i++ )
+		{
+			targets[ i % numObjects ]->PostEventMS( &EV_EventBenchmark, 1000 + random.RandomInt( 60000 ) );
+		}
+		postTime += Sys_Microseconds() - start;
+
+		const int numFree = FreeEvents.Num();
+		start = Sys_Microseconds();
+		for( int i = 0; i < numObjects; i++ )
+		{
+			targets[ i ]->CancelEvents( &EV_EventBenchmark );
+		}
+		cancelTime += Sys_Microseconds() - start;
+		numCanceled += FreeEvents.Num() - numFree;
+
+		for( int i = 0; i < numEvents; i++ )
+		{
+			targets[ i % numObjects ]->PostEventMS( &EV_EventBenchmark, 0 );
+		}
+
+		start = Sys_Microseconds();
+		ServiceEvents();
+		serviceTime += Sys_Microseconds() - start;
+	}
+
+	for( int i = 0; i < numObjects; i++ )
+	{
+		delete targets[ i ];
+	}
+
+	const int totalEvents = numEvents * numRounds;
+	common->Printf( "%d events on %d objects, %d rounds, %d events pending in the game\n", numEvents, numObjects, numRounds, EventQueue.Num() + FastEventQueue.Num() );
+	common->Printf( "post:    %8.2f msec, %10.0f events/sec\n", postTime * 0.001f, totalEvents * 1000000.0f / Max<uint64_t>( postTime, 1 ) );
+	common->Printf( "cancel:  %8.2f msec, %10.0f events/sec\n", cancelTime * 0.001f, numCanceled * 1000000.0f / Max<uint64_t>( cancelTime, 1 ) );
+	common->Printf( "service: %8.2f msec, %10.0f events/sec\n", serviceTime * 0.001f, idEventBenchmarkTarget::numServiced * 1000000.0f / Max<uint64_t>( serviceTime, 1 ) );
+	if( numCanceled != totalEvents || idEventBenchmarkTarget::numServiced != totalEvents )
+	{
+		common->Warning( "testEventQueue: %d events canceled and %d serviced, expected %d", numCanceled, idEventBenchmarkTarget::numServiced, totalEvents );
+	}
+}
+
 /*
 ================
 idEvent::Save
@@ -859,11 +1154,14 @@ void idEvent::Save( idSaveGame* savefile )
 	idStr s;
 	// RB end
 
-	savefile->WriteInt( EventQueue.Num() );
+	idList<idEvent*> sortedEvents;
+	EventQueue.GetSorted( sortedEvents );
 
-	event = EventQueue.Next();
-	while( event != NULL )
+	savefile->WriteInt( sortedEvents.Num() );
+
+	for( int e = 0; e < sortedEvents.Num(); e++ )
 	{
+		event = sortedEvents[ e ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
@@ -933,23 +1231,22 @@ void idEvent::Save( idSaveGame* savefile )
 			}
 		}
 		assert( size == ( int )event->eventdef->GetArgSize() );
-		event = event->eventNode.Next();
 	}
 
 	// Save the Fast EventQueue
-	savefile->WriteInt( FastEventQueue.Num() );
+	FastEventQueue.GetSorted( sortedEvents );
+
+	savefile->WriteInt( sortedEvents.Num() );
 
-	event = FastEventQueue.Next();
-	while( event != NULL )
+	for( int e = 0; e < sortedEvents.Num(); e++ )
 	{
+		event = sortedEvents[ e ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
 		savefile->WriteObject( event->object );
 		savefile->WriteInt( event->eventdef->GetArgSize() );
 		savefile->Write( event->data, event->eventdef->GetArgSize() );
-
-		event = event->eventNode.Next();
 	}
 }
 
@@ -981,7 +1278,6 @@ void idEvent::Restore( idRestoreGame* savefile )
 
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( EventQueue );
 
 		savefile->ReadInt( event->time );
 
@@ -1004,6 +1300,15 @@ void idEvent::Restore( idRestoreGame* savefile )
 		}
 
 		savefile->ReadObject( event->object );
+		if( event->object != NULL )
+		{
+			event->objectNode.SetOwner( event );
+			event->objectNode.AddToEnd( event->object->eventList );
+		}
+
+		// the events were saved in the order they are serviced in
+		event->sequence = EventSequence++;
+		EventQueue.Add( event );
 
 		// read the args
 		savefile->ReadInt( argsize );
@@ -1099,7 +1404,6 @@ void idEvent::Restore( idRestoreGame* savefile )
 
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( FastEventQueue );
 
 		savefile->ReadInt( event->time );
 
@@ -1122,6 +1426,15 @@ void idEvent::Restore( idRestoreGame* savefile )
 		}
 
 		savefile->ReadObject( event->object );
+		if( event->object != NULL )
+		{
+			event->objectNode.SetOwner( event );
+			event->objectNode.AddToEnd( event->object->eventList );
+		}
+
+		// the events were saved in the order they are serviced in
+		event->sequence = EventSequence++;
+		FastEventQueue.Add( event );
 
 		// read the args
 		savefile->ReadInt( argsize );
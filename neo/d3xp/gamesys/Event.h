@@ -91,9 +91,12 @@ public:
 
 class idSaveGame;
 class idRestoreGame;
+class idEventHeap;
 
 class idEvent
 {
+	friend class idEventHeap;
+
 private:
 	const idEventDef*			eventdef;
 	byte*						data;
@@ -101,7 +104,12 @@ private:
 	idClass*						object;
 	const idTypeInfo*			typeinfo;
 
-	idLinkList<idEvent>			eventNode;
+	idLinkList<idEvent>			eventNode;		// on the free list
+	idLinkList<idEvent>			objectNode;		// on the event list of the object, for CancelEvents
+
+	idEventHeap*				queue;			// the queue the event is scheduled in, or NULL
+	int							queueIndex;		// heap position in the queue
+	unsigned int				sequence;		// orders events scheduled for the same time
 
 	static idDynamicBlockAlloc<byte, 16 * 1024, 256> eventDataAllocator;
 
@@ -124,6 +132,7 @@ public:
 	static void					ClearEventList();
 	static void					ServiceEvents();
 	static void					ServiceFastEvents();
+	static void					Benchmark_f( const idCmdArgs& args );
 	static void					Init();
 	static void					Shutdown();
 
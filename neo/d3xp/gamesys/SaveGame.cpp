@@ -64,12 +64,15 @@ file be unloadable in some way (for example, due to script changes).
 idSaveGame::idSaveGame()
 ================
 */
-idSaveGame::idSaveGame( idFile* savefile, idFile* stringTableFile, int saveVersion )
+idSaveGame::idSaveGame( idFile* savefile, idFile* stringTableFile, int saveVersion ) :
+	bufferedFile( savefile )
 {
 	//compressor = idCompressor::AllocLZW();
 	//compressor->Init( savefile, true, 8 );
 	//file = compressor;
-	file = savefile;
+
+	// g_flushSave wants every write to reach the save file right away
+	file = g_flushSave.GetBool() ? savefile : &bufferedFile;
 	stringFile = stringTableFile;
 	version = saveVersion;
 
@@ -124,6 +127,8 @@ void idSaveGame::Close()
 	stringHash.Free();
 	stringTable.Clear();
 
+	file->Flush();
+
 	if( file->Length() > MIN_SAVEGAME_SIZE_BYTES || stringFile->Length() > MAX_SAVEGAME_STRING_TABLE_SIZE )
 	{
 		idLib::FatalError( "OVERFLOWED SAVE GAME FILE BUFFER" );
@@ -109,6 +109,7 @@ private:
 	idFile* 				file;
 	idFile* 				stringFile;
 	idCompressor* 			compressor;
+	idFile_SaveGameBuffered	bufferedFile;		// batches the small writes to the save file
 
 	idList<const idClass*>	objects;
 	int						version;
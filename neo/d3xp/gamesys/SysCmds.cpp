@@ -1774,6 +1774,271 @@ static void Cmd_TestDeath_f( const idCmdArgs& args )
 
 }
 
+/*
+==================
+TestAFSolve_Run
+
+Spawns a grid of articulated figures above the player and times stepping them.
+==================
+*/
+static bool TestAFSolve_Run( idPlayer* player, const char* classname, int count, int steps, bool parallel, float& msec, int& numFigures )
+{
+	idList<idEntity*> entities;
+	idList<idPhysics_AF*> figures;
+	idDict dict;
+	idEntity* ent;
+	int i, side;
+
+	const float yaw = player->viewAngles.yaw;
+	const idMat3 axis = idAngles( 0, yaw, 0 ).ToMat3();
+	const idVec3 start = player->GetPhysics()->GetOrigin() + axis[0] * 128.0f + idVec3( 0, 0, 64.0f );
+
+	// keep the figures far enough apart so they don't interact
+	side = idMath::Ftoi( idMath::Ceil( idMath::Sqrt( ( float )count ) ) );
+	for( i = 0; i < count; i++ )
+	{
+		const idVec3 org = start + axis[0] * ( ( i / side ) * 96.0f ) + axis[1] * ( ( ( i % side ) - side / 2 ) * 96.0f );
+
+		dict.Clear();
+		dict.Set( "classname", classname );
+		dict.Set( "angle", va( "%f", yaw + 180 ) );
+		dict.Set( "origin", org.ToString() );
+
+		ent = NULL;
+		if( !gameLocal.SpawnEntityDef( dict, &ent ) || ent == NULL )
+		{
+			break;
+		}
+		entities.Append( ent );
+
+		if( ent->GetPhysics()->IsType( idPhysics_AF::Type ) )
+		{
+			ent->GetPhysics()->Activate();
+			figures.Append( static_cast<idPhysics_AF*>( ent->GetPhysics() ) );
+		}
+	}
+
+	numFigures = figures.Num();
+
+	const int timeStep = gameLocal.time - gameLocal.previousTime;
+	const uint64_t startTime = Sys_Microseconds();
+
+	for( i = 0; i < steps && figures.Num(); i++ )
+	{
+		if( parallel )
+		{
+			idPhysics_AF::PresolveFigures( figures.Ptr(), figures.Num(), timeStep, gameLocal.time );
+		}
+		for( int j = 0; j < entities.Num(); j++ )
+		{
+			entities[j]->RunPhysics();
+		}
+		idPhysics_AF::ClearPresolvedFigures();
+	}
+
+	msec = ( Sys_Microseconds() - startTime ) / 1000.0f;
+
+	for( i = 0; i < entities.Num(); i++ )
+	{
+		delete entities[i];
+	}
+
+	return numFigures > 0;
+}
+
+/*
+==================
+Cmd_TestAFSolve_f
+
+Compares stepping articulated figures one by one with presolving them in parallel.
+==================
+*/
+static void Cmd_TestAFSolve_f( const idCmdArgs& args )
+{
+	idPlayer* player;
+	float serialMsec, parallelMsec;
+	int count, steps, numFigures;
+
+	player = gameLocal.GetLocalPlayer();
+	if( !player || !gameLocal.CheatsOk( false ) )
+	{
+		return;
+	}
+
+	if( args.Argc() < 2 )
+	{
+		gameLocal.Printf( "usage: testAFSolve <entityDef> [count] [steps]\n" );
+		return;
+	}
+
+	count = ( args.Argc() > 2 ) ? idMath::ClampInt( 1, 256, atoi( args.Argv( 2 ) ) ) : 16;
+	steps = ( args.Argc() > 3 ) ? idMath::ClampInt( 1, 10000, atoi( args.Argv( 3 ) ) ) : 100;
+
+	if( gameLocal.time - gameLocal.previousTime <= 0 )
+	{
+		gameLocal.Printf( "the game must be running\n" );
+		return;
+	}
+
+	if( !TestAFSolve_Run( player, args.Argv( 1 ), count, steps, false, serialMsec, numFigures ) )
+	{
+		gameLocal.Printf( "'%s' does not spawn an articulated figure\n", args.Argv( 1 ) );
+		return;
+	}
+	TestAFSolve_Run( player, args.Argv( 1 ), count, steps, true, parallelMsec, numFigures );
+
+	gameLocal.Printf( "%d figures, %d steps\n", numFigures, steps );
+	gameLocal.Printf( "serial:   %7.3f ms/step\n", serialMsec / steps );
+	gameLocal.Printf( "parallel: %7.3f ms/step (%.2fx)\n", parallelMsec / steps, ( parallelMsec > 0.0f ) ? serialMsec / parallelMsec : 0.0f );
+}
+
+/*
+==================
+TestDebris_Run
+
+Drops a pile of rigid bodies in front of the player and times stepping them. The game
+time advances by one frame per step so bodies can come to rest and islands time out.
+==================
+*/
+static bool TestDebris_Run( idPlayer* player, const char* classname, int count, int steps, bool islands, float& msec, float& averageActive, int& numBodies )
+{
+	idList<idEntity*> entities;
+	idList<idPhysics_RigidBody*> bodies;
+	idDict dict;
+	idEntity* ent;
+	int i, j, numActive;
+	uint64_t startTime;
+
+	const float yaw = player->viewAngles.yaw;
+	const idMat3 axis = idAngles( 0, yaw, 0 ).ToMat3();
+	const idVec3 start = player->GetPhysics()->GetOrigin() + axis[0] * 128.0f + idVec3( 0, 0, 32.0f );
+
+	// stack layers of 4x4 bodies so they land on top of each other
+	for( i = 0; i < count; i++ )
+	{
+		const int layer = i / 16;
+		const idVec3 org = start + axis[0] * ( ( ( i / 4 ) & 3 ) * 24.0f ) + axis[1] * ( ( ( i & 3 ) - 2 ) * 24.0f ) + idVec3( 0, 0, layer * 32.0f );
+
+		dict.Clear();
+		dict.Set( "classname", classname );
+		dict.Set( "angle", va( "%f", yaw + layer * 30.0f ) );
+		dict.Set( "origin", org.ToString() );
+
+		ent = NULL;
+		if( !gameLocal.SpawnEntityDef( dict, &ent ) || ent == NULL )
+		{
+			break;
+		}
+		entities.Append( ent );
+
+		if( ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) )
+		{
+			ent->GetPhysics()->Activate();
+			bodies.Append( static_cast<idPhysics_RigidBody*>( ent->GetPhysics() ) );
+		}
+	}
+
+	numBodies = bodies.Num();
+
+	const bool groupSleep = rb_groupSleep.GetBool();
+	rb_groupSleep.SetBool( islands );
+
+	const int savedTime = gameLocal.time;
+	const int savedPreviousTime = gameLocal.previousTime;
+	const int timeStep = gameLocal.time - gameLocal.previousTime;
+	numActive = 0;
+	msec = 0.0f;
+
+	for( i = 0; i < steps && bodies.Num(); i++ )
+	{
+		gameLocal.previousTime = gameLocal.time;
+		gameLocal.time += timeStep;
+
+		startTime = Sys_Microseconds();
+
+		for( j = 0; j < entities.Num(); j++ )
+		{
+			entities[j]->RunPhysics();
+		}
+		idPhysics_RigidBody::UpdateIslands();
+
+		msec += ( Sys_Microseconds() - startTime ) / 1000.0f;
+
+		for( j = 0; j < bodies.Num(); j++ )
+		{
+			if( !bodies[j]->IsAtRest() )
+			{
+				numActive++;
+			}
+		}
+	}
+
+	rb_groupSleep.SetBool( groupSleep );
+
+	averageActive = ( float )numActive / steps;
+
+	for( i = 0; i < entities.Num(); i++ )
+	{
+		delete entities[i];
+	}
+
+	gameLocal.time = savedTime;
+	gameLocal.previousTime = savedPreviousTime;
+
+	return numBodies > 0;
+}
+
+/*
+==================
+Cmd_TestDebris_f
+
+Compares a pile of rigid bodies stepped with and without island sleeping.
+==================
+*/
+static void Cmd_TestDebris_f( const idCmdArgs& args )
+{
+	static const char* names[2] = { "serial", "islands" };
+	idPlayer* player;
+	float msec[2], active[2];
+	int i, count, steps, numBodies;
+
+	player = gameLocal.GetLocalPlayer();
+	if( !player || !gameLocal.CheatsOk( false ) )
+	{
+		return;
+	}
+
+	if( args.Argc() < 2 )
+	{
+		gameLocal.Printf( "usage: testDebris <entityDef> [count] [steps]\n" );
+		return;
+	}
+
+	count = ( args.Argc() > 2 ) ? idMath::ClampInt( 1, 512, atoi( args.Argv( 2 ) ) ) : 64;
+	steps = ( args.Argc() > 3 ) ? idMath::ClampInt( 1, 10000, atoi( args.Argv( 3 ) ) ) : 300;
+
+	if( gameLocal.time - gameLocal.previousTime <= 0 )
+	{
+		gameLocal.Printf( "the game must be running\n" );
+		return;
+	}
+
+	for( i = 0; i < 2; i++ )
+	{
+		if( !TestDebris_Run( player, args.Argv( 1 ), count, steps, i == 1, msec[i], active[i], numBodies ) )
+		{
+			gameLocal.Printf( "'%s' does not spawn a rigid body\n", args.Argv( 1 ) );
+			return;
+		}
+	}
+
+	gameLocal.Printf( "%d bodies, %d steps of %d ms\n", numBodies, steps, gameLocal.time - gameLocal.previousTime );
+	for( i = 0; i < 2; i++ )
+	{
+		gameLocal.Printf( "%-9s %7.3f ms/frame (%.2fx), %6.1f active bodies\n", va( "%s:", names[i] ), msec[i] / steps, ( msec[i] > 0.0f ) ? msec[0] / msec[i] : 0.0f, active[i] );
+	}
+}
+
 /*
 ==================
 Cmd_WeaponSplat_f
@@ -2817,6 +3082,8 @@ void idGameLocal::InitConsoleCommands()
 	cmdSystem->AddCommand( "testPointLight",		Cmd_TestPointLight_f,		CMD_FL_GAME | CMD_FL_CHEAT,	"tests a point light" );
 	cmdSystem->AddCommand( "popLight",				Cmd_PopLight_f,				CMD_FL_GAME | CMD_FL_CHEAT,	"removes the last created light" );
 	cmdSystem->AddCommand( "testDeath",				Cmd_TestDeath_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"tests death" );
+	cmdSystem->AddCommand( "testDebris",			Cmd_TestDebris_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"times a pile of rigid bodies with and without island sleeping", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
+	cmdSystem->AddCommand( "testAFSolve",			Cmd_TestAFSolve_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"times serial and parallel solving of articulated figures", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
 	cmdSystem->AddCommand( "testSave",				Cmd_TestSave_f,				CMD_FL_GAME | CMD_FL_CHEAT,	"writes out a test savegame" );
 	cmdSystem->AddCommand( "testModel",				idTestModel::TestModel_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"tests a model", idTestModel::ArgCompletion_TestModel );
 	cmdSystem->AddCommand( "testSkin",				idTestModel::TestSkin_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"tests a skin on an existing testModel", idCmdSystem::ArgCompletion_Decl<DECL_SKIN> );
@@ -2879,6 +3146,7 @@ void idGameLocal::InitConsoleCommands()
 	// localization help commands
 	cmdSystem->AddCommand( "nextGUI",				Cmd_NextGUI_f,				CMD_FL_GAME | CMD_FL_CHEAT,	"teleport the player to the next func_static with a gui" );
 	cmdSystem->AddCommand( "testid",				Cmd_TestId_f,				CMD_FL_GAME | CMD_FL_CHEAT,	"output the string for the specified id." );
+	cmdSystem->AddCommand( "testEventQueue",		idEvent::Benchmark_f,		CMD_FL_GAME | CMD_FL_CHEAT,	"measures posting, cancelling and servicing events: testEventQueue [events] [objects] [rounds]" );
 
 	cmdSystem->AddCommand( "setActorState",			Cmd_SetActorState_f,		CMD_FL_GAME | CMD_FL_CHEAT,	"Manually sets an actors script state", idGameLocal::ArgCompletion_EntityName );
 }
@@ -150,6 +150,7 @@ extern idCVar	af_showInertia;
 extern idCVar	af_showVelocity;
 extern idCVar	af_showActive;
 extern idCVar	af_testSolid;
+extern idCVar	af_parallelSolve;
 
 extern idCVar	rb_showTimings;
 extern idCVar	rb_showBodies;
@@ -157,6 +158,7 @@ extern idCVar	rb_showMass;
 extern idCVar	rb_showInertia;
 extern idCVar	rb_showVelocity;
 extern idCVar	rb_showActive;
+extern idCVar	rb_groupSleep;
 
 extern idCVar	pm_jumpheight;
 extern idCVar	pm_stepsize;
@@ -51,6 +51,7 @@ const float SUSPEND_LINEAR_VELOCITY			= 10.0f;
 const float SUSPEND_ANGULAR_VELOCITY		= 15.0f;
 const float SUSPEND_LINEAR_ACCELERATION		= 20.0f;
 const float SUSPEND_ANGULAR_ACCELERATION	= 30.0f;
+const float AF_PRESOLVE_CONTACT_RANGE		= 4.0f;		// entities this close to a presolved figure may change its contacts
 const idVec6 vec6_lcp_epsilon				= idVec6( LCP_EPSILON, LCP_EPSILON, LCP_EPSILON,
 		LCP_EPSILON, LCP_EPSILON, LCP_EPSILON );
 
@@ -62,6 +63,37 @@ const idVec6 vec6_lcp_epsilon				= idVec6( LCP_EPSILON, LCP_EPSILON, LCP_EPSILON
 	static idTimer timer_total, timer_pc, timer_ac, timer_collision, timer_lcp;
 #endif
 
+// set while a figure is solved in a job, the warnings are printed on the main thread afterwards
+static thread_local idStrList* afDeferredWarnings = NULL;
+
+// scratch list for the presolve neighbour queries, only used on the main thread
+static idEntity* afPresolveEntities[MAX_GENTITIES];
+
+/*
+================
+AF_Warning
+
+  warnings that can be raised while solving the constraints
+================
+*/
+static void AF_Warning( VERIFY_FORMAT_STRING const char* fmt, ... )
+{
+	char text[MAX_STRING_CHARS];
+	va_list argptr;
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if( afDeferredWarnings != NULL )
+	{
+		afDeferredWarnings->Append( text );
+	}
+	else
+	{
+		gameLocal.Warning( "%s", text );
+	}
+}
 
 
 //===============================================================
@@ -4930,7 +4962,7 @@ ID_INLINE void idAFBody::InverseWorldSpatialInertiaMultiply( idVecX& dst, const
 	}
 	else
 	{
-		gameLocal.Warning( "spatial inertia is not sparse for body %s", name.c_str() );
+		AF_Warning( "spatial inertia is not sparse for body %s", name.c_str() );
 	}
 }
 
@@ -5041,8 +5073,8 @@ void idAFTree::Factor() const
 				child->invI = childI;
 				if( !child->invI.InverseFastSelf() )
 				{
-					gameLocal.Warning( "idAFTree::Factor: couldn't invert %dx%d matrix for constraint '%s'",
-									   child->invI.GetNumRows(), child->invI.GetNumColumns(), child->GetName().c_str() );
+					AF_Warning( "idAFTree::Factor: couldn't invert %dx%d matrix for constraint '%s'",
+								child->invI.GetNumRows(), child->invI.GetNumColumns(), child->GetName().c_str() );
 				}
 				child->J = child->invI * child->J;
 
@@ -5052,8 +5084,8 @@ void idAFTree::Factor() const
 			body->invI = body->I;
 			if( !body->invI.InverseFastSelf() && child != NULL )
 			{
-				gameLocal.Warning( "idAFTree::Factor: couldn't invert %dx%d matrix for body %s",
-								   child->invI.GetNumRows(), child->invI.GetNumColumns(), body->GetName().c_str() );
+				AF_Warning( "idAFTree::Factor: couldn't invert %dx%d matrix for body %s",
+							child->invI.GetNumRows(), child->invI.GetNumColumns(), body->GetName().c_str() );
 			}
 			if( body->primaryConstraint )
 			{
@@ -5877,17 +5909,30 @@ void idPhysics_AF::AuxiliaryForces( float timeStep )
 	}
 
 #ifdef AF_TIMINGS
-	timer_lcp.Start();
+	const bool timings = idLib::IsMainThread();
+	if( timings )
+	{
+		timer_lcp.Start();
+	}
 #endif
 
 	// calculate lagrange multipliers for auxiliary constraints
 	if( !lcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) )
 	{
+#ifdef AF_TIMINGS
+		if( timings )
+		{
+			timer_lcp.Stop();
+		}
+#endif
 		return;		// bad monkey!
 	}
 
 #ifdef AF_TIMINGS
-	timer_lcp.Stop();
+	if( timings )
+	{
+		timer_lcp.Stop();
+	}
 #endif
 
 	// calculate auxiliary constraint forces
@@ -6816,6 +6861,7 @@ idPhysics_AF::PutToRest
 */
 void idPhysics_AF::PutToRest()
 {
+	InvalidatePresolve();
 	Rest();
 }
 
@@ -7031,15 +7077,19 @@ const idBounds& idPhysics_AF::GetAbsBounds( int id ) const
 	}
 }
 
+// figures with a presolved step that was not evaluated yet
+static idList<idPhysics_AF*, TAG_IDLIB_LIST_PHYSICS> afPresolvedFigures;
+
 /*
 ================
-idPhysics_AF::Evaluate
+idPhysics_AF::EvaluateBegin
+
+  prepares the figure for a time step and collects the contacts,
+  returns false if the figure does not need to be simulated
 ================
 */
-bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
+bool idPhysics_AF::EvaluateBegin( int timeStepMSec, int endTimeMSec, float& timeStep )
 {
-	float timeStep;
-
 	if( timeScaleRampStart < MS2SEC( endTimeMSec ) && timeScaleRampEnd > MS2SEC( endTimeMSec ) )
 	{
 		timeStep = MS2SEC( timeStepMSec ) * ( MS2SEC( endTimeMSec ) - timeScaleRampStart ) / ( timeScaleRampEnd - timeScaleRampStart );
@@ -7087,10 +7137,6 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	// move the af velocity into the frame of a pusher
 	AddPushVelocity( -current.pushVelocity );
 
-#ifdef AF_TIMINGS
-	timer_total.Start();
-#endif
-
 #ifdef AF_TIMINGS
 	timer_collision.Start();
 #endif
@@ -7105,6 +7151,24 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	timer_collision.Stop();
 #endif
 
+	return true;
+}
+
+/*
+================
+idPhysics_AF::EvaluateSolve
+
+  solves the constraint forces and evolves the bodies to the next state,
+  only touches this figure so it can run in a job
+================
+*/
+void idPhysics_AF::EvaluateSolve( float timeStep, int endTimeMSec )
+{
+#ifdef AF_TIMINGS
+	// the timers are shared so only time the solve when it runs on the main thread
+	const bool timings = idLib::IsMainThread();
+#endif
+
 	// evaluate constraint equations
 	EvaluateConstraints( timeStep );
 
@@ -7115,16 +7179,10 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	AddFrameConstraints();
 
 #ifdef AF_TIMINGS
-	int i, numPrimary = 0, numAuxiliary = 0;
-	for( i = 0; i < primaryConstraints.Num(); i++ )
-	{
-		numPrimary += primaryConstraints[i]->J1.GetNumRows();
-	}
-	for( i = 0; i < auxiliaryConstraints.Num(); i++ )
+	if( timings )
 	{
-		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+		timer_pc.Start();
 	}
-	timer_pc.Start();
 #endif
 
 	// factor matrices for primary constraints
@@ -7134,19 +7192,47 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	PrimaryForces( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_pc.Stop();
-	timer_ac.Start();
+	if( timings )
+	{
+		timer_pc.Stop();
+		timer_ac.Start();
+	}
 #endif
 
 	// calculate and apply auxiliary constraint forces
 	AuxiliaryForces( timeStep );
 
 #ifdef AF_TIMINGS
-	timer_ac.Stop();
+	if( timings )
+	{
+		timer_ac.Stop();
+	}
 #endif
 
 	// evolve current state to next state
 	Evolve( timeStep );
+}
+
+/*
+================
+idPhysics_AF::EvaluateEnd
+
+  applies the solved step to the world
+================
+*/
+void idPhysics_AF::EvaluateEnd( float timeStep, int endTimeMSec )
+{
+#ifdef AF_TIMINGS
+	int i, numPrimary = 0, numAuxiliary = 0;
+	for( i = 0; i < primaryConstraints.Num(); i++ )
+	{
+		numPrimary += primaryConstraints[i]->J1.GetNumRows();
+	}
+	for( i = 0; i < auxiliaryConstraints.Num(); i++ )
+	{
+		numAuxiliary += auxiliaryConstraints[i]->J1.GetNumRows();
+	}
+#endif
 
 	// debug graphics
 	DebugDraw();
@@ -7248,10 +7334,494 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 		timer_lcp.Clear();
 	}
 #endif
+}
+
+/*
+================
+idPhysics_AF::Evaluate
+================
+*/
+bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
+{
+	float timeStep;
+
+#ifdef AF_TIMINGS
+	timer_total.Start();
+#endif
+
+	if( IsPresolved( timeStepMSec, endTimeMSec ) && PresolveContactsValid() )
+	{
+		// the constraint forces were already solved in parallel with other figures
+		timeStep = current.lastTimeStep;
+		presolveTime = -1;
+		afPresolvedFigures.Remove( this );
+	}
+	else
+	{
+		InvalidatePresolve();
+
+		if( !EvaluateBegin( timeStepMSec, endTimeMSec, timeStep ) )
+		{
+#ifdef AF_TIMINGS
+			timer_total.Stop();
+#endif
+			return false;
+		}
+
+		EvaluateSolve( timeStep, endTimeMSec );
+	}
+
+	EvaluateEnd( timeStep, endTimeMSec );
+
+	return true;
+}
+
+/*
+================
+AF_PresolveFigure
+
+  job that solves the constraint forces for a single figure
+================
+*/
+void AF_PresolveFigure( idPhysics_AF* af )
+{
+	afDeferredWarnings = &af->presolveWarnings;
+	af->EvaluateSolve( af->current.lastTimeStep, af->presolveTime );
+	afDeferredWarnings = NULL;
+}
+
+REGISTER_PARALLEL_JOB( AF_PresolveFigure, "AF_PresolveFigure" );
+
+/*
+================
+idPhysics_AF::CanPresolve
+
+  figures that trace the world while solving or have their constraints
+  steered by the entity are always evaluated serially
+================
+*/
+bool idPhysics_AF::CanPresolve() const
+{
+	int i;
+
+	if( current.atRest >= 0 || !bodies.Num() )
+	{
+		return false;
+	}
+
+	for( i = 0; i < constraints.Num(); i++ )
+	{
+		if( constraints[i]->GetType() == CONSTRAINT_SUSPENSION || constraints[i]->GetType() == CONSTRAINT_HINGESTEERING )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::IsPresolved
+
+  returns true if the presolved step can be used for this evaluation
+================
+*/
+bool idPhysics_AF::IsPresolved( int timeStepMSec, int endTimeMSec ) const
+{
+	int i;
+
+	if( presolveTime != endTimeMSec || presolveTimeStepMSec != timeStepMSec )
+	{
+		return false;
+	}
+
+	if( changedAF || current.atRest >= 0 || presolveEnd.Num() != bodies.Num() )
+	{
+		return false;
+	}
+
+	// the bodies may have been moved directly after the presolve
+	for( i = 0; i < bodies.Num(); i++ )
+	{
+		if( memcmp( bodies[i]->current, &presolveEnd[i], sizeof( AFBodyPState_t ) ) != 0 )
+		{
+			return false;
+		}
+	}
+
+	if( masterBody )
+	{
+		idVec3 masterOrigin;
+		idMat3 masterAxis;
+		self->GetMasterPosition( masterOrigin, masterAxis );
+		if( masterBody->current->worldOrigin != masterOrigin || masterBody->current->worldAxis != masterAxis )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::InvalidatePresolve
+
+  drops a presolved step that has not been evaluated yet
+================
+*/
+void idPhysics_AF::InvalidatePresolve()
+{
+	int i;
+
+	if( presolveTime < 0 )
+	{
+		return;
+	}
+	presolveTime = -1;
+
+	afPresolvedFigures.Remove( this );
+
+	// remove the frame constraints added by the solve
+	RemoveFrameConstraints();
+
+	if( presolveStart.Num() != bodies.Num() || presolveEnd.Num() != bodies.Num() )
+	{
+		return;
+	}
+
+	// undo the push velocity and friction impulses unless a velocity was set since
+	for( i = 0; i < bodies.Num(); i++ )
+	{
+		if( bodies[i]->current->spatialVelocity == presolveEnd[i].spatialVelocity )
+		{
+			bodies[i]->current->spatialVelocity = presolveStart[i].spatialVelocity;
+		}
+	}
+}
+
+/*
+================
+idPhysics_AF::PresolveFigures
+
+  Collects the contacts for each figure serially and then solves the
+  constraint forces of all figures in parallel. Figures touching each
+  other are solved as a group from the same start state, the results are
+  applied to the world in the regular Evaluate of each figure, in the
+  order the figures think. The other entities in contact range are
+  recorded so Evaluate can tell if the contacts changed in between.
+================
+*/
+void idPhysics_AF::PresolveFigures( idPhysics_AF** figures, int numFigures, int timeStepMSec, int endTimeMSec )
+{
+	static idList<idPhysics_AF*, TAG_IDLIB_LIST_PHYSICS> solveList;
+	int i, j;
+	float timeStep;
+	bool active;
+	idEntity* part;
+
+	solveList.SetNum( 0 );
+
+	for( i = 0; i < numFigures; i++ )
+	{
+		idPhysics_AF* af = figures[i];
+
+		af->InvalidatePresolve();
+
+		if( !af->CanPresolve() )
+		{
+			continue;
+		}
+
+		af->presolveStart.SetNum( af->bodies.Num() );
+		for( j = 0; j < af->bodies.Num(); j++ )
+		{
+			af->presolveStart[j] = *af->bodies[j]->current;
+		}
+
+		// disable the team for collision detection the same way idEntity::RunPhysics does
+		for( part = af->self; part != NULL; part = part->GetTeamChain() )
+		{
+			if( part->GetPhysics() && !part->fl.solidForTeam )
+			{
+				part->GetPhysics()->DisableClip();
+			}
+		}
+
+		active = af->EvaluateBegin( timeStepMSec, endTimeMSec, timeStep );
+
+		for( part = af->self; part != NULL; part = part->GetTeamChain() )
+		{
+			if( part->GetPhysics() && !part->fl.solidForTeam )
+			{
+				part->GetPhysics()->EnableClip();
+			}
+		}
+
+		if( !active )
+		{
+			continue;
+		}
+
+		af->presolveTime = endTimeMSec;
+		af->presolveTimeStepMSec = timeStepMSec;
+		af->presolveBatchTime = endTimeMSec;
+		solveList.Append( af );
+	}
+
+	// the whole batch has to be known before the neighbours are recorded
+	for( i = 0; i < solveList.Num(); i++ )
+	{
+		solveList[i]->RecordPresolveNeighbours();
+	}
+
+	if( gameLocal.physicsJobList != NULL && solveList.Num() > 1 )
+	{
+		for( i = 0; i < solveList.Num(); i++ )
+		{
+			gameLocal.physicsJobList->AddJob( ( jobRun_t )AF_PresolveFigure, solveList[i] );
+		}
+		gameLocal.physicsJobList->Submit();
+		gameLocal.physicsJobList->Wait();
+	}
+	else
+	{
+		for( i = 0; i < solveList.Num(); i++ )
+		{
+			AF_PresolveFigure( solveList[i] );
+		}
+	}
 
+	for( i = 0; i < solveList.Num(); i++ )
+	{
+		idPhysics_AF* af = solveList[i];
+
+		// the game warnings aren't thread safe
+		for( j = 0; j < af->presolveWarnings.Num(); j++ )
+		{
+			gameLocal.Warning( "%s", af->presolveWarnings[j].c_str() );
+		}
+		af->presolveWarnings.Clear();
+
+		af->presolveEnd.SetNum( af->bodies.Num() );
+		for( j = 0; j < af->bodies.Num(); j++ )
+		{
+			af->presolveEnd[j] = *af->bodies[j]->current;
+		}
+		afPresolvedFigures.Append( af );
+	}
+}
+
+/*
+================
+idPhysics_AF::IsPresolveNeighbour
+
+  returns true if the entity may change the contacts of the presolved figure,
+  the team of the figure and the figures presolved in the same batch don't
+================
+*/
+bool idPhysics_AF::IsPresolveNeighbour( const idEntity* ent ) const
+{
+	const idEntity* master;
+	const idPhysics* physics;
+
+	if( ent == self || ent->GetTeamMaster() == self )
+	{
+		return false;
+	}
+
+	master = ent->GetTeamMaster() != NULL ? ent->GetTeamMaster() : ent;
+	physics = master->GetPhysics();
+	if( physics != NULL && physics->IsType( idPhysics_AF::Type ) )
+	{
+		if( static_cast<const idPhysics_AF*>( physics )->presolveBatchTime == presolveBatchTime )
+		{
+			return false;
+		}
+	}
 	return true;
 }
 
+/*
+================
+idPhysics_AF::RecordPresolveNeighbours
+
+  stores the clip model poses of the entities in contact range of the figure
+================
+*/
+void idPhysics_AF::RecordPresolveNeighbours()
+{
+	idPhysics* physics;
+	int i, j, num;
+
+	presolveNeighbours.SetNum( 0 );
+
+	idBounds bounds = GetAbsBounds();
+	bounds.ExpandSelf( AF_PRESOLVE_CONTACT_RANGE );
+
+	num = gameLocal.clip.EntitiesTouchingBounds( bounds, -1, afPresolveEntities, MAX_GENTITIES );
+	for( i = 0; i < num; i++ )
+	{
+		if( !IsPresolveNeighbour( afPresolveEntities[i] ) )
+		{
+			continue;
+		}
+		physics = afPresolveEntities[i]->GetPhysics();
+		if( physics == NULL )
+		{
+			continue;
+		}
+		for( j = 0; j < physics->GetNumClipModels(); j++ )
+		{
+			AFPresolvePose_t& pose = presolveNeighbours.Alloc();
+			pose.spawnId = gameLocal.GetSpawnId( afPresolveEntities[i] );
+			pose.clipModel = j;
+			pose.origin = physics->GetOrigin( j );
+			pose.axis = physics->GetAxis( j );
+		}
+	}
+}
+
+/*
+================
+idPhysics_AF::PresolveContactsValid
+
+  returns true if no entity moved into, out of or within contact range of the
+  figure since it was presolved
+================
+*/
+bool idPhysics_AF::PresolveContactsValid() const
+{
+	const idEntity* ent;
+	idPhysics* physics;
+	int i, j, num, spawnId;
+
+	for( i = 0; i < presolveNeighbours.Num(); i++ )
+	{
+		const AFPresolvePose_t& pose = presolveNeighbours[i];
+
+		ent = gameLocal.entities[ pose.spawnId & ( ( 1 << GENTITYNUM_BITS ) - 1 ) ];
+		if( ent == NULL || gameLocal.GetSpawnId( ent ) != pose.spawnId )
+		{
+			return false;
+		}
+		physics = ent->GetPhysics();
+		if( physics == NULL || pose.clipModel >= physics->GetNumClipModels() )
+		{
+			return false;
+		}
+		if( physics->GetOrigin( pose.clipModel ) != pose.origin || physics->GetAxis( pose.clipModel ) != pose.axis )
+		{
+			return false;
+		}
+	}
+
+	idBounds bounds = GetAbsBounds();
+	bounds.ExpandSelf( AF_PRESOLVE_CONTACT_RANGE );
+
+	num = gameLocal.clip.EntitiesTouchingBounds( bounds, -1, afPresolveEntities, MAX_GENTITIES );
+	for( i = 0; i < num; i++ )
+	{
+		if( !IsPresolveNeighbour( afPresolveEntities[i] ) )
+		{
+			continue;
+		}
+		spawnId = gameLocal.GetSpawnId( afPresolveEntities[i] );
+		for( j = 0; j < presolveNeighbours.Num(); j++ )
+		{
+			if( presolveNeighbours[j].spawnId == spawnId )
+			{
+				break;
+			}
+		}
+		if( j >= presolveNeighbours.Num() )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+================
+idPhysics_AF::PresolveActiveFigures
+
+  Presolves the thinking articulated figures for the current game frame.
+
+  The contacts of a presolved figure are collected before any entity thinks.
+  Impulses and moves applied to the figure in between are caught by IsPresolved,
+  an entity moving into, out of or within contact range of the figure is caught
+  by PresolveContactsValid. Either way the figure is solved again serially when
+  it thinks. Figures touching each other, like a pile of ragdolls, stay presolved
+  as a group that was solved from the same start state.
+================
+*/
+void idPhysics_AF::PresolveActiveFigures()
+{
+	static idList<idPhysics_AF*, TAG_IDLIB_LIST_PHYSICS> figures;
+	idEntity* ent;
+	idPhysics* physics;
+	idPhysics_AF* af;
+
+	if( !af_parallelSolve.GetBool() || gameLocal.physicsJobList == NULL )
+	{
+		return;
+	}
+
+	figures.SetNum( 0 );
+	for( ent = gameLocal.activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() )
+	{
+		if( ent->timeGroup != TIME_GROUP1 || ent->fl.isDormant || !( ent->thinkFlags & TH_PHYSICS ) )
+		{
+			continue;
+		}
+		if( ent->entityNumber < MAX_PLAYERS )
+		{
+			continue;
+		}
+		if( ent->GetTeamMaster() != NULL && ent->GetTeamMaster() != ent )
+		{
+			continue;
+		}
+		physics = ent->GetPhysics();
+		if( physics == NULL || !physics->IsType( idPhysics_AF::Type ) )
+		{
+			continue;
+		}
+		af = static_cast<idPhysics_AF*>( physics );
+		if( !af->CanPresolve() )
+		{
+			continue;
+		}
+		figures.Append( af );
+	}
+
+	// a single figure gains nothing from the batch
+	if( figures.Num() < 2 )
+	{
+		return;
+	}
+
+	PresolveFigures( figures.Ptr(), figures.Num(), gameLocal.time - gameLocal.previousTime, gameLocal.time );
+}
+
+/*
+================
+idPhysics_AF::ClearPresolvedFigures
+
+  drops the presolved steps of figures that did not evaluate this frame
+================
+*/
+void idPhysics_AF::ClearPresolvedFigures()
+{
+	while( afPresolvedFigures.Num() )
+	{
+		afPresolvedFigures[afPresolvedFigures.Num() - 1]->InvalidatePresolve();
+	}
+}
+
 /*
 ================
 idPhysics_AF::UpdateTime
@@ -7479,6 +8049,10 @@ idPhysics_AF::idPhysics_AF()
 
 	lcp = idLCP::AllocSymmetric();
 
+	presolveTime = -1;
+	presolveTimeStepMSec = 0;
+	presolveBatchTime = -1;
+
 	memset( &current, 0, sizeof( current ) );
 	current.atRest = -1;
 	current.lastTimeStep = 0.0f;
@@ -7556,6 +8130,11 @@ idPhysics_AF::~idPhysics_AF()
 		delete contactConstraints[i];
 	}
 
+	if( presolveTime >= 0 )
+	{
+		afPresolvedFigures.Remove( this );
+	}
+
 	delete lcp;
 
 	if( masterBody )
@@ -8401,6 +8980,7 @@ void idPhysics_AF::ApplyImpulse( const int id, const idVec3& point, const idVec3
 	{
 		return;
 	}
+	InvalidatePresolve();
 	const float maxImpulse =  100000.0f;
 	const float maxRotation = 100000.0f;
 	idMat3 invWorldInertiaTensor = bodies[id]->current->worldAxis.Transpose() * bodies[id]->inverseInertiaTensor * bodies[id]->current->worldAxis;
@@ -8424,6 +9004,7 @@ void idPhysics_AF::AddForce( const int id, const idVec3& point, const idVec3& fo
 	{
 		return;
 	}
+	InvalidatePresolve();
 	bodies[id]->current->externalForce.SubVec3( 0 ) += force;
 	bodies[id]->current->externalForce.SubVec3( 1 ) += ( point - bodies[id]->current->worldOrigin ).Cross( force );
 	Activate();
@@ -8485,6 +9066,8 @@ void idPhysics_AF::RestoreState()
 {
 	int i;
 
+	InvalidatePresolve();
+
 	current = saved;
 
 	for( i = 0; i < bodies.Num(); i++ )
@@ -8546,6 +9129,8 @@ void idPhysics_AF::Translate( const idVec3& translation, int id )
 	int i;
 	idAFBody* body;
 
+	InvalidatePresolve();
+
 	if( !worldConstraintsLocked )
 	{
 		// translate constraints attached to the world
@@ -8578,6 +9163,8 @@ void idPhysics_AF::Rotate( const idRotation& rotation, int id )
 	int i;
 	idAFBody* body;
 
+	InvalidatePresolve();
+
 	if( !worldConstraintsLocked )
 	{
 		// rotate constraints attached to the world
@@ -8646,6 +9233,7 @@ void idPhysics_AF::SetLinearVelocity( const idVec3& newLinearVelocity, int id )
 	{
 		return;
 	}
+	InvalidatePresolve();
 	bodies[id]->current->spatialVelocity.SubVec3( 0 ) = newLinearVelocity;
 	Activate();
 }
@@ -8661,6 +9249,7 @@ void idPhysics_AF::SetAngularVelocity( const idVec3& newAngularVelocity, int id
 	{
 		return;
 	}
+	InvalidatePresolve();
 	bodies[id]->current->spatialVelocity.SubVec3( 1 ) = newAngularVelocity;
 	Activate();
 }
@@ -8883,6 +9472,8 @@ void idPhysics_AF::SetPushed( int deltaTime )
 	idAFBody* body;
 	idRotation rotation;
 
+	InvalidatePresolve();
+
 	if( bodies.Num() )
 	{
 		body = bodies[0];
@@ -8928,6 +9519,8 @@ void idPhysics_AF::SetMaster( idEntity* master, const bool orientated )
 	idMat3 masterAxis;
 	idRotation rotation;
 
+	InvalidatePresolve();
+
 	if( master )
 	{
 		self->GetMasterPosition( masterOrigin, masterAxis );
@@ -746,6 +746,14 @@ typedef struct AFBodyPState_s
 	idVec6					externalForce;				// external force and torque applied to body
 } AFBodyPState_t;
 
+typedef struct AFPresolvePose_s
+{
+	int						spawnId;					// entity near the figure when it was presolved
+	int						clipModel;					// clip model of the entity
+	idVec3					origin;						// origin of the clip model at the presolve
+	idMat3					axis;						// axis of the clip model at the presolve
+} AFPresolvePose_t;
+
 
 class idAFBody
 {
@@ -1087,6 +1095,13 @@ public:
 	}
 	// update the clip model positions
 	void					UpdateClipModels();
+	// collect contacts serially and then solve independent figures in parallel jobs,
+	// the solved step is applied by the next Evaluate with the same time step
+	static void				PresolveFigures( idPhysics_AF** figures, int numFigures, int timeStepMSec, int endTimeMSec );
+	// presolve all thinking articulated figures for the current game frame
+	static void				PresolveActiveFigures();
+	// drop presolved steps that were not evaluated
+	static void				ClearPresolvedFigures();
 
 public:	// common physics interface
 	void					SetClipModel( idClipModel* model, float density, int id = 0, bool freeOld = true );
@@ -1215,6 +1230,15 @@ private:
 	idAFBody* 				masterBody;						// master body
 	idLCP* 					lcp;							// linear complementarity problem solver
 
+	// presolved step
+	int						presolveTime;					// end time of the presolved step, -1 if none
+	int						presolveTimeStepMSec;			// time step of the presolved step
+	idList<AFBodyPState_t, TAG_IDLIB_LIST_PHYSICS>	presolveStart;	// body states before the presolve
+	idList<AFBodyPState_t, TAG_IDLIB_LIST_PHYSICS>	presolveEnd;	// body states after the presolve
+	idStrList				presolveWarnings;				// raised by the presolve job, printed on the main thread
+	int						presolveBatchTime;				// end time of the last batch the figure was presolved in
+	idList<AFPresolvePose_t, TAG_IDLIB_LIST_PHYSICS>	presolveNeighbours;	// entities in contact range at the presolve
+
 private:
 	void					BuildTrees();
 	bool					IsClosedLoop( const idAFBody* body1, const idAFBody* body2 ) const;
@@ -1241,6 +1265,17 @@ private:
 	void					Rest();
 	void					AddPushVelocity( const idVec6& pushVelocity );
 	void					DebugDraw();
+	bool					EvaluateBegin( int timeStepMSec, int endTimeMSec, float& timeStep );
+	void					EvaluateSolve( float timeStep, int endTimeMSec );
+	void					EvaluateEnd( float timeStep, int endTimeMSec );
+	bool					CanPresolve() const;
+	bool					IsPresolveNeighbour( const idEntity* ent ) const;
+	void					RecordPresolveNeighbours();
+	bool					PresolveContactsValid() const;
+	bool					IsPresolved( int timeStepMSec, int endTimeMSec ) const;
+	void					InvalidatePresolve();
+
+	friend void				AF_PresolveFigure( idPhysics_AF* af );
 };
 
 #endif /* !__PHYSICS_AF_H__ */
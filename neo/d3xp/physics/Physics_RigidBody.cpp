@@ -35,6 +35,10 @@ CLASS_DECLARATION( idPhysics_Base, idPhysics_RigidBody )
 END_CLASS
 
 const float STOP_SPEED		= 10.0f;
+const int RB_GROUP_SLEEP_TIME	= 1000;		// bodies rest on their own when their island did not come to rest within this many milliseconds
+
+// bodies at rest that touch other active bodies and wait for their island to come to rest
+static idList<idPhysics_RigidBody*, TAG_PHYSICS> rbRestCandidates;
 
 
 #undef RB_TIMINGS
@@ -507,6 +511,10 @@ idPhysics_RigidBody::idPhysics_RigidBody()
 	hasMaster = false;
 	isOrientated = false;
 
+	islandNext = NULL;
+	islandMark = -1;
+	restCandidateTime = -1;
+
 #ifdef RB_TIMINGS
 	lastTimerReset = 0;
 #endif
@@ -519,6 +527,12 @@ idPhysics_RigidBody::~idPhysics_RigidBody
 */
 idPhysics_RigidBody::~idPhysics_RigidBody()
 {
+	LeaveIsland();
+	if( restCandidateTime >= 0 )
+	{
+		rbRestCandidates.Remove( this );
+	}
+
 	if( clipModel )
 	{
 		delete clipModel;
@@ -692,6 +706,7 @@ void idPhysics_RigidBody::SetClipModel( idClipModel* model, const float density,
 
 	current.i.linearMomentum.Zero();
 	current.i.angularMomentum.Zero();
+
 }
 
 /*
@@ -777,6 +792,11 @@ idPhysics_RigidBody::Rest
 */
 void idPhysics_RigidBody::Rest()
 {
+	if( restCandidateTime >= 0 )
+	{
+		restCandidateTime = -1;
+		rbRestCandidates.Remove( this );
+	}
 	current.atRest = gameLocal.time;
 	current.i.linearMomentum.Zero();
 	current.i.angularMomentum.Zero();
@@ -811,8 +831,22 @@ idPhysics_RigidBody::Activate
 */
 void idPhysics_RigidBody::Activate()
 {
+	idPhysics_RigidBody* body, *next;
+
 	current.atRest = -1;
 	self->BecomeActive( TH_PHYSICS );
+
+	// wake up the bodies that went to rest together with this one
+	if( islandNext )
+	{
+		for( body = islandNext, islandNext = NULL; body != this && body != NULL; body = next )
+		{
+			next = body->islandNext;
+			body->islandNext = NULL;
+			body->current.atRest = -1;
+			body->self->BecomeActive( TH_PHYSICS );
+		}
+	}
 }
 
 /*
@@ -1007,20 +1041,36 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 #endif
 
 		// check if the body has come to rest
-		if( TestIfAtRest() )
+		if( !TestIfAtRest() )
 		{
-			// put to rest
-			Rest();
-			cameToRest = true;
+			if( restCandidateTime >= 0 )
+			{
+				restCandidateTime = -1;
+				rbRestCandidates.Remove( this );
+			}
+
+			// apply contact friction
+			ContactFriction( timeStep );
 		}
-		else
+		else if( rb_groupSleep.GetBool() && TouchesActiveBodies() && ( restCandidateTime < 0 || gameLocal.time - restCandidateTime < RB_GROUP_SLEEP_TIME ) )
 		{
-			// apply contact friction
+			// wait for the other bodies in the island so the pile does not wake itself up again
+			if( restCandidateTime < 0 )
+			{
+				restCandidateTime = gameLocal.time;
+				rbRestCandidates.Append( this );
+			}
 			ContactFriction( timeStep );
 		}
+		else
+		{
+			// put to rest
+			Rest();
+			cameToRest = true;
+		}
 	}
 
-	if( current.atRest < 0 )
+	if( current.atRest < 0 && restCandidateTime < 0 )
 	{
 		ActivateContactEntities();
 	}
@@ -1084,6 +1134,141 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 	return true;
 }
 
+/*
+================
+idPhysics_RigidBody::TouchesActiveBodies
+
+  Returns true if any of the contacts is with another rigid body that is not at rest.
+================
+*/
+bool idPhysics_RigidBody::TouchesActiveBodies() const
+{
+	int i;
+	idEntity* ent;
+
+	for( i = 0; i < contacts.Num(); i++ )
+	{
+		ent = gameLocal.entities[ contacts[i].entityNum ];
+		if( ent && ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) && !ent->GetPhysics()->IsAtRest() )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+================
+idPhysics_RigidBody::LeaveIsland
+
+  Removes the body from the ring of bodies that went to rest together.
+================
+*/
+void idPhysics_RigidBody::LeaveIsland()
+{
+	idPhysics_RigidBody* prev;
+
+	if( !islandNext )
+	{
+		return;
+	}
+
+	for( prev = islandNext; prev->islandNext != this; prev = prev->islandNext )
+	{
+	}
+	prev->islandNext = ( islandNext != prev ) ? islandNext : NULL;
+	islandNext = NULL;
+}
+
+/*
+================
+idPhysics_RigidBody::UpdateIslands
+
+  Bodies touching other active rigid bodies do not come to rest on their own.
+  They wait until every active body in their island of touching bodies is at rest
+  and then all of them are put to rest together. The bodies are linked in a ring
+  so the whole island wakes up again when any of them is activated.
+================
+*/
+void idPhysics_RigidBody::UpdateIslands()
+{
+	static idList<idPhysics_RigidBody*, TAG_PHYSICS> candidates;
+	static idList<idPhysics_RigidBody*, TAG_PHYSICS> island;
+	static int islandCount = 0;
+	int i, j, k;
+	bool canSleep;
+	idEntity* ent;
+	idPhysics_RigidBody* body, *other;
+
+	if( !rbRestCandidates.Num() )
+	{
+		return;
+	}
+
+	// bodies leave the list when put to rest
+	candidates = rbRestCandidates;
+
+	islandCount++;
+
+	for( i = 0; i < candidates.Num(); i++ )
+	{
+		body = candidates[i];
+		if( body->islandMark == islandCount || body->restCandidateTime < 0 )
+		{
+			continue;
+		}
+
+		// flood the contact graph through all active rigid bodies
+		island.SetNum( 0 );
+		island.Append( body );
+		body->islandMark = islandCount;
+		canSleep = true;
+
+		for( j = 0; j < island.Num(); j++ )
+		{
+			if( island[j]->restCandidateTime < 0 )
+			{
+				canSleep = false;
+			}
+
+			const idList<contactInfo_t, TAG_IDLIB_LIST_PHYSICS>& touching = island[j]->contacts;
+			for( k = 0; k < touching.Num(); k++ )
+			{
+				ent = gameLocal.entities[ touching[k].entityNum ];
+				if( !ent || !ent->GetPhysics()->IsType( idPhysics_RigidBody::Type ) )
+				{
+					continue;
+				}
+				other = static_cast<idPhysics_RigidBody*>( ent->GetPhysics() );
+				if( other->current.atRest >= 0 || other->islandMark == islandCount )
+				{
+					continue;
+				}
+				other->islandMark = islandCount;
+				island.Append( other );
+			}
+		}
+
+		if( !canSleep )
+		{
+			continue;
+		}
+
+		for( j = 0; j < island.Num(); j++ )
+		{
+			island[j]->LeaveIsland();
+			island[j]->Rest();
+		}
+		if( island.Num() > 1 )
+		{
+			for( j = 0; j < island.Num(); j++ )
+			{
+				island[j]->islandNext = island[( j + 1 ) % island.Num()];
+			}
+		}
+	}
+}
+
 /*
 ================
 idPhysics_RigidBody::Interpolate
@@ -108,6 +108,9 @@ public:
 	void					EnableImpact();
 	void					DisableImpact();
 
+	// put islands of touching bodies to rest together once all of them came to rest
+	static void				UpdateIslands();
+
 public:	// common physics interface
 	void					SetClipModel( idClipModel* model, float density, int id = 0, bool freeOld = true );
 	idClipModel* 			GetClipModel( int id = 0 ) const;
@@ -209,6 +212,11 @@ private:
 	bool					hasMaster;
 	bool					isOrientated;
 
+	// sleeping islands
+	idPhysics_RigidBody* 	islandNext;					// next body in the ring of bodies that went to rest together
+	int						islandMark;					// set when visited while building islands
+	int						restCandidateTime;			// time the body first came to rest while touching other active bodies, -1 if not
+
 private:
 	friend void				RigidBodyDerivatives( const float t, const void* clientData, const float* state, float* derivatives );
 	void					Integrate( const float deltaTime, rigidBodyPState_t& next );
@@ -219,6 +227,8 @@ private:
 	bool					TestIfAtRest() const;
 	void					Rest();
 	void					DebugDraw();
+	bool					TouchesActiveBodies() const;
+	void					LeaveIsland();
 };
 
 #endif /* !__PHYSICS_RIGIDBODY_H__ */
@@ -187,6 +187,9 @@ idCommonLocal::idCommonLocal() :
 	syncNextGameFrame = true;
 	mapSpawned = false;
 	timeDemo = TD_NO;
+	timeDemoStartTime = 0;
+	numDemoFrames = 0;
+	recordingCameraPath = false;
 
 	nextSnapshotSendTime = 0;
 	nextUsercmdSendTime = 0;
@@ -262,6 +265,13 @@ void idCommonLocal::ParseCommandLine( int argc, const char* const* argv )
 #endif
 			// RB end
 		}
+		else if( idStr::Icmp( argv[ i ], "-nullrender" ) == 0 )
+		{
+			// run the renderer front end without executing or presenting anything,
+			// for CPU benchmarks with timeDemo
+			com_numConsoleLines++;
+			com_consoleLines[ com_numConsoleLines - 1 ].TokenizeString( "set r_nullRender 1", false );
+		}
 		else if( argv[ i ][ 0 ] == '+' )
 		{
 			com_numConsoleLines++;
@@ -1161,6 +1171,8 @@ void idCommonLocal::Init( int argc, const char* const* argv, const char* cmdline
 		// initialize idLib
 		idLib::Init();
 
+		idProfiler::SetThreadName( "MainThread" );
+
 		// clear warning buffer
 		ClearWarnings( GAME_NAME " initialization" );
 
@@ -1914,6 +1926,81 @@ CONSOLE_COMMAND( testSIMD, "test SIMD code", NULL )
 	idSIMD::Test_f( args );
 }
 
+/*
+=================
+TestListGrowth
+
+Appends the same elements to idLists with the different growth policies.
+=================
+*/
+template< typename type >
+static void TestListGrowth( const char* typeName, int numElements, const type& element )
+{
+	uint64_t start, end;
+
+	common->Printf( "%d x %s (%d bytes, %s)\n", numElements, typeName, ( int )sizeof( type ),
+					idListRelocatable< type >::value && std::is_trivially_destructible< type >::value ? "memcpy relocation" : "element relocation" );
+
+	{
+		idList< type > list;
+		start = Sys_Microseconds();
+		for( int i = 0; i < numElements; i++ )
+		{
+			list.Append( element );
+		}
+		end = Sys_Microseconds();
+		common->Printf( "  fixed granularity: %8.2f msec, %d allocated\n", ( end - start ) * 0.001f, list.NumAllocated() );
+	}
+
+	{
+		idList< type > list;
+		list.SetGeometricGrowth( true );
+		start = Sys_Microseconds();
+		for( int i = 0; i < numElements; i++ )
+		{
+			list.Append( element );
+		}
+		end = Sys_Microseconds();
+		common->Printf( "  geometric growth:  %8.2f msec, %d allocated\n", ( end - start ) * 0.001f, list.NumAllocated() );
+	}
+
+	{
+		idList< type > list;
+		start = Sys_Microseconds();
+		list.Reserve( numElements );
+		for( int i = 0; i < numElements; i++ )
+		{
+			list.Append( element );
+		}
+		end = Sys_Microseconds();
+		common->Printf( "  reserved:          %8.2f msec, %d allocated\n", ( end - start ) * 0.001f, list.NumAllocated() );
+	}
+
+	{
+		idList< type > list;
+		list.SetGeometricGrowth( true );
+		start = Sys_Microseconds();
+		for( int i = 0; i < numElements; i++ )
+		{
+			list.Emplace( element );
+		}
+		end = Sys_Microseconds();
+		common->Printf( "  geometric emplace: %8.2f msec, %d allocated\n", ( end - start ) * 0.001f, list.NumAllocated() );
+	}
+}
+
+CONSOLE_COMMAND( testListGrowth, "compares the idList growth policies, usage: testListGrowth [numElements]", NULL )
+{
+	const int numElements = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 50000;
+
+	idDrawVert vert;
+	vert.Clear();
+
+	TestListGrowth< int >( "int", numElements, 1 );
+	TestListGrowth< idDrawVert >( "idDrawVert", numElements, vert );
+	TestListGrowth< idStr >( "idStr", numElements / 4, idStr( "testListGrowth" ) );
+}
+
 // RB begin
 CONSOLE_COMMAND( testFormattingSizes, "test printf format security", 0 )
 {
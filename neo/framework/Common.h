@@ -77,11 +77,20 @@ class idMatchParameters;
 
 struct lobbyConnectInfo_t;
 
+// the native profiler ignores the color, events are recorded only while idProfiler is capturing
 ID_INLINE void BeginProfileNamedEventColor( uint32_t color, VERIFY_FORMAT_STRING const char* szName )
 {
+	if( idProfiler::IsCapturing() )
+	{
+		idProfiler::BeginEvent( szName );
+	}
 }
 ID_INLINE void EndProfileNamedEvent()
 {
+	if( idProfiler::IsCapturing() )
+	{
+		idProfiler::EndEvent();
+	}
 }
 
 ID_INLINE void BeginProfileNamedEvent( VERIFY_FORMAT_STRING const char* szName )
@@ -92,30 +101,54 @@ ID_INLINE void BeginProfileNamedEvent( VERIFY_FORMAT_STRING const char* szName )
 class idScopedProfileEvent
 {
 public:
-	idScopedProfileEvent( const char* name )
+	idScopedProfileEvent( const char* name, bool dynamicName = false ) : active( idProfiler::IsCapturing() )
 	{
-		BeginProfileNamedEvent( name );
+		if( active )
+		{
+			if( dynamicName )
+			{
+				idProfiler::BeginDynamicEvent( name );
+			}
+			else
+			{
+				idProfiler::BeginEvent( name );
+			}
+		}
 	}
 	~idScopedProfileEvent()
 	{
-		EndProfileNamedEvent();
+		if( active )
+		{
+			idProfiler::EndEvent();
+		}
 	}
+
+private:
+	bool	active;		// only close the event if it was opened
 };
 
 #if USE_OPTICK
 	#define SCOPED_PROFILE_EVENT( x ) OPTICK_EVENT( x )
+	#define SCOPED_PROFILE_EVENT_DYNAMIC( x ) OPTICK_EVENT_DYNAMIC( x )
 #else
 	#define SCOPED_PROFILE_EVENT( x ) idScopedProfileEvent scopedProfileEvent_##__LINE__( x )
+	// for names that may be freed before the capture is written, like model or material names
+	#define SCOPED_PROFILE_EVENT_DYNAMIC( x ) idScopedProfileEvent scopedProfileEvent_##__LINE__( x, true )
 #endif
 
+// traces are written to profiles/ as Chrome trace JSON, only the file name of szName is used
 ID_INLINE bool BeginTraceRecording( const char* szName )
 {
-	return false;
+	idStr fileName = szName;
+	fileName.BackSlashesToSlashes();
+	fileName.StripPath();
+	fileName.SetFileExtension( ".json" );
+	return idProfiler::StartCapture( 0, "profiles/" + fileName );
 }
 
 ID_INLINE bool EndTraceRecording()
 {
-	return false;
+	return idProfiler::StopCapture();
 }
 
 typedef enum
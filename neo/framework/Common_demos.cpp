@@ -0,0 +1,486 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "Common_local.h"
+#include "../renderer/RenderCommon.h"
+
+/*
+===============================================================================
+
+	Camera paths and timedemos.
+
+	A camera path is a list of views recorded from the primary view while
+	playing. A timedemo replays the path one frame per rendered frame while
+	the game keeps running, and writes the game and renderer front end
+	timings of every frame to a CSV file. Combined with -nullrender this is
+	a reproducible CPU benchmark that doesn't depend on the GPU.
+
+===============================================================================
+*/
+
+static const char* CAMERA_PATH_DIR = "campaths";
+static const char* TIMEDEMO_DIR = "timedemos";
+
+/*
+================
+idCommonLocal::StartRecordingCameraPath
+================
+*/
+void idCommonLocal::StartRecordingCameraPath( const char* name )
+{
+	if( !mapSpawned )
+	{
+		Printf( "recordCameraPath: no map loaded\n" );
+		return;
+	}
+	if( timeDemo != TD_NO )
+	{
+		Printf( "recordCameraPath: can't record while a timedemo is running\n" );
+		return;
+	}
+	if( recordingCameraPath )
+	{
+		StopRecordingCameraPath();
+	}
+
+	cameraPath.Clear();
+	cameraPathName = name;
+	cameraPathMap = currentMapName;
+	recordingCameraPath = true;
+
+	Printf( "recording camera path %s\n", cameraPathName.c_str() );
+}
+
+/*
+================
+idCommonLocal::StopRecordingCameraPath
+================
+*/
+void idCommonLocal::StopRecordingCameraPath()
+{
+	if( !recordingCameraPath )
+	{
+		return;
+	}
+	recordingCameraPath = false;
+
+	if( WriteCameraPath( cameraPathName ) )
+	{
+		Printf( "wrote %i frames to camera path %s\n", cameraPath.Num(), cameraPathName.c_str() );
+	}
+	cameraPath.Clear();
+}
+
+/*
+================
+idCommonLocal::RecordCameraPathFrame
+
+Called at the end of each frame, after the game thread has drawn the primary view.
+================
+*/
+void idCommonLocal::RecordCameraPathFrame()
+{
+	if( !mapSpawned || idStr::Icmp( currentMapName, cameraPathMap ) != 0 )
+	{
+		return;
+	}
+
+	const renderView_t& view = tr.primaryRenderView;
+	if( view.viewID == 0 )
+	{
+		// only player views are recorded, not cinematics
+		return;
+	}
+
+	cameraPathFrame_t& frame = cameraPath.Alloc();
+	frame.origin = view.vieworg;
+	frame.axis = view.viewaxis;
+	frame.fov_x = view.fov_x;
+	frame.fov_y = view.fov_y;
+}
+
+/*
+================
+idCommonLocal::WriteCameraPath
+================
+*/
+bool idCommonLocal::WriteCameraPath( const char* name )
+{
+	idStr fileName;
+	fileName.Format( "%s/%s", CAMERA_PATH_DIR, name );
+	fileName.SetFileExtension( "campath" );
+
+	idFile* file = fileSystem->OpenFileWrite( fileName );
+	if( file == NULL )
+	{
+		Warning( "couldn't write camera path %s", fileName.c_str() );
+		return false;
+	}
+
+	file->Printf( "map \"%s\"\n", cameraPathMap.c_str() );
+	file->Printf( "frames %i\n", cameraPath.Num() );
+	for( int i = 0; i < cameraPath.Num(); i++ )
+	{
+		const cameraPathFrame_t& frame = cameraPath[i];
+		file->Printf( "( %.9g %.9g %.9g ) ", frame.origin.x, frame.origin.y, frame.origin.z );
+		file->Printf( "( %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g %.9g ) ",
+					  frame.axis[0].x, frame.axis[0].y, frame.axis[0].z,
+					  frame.axis[1].x, frame.axis[1].y, frame.axis[1].z,
+					  frame.axis[2].x, frame.axis[2].y, frame.axis[2].z );
+		file->Printf( "%.9g %.9g\n", frame.fov_x, frame.fov_y );
+	}
+
+	delete file;
+	return true;
+}
+
+/*
+================
+idCommonLocal::ReadCameraPath
+================
+*/
+bool idCommonLocal::ReadCameraPath( const char* name )
+{
+	idStr fileName;
+	fileName.Format( "%s/%s", CAMERA_PATH_DIR, name );
+	fileName.SetFileExtension( "campath" );
+
+	cameraPath.Clear();
+
+	idLexer src( LEXFL_NOSTRINGCONCAT | LEXFL_NOFATALERRORS );
+	if( !src.LoadFile( fileName ) )
+	{
+		Warning( "couldn't load camera path %s", fileName.c_str() );
+		return false;
+	}
+
+	idToken token;
+	if( !src.ExpectTokenString( "map" ) || !src.ReadToken( &token ) )
+	{
+		return false;
+	}
+	cameraPathMap = token;
+
+	if( !src.ExpectTokenString( "frames" ) )
+	{
+		return false;
+	}
+	const int numFrames = src.ParseInt();
+	if( numFrames <= 0 )
+	{
+		Warning( "camera path %s has no frames", fileName.c_str() );
+		return false;
+	}
+
+	cameraPath.SetNum( numFrames );
+	for( int i = 0; i < numFrames; i++ )
+	{
+		cameraPathFrame_t& frame = cameraPath[i];
+		if( !src.Parse1DMatrix( 3, frame.origin.ToFloatPtr() ) || !src.Parse1DMatrix( 9, frame.axis.ToFloatPtr() ) )
+		{
+			Warning( "camera path %s is truncated at frame %i", fileName.c_str(), i );
+			cameraPath.Clear();
+			return false;
+		}
+		frame.fov_x = src.ParseFloat();
+		frame.fov_y = src.ParseFloat();
+	}
+
+	cameraPathName = name;
+	return true;
+}
+
+/*
+================
+idCommonLocal::StartTimeDemo
+================
+*/
+void idCommonLocal::StartTimeDemo( const char* pathName, const char* csvName, bool quit )
+{
+	StopRecordingCameraPath();
+	StopTimeDemo();
+
+	if( !ReadCameraPath( pathName ) )
+	{
+		if( quit )
+		{
+			cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
+		}
+		return;
+	}
+
+	if( csvName != NULL && csvName[0] != '\0' )
+	{
+		timeDemoCSVName = csvName;
+	}
+	else
+	{
+		timeDemoCSVName.Format( "%s/%s", TIMEDEMO_DIR, pathName );
+	}
+	timeDemoCSVName.SetFileExtension( "csv" );
+
+	timeDemoFrames.Clear();
+	timeDemoFrames.SetGranularity( 1024 );
+	numDemoFrames = 0;
+	timeDemoStartTime = 0;
+	timeDemo = quit ? TD_YES_THEN_QUIT : TD_YES;
+
+	// load the map the path was recorded in, the timedemo starts when it is spawned
+	if( !mapSpawned || idStr::Icmp( currentMapName, cameraPathMap ) != 0 )
+	{
+		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, va( "map %s\n", cameraPathMap.c_str() ) );
+	}
+
+	Printf( "timedemo %s: %i frames in %s\n", pathName, cameraPath.Num(), cameraPathMap.c_str() );
+}
+
+/*
+================
+idCommonLocal::DrawTimeDemoFrame
+
+Called by Draw on the game thread instead of drawing the player view.
+Returns false if the game should draw normally.
+================
+*/
+bool idCommonLocal::DrawTimeDemoFrame()
+{
+	if( timeDemo == TD_NO || renderWorld == NULL || idStr::Icmp( currentMapName, cameraPathMap ) != 0 )
+	{
+		return false;
+	}
+	if( numDemoFrames >= cameraPath.Num() )
+	{
+		return false;
+	}
+
+	if( numDemoFrames == 0 )
+	{
+		timeDemoStartTime = Sys_Milliseconds();
+	}
+
+	const cameraPathFrame_t& frame = cameraPath[numDemoFrames];
+
+	memset( &currentDemoRenderView, 0, sizeof( currentDemoRenderView ) );
+	currentDemoRenderView.viewID = Game()->GetLocalClientNum() + 1;
+	currentDemoRenderView.vieworg = frame.origin;
+	currentDemoRenderView.vieworg_weapon = frame.origin;
+	currentDemoRenderView.viewaxis = frame.axis;
+	currentDemoRenderView.fov_x = frame.fov_x;
+	currentDemoRenderView.fov_y = frame.fov_y;
+	currentDemoRenderView.time[0] = FRAME_TO_MSEC( gameFrame );
+	currentDemoRenderView.time[1] = currentDemoRenderView.time[0];
+
+	renderWorld->RenderScene( &currentDemoRenderView );
+
+	numDemoFrames++;
+	return true;
+}
+
+/*
+================
+idCommonLocal::UpdateTimeDemo
+
+Called by Frame after the command buffers have been swapped, so the
+counters belong to the demo frame that was drawn during the last frame.
+================
+*/
+void idCommonLocal::UpdateTimeDemo()
+{
+	if( timeDemo == TD_NO )
+	{
+		return;
+	}
+
+	if( timeDemoFrames.Num() < numDemoFrames )
+	{
+		timeDemoFrame_t& frame = timeDemoFrames.Alloc();
+		frame.gameMicroSec = ( int )( mainFrameTiming.finishGameTime - mainFrameTiming.startGameTime );
+		frame.drawMicroSec = ( int )( mainFrameTiming.finishDrawTime - mainFrameTiming.finishGameTime );
+		frame.frontEndMicroSec = ( int )time_frontend;
+		frame.mocMicroSec = ( int )time_moc;
+		frame.backEndMicroSec = ( int )time_backend;
+		frame.numViews = stats_frontend.c_numViews;
+		frame.viewLights = stats_frontend.c_viewLights;
+		frame.visibleViewEntities = stats_frontend.c_visibleViewEntities;
+		frame.shadowViewEntities = stats_frontend.c_shadowViewEntities;
+		frame.createInteractions = stats_frontend.c_createInteractions;
+		frame.deformedSurfaces = stats_frontend.c_deformedSurfaces;
+	}
+
+	if( timeDemoFrames.Num() >= cameraPath.Num() )
+	{
+		StopTimeDemo();
+	}
+}
+
+/*
+================
+TimeDemo_PrintStat
+================
+*/
+static void TimeDemo_PrintStat( const char* name, idList<int>& values )
+{
+	if( values.Num() == 0 )
+	{
+		return;
+	}
+
+	int64_t total = 0;
+	for( int i = 0; i < values.Num(); i++ )
+	{
+		total += values[i];
+	}
+	values.SortWithTemplate();
+
+	const int median = values[values.Num() / 2];
+	const int p99 = values[Min( values.Num() - 1, ( values.Num() * 99 ) / 100 )];
+
+	common->Printf( "%-10s avg %7.3f  min %7.3f  median %7.3f  99%% %7.3f  max %7.3f msec\n", name,
+					total * 0.001f / values.Num(), values[0] * 0.001f, median * 0.001f, p99 * 0.001f, values[values.Num() - 1] * 0.001f );
+}
+
+/*
+================
+idCommonLocal::WriteTimeDemoResults
+================
+*/
+void idCommonLocal::WriteTimeDemoResults()
+{
+	const int numFrames = timeDemoFrames.Num();
+	if( numFrames == 0 )
+	{
+		return;
+	}
+
+	const int msec = Sys_Milliseconds() - timeDemoStartTime;
+	Printf( "timedemo %s: %i frames in %.2f seconds, %.2f fps%s\n", cameraPathName.c_str(), numFrames,
+			msec * 0.001f, numFrames * 1000.0f / Max( msec, 1 ), r_nullRender.GetBool() ? " (null renderer)" : "" );
+
+	idList<int> game, draw, frontEnd, moc;
+	for( int i = 0; i < numFrames; i++ )
+	{
+		game.Append( timeDemoFrames[i].gameMicroSec );
+		draw.Append( timeDemoFrames[i].drawMicroSec );
+		frontEnd.Append( timeDemoFrames[i].frontEndMicroSec );
+		moc.Append( timeDemoFrames[i].mocMicroSec );
+	}
+	TimeDemo_PrintStat( "game", game );
+	TimeDemo_PrintStat( "draw", draw );
+	TimeDemo_PrintStat( "frontend", frontEnd );
+	TimeDemo_PrintStat( "moc", moc );
+
+	idFile* file = fileSystem->OpenFileWrite( timeDemoCSVName );
+	if( file == NULL )
+	{
+		Warning( "couldn't write %s", timeDemoCSVName.c_str() );
+		return;
+	}
+
+	file->Printf( "frame,gameUsec,drawUsec,frontendUsec,mocUsec,backendUsec,views,viewLights,visibleEntities,shadowEntities,createInteractions,deformedSurfaces\n" );
+	for( int i = 0; i < numFrames; i++ )
+	{
+		const timeDemoFrame_t& frame = timeDemoFrames[i];
+		file->Printf( "%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i,%i\n", i,
+					  frame.gameMicroSec, frame.drawMicroSec, frame.frontEndMicroSec, frame.mocMicroSec, frame.backEndMicroSec,
+					  frame.numViews, frame.viewLights, frame.visibleViewEntities, frame.shadowViewEntities,
+					  frame.createInteractions, frame.deformedSurfaces );
+	}
+	delete file;
+
+	Printf( "wrote %s\n", timeDemoCSVName.c_str() );
+}
+
+/*
+================
+idCommonLocal::StopTimeDemo
+================
+*/
+void idCommonLocal::StopTimeDemo()
+{
+	if( timeDemo == TD_NO )
+	{
+		return;
+	}
+
+	WriteTimeDemoResults();
+
+	const bool quit = ( timeDemo == TD_YES_THEN_QUIT );
+
+	timeDemo = TD_NO;
+	timeDemoFrames.Clear();
+	cameraPath.Clear();
+	numDemoFrames = 0;
+
+	if( quit )
+	{
+		cmdSystem->BufferCommandText( CMD_EXEC_APPEND, "quit\n" );
+	}
+}
+
+/*
+================
+Camera path and timedemo commands
+================
+*/
+CONSOLE_COMMAND( recordCameraPath, "records the player view into a camera path for timeDemo", NULL )
+{
+	if( args.Argc() != 2 )
+	{
+		common->Printf( "usage: recordCameraPath <name>\n" );
+		return;
+	}
+	commonLocal.StartRecordingCameraPath( args.Argv( 1 ) );
+}
+
+CONSOLE_COMMAND( stopCameraPath, "stops recording a camera path and writes it", NULL )
+{
+	commonLocal.StopRecordingCameraPath();
+}
+
+CONSOLE_COMMAND( timeDemo, "plays back a camera path and writes per frame timings, usage: timeDemo <path> [csv]", NULL )
+{
+	if( args.Argc() < 2 )
+	{
+		commonLocal.StopTimeDemo();
+		return;
+	}
+	commonLocal.StartTimeDemo( args.Argv( 1 ), args.Argv( 2 ), false );
+}
+
+CONSOLE_COMMAND( timeDemoQuit, "plays back a camera path, writes per frame timings and quits, usage: timeDemoQuit <path> [csv]", NULL )
+{
+	if( args.Argc() < 2 )
+	{
+		common->Printf( "usage: timeDemoQuit <path> [csv]\n" );
+		return;
+	}
+	commonLocal.StartTimeDemo( args.Argv( 1 ), args.Argv( 2 ), true );
+}
@@ -1042,6 +1042,7 @@ bool idCommonLocal::SaveGame( const char* saveName )
 	stringsFile.Clear( false );
 
 	// Setup the save pipeline
+	const int saveStartTimeMs = Sys_Milliseconds();
 	pipelineFile = new( TAG_SAVEGAMES ) idFile_SaveGamePipelined();
 	pipelineFile->OpenForWriting( &saveFile );
 
@@ -1064,6 +1065,8 @@ bool idCommonLocal::SaveGame( const char* saveName )
 
 	pipelineFile->Finish();
 
+	common->Printf( "%6d msec to save, %dkb compressed\n", Sys_Milliseconds() - saveStartTimeMs, saveFile.Length() / 1024 );
+
 	idSaveGameDetails gameDetails;
 	game->GetSaveGameDetails( gameDetails );
 
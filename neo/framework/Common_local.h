@@ -477,6 +477,12 @@ public:	// These are public because they are called directly by static functions
 		return userCmdMgr;
 	}
 
+	// camera paths and timedemos
+	void	StartRecordingCameraPath( const char* name );
+	void	StopRecordingCameraPath();
+	void	StartTimeDemo( const char* pathName, const char* csvName, bool quit );
+	void	StopTimeDemo();
+
 private:
 	bool						com_fullyInitialized;
 	bool						com_refreshOnPrint;		// update the screen every print for dmap
@@ -603,6 +609,36 @@ private:
 	int					demoTimeOffset;
 	renderView_t		currentDemoRenderView;
 
+	struct cameraPathFrame_t
+	{
+		idVec3			origin;
+		idMat3			axis;
+		float			fov_x;
+		float			fov_y;
+	};
+	idList<cameraPathFrame_t>	cameraPath;
+	idStr				cameraPathName;
+	idStr				cameraPathMap;
+	bool				recordingCameraPath;
+
+	// timings of a single timedemo frame, in microseconds
+	struct timeDemoFrame_t
+	{
+		int				gameMicroSec;
+		int				drawMicroSec;
+		int				frontEndMicroSec;
+		int				mocMicroSec;
+		int				backEndMicroSec;
+		int				numViews;
+		int				viewLights;
+		int				visibleViewEntities;
+		int				shadowViewEntities;
+		int				createInteractions;
+		int				deformedSurfaces;
+	};
+	idList<timeDemoFrame_t>	timeDemoFrames;
+	idStr				timeDemoCSVName;
+
 	idStrList			mpGameModes;
 	idStrList			mpDisplayGameModes;
 	idList<mpMap_t>		mpGameMaps;
@@ -699,6 +735,14 @@ private:
 	void	RunNetworkSnapshotFrame();
 	void	ExecuteReliableMessages();
 
+	// Common_demos.cpp
+	void	RecordCameraPathFrame();
+	bool	DrawTimeDemoFrame();
+	void	UpdateTimeDemo();
+	bool	WriteCameraPath( const char* name );
+	bool	ReadCameraPath( const char* name );
+	void	WriteTimeDemoResults();
+
 
 	// Snapshot interpolation
 	void	ProcessSnapshot( idSnapShot& ss );
@@ -138,6 +138,15 @@ protected:
 	// Set textSource possible with compression.
 	void						SetTextLocal( const char* text, const int length );
 
+	// Only remember the checksum and length, the text is read back
+	// from the source file when the decl is parsed.
+	void						SetSourceTextLocal( const char* text, const int length );
+
+	bool						HasText() const
+	{
+		return ( textSource != NULL || textInSourceFile );
+	}
+
 private:
 	idDecl* 					self;
 
@@ -145,6 +154,7 @@ private:
 	char* 						textSource;				// decl text definition
 	int							textLength;				// length of textSource
 	int							compressedLength;		// compressed length
+	bool						textInSourceFile;		// textSource is NULL and the text is read from sourceFile on demand
 	idDeclFile* 				sourceFile;				// source file in which the decl was defined
 	int							sourceTextOffset;		// offset in source file to decl text
 	int							sourceTextLength;		// length of decl text in source file
@@ -234,6 +244,16 @@ public:
 
 public:
 	static void					MakeNameCanonical( const char* name, char* result, int maxLength );
+
+	// headless servers only index the decl text and never parse the decls that are only rendered or played
+	bool						IsHeadless() const
+	{
+		return decl_headless.GetBool();
+	}
+	static bool					IsPresentationType( declType_t type );
+	bool						ReadSourceText( const idDeclLocal* decl, char* text );
+	void						FreeSourceTextCache();
+
 	idDeclLocal* 				FindTypeWithoutParsing( declType_t type, const char* name, bool makeDefault = true );
 
 	idDeclType* 				GetDeclType( int type ) const
@@ -263,12 +283,20 @@ private:
 	int							indent;			// for MediaPrint
 	bool						insideLevelLoad;
 
+	// the last decl file ReadSourceText loaded, decls are usually parsed in bursts from the same files
+	idSysMutex					sourceTextMutex;
+	const idDeclFile* 			sourceTextFile;
+	char* 						sourceTextBuffer;
+	int							sourceTextBufferLength;
+
 	static idCVar				decl_show;
+	static idCVar				decl_headless;
 
 private:
 	static void					ListDecls_f( const idCmdArgs& args );
 	static void					ReloadDecls_f( const idCmdArgs& args );
 	static void					TouchDecl_f( const idCmdArgs& args );
+	static void					ListDeclMemory_f( const idCmdArgs& args );
 	// RB begin
 	static void                 ExportEntityDefsToTrenchBroom_f( const idCmdArgs& args );
 	static void                 ExportModelsToTrenchBroom_f( const idCmdArgs& args );
@@ -279,6 +307,7 @@ private:
 };
 
 idCVar idDeclManagerLocal::decl_show( "decl_show", "0", CVAR_SYSTEM, "set to 1 to print parses, 2 to also print references", 0, 2, idCmdSystem::ArgCompletion_Integer<0, 2> );
+idCVar idDeclManagerLocal::decl_headless( "decl_headless", "0", CVAR_SYSTEM | CVAR_BOOL | CVAR_INIT, "for dedicated servers: keep decl text in the decl files until a decl is parsed, and default sound, particle, video and audio decls without parsing them" );
 
 idDeclManagerLocal	declManagerLocal;
 idDeclManager* 		declManager = &declManagerLocal;
@@ -709,6 +738,9 @@ int idDeclFile::LoadAndParse()
 		return 0;
 	}
 
+	// decls that are parsed again below must not read the old text
+	declManagerLocal.FreeSourceTextCache();
+
 	// mark all the defs that were from the last reload of this file
 	for( idDeclLocal* decl = decls; decl; decl = decl->nextInFile )
 	{
@@ -848,7 +880,14 @@ int idDeclFile::LoadAndParse()
 			newDecl->textSource = NULL;
 		}
 
-		newDecl->SetTextLocal( buffer + startMarker, size );
+		if( declManagerLocal.IsHeadless() )
+		{
+			newDecl->SetSourceTextLocal( buffer + startMarker, size );
+		}
+		else
+		{
+			newDecl->SetTextLocal( buffer + startMarker, size );
+		}
 		newDecl->sourceFile = this;
 		newDecl->sourceTextOffset = startMarker;
 		newDecl->sourceTextLength = size;
@@ -872,6 +911,7 @@ int idDeclFile::LoadAndParse()
 		if( decl->redefinedInReload == false )
 		{
 			decl->MakeDefault();
+			decl->textInSourceFile = false;
 			decl->sourceTextOffset = decl->sourceFile->fileSize;
 			decl->sourceTextLength = 0;
 			decl->sourceLine = decl->sourceFile->numLines;
@@ -902,6 +942,10 @@ void idDeclManagerLocal::Init()
 
 	checksum = 0;
 
+	sourceTextFile = NULL;
+	sourceTextBuffer = NULL;
+	sourceTextBufferLength = 0;
+
 #ifdef USE_COMPRESSED_DECLS
 	SetupHuffman();
 #endif
@@ -933,6 +977,7 @@ void idDeclManagerLocal::Init()
 #if !defined( DMAP )
 	// add console commands
 	cmdSystem->AddCommand( "listDecls", ListDecls_f, CMD_FL_SYSTEM, "lists all decls" );
+	cmdSystem->AddCommand( "listDeclMemory", ListDeclMemory_f, CMD_FL_SYSTEM, "lists decl text and data memory per decl type" );
 
 	cmdSystem->AddCommand( "reloadDecls", ReloadDecls_f, CMD_FL_SYSTEM, "reloads decls" );
 	cmdSystem->AddCommand( "touch", TouchDecl_f, CMD_FL_SYSTEM, "touches a decl" );
@@ -1005,6 +1050,10 @@ void idDeclManagerLocal::InitTool()
 
 	checksum = 0;
 
+	sourceTextFile = NULL;
+	sourceTextBuffer = NULL;
+	sourceTextBufferLength = 0;
+
 #ifdef USE_COMPRESSED_DECLS
 	SetupHuffman();
 #endif
@@ -1062,6 +1111,7 @@ void idDeclManagerLocal::Shutdown()
 	}
 
 	// free decl files
+	FreeSourceTextCache();
 	loadedFiles.DeleteContents( true );
 
 	// free the decl types and folders
@@ -1117,7 +1167,10 @@ void idDeclManagerLocal::EndLevelLoad()
 {
 	insideLevelLoad = false;
 
-	// we don't need to do anything here, but the image manager, model manager,
+	// the level load parsed its decls
+	FreeSourceTextCache();
+
+	// we don't need to do anything else here, but the image manager, model manager,
 	// and sound sample manager will need to free media that was not referenced
 }
 
@@ -1563,7 +1616,7 @@ void idDeclManagerLocal::PrintType( const idCmdArgs& args, declType_t type )
 	common->Printf( "%s %s:\n", declTypes[ type ]->typeName.c_str(), decl->name.c_str() );
 	common->Printf( "source: %s:%i\n", decl->sourceFile->fileName.c_str(), decl->sourceLine );
 	common->Printf( "----------\n" );
-	if( decl->textSource != NULL )
+	if( decl->HasText() )
 	{
 		char* declText = ( char* )_alloca( decl->textLength + 1 );
 		decl->GetText( declText );
@@ -1868,6 +1921,82 @@ void idDeclManagerLocal::Touch( const idDecl* decl )
 	}
 }
 
+/*
+===================
+idDeclManagerLocal::IsPresentationType
+
+Decls that only feed the renderer and the sound system.
+Materials are not among them because collision uses their contents.
+===================
+*/
+bool idDeclManagerLocal::IsPresentationType( declType_t type )
+{
+	return ( type == DECL_SOUND || type == DECL_PARTICLE || type == DECL_VIDEO || type == DECL_AUDIO );
+}
+
+/*
+===================
+idDeclManagerLocal::ReadSourceText
+
+Reads the text of a decl that was only indexed back from its source file.
+Returns false if the file changed since it was indexed.
+===================
+*/
+bool idDeclManagerLocal::ReadSourceText( const idDeclLocal* decl, char* text )
+{
+	idScopedCriticalSection cs( sourceTextMutex );
+
+	if( sourceTextFile != decl->sourceFile )
+	{
+		if( sourceTextBuffer != NULL )
+		{
+			fileSystem->FreeFile( sourceTextBuffer );
+			sourceTextBuffer = NULL;
+		}
+		sourceTextFile = NULL;
+
+		sourceTextBufferLength = fileSystem->ReadFile( decl->sourceFile->fileName, ( void** )&sourceTextBuffer, NULL );
+		if( sourceTextBufferLength < 0 || sourceTextBuffer == NULL )
+		{
+			common->Warning( "couldn't read %s for %s '%s'", decl->sourceFile->fileName.c_str(), GetDeclNameFromType( decl->type ), decl->GetName() );
+			sourceTextBuffer = NULL;
+			sourceTextBufferLength = 0;
+			return false;
+		}
+		sourceTextFile = decl->sourceFile;
+	}
+
+	if( decl->sourceTextOffset < 0 || decl->sourceTextOffset + decl->textLength > sourceTextBufferLength ||
+			( int )MD5_BlockChecksum( sourceTextBuffer + decl->sourceTextOffset, decl->textLength ) != decl->checksum )
+	{
+		common->Warning( "%s '%s' changed in %s since it was loaded", GetDeclNameFromType( decl->type ), decl->GetName(), decl->sourceFile->fileName.c_str() );
+		return false;
+	}
+
+	memcpy( text, sourceTextBuffer + decl->sourceTextOffset, decl->textLength );
+	text[decl->textLength] = '\0';
+
+	return true;
+}
+
+/*
+===================
+idDeclManagerLocal::FreeSourceTextCache
+===================
+*/
+void idDeclManagerLocal::FreeSourceTextCache()
+{
+	idScopedCriticalSection cs( sourceTextMutex );
+
+	if( sourceTextBuffer != NULL )
+	{
+		fileSystem->FreeFile( sourceTextBuffer );
+		sourceTextBuffer = NULL;
+	}
+	sourceTextFile = NULL;
+	sourceTextBufferLength = 0;
+}
+
 /*
 ===================
 idDeclManagerLocal::MakeNameCanonical
@@ -1953,6 +2082,78 @@ void idDeclManagerLocal::ListDecls_f( const idCmdArgs& args )
 	common->Printf( "%iKB in text, %iKB in structures\n", totalText >> 10, totalStructs >> 10 );
 }
 
+/*
+================
+idDeclManagerLocal::ListDeclMemory_f
+
+Shows how much decl text is held in memory and how much was left in the
+decl files, next to the size of the parsed decl data.
+================
+*/
+void idDeclManagerLocal::ListDeclMemory_f( const idCmdArgs& args )
+{
+	const bool headless = declManagerLocal.IsHeadless();
+
+	size_t totalText = 0;
+	size_t totalFileText = 0;
+	size_t totalData = 0;
+	int totalDecls = 0;
+	int totalParsed = 0;
+
+	common->Printf( " decls parsed   textKB   fileKB   dataKB type\n" );
+
+	for( int i = 0; i < declManagerLocal.declTypes.Num(); i++ )
+	{
+		if( declManagerLocal.declTypes[i] == NULL )
+		{
+			continue;
+		}
+
+		const int num = declManagerLocal.linearLists[i].Num();
+		int numParsed = 0;
+		size_t text = 0;
+		size_t fileText = 0;
+		size_t data = 0;
+
+		for( int j = 0; j < num; j++ )
+		{
+			const idDeclLocal* decl = declManagerLocal.linearLists[i][j];
+
+			if( decl->declState != DS_UNPARSED )
+			{
+				numParsed++;
+			}
+
+			if( decl->textSource != NULL )
+			{
+				text += decl->compressedLength;
+			}
+			else if( decl->textInSourceFile )
+			{
+				fileText += decl->textLength;
+			}
+
+			data += decl->Size();
+			if( decl->self != NULL )
+			{
+				data += decl->self->Size();
+			}
+		}
+
+		totalDecls += num;
+		totalParsed += numParsed;
+		totalText += text;
+		totalFileText += fileText;
+		totalData += data;
+
+		common->Printf( "%6i %6i %8i %8i %8i %s%s\n", num, numParsed, ( int )( text >> 10 ), ( int )( fileText >> 10 ), ( int )( data >> 10 ),
+						declManagerLocal.declTypes[i]->typeName.c_str(), ( headless && IsPresentationType( ( declType_t )i ) ) ? " (defaulted)" : "" );
+	}
+
+	common->Printf( "%i decls, %i parsed\n", totalDecls, totalParsed );
+	common->Printf( "%iKB text in memory, %iKB text left in the decl files, %iKB in structures\n", ( int )( totalText >> 10 ), ( int )( totalFileText >> 10 ), ( int )( totalData >> 10 ) );
+}
+
 /*
 ===================
 idDeclManagerLocal::ReloadDecls_f
@@ -4083,6 +4284,7 @@ idDeclLocal* idDeclManagerLocal::FindTypeWithoutParsing( declType_t type, const
 	decl->declState = DS_UNPARSED;
 	decl->textSource = NULL;
 	decl->textLength = 0;
+	decl->textInSourceFile = false;
 	decl->sourceFile = &implicitDecls;
 	decl->referencedThisLevel = false;
 	decl->everReferenced = false;
@@ -4300,6 +4502,7 @@ idDeclLocal::idDeclLocal()
 	textSource = NULL;
 	textLength = 0;
 	compressedLength = 0;
+	textInSourceFile = false;
 	sourceFile = NULL;
 	sourceTextOffset = 0;
 	sourceTextLength = 0;
@@ -4435,6 +4638,15 @@ idDeclLocal::GetText
 */
 void idDeclLocal::GetText( char* text ) const
 {
+	if( textSource == NULL && textInSourceFile )
+	{
+		if( !declManagerLocal.ReadSourceText( this, text ) )
+		{
+			text[0] = '\0';
+		}
+		return;
+	}
+
 #ifdef USE_COMPRESSED_DECLS
 	HuffmanDecompressText( text, textLength, ( byte* )textSource, compressedLength );
 #else
@@ -4494,6 +4706,24 @@ void idDeclLocal::SetTextLocal( const char* text, const int length )
 	textSource[length] = '\0';
 #endif
 	textLength = length;
+	textInSourceFile = false;
+}
+
+/*
+=================
+idDeclLocal::SetSourceTextLocal
+=================
+*/
+void idDeclLocal::SetSourceTextLocal( const char* text, const int length )
+{
+	Mem_Free( textSource );
+	textSource = NULL;
+
+	checksum = MD5_BlockChecksum( text, length );
+
+	compressedLength = 0;
+	textLength = length;
+	textInSourceFile = true;
 }
 
 /*
@@ -4748,8 +4978,17 @@ void idDeclLocal::ParseLocal()
 
 	declManagerLocal.MediaPrint( "parsing %s %s\n", declManagerLocal.declTypes[type]->typeName.c_str(), name.c_str() );
 
+	// a headless server never renders or plays these, the default keeps the pointers valid
+	if( declManagerLocal.IsHeadless() && idDeclManagerLocal::IsPresentationType( type ) )
+	{
+		declManagerLocal.indent++;
+		MakeDefault();
+		declManagerLocal.indent--;
+		return;
+	}
+
 	// if no text source try to generate default text
-	if( textSource == NULL )
+	if( !HasText() )
 	{
 		generatedDefaultText = self->SetDefaultText();
 	}
@@ -4758,18 +4997,32 @@ void idDeclLocal::ParseLocal()
 	declManagerLocal.indent++;
 
 	// no text immediately causes a MakeDefault()
-	if( textSource == NULL )
+	if( !HasText() )
 	{
 		MakeDefault();
 		declManagerLocal.indent--;
 		return;
 	}
 
+	// text that was only indexed is read back from the source file
+	char* declText = ( char* ) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
+	if( textSource == NULL )
+	{
+		if( !declManagerLocal.ReadSourceText( this, declText ) )
+		{
+			MakeDefault();
+			declManagerLocal.indent--;
+			return;
+		}
+	}
+	else
+	{
+		GetText( declText );
+	}
+
 	declState = DS_PARSED;
 
 	// parse
-	char* declText = ( char* ) _alloca( ( GetTextLength() + 1 ) * sizeof( char ) );
-	GetText( declText );
 	self->Parse( declText, GetTextLength(), true );
 
 	// free generated text
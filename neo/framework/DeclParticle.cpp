@@ -1056,6 +1056,34 @@ float idParticleParm::Eval( float frac, idRandom& rand ) const
 	return from + frac * ( to - from );
 }
 
+void idParticleParm::EvalBatch( const float* frac, float* result, int num ) const
+{
+	assert( ( num & 3 ) == 0 );
+
+	if( table )
+	{
+		for( int i = 0; i < num; i++ )
+		{
+			result[i] = table->TableLookup( frac[i] );
+		}
+		return;
+	}
+
+#if defined(USE_INTRINSICS_SSE)
+	const __m128 vfrom = _mm_set1_ps( from );
+	const __m128 vrange = _mm_set1_ps( to - from );
+	for( int i = 0; i < num; i += 4 )
+	{
+		_mm_store_ps( result + i, _mm_add_ps( vfrom, _mm_mul_ps( _mm_load_ps( frac + i ), vrange ) ) );
+	}
+#else
+	for( int i = 0; i < num; i++ )
+	{
+		result[i] = from + frac[i] * ( to - from );
+	}
+#endif
+}
+
 float idParticleParm::Integrate( float frac, idRandom& rand ) const
 {
 	if( table )
@@ -1448,9 +1476,18 @@ idParticleStage::ParticleVerts
 */
 int	idParticleStage::ParticleVerts( particleGen_t* g, idVec3 origin, idDrawVert* verts ) const
 {
-	float	psize = size.Eval( g->frac, g->random );
-	float	paspect = aspect.Eval( g->frac, g->random );
+	return ParticleVerts( g, origin, size.Eval( g->frac, g->random ), aspect.Eval( g->frac, g->random ), verts );
+}
+
+/*
+==================
+idParticleStage::ParticleVerts
 
+Same as above with the size and aspect parms already evaluated
+==================
+*/
+int	idParticleStage::ParticleVerts( particleGen_t* g, idVec3 origin, float psize, float paspect, idDrawVert* verts ) const
+{
 	float	width = psize;
 	float	height = psize * paspect;
 
@@ -1741,6 +1778,18 @@ int idParticleStage::CreateParticle( particleGen_t* g, idDrawVert* verts ) const
 
 	int	numVerts = ParticleVerts( g, origin, verts );
 
+	return ParticleCrossFade( g, verts, numVerts );
+}
+
+/*
+================
+idParticleStage::ParticleCrossFade
+
+Doubles the quads of a strip animated particle, returns the final number of verts
+================
+*/
+int idParticleStage::ParticleCrossFade( particleGen_t* g, idDrawVert* verts, int numVerts ) const
+{
 	if( animationFrames <= 1 )
 	{
 		return numVerts;
@@ -1773,6 +1822,670 @@ int idParticleStage::CreateParticle( particleGen_t* g, idDrawVert* verts ) const
 	return numVerts * 2;
 }
 
+#if defined(USE_INTRINSICS_SSE)
+
+/*
+================
+Particle_RandomFloat4
+
+Four idRandom::RandomFloat streams at once, stepping the seeds the same way.
+================
+*/
+static ID_INLINE __m128 Particle_RandomFloat4( __m128i& seed )
+{
+	// there is no 32 bit multiply in SSE2, multiply the even and odd lanes separately
+	const __m128i multiplier = _mm_set1_epi32( 69069 );
+	const __m128i even = _mm_mul_epu32( seed, multiplier );
+	const __m128i odd = _mm_mul_epu32( _mm_srli_epi64( seed, 32 ), multiplier );
+	seed = _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+	seed = _mm_add_epi32( seed, _mm_set1_epi32( 1 ) );
+
+	const __m128i value = _mm_and_si128( seed, _mm_set1_epi32( idRandom::MAX_RAND ) );
+	return _mm_div_ps( _mm_cvtepi32_ps( value ), _mm_set1_ps( ( float )( idRandom::MAX_RAND + 1 ) ) );
+}
+
+/*
+================
+Particle_CRandomFloat4
+================
+*/
+static ID_INLINE __m128 Particle_CRandomFloat4( __m128i& seed )
+{
+	return _mm_mul_ps( _mm_set1_ps( 2.0f ), _mm_sub_ps( Particle_RandomFloat4( seed ), _mm_set1_ps( 0.5f ) ) );
+}
+
+/*
+================
+Particle_Select4
+================
+*/
+static ID_INLINE __m128 Particle_Select4( const __m128 mask, const __m128 a, const __m128 b )
+{
+	return _mm_or_ps( _mm_and_ps( mask, a ), _mm_andnot_ps( mask, b ) );
+}
+
+/*
+================
+Particle_SinCos16_4
+
+idMath::SinCos16 for four angles, with the same range reduction and polynomials.
+================
+*/
+static ID_INLINE void Particle_SinCos16_4( __m128 a, __m128& s, __m128& c )
+{
+	const __m128 vector_float_one = _mm_set1_ps( 1.0f );
+	const __m128 vector_float_pi = _mm_set1_ps( idMath::PI );
+	const __m128 vector_float_half_pi = _mm_set1_ps( idMath::HALF_PI );
+	const __m128 vector_float_two_pi = _mm_set1_ps( idMath::TWO_PI );
+
+	// a -= floorf( a * ONEOVER_TWOPI ) * TWO_PI outside [0, TWO_PI)
+	const __m128 scaled = _mm_mul_ps( a, _mm_set1_ps( idMath::ONEOVER_TWOPI ) );
+	__m128 floored = _mm_cvtepi32_ps( _mm_cvttps_epi32( scaled ) );
+	floored = _mm_sub_ps( floored, _mm_and_ps( _mm_cmpgt_ps( floored, scaled ), vector_float_one ) );
+	const __m128 outside = _mm_or_ps( _mm_cmplt_ps( a, _mm_setzero_ps() ), _mm_cmpge_ps( a, vector_float_two_pi ) );
+	a = Particle_Select4( outside, _mm_sub_ps( a, _mm_mul_ps( floored, vector_float_two_pi ) ), a );
+
+	const __m128 lowHalf = _mm_cmplt_ps( a, vector_float_pi );
+	const __m128 secondQuadrant = _mm_and_ps( lowHalf, _mm_cmpgt_ps( a, vector_float_half_pi ) );
+	const __m128 fourthQuadrant = _mm_andnot_ps( lowHalf, _mm_cmpgt_ps( a, _mm_set1_ps( idMath::PI + idMath::HALF_PI ) ) );
+	const __m128 thirdQuadrant = _mm_andnot_ps( _mm_or_ps( lowHalf, fourthQuadrant ), _mm_cmpeq_ps( a, a ) );
+	const __m128 mirrored = _mm_or_ps( secondQuadrant, thirdQuadrant );
+
+	a = Particle_Select4( mirrored, _mm_sub_ps( vector_float_pi, a ), Particle_Select4( fourthQuadrant, _mm_sub_ps( a, vector_float_two_pi ), a ) );
+	const __m128 d = Particle_Select4( mirrored, _mm_set1_ps( -1.0f ), vector_float_one );
+
+	const __m128 t = _mm_mul_ps( a, a );
+
+	__m128 ps = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( -2.39e-08f ), t ), _mm_set1_ps( 2.7526e-06f ) );
+	ps = _mm_sub_ps( _mm_mul_ps( ps, t ), _mm_set1_ps( 1.98409e-04f ) );
+	ps = _mm_add_ps( _mm_mul_ps( ps, t ), _mm_set1_ps( 8.3333315e-03f ) );
+	ps = _mm_sub_ps( _mm_mul_ps( ps, t ), _mm_set1_ps( 1.666666664e-01f ) );
+	ps = _mm_add_ps( _mm_mul_ps( ps, t ), vector_float_one );
+	s = _mm_mul_ps( a, ps );
+
+	__m128 pc = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( -2.605e-07f ), t ), _mm_set1_ps( 2.47609e-05f ) );
+	pc = _mm_sub_ps( _mm_mul_ps( pc, t ), _mm_set1_ps( 1.3888397e-03f ) );
+	pc = _mm_add_ps( _mm_mul_ps( pc, t ), _mm_set1_ps( 4.16666418e-02f ) );
+	pc = _mm_sub_ps( _mm_mul_ps( pc, t ), _mm_set1_ps( 4.999999963e-01f ) );
+	pc = _mm_add_ps( _mm_mul_ps( pc, t ), vector_float_one );
+	c = _mm_mul_ps( d, pc );
+}
+
+/*
+================
+idParticleStage::CanBatchQuads
+
+Custom paths and aimed trails keep using the per particle path, as do
+integrated parms with tables, which only print a warning there.
+================
+*/
+bool idParticleStage::CanBatchQuads() const
+{
+	return ( customPathType == PPATH_STANDARD && orientation != POR_AIMED && speed.table == NULL && rotationSpeed.table == NULL );
+}
+
+/*
+================
+idParticleStage::ParticleQuads4
+
+Every particle has its own random generator seeded from the spawn stepping, so
+four generators can be stepped side by side in the SIMD lanes. The operations
+are done in the same order as in ParticleOrigin and ParticleVerts, so the corners
+match the per particle path. The rare ring reprojection and outward directions
+are done per lane with the scalar code.
+================
+*/
+void idParticleStage::ParticleQuads4( const particleGen_t* g, const float* frac, const int* index, const int* seed,
+									  const float* psize, const float* paspect, idVec3 xyz[4][4] ) const
+{
+	const __m128 vector_float_one = _mm_set1_ps( 1.0f );
+
+	__m128i random = _mm_loadu_si128( ( const __m128i* )seed );
+	const __m128 vfrac = _mm_loadu_ps( frac );
+	const __m128 age = _mm_mul_ps( vfrac, _mm_set1_ps( particleLife ) );
+
+	//
+	// find intial origin distribution
+	//
+	__m128 ox = _mm_setzero_ps();
+	__m128 oy = _mm_setzero_ps();
+	__m128 oz = _mm_setzero_ps();
+	__m128 radiusSqr = _mm_setzero_ps();
+	int numRescale = 0;
+
+	switch( distributionType )
+	{
+		case PDIST_RECT:
+		{
+			ox = _mm_mul_ps( ( randomDistribution ) ? Particle_CRandomFloat4( random ) : vector_float_one, _mm_set1_ps( distributionParms[0] ) );
+			oy = _mm_mul_ps( ( randomDistribution ) ? Particle_CRandomFloat4( random ) : vector_float_one, _mm_set1_ps( distributionParms[1] ) );
+			oz = _mm_mul_ps( ( randomDistribution ) ? Particle_CRandomFloat4( random ) : vector_float_one, _mm_set1_ps( distributionParms[2] ) );
+			break;
+		}
+		case PDIST_CYLINDER:
+		{
+			const __m128 angle1 = _mm_mul_ps( ( randomDistribution ) ? Particle_CRandomFloat4( random ) : vector_float_one, _mm_set1_ps( idMath::TWO_PI ) );
+			Particle_SinCos16_4( angle1, ox, oy );
+			oz = ( randomDistribution ) ? Particle_CRandomFloat4( random ) : vector_float_one;
+
+			if( distributionParms[3] > 0.0f )
+			{
+				radiusSqr = _mm_add_ps( _mm_mul_ps( ox, ox ), _mm_mul_ps( oy, oy ) );
+				numRescale = 2;
+			}
+			break;
+		}
+		case PDIST_SPHERE:
+		{
+			// iterating with rejection, the lanes that are done stop stepping their generator
+			if( randomDistribution )
+			{
+				__m128 active = _mm_cmpeq_ps( vector_float_one, vector_float_one );
+				do
+				{
+					const __m128i oldRandom = random;
+					const __m128 x = Particle_CRandomFloat4( random );
+					const __m128 y = Particle_CRandomFloat4( random );
+					const __m128 z = Particle_CRandomFloat4( random );
+					const __m128 r = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+
+					const __m128i activeInt = _mm_castps_si128( active );
+					random = _mm_or_si128( _mm_and_si128( activeInt, random ), _mm_andnot_si128( activeInt, oldRandom ) );
+					ox = Particle_Select4( active, x, ox );
+					oy = Particle_Select4( active, y, oy );
+					oz = Particle_Select4( active, z, oz );
+					radiusSqr = Particle_Select4( active, r, radiusSqr );
+
+					active = _mm_and_ps( active, _mm_cmpgt_ps( r, vector_float_one ) );
+				}
+				while( _mm_movemask_ps( active ) != 0 );
+			}
+			else
+			{
+				ox = oy = oz = vector_float_one;
+				radiusSqr = _mm_set1_ps( 3.0f );
+			}
+
+			if( distributionParms[3] > 0.0f )
+			{
+				numRescale = 3;
+			}
+			break;
+		}
+	}
+
+	ALIGN16( float lane[4][4] );
+
+	if( numRescale > 0 )
+	{
+		// reproject points that are inside the ringFraction to the outer band
+		_mm_store_ps( lane[0], ox );
+		_mm_store_ps( lane[1], oy );
+		_mm_store_ps( lane[2], oz );
+		_mm_store_ps( lane[3], radiusSqr );
+		for( int i = 0; i < 4; i++ )
+		{
+			if( lane[3][i] < distributionParms[3] * distributionParms[3] )
+			{
+				float f = sqrt( lane[3][i] ) / distributionParms[3];
+				float invf = 1.0f / f;
+				float newRadius = distributionParms[3] + f * ( 1.0f - distributionParms[3] );
+				float rescale = invf * newRadius;
+
+				for( int j = 0; j < numRescale; j++ )
+				{
+					lane[j][i] *= rescale;
+				}
+			}
+		}
+		ox = _mm_load_ps( lane[0] );
+		oy = _mm_load_ps( lane[1] );
+		oz = _mm_load_ps( lane[2] );
+	}
+
+	if( distributionType != PDIST_RECT )
+	{
+		ox = _mm_mul_ps( ox, _mm_set1_ps( distributionParms[0] ) );
+		oy = _mm_mul_ps( oy, _mm_set1_ps( distributionParms[1] ) );
+		oz = _mm_mul_ps( oz, _mm_set1_ps( distributionParms[2] ) );
+	}
+
+	// offset will effect all particle origin types
+	ox = _mm_add_ps( ox, _mm_set1_ps( offset.x ) );
+	oy = _mm_add_ps( oy, _mm_set1_ps( offset.y ) );
+	oz = _mm_add_ps( oz, _mm_set1_ps( offset.z ) );
+
+	//
+	// add the velocity over time
+	//
+	__m128 dx = _mm_setzero_ps();
+	__m128 dy = _mm_setzero_ps();
+	__m128 dz = _mm_setzero_ps();
+
+	switch( directionType )
+	{
+		case PDIR_CONE:
+		{
+			const __m128 angle1 = _mm_mul_ps( _mm_mul_ps( Particle_CRandomFloat4( random ), _mm_set1_ps( directionParms[0] ) ), _mm_set1_ps( idMath::M_DEG2RAD ) );
+			const __m128 angle2 = _mm_mul_ps( Particle_CRandomFloat4( random ), _mm_set1_ps( idMath::PI ) );
+
+			__m128 s1, c1, s2, c2;
+			Particle_SinCos16_4( angle1, s1, c1 );
+			Particle_SinCos16_4( angle2, s2, c2 );
+
+			dx = _mm_mul_ps( s1, c2 );
+			dy = _mm_mul_ps( s1, s2 );
+			dz = c1;
+			break;
+		}
+		case PDIR_OUTWARD:
+		{
+			_mm_store_ps( lane[0], ox );
+			_mm_store_ps( lane[1], oy );
+			_mm_store_ps( lane[2], oz );
+			for( int i = 0; i < 4; i++ )
+			{
+				idVec3 dir( lane[0][i], lane[1][i], lane[2][i] );
+				dir.Normalize();
+				dir[2] += directionParms[0];
+
+				lane[0][i] = dir[0];
+				lane[1][i] = dir[1];
+				lane[2][i] = dir[2];
+			}
+			dx = _mm_load_ps( lane[0] );
+			dy = _mm_load_ps( lane[1] );
+			dz = _mm_load_ps( lane[2] );
+			break;
+		}
+	}
+
+	// add speed, same as idParticleParm::Integrate
+	const __m128 speedFrom = _mm_set1_ps( speed.from );
+	const __m128 iSpeed = _mm_mul_ps( _mm_add_ps( speedFrom, _mm_mul_ps( _mm_mul_ps( vfrac, _mm_set1_ps( speed.to - speed.from ) ), _mm_set1_ps( 0.5f ) ) ), vfrac );
+	const __m128 life = _mm_set1_ps( particleLife );
+	ox = _mm_add_ps( ox, _mm_mul_ps( _mm_mul_ps( dx, iSpeed ), life ) );
+	oy = _mm_add_ps( oy, _mm_mul_ps( _mm_mul_ps( dy, iSpeed ), life ) );
+	oz = _mm_add_ps( oz, _mm_mul_ps( _mm_mul_ps( dz, iSpeed ), life ) );
+
+	// adjust for the per-particle smoke offset
+	const idMat3& axis = g->axis;
+	const __m128 x = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( axis[0].x ), ox ), _mm_mul_ps( _mm_set1_ps( axis[1].x ), oy ) ), _mm_mul_ps( _mm_set1_ps( axis[2].x ), oz ) );
+	const __m128 y = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( axis[0].y ), ox ), _mm_mul_ps( _mm_set1_ps( axis[1].y ), oy ) ), _mm_mul_ps( _mm_set1_ps( axis[2].y ), oz ) );
+	const __m128 z = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_set1_ps( axis[0].z ), ox ), _mm_mul_ps( _mm_set1_ps( axis[1].z ), oy ) ), _mm_mul_ps( _mm_set1_ps( axis[2].z ), oz ) );
+	ox = _mm_add_ps( x, _mm_set1_ps( g->origin.x ) );
+	oy = _mm_add_ps( y, _mm_set1_ps( g->origin.y ) );
+	oz = _mm_add_ps( z, _mm_set1_ps( g->origin.z ) );
+
+	// add gravity after adjusting for axis
+	if( worldGravity )
+	{
+		idVec3 gra( 0, 0, -gravity );
+		gra *= g->renderEnt->axis.Transpose();
+		ox = _mm_add_ps( ox, _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( gra.x ), age ), age ) );
+		oy = _mm_add_ps( oy, _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( gra.y ), age ), age ) );
+		oz = _mm_add_ps( oz, _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( gra.z ), age ), age ) );
+	}
+	else
+	{
+		oz = _mm_sub_ps( oz, _mm_mul_ps( _mm_mul_ps( _mm_set1_ps( gravity ), age ), age ) );
+	}
+
+	//
+	// constant rotation
+	//
+	__m128 angle = ( initialAngle ) ? _mm_set1_ps( initialAngle ) : _mm_mul_ps( _mm_set1_ps( 360.0f ), Particle_RandomFloat4( random ) );
+
+	const __m128 angleMove = _mm_mul_ps( _mm_mul_ps( _mm_add_ps( _mm_set1_ps( rotationSpeed.from ),
+										 _mm_mul_ps( _mm_mul_ps( vfrac, _mm_set1_ps( rotationSpeed.to - rotationSpeed.from ) ), _mm_set1_ps( 0.5f ) ) ), vfrac ), life );
+
+	// have half the particles rotate each way
+	const __m128i odd = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )index ), _mm_set1_epi32( 1 ) );
+	const __m128 oddMask = _mm_castsi128_ps( _mm_cmpeq_epi32( odd, _mm_set1_epi32( 1 ) ) );
+	angle = Particle_Select4( oddMask, _mm_add_ps( angle, angleMove ), _mm_sub_ps( angle, angleMove ) );
+
+	angle = _mm_mul_ps( _mm_div_ps( angle, _mm_set1_ps( 180.0f ) ), _mm_set1_ps( idMath::PI ) );
+	__m128 s, c;
+	Particle_SinCos16_4( angle, s, c );
+
+	__m128 lx, ly, lz, ux, uy, uz;
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 negS = _mm_xor_ps( s, _mm_set1_ps( -0.0f ) );
+
+	if( orientation == POR_Z )
+	{
+		// oriented in entity space
+		lx = s;
+		ly = c;
+		lz = zero;
+		ux = c;
+		uy = negS;
+		uz = zero;
+	}
+	else if( orientation == POR_X )
+	{
+		lx = zero;
+		ly = c;
+		lz = s;
+		ux = zero;
+		uy = negS;
+		uz = c;
+	}
+	else if( orientation == POR_Y )
+	{
+		lx = c;
+		ly = zero;
+		lz = s;
+		ux = negS;
+		uy = zero;
+		uz = c;
+	}
+	else
+	{
+		// oriented in viewer space
+		idVec3	entityLeft, entityUp;
+
+		g->renderEnt->axis.ProjectVector( g->renderView->viewaxis[1], entityLeft );
+		g->renderEnt->axis.ProjectVector( g->renderView->viewaxis[2], entityUp );
+
+		lx = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( entityLeft.x ), c ), _mm_mul_ps( _mm_set1_ps( entityUp.x ), s ) );
+		ly = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( entityLeft.y ), c ), _mm_mul_ps( _mm_set1_ps( entityUp.y ), s ) );
+		lz = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( entityLeft.z ), c ), _mm_mul_ps( _mm_set1_ps( entityUp.z ), s ) );
+		ux = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.x ), c ), _mm_mul_ps( _mm_set1_ps( entityLeft.x ), s ) );
+		uy = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.y ), c ), _mm_mul_ps( _mm_set1_ps( entityLeft.y ), s ) );
+		uz = _mm_sub_ps( _mm_mul_ps( _mm_set1_ps( entityUp.z ), c ), _mm_mul_ps( _mm_set1_ps( entityLeft.z ), s ) );
+	}
+
+	const __m128 width = _mm_loadu_ps( psize );
+	const __m128 height = _mm_mul_ps( width, _mm_loadu_ps( paspect ) );
+	lx = _mm_mul_ps( lx, width );
+	ly = _mm_mul_ps( ly, width );
+	lz = _mm_mul_ps( lz, width );
+	ux = _mm_mul_ps( ux, height );
+	uy = _mm_mul_ps( uy, height );
+	uz = _mm_mul_ps( uz, height );
+
+	// corners in the 0 1 / 2 3 order of ParticleVerts
+	ALIGN16( float corner[4][3][4] );
+	const __m128 minusLeft[3] = { _mm_sub_ps( ox, lx ), _mm_sub_ps( oy, ly ), _mm_sub_ps( oz, lz ) };
+	const __m128 plusLeft[3] = { _mm_add_ps( ox, lx ), _mm_add_ps( oy, ly ), _mm_add_ps( oz, lz ) };
+	const __m128 up[3] = { ux, uy, uz };
+	for( int k = 0; k < 3; k++ )
+	{
+		_mm_store_ps( corner[0][k], _mm_add_ps( minusLeft[k], up[k] ) );
+		_mm_store_ps( corner[1][k], _mm_add_ps( plusLeft[k], up[k] ) );
+		_mm_store_ps( corner[2][k], _mm_sub_ps( minusLeft[k], up[k] ) );
+		_mm_store_ps( corner[3][k], _mm_sub_ps( plusLeft[k], up[k] ) );
+	}
+
+	for( int i = 0; i < 4; i++ )
+	{
+		for( int j = 0; j < 4; j++ )
+		{
+			xyz[i][j].Set( corner[j][0][i], corner[j][1][i], corner[j][2][i] );
+		}
+	}
+}
+
+#endif
+
+/*
+================
+idParticleStage::CreateParticles
+
+Batched version of the parametric particle loop in idRenderModelPrt.
+
+The spawn timing has to step the random generators in index order, so it is
+worked out per particle first, then the fades, colors, sizes and aspects of
+the surviving particles are evaluated four at a time. The origins and quad
+corners are evaluated four at a time as well unless the stage uses a custom
+path or aimed trails. The results are identical to calling CreateParticle for
+every index.
+================
+*/
+static const int PARTICLE_BATCH_SIZE = 64;
+
+int idParticleStage::CreateParticles( particleGen_t* g, int stageAge, idDrawVert* verts ) const
+{
+	const renderEntity_t* renderEntity = g->renderEnt;
+	const int renderTime = g->renderView->time[renderEntity->timeGroup];
+	const int stageCycle = stageAge / cycleMsec;
+	const int diversity = ( int )( renderEntity->shaderParms[SHADERPARM_DIVERSITY] * idRandom::MAX_RAND );
+
+	// some particles will be in this cycle, some will be in the previous cycle
+	idRandom steppingRandom( ( ( stageCycle << 10 ) & idRandom::MAX_RAND ) ^ diversity );
+	idRandom steppingRandom2( ( ( ( stageCycle - 1 ) << 10 ) & idRandom::MAX_RAND ) ^ diversity );
+
+	ALIGN16( float batchFrac[PARTICLE_BATCH_SIZE] );
+	ALIGN16( int batchIndex[PARTICLE_BATCH_SIZE] );
+	ALIGN16( float batchSize[PARTICLE_BATCH_SIZE] );
+	ALIGN16( float batchAspect[PARTICLE_BATCH_SIZE] );
+	ALIGN16( int batchColor[4][PARTICLE_BATCH_SIZE] );
+	int batchSeed[PARTICLE_BATCH_SIZE];
+#if defined(USE_INTRINSICS_SSE)
+	idVec3 batchXyz[PARTICLE_BATCH_SIZE][4];
+	const bool batchQuads = CanBatchQuads();
+#endif
+
+	float baseColor[4];
+	for( int i = 0; i < 4; i++ )
+	{
+		baseColor[i] = ( entityColor ) ? renderEntity->shaderParms[i] : color[i];
+	}
+
+	int numVerts = 0;
+	int index = 0;
+
+	while( index < totalParticles )
+	{
+		//
+		// find the next batch of live particles
+		//
+		int numBatch = 0;
+		for( ; index < totalParticles && numBatch < PARTICLE_BATCH_SIZE; index++ )
+		{
+			// bump the random
+			steppingRandom.RandomInt();
+			steppingRandom2.RandomInt();
+
+			// calculate local age for this index
+			int	bunchOffset = particleLife * 1000 * spawnBunching * index / totalParticles;
+
+			int particleAge = stageAge - bunchOffset;
+			int	particleCycle = particleAge / cycleMsec;
+			if( particleCycle < 0 )
+			{
+				// before the particleSystem spawned
+				continue;
+			}
+			if( cycles && particleCycle >= cycles )
+			{
+				// cycled systems will only run cycle times
+				continue;
+			}
+
+			int	inCycleTime = particleAge - particleCycle * cycleMsec;
+
+			if( renderEntity->shaderParms[SHADERPARM_PARTICLE_STOPTIME] &&
+					renderTime - inCycleTime >= renderEntity->shaderParms[SHADERPARM_PARTICLE_STOPTIME] * 1000 )
+			{
+				// don't fire any more particles
+				continue;
+			}
+
+			// supress particles before or after the age clamp
+			float frac = ( float )inCycleTime / ( particleLife * 1000 );
+			if( frac < 0.0f || frac > 1.0f )
+			{
+				continue;
+			}
+
+			batchFrac[numBatch] = frac;
+			batchIndex[numBatch] = index;
+			batchSeed[numBatch] = ( particleCycle == stageCycle ) ? steppingRandom.GetSeed() : steppingRandom2.GetSeed();
+			numBatch++;
+		}
+
+		if( numBatch == 0 )
+		{
+			break;
+		}
+
+		// pad to a multiple of four, the padding lanes are never emitted
+		const int numPadded = ( numBatch + 3 ) & ~3;
+		for( int i = numBatch; i < numPadded; i++ )
+		{
+			batchFrac[i] = 0.0f;
+			batchIndex[i] = 0;
+			batchSeed[i] = 0;
+		}
+
+		size.EvalBatch( batchFrac, batchSize, numPadded );
+		aspect.EvalBatch( batchFrac, batchAspect, numPadded );
+
+		//
+		// fade and color, same math as ParticleColors
+		//
+#if defined(USE_INTRINSICS_SSE)
+		const __m128 vector_float_one = _mm_set1_ps( 1.0f );
+		const __m128 vector_float_255 = _mm_set1_ps( 255.0f );
+		const __m128i vector_int_zero = _mm_setzero_si128();
+		const __m128i vector_int_255 = _mm_set1_epi32( 255 );
+		const __m128 fadeIn = _mm_set1_ps( fadeInFraction );
+		const __m128 fadeOut = _mm_set1_ps( fadeOutFraction );
+		const __m128 fadeIndex = _mm_set1_ps( fadeIndexFraction );
+		const __m128 total = _mm_set1_ps( ( float )totalParticles );
+		const __m128i totalInt = _mm_set1_epi32( totalParticles );
+
+		for( int i = 0; i < numPadded; i += 4 )
+		{
+			const __m128 frac = _mm_load_ps( batchFrac + i );
+			const __m128 invFrac = _mm_sub_ps( vector_float_one, frac );
+
+			// most particles fade in at the beginning and fade out at the end
+			__m128 fade = vector_float_one;
+			__m128 mask = _mm_cmplt_ps( frac, fadeIn );
+			fade = _mm_or_ps( _mm_and_ps( mask, _mm_mul_ps( fade, _mm_div_ps( frac, fadeIn ) ) ), _mm_andnot_ps( mask, fade ) );
+			mask = _mm_cmplt_ps( invFrac, fadeOut );
+			fade = _mm_or_ps( _mm_and_ps( mask, _mm_mul_ps( fade, _mm_div_ps( invFrac, fadeOut ) ) ), _mm_andnot_ps( mask, fade ) );
+
+			if( fadeIndexFraction )
+			{
+				const __m128i particleIndex = _mm_load_si128( ( const __m128i* )( batchIndex + i ) );
+				const __m128 indexFrac = _mm_div_ps( _mm_cvtepi32_ps( _mm_sub_epi32( totalInt, particleIndex ) ), total );
+				mask = _mm_cmplt_ps( indexFrac, fadeIndex );
+				fade = _mm_or_ps( _mm_and_ps( mask, _mm_mul_ps( fade, _mm_div_ps( indexFrac, fadeIndex ) ) ), _mm_andnot_ps( mask, fade ) );
+			}
+
+			const __m128 invFade = _mm_sub_ps( vector_float_one, fade );
+
+			for( int c = 0; c < 4; c++ )
+			{
+				const __m128 fcolor = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( baseColor[c] ), fade ), _mm_mul_ps( _mm_set1_ps( fadeColor[c] ), invFade ) );
+				__m128i icolor = _mm_cvttps_epi32( _mm_mul_ps( fcolor, vector_float_255 ) );
+				icolor = _mm_and_si128( icolor, _mm_cmpgt_epi32( icolor, vector_int_zero ) );
+				const __m128i over = _mm_cmpgt_epi32( icolor, vector_int_255 );
+				icolor = _mm_or_si128( _mm_and_si128( over, vector_int_255 ), _mm_andnot_si128( over, icolor ) );
+				_mm_store_si128( ( __m128i* )( batchColor[c] + i ), icolor );
+			}
+		}
+#else
+		for( int i = 0; i < numPadded; i++ )
+		{
+			const float frac = batchFrac[i];
+			float fadeFraction = 1.0f;
+
+			if( frac < fadeInFraction )
+			{
+				fadeFraction *= ( frac / fadeInFraction );
+			}
+			if( 1.0f - frac < fadeOutFraction )
+			{
+				fadeFraction *= ( ( 1.0f - frac ) / fadeOutFraction );
+			}
+			if( fadeIndexFraction )
+			{
+				float	indexFrac = ( totalParticles - batchIndex[i] ) / ( float )totalParticles;
+				if( indexFrac < fadeIndexFraction )
+				{
+					fadeFraction *= indexFrac / fadeIndexFraction;
+				}
+			}
+
+			for( int c = 0; c < 4; c++ )
+			{
+				float	fcolor = baseColor[c] * fadeFraction + fadeColor[c] * ( 1.0f - fadeFraction );
+				batchColor[c][i] = idMath::ClampInt( 0, 255, idMath::Ftoi( fcolor * 255.0f ) );
+			}
+		}
+#endif
+
+#if defined(USE_INTRINSICS_SSE)
+		if( batchQuads )
+		{
+			for( int i = 0; i < numPadded; i += 4 )
+			{
+				ParticleQuads4( g, batchFrac + i, batchIndex + i, batchSeed + i, batchSize + i, batchAspect + i, batchXyz + i );
+			}
+		}
+#endif
+
+		//
+		// write the verts of the visible particles
+		//
+		for( int i = 0; i < numBatch; i++ )
+		{
+			// if we are completely faded out, kill the particle
+			if( ( batchColor[0][i] | batchColor[1][i] | batchColor[2][i] | batchColor[3][i] ) == 0 )
+			{
+				continue;
+			}
+
+			idDrawVert* v = verts + numVerts;
+			for( int j = 0; j < 4; j++ )
+			{
+				v[j].Clear();
+				v[j].color[0] = batchColor[0][i];
+				v[j].color[1] = batchColor[1][i];
+				v[j].color[2] = batchColor[2][i];
+				v[j].color[3] = batchColor[3][i];
+			}
+
+			g->index = batchIndex[i];
+			g->frac = batchFrac[i];
+			g->random.SetSeed( batchSeed[i] );
+
+			// this is needed so aimed particles can calculate origins at different times
+			g->originalRandom = g->random;
+
+			g->age = g->frac * particleLife;
+
+#if defined(USE_INTRINSICS_SSE)
+			if( batchQuads )
+			{
+				ParticleTexCoords( g, v );
+
+				for( int j = 0; j < 4; j++ )
+				{
+					v[j].xyz = batchXyz[i][j];
+				}
+				numVerts += ParticleCrossFade( g, v, 4 );
+				continue;
+			}
+#endif
+
+			idVec3 origin;
+			ParticleOrigin( g, origin );
+
+			ParticleTexCoords( g, v );
+
+			numVerts += ParticleCrossFade( g, v, ParticleVerts( g, origin, batchSize[i], batchAspect[i], v ) );
+		}
+	}
+
+	return numVerts;
+}
+
 /*
 ==================
 idParticleStage::GetCustomPathName
@@ -54,6 +54,8 @@ public:
 
 	float					Eval( float frac, idRandom& rand ) const;
 	float					Integrate( float frac, idRandom& rand ) const;
+	// evaluates num fractions at once, num must be a multiple of 4 and both arrays 16 byte aligned
+	void					EvalBatch( const float* frac, float* result, int num ) const;
 };
 
 
@@ -123,11 +125,23 @@ public:
 	int						NumQuadsPerParticle() const;	// includes trails and cross faded animations
 	// returns the number of verts created, which will range from 0 to 4*NumQuadsPerParticle()
 	int						CreateParticle( particleGen_t* g, idDrawVert* verts ) const;
+	// creates every live particle of a parametric particle stage at stageAge msec, matching
+	// CreateParticle stepped over all indexes, returns the number of verts created
+	int						CreateParticles( particleGen_t* g, int stageAge, idDrawVert* verts ) const;
 
 	void					ParticleOrigin( particleGen_t* g, idVec3& origin ) const;
 	int						ParticleVerts( particleGen_t* g, const idVec3 origin, idDrawVert* verts ) const;
+	int						ParticleVerts( particleGen_t* g, const idVec3 origin, float psize, float paspect, idDrawVert* verts ) const;
 	void					ParticleTexCoords( particleGen_t* g, idDrawVert* verts ) const;
 	void					ParticleColors( particleGen_t* g, idDrawVert* verts ) const;
+	int						ParticleCrossFade( particleGen_t* g, idDrawVert* verts, int numVerts ) const;
+#if defined(USE_INTRINSICS_SSE)
+	// true if ParticleQuads4 can replace ParticleOrigin and ParticleVerts
+	bool					CanBatchQuads() const;
+	// origins and quad corners of four particles at once, same results as ParticleOrigin and ParticleVerts
+	void					ParticleQuads4( const particleGen_t* g, const float* frac, const int* index, const int* seed,
+											const float* psize, const float* paspect, idVec3 xyz[4][4] ) const;
+#endif
 
 	const char* 			GetCustomPathName();
 	const char* 			GetCustomPathDesc();
@@ -57,7 +57,7 @@ void ZlibFree( void* opaque, void* address )
 	Mem_Free( address );
 }
 
-idCVar sgf_threads( "sgf_threads", "2", CVAR_INTEGER, "0 = all foreground, 1 = background write, 2 = background write + compress" );
+idCVar sgf_threads( "sgf_threads", "3", CVAR_INTEGER, "0 = all foreground, 1 = background compress, 2 = background compress + write, 3 = parallel compress jobs + background write" );
 idCVar sgf_checksums( "sgf_checksums", "1", CVAR_BOOL, "enable save game file checksums" );
 idCVar sgf_testCorruption( "sgf_testCorruption", "-1", CVAR_INTEGER, "test corruption at the 128 kB compressed block" );
 
@@ -134,6 +134,10 @@ idFile_SaveGamePipelined::idFile_SaveGamePipelined() :
 	decompressThread( NULL ),
 	compressThread( NULL ),
 	blockFinished( true ),
+	batches( NULL ),
+	fillBatch( 0 ),
+	batchPending( false ),
+	compressedPayloadBytes( 0 ),
 	buildVersion( "" ),
 	saveFormatVersion( 0 )
 {
@@ -153,6 +157,7 @@ idFile_SaveGamePipelined::~idFile_SaveGamePipelined
 idFile_SaveGamePipelined::~idFile_SaveGamePipelined()
 {
 	Finish();
+	FreeCompressJobs();
 
 	// free the threads
 	if( compressThread != NULL )
@@ -238,19 +243,27 @@ void idFile_SaveGamePipelined::Finish()
 	if( mode == WRITE )
 	{
 
-		// wait for the compression thread to complete, which may kick off a write
-		if( compressThread != NULL )
+		if( batches != NULL )
 		{
-			compressThread->WaitForThread();
+			// compress the last batch and emit everything
+			SubmitBatch( true );
 		}
+		else
+		{
+			// wait for the compression thread to complete, which may kick off a write
+			if( compressThread != NULL )
+			{
+				compressThread->WaitForThread();
+			}
 
-		// force the next compression to emit everything
-		zLibFlushType = Z_FINISH;
-		FlushUncompressedBlock();
+			// force the next compression to emit everything
+			zLibFlushType = Z_FINISH;
+			FlushUncompressedBlock();
 
-		if( compressThread != NULL )
-		{
-			compressThread->WaitForThread();
+			if( compressThread != NULL )
+			{
+				compressThread->WaitForThread();
+			}
 		}
 
 		if( writeThread != NULL )
@@ -269,6 +282,7 @@ void idFile_SaveGamePipelined::Finish()
 
 		// free zlib tables
 		deflateEnd( &zStream );
+		FreeCompressJobs();
 
 	}
 	else if( mode == READ )
@@ -315,6 +329,12 @@ void idFile_SaveGamePipelined::Abort()
 		{
 			compressThread->WaitForThread();
 		}
+		if( batches != NULL && batchPending )
+		{
+			batches[fillBatch ^ 1].jobList->Wait();
+			batchPending = false;
+		}
+		FreeCompressJobs();
 		if( writeThread != NULL )
 		{
 			writeThread->WaitForThread();
@@ -407,7 +427,11 @@ bool idFile_SaveGamePipelined::OpenForWriting( const char* const filename, bool
 		zStream.avail_out -= sizeof( uint32_t );
 	}
 
-	if( sgf_threads.GetInteger() >= 1 )
+	if( sgf_threads.GetInteger() >= 3 )
+	{
+		StartCompressJobs();
+	}
+	else if( sgf_threads.GetInteger() >= 1 )
 	{
 		compressThread = new( TAG_IDFILE ) idSGFcompressThread();
 		compressThread->sgf = this;
@@ -467,7 +491,11 @@ bool idFile_SaveGamePipelined::OpenForWriting( idFile* file )
 		zStream.avail_out -= sizeof( uint32_t );
 	}
 
-	if( sgf_threads.GetInteger() >= 1 )
+	if( sgf_threads.GetInteger() >= 3 )
+	{
+		StartCompressJobs();
+	}
+	else if( sgf_threads.GetInteger() >= 1 )
 	{
 		compressThread = new( TAG_IDFILE ) idSGFcompressThread();
 		compressThread->sgf = this;
@@ -719,6 +747,255 @@ void idFile_SaveGamePipelined::FlushUncompressedBlock()
 	}
 }
 
+/*
+============================
+SGF_CompressJob
+
+Deflates a single uncompressed block into a piece of the raw deflate stream that
+ends on a byte boundary, so the pieces of all blocks can be concatenated. The
+dictionary makes the matches of the block identical to those of a single stream.
+============================
+*/
+static void SGF_CompressJob( sgfCompressJob_t* job )
+{
+	z_stream zs;
+	memset( &zs, 0, sizeof( zs ) );
+	zs.zalloc = ZlibAlloc;
+	zs.zfree = ZlibFree;
+
+	job->compressedBytes = 0;
+	job->failed = true;
+
+	if( deflateInit2( &zs, Z_BEST_SPEED, Z_DEFLATED, job->windowBits, 9, Z_DEFAULT_STRATEGY ) != Z_OK )
+	{
+		return;
+	}
+
+	if( job->dictionaryBytes > 0 )
+	{
+		deflateSetDictionary( &zs, ( const Bytef* )job->dictionary, ( uInt )job->dictionaryBytes );
+	}
+
+	zs.next_in = ( Bytef* )job->data;
+	zs.avail_in = ( uInt )job->bytes;
+	zs.next_out = ( Bytef* )job->compressed;
+	zs.avail_out = ( uInt )job->compressedCapacity;
+
+	// a sync flush aligns the output to a byte boundary without ending the stream
+	const int zstat = deflate( &zs, job->last ? Z_FINISH : Z_SYNC_FLUSH );
+	const bool done = job->last ? ( zstat == Z_STREAM_END ) : ( zstat == Z_OK && zs.avail_out > 0 );
+	if( done && zs.avail_in == 0 )
+	{
+		job->compressedBytes = zs.total_out;
+		job->failed = false;
+	}
+
+	deflateEnd( &zs );
+}
+
+REGISTER_PARALLEL_JOB( SGF_CompressJob, "SGF_CompressJob" );
+
+/*
+============================
+idFile_SaveGamePipelined::StartCompressJobs
+============================
+*/
+void idFile_SaveGamePipelined::StartCompressJobs()
+{
+	assert( batches == NULL );
+
+	const size_t batchSize = PARALLEL_BLOCKS * UNCOMPRESSED_BLOCK_SIZE + PARALLEL_BLOCKS * COMPRESSED_JOB_SIZE + DICTIONARY_SIZE;
+
+	batches = new( TAG_SAVEGAMES ) compressBatch_t[2];
+	for( int i = 0; i < 2; i++ )
+	{
+		compressBatch_t& batch = batches[i];
+		batch.uncompressed = ( byte* )Mem_Alloc( batchSize, TAG_SAVEGAMES );
+		batch.compressed = batch.uncompressed + PARALLEL_BLOCKS * UNCOMPRESSED_BLOCK_SIZE;
+		batch.dictionary = batch.compressed + PARALLEL_BLOCKS * COMPRESSED_JOB_SIZE;
+		batch.dictionaryBytes = 0;
+		batch.bytes = 0;
+		batch.numJobs = 0;
+		batch.jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, PARALLEL_BLOCKS, 0, NULL );
+	}
+
+	fillBatch = 0;
+	batchPending = false;
+	compressedPayloadBytes = 0;
+}
+
+/*
+============================
+idFile_SaveGamePipelined::FreeCompressJobs
+============================
+*/
+void idFile_SaveGamePipelined::FreeCompressJobs()
+{
+	if( batches == NULL )
+	{
+		return;
+	}
+
+	assert( !batchPending );
+
+	for( int i = 0; i < 2; i++ )
+	{
+		parallelJobManager->FreeJobList( batches[i].jobList );
+		Mem_Free( batches[i].uncompressed );
+	}
+	delete[] batches;
+	batches = NULL;
+}
+
+/*
+============================
+idFile_SaveGamePipelined::SubmitBatch
+
+Called when the fill batch is full, and with last set to flush the final partial batch.
+The jobs of the batch run while the next batch is filled, then the output of the
+previous batch is emitted in order.
+
+Modifies:
+	batches
+	fillBatch
+	batchPending
+============================
+*/
+void idFile_SaveGamePipelined::SubmitBatch( bool last )
+{
+	compressBatch_t& batch = batches[fillBatch];
+	compressBatch_t& previous = batches[fillBatch ^ 1];
+
+	// the last batch always gets a job, even when empty, to end the stream
+	batch.numJobs = 0;
+	for( size_t offset = 0; offset < batch.bytes || ( last && batch.numJobs == 0 ); offset += UNCOMPRESSED_BLOCK_SIZE )
+	{
+		sgfCompressJob_t& job = batch.jobs[batch.numJobs];
+		job.data = batch.uncompressed + offset;
+		job.bytes = Min( batch.bytes - offset, ( size_t )UNCOMPRESSED_BLOCK_SIZE );
+		if( batch.numJobs == 0 )
+		{
+			job.dictionary = batch.dictionary;
+			job.dictionaryBytes = batch.dictionaryBytes;
+		}
+		else
+		{
+			// only the last block can be partial
+			job.dictionary = job.data - DICTIONARY_SIZE;
+			job.dictionaryBytes = DICTIONARY_SIZE;
+		}
+		job.compressed = batch.compressed + batch.numJobs * COMPRESSED_JOB_SIZE;
+		job.compressedCapacity = COMPRESSED_JOB_SIZE;
+		job.compressedBytes = 0;
+		job.windowBits = sgf_windowBits.GetInteger();
+		job.last = false;
+		job.failed = false;
+		batch.jobList->AddJob( ( jobRun_t )SGF_CompressJob, &job );
+		batch.numJobs++;
+	}
+	batch.jobs[batch.numJobs - 1].last = last;
+	batch.jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+
+	if( batchPending )
+	{
+		previous.jobList->Wait();
+		batchPending = false;
+		WriteBatch( previous, false );
+	}
+
+	if( last )
+	{
+		batch.jobList->Wait();
+		WriteBatch( batch, true );
+		return;
+	}
+
+	// the next batch continues from the end of this one, which is a full batch
+	const size_t dictionaryBytes = Min( batch.bytes, ( size_t )DICTIONARY_SIZE );
+	memcpy( previous.dictionary, batch.uncompressed + batch.bytes - dictionaryBytes, dictionaryBytes );
+	previous.dictionaryBytes = dictionaryBytes;
+	previous.bytes = 0;
+
+	batchPending = true;
+	fillBatch ^= 1;
+}
+
+/*
+============================
+idFile_SaveGamePipelined::WriteBatch
+============================
+*/
+void idFile_SaveGamePipelined::WriteBatch( const compressBatch_t& batch, bool last )
+{
+	for( int i = 0; i < batch.numJobs; i++ )
+	{
+		const sgfCompressJob_t& job = batch.jobs[i];
+		if( job.failed )
+		{
+			idLib::FatalError( "idFile_SaveGamePipelined::WriteBatch: deflate() failed" );
+		}
+		AppendCompressed( job.compressed, job.compressedBytes, last && i == batch.numJobs - 1 );
+	}
+}
+
+/*
+============================
+idFile_SaveGamePipelined::AppendCompressed
+
+Cuts the compressed data into COMPRESSED_BLOCK_SIZE blocks with the same layout
+CompressBlock produces, and flushes the final partial block when last is set.
+
+Modifies:
+	compressed
+	compressedPayloadBytes
+	compressedProducedBytes
+	zStreamEndHit
+============================
+*/
+void idFile_SaveGamePipelined::AppendCompressed( const byte* data, size_t bytes, bool last )
+{
+	const size_t payloadSize = COMPRESSED_BLOCK_SIZE - ( sgf_checksums.GetBool() ? sizeof( uint32_t ) : 0 );
+
+	for( ;; )
+	{
+		byte* block = &compressed[ compressedProducedBytes & ( COMPRESSED_BUFFER_SIZE - 1 ) ];
+		const size_t remainingInBlock = payloadSize - compressedPayloadBytes;
+		const size_t copyToBlock = ( bytes < remainingInBlock ) ? bytes : remainingInBlock;
+
+		memcpy( block + compressedPayloadBytes, data, copyToBlock );
+		compressedPayloadBytes += copyToBlock;
+		data += copyToBlock;
+		bytes -= copyToBlock;
+
+		if( compressedPayloadBytes < payloadSize && !( last && bytes == 0 ) )
+		{
+			return;
+		}
+
+		if( sgf_checksums.GetBool() )
+		{
+			uint32_t checksum = MD5_BlockChecksum( block, compressedPayloadBytes );
+			block[compressedPayloadBytes + 0] = ( ( checksum >>  0 ) & 0xFF );
+			block[compressedPayloadBytes + 1] = ( ( checksum >>  8 ) & 0xFF );
+			block[compressedPayloadBytes + 2] = ( ( checksum >> 16 ) & 0xFF );
+			block[compressedPayloadBytes + 3] = ( ( checksum >> 24 ) & 0xFF );
+			numChecksums++;
+			compressedPayloadBytes += sizeof( uint32_t );
+		}
+
+		// flush the output buffer IO
+		compressedProducedBytes += compressedPayloadBytes;
+		compressedPayloadBytes = 0;
+		FlushCompressedBlock();
+
+		if( bytes == 0 )
+		{
+			zStreamEndHit = last;
+			return;
+		}
+	}
+}
+
 /*
 ============================
 idFile_SaveGamePipelined::Write
@@ -749,6 +1026,30 @@ int idFile_SaveGamePipelined::Write( const void* buffer, int length )
 	assert( mode == WRITE );
 	size_t lengthRemaining = length;
 	const byte* buffer_p = ( const byte* )buffer;
+
+	if( batches != NULL )
+	{
+		while( lengthRemaining > 0 )
+		{
+			compressBatch_t& batch = batches[fillBatch];
+			const size_t remainingInBatch = PARALLEL_BLOCKS * UNCOMPRESSED_BLOCK_SIZE - batch.bytes;
+			const size_t copyToBatch = ( lengthRemaining < remainingInBatch ) ? lengthRemaining : remainingInBatch;
+
+			memcpy( batch.uncompressed + batch.bytes, buffer_p, copyToBatch );
+			batch.bytes += copyToBatch;
+			uncompressedProducedBytes += copyToBatch;
+
+			buffer_p += copyToBatch;
+			lengthRemaining -= copyToBatch;
+
+			if( copyToBatch == remainingInBatch )
+			{
+				SubmitBatch( false );
+			}
+		}
+		return length;
+	}
+
 	while( lengthRemaining > 0 )
 	{
 		const size_t ofsInBuffer = uncompressedProducedBytes & ( UNCOMPRESSED_BUFFER_SIZE - 1 );
@@ -1198,6 +1499,56 @@ int idFile_SaveGamePipelined::Read( void* buffer, int length )
 /*
 ===================================================================================
 
+BUFFERED WRITER
+
+===================================================================================
+*/
+
+/*
+============================
+idFile_SaveGameBuffered::Write
+============================
+*/
+int idFile_SaveGameBuffered::Write( const void* buffer, int len )
+{
+	if( buffer == NULL || len <= 0 )
+	{
+		return 0;
+	}
+
+	if( bufferBytes + len > BUFFER_SIZE )
+	{
+		Flush();
+	}
+
+	// large writes go straight through
+	if( len >= BUFFER_SIZE )
+	{
+		return file->Write( buffer, len );
+	}
+
+	memcpy( data + bufferBytes, buffer, len );
+	bufferBytes += len;
+	return len;
+}
+
+/*
+============================
+idFile_SaveGameBuffered::Flush
+============================
+*/
+void idFile_SaveGameBuffered::Flush()
+{
+	if( bufferBytes > 0 )
+	{
+		file->Write( data, bufferBytes );
+		bufferBytes = 0;
+	}
+}
+
+/*
+===================================================================================
+
 TEST CODE
 
 ===================================================================================
@@ -93,6 +93,21 @@ struct blockForIO_t
 	size_t		bytes;
 };
 
+// one uncompressed block deflated by a job, see idFile_SaveGamePipelined::SubmitBatch
+struct sgfCompressJob_t
+{
+	const byte* 	data;
+	size_t			bytes;
+	const byte* 	dictionary;		// the uncompressed data in front of this block
+	size_t			dictionaryBytes;
+	byte* 			compressed;
+	size_t			compressedCapacity;
+	size_t			compressedBytes;
+	int				windowBits;
+	bool			last;			// finishes the deflate stream
+	bool			failed;
+};
+
 class idFile_SaveGamePipelined : public idFile
 {
 public:
@@ -103,6 +118,14 @@ public:
 	static const int COMPRESSED_BLOCK_SIZE		= 128 * 1024;
 	static const int UNCOMPRESSED_BLOCK_SIZE	= 256 * 1024;
 
+	// With sgf_threads 3 the uncompressed blocks are deflated independently in parallel
+	// jobs, each one primed with the data in front of it as dictionary. The pieces end on
+	// byte boundaries and are joined into the same single deflate stream that the compress
+	// thread produces, so reading is unchanged.
+	static const int PARALLEL_BLOCKS			= 8;
+	static const int DICTIONARY_SIZE			= 32 * 1024;
+	static const int COMPRESSED_JOB_SIZE		= UNCOMPRESSED_BLOCK_SIZE + UNCOMPRESSED_BLOCK_SIZE / 256 + 64;
+
 
 	idFile_SaveGamePipelined();
 	virtual					~idFile_SaveGamePipelined();
@@ -274,6 +297,28 @@ private:
 	idSysSignal				blockAvailable;
 	idSysSignal				blockFinished;
 
+	//------------------------
+	// Double buffered batches for compressing in jobs, one is filled while the
+	// jobs of the other one run.
+	//------------------------
+
+	struct compressBatch_t
+	{
+		byte* 				uncompressed;		// PARALLEL_BLOCKS uncompressed blocks
+		byte* 				compressed;			// PARALLEL_BLOCKS * COMPRESSED_JOB_SIZE
+		byte* 				dictionary;			// end of the previous batch
+		size_t				dictionaryBytes;
+		size_t				bytes;				// uncompressed bytes in this batch
+		sgfCompressJob_t	jobs[PARALLEL_BLOCKS];
+		int					numJobs;
+		idParallelJobList* 	jobList;
+	};
+
+	compressBatch_t* 		batches;			// NULL unless compressing in jobs
+	int						fillBatch;
+	bool					batchPending;		// the other batch is compressing
+	size_t					compressedPayloadBytes;	// in the current compressed block
+
 	idStrStatic< 32 >		buildVersion;		// build version this file was saved with
 	int16_t					pointerSize;		// the number of bytes in a pointer, because different pointer sizes mean different offsets into objects a 64 bit build cannot load games saved from a 32 bit build or vice version (a value of 0 is interpreted as 4 bytes)
 	int16_t					saveFormatVersion;	// version number specific to save games (for maintaining save compatibility across builds)
@@ -288,10 +333,54 @@ private:
 	void					CompressBlock();
 	void					WriteBlock();
 
+	void					StartCompressJobs();
+	void					FreeCompressJobs();
+	void					SubmitBatch( bool last );
+	void					WriteBatch( const compressBatch_t& batch, bool last );
+	void					AppendCompressed( const byte* data, size_t bytes, bool last );
+
 	void					PumpUncompressedBlock();
 	void					PumpCompressedBlock();
 	void					DecompressBlock();
 	void					ReadBlock();
 };
 
+/*
+================================================
+idFile_SaveGameBuffered collects the many small writes of a savegame and passes
+them on to the wrapped file in larger pieces.
+================================================
+*/
+class idFile_SaveGameBuffered : public idFile
+{
+public:
+	idFile_SaveGameBuffered( idFile* file_ ) : file( file_ ), bufferBytes( 0 ) {}
+	virtual					~idFile_SaveGameBuffered()
+	{
+		Flush();
+	}
+
+	virtual const char* 	GetName() const
+	{
+		return file->GetName();
+	}
+	virtual const char* 	GetFullPath() const
+	{
+		return file->GetFullPath();
+	}
+	virtual int				Write( const void* buffer, int len );
+	virtual int				Length() const
+	{
+		return file->Length();
+	}
+	virtual void			Flush();
+
+private:
+	static const int BUFFER_SIZE = 16 * 1024;
+
+	idFile* 				file;
+	byte					data[BUFFER_SIZE];
+	int						bufferBytes;
+};
+
 #endif // !__FILE_SAVEGAME_H__
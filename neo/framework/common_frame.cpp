@@ -338,7 +338,11 @@ void idCommonLocal::Draw()
 		{
 			// draw the game view
 			int	start = Sys_Milliseconds();
-			if( game )
+			if( timeDemo != TD_NO && DrawTimeDemoFrame() )
+			{
+				gameDraw = true;
+			}
+			else if( game )
 			{
 				gameDraw = game->Draw( Game()->GetLocalClientNum() );
 			}
@@ -484,6 +488,9 @@ idCommonLocal::Frame
 */
 void idCommonLocal::Frame()
 {
+	// ends profileCapture after the requested number of frames
+	idProfiler::BeginFrame();
+
 	try
 	{
 		SCOPED_PROFILE_EVENT( "Common::Frame" );
@@ -573,6 +580,9 @@ void idCommonLocal::Frame()
 		}
 		frameTiming.finishSyncTime = Sys_Microseconds();
 
+		// collect the timings of the last timedemo frame
+		UpdateTimeDemo();
+
 		//--------------------------------------------
 		// Determine how many game tics we are going to run,
 		// now that the previous frame is completely finished.
@@ -871,6 +881,11 @@ void idCommonLocal::Frame()
 
 		mainFrameTiming = frameTiming;
 
+		if( recordingCameraPath )
+		{
+			RecordCameraPathFrame();
+		}
+
 		session->GetSaveGameManager().Pump();
 	}
 	catch( idException& )
@@ -113,6 +113,182 @@ int default_setup;
 
 char idLexer::baseFolder[ 256 ];
 
+// scan whitespace, comments and strings 16 bytes at a time, only cleared to benchmark the scalar loops
+static bool lexerFastScan = true;
+
+// character classes used to scan names
+#define LCC_NAME			BIT( 0 )	// a-z A-Z 0-9 _
+#define LCC_NAMESTART		BIT( 1 )	// a-z A-Z _
+#define LCC_DIGIT			BIT( 2 )	// 0-9
+#define LCC_PATH			BIT( 3 )	// / \ : . with LEXFL_ALLOWPATHNAMES
+#define LCC_DASH			BIT( 4 )	// - with LEXFL_ONLYSTRINGS
+
+static class idLexerCharClasses
+{
+public:
+	idLexerCharClasses()
+	{
+		memset( classes, 0, sizeof( classes ) );
+		for( int c = 0; c < 256; c++ )
+		{
+			if( ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || c == '_' )
+			{
+				classes[c] |= LCC_NAME | LCC_NAMESTART;
+			}
+			else if( c >= '0' && c <= '9' )
+			{
+				classes[c] |= LCC_NAME | LCC_DIGIT;
+			}
+		}
+		classes['/'] |= LCC_PATH;
+		classes['\\'] |= LCC_PATH;
+		classes[':'] |= LCC_PATH;
+		classes['.'] |= LCC_PATH;
+		classes['-'] |= LCC_DASH;
+	}
+
+	byte			operator[]( char c ) const
+	{
+		return classes[( byte )c];
+	}
+
+private:
+	byte			classes[256];
+} lexerCharClasses;
+
+#if defined(USE_INTRINSICS_SSE)
+
+/*
+================
+Lex_FirstBit
+================
+*/
+static ID_INLINE int Lex_FirstBit( int mask )
+{
+	return idMath::BitCount( ( mask & -mask ) - 1 );
+}
+
+/*
+================
+Lex_SkipSpaces
+
+Skips characters <= ' ', compared as signed chars like the scalar loops, and
+stops at a '\0', and at a '\n' if stopAtNewline is set. Newlines that are
+skipped are added to lines. Stops before the last 16 bytes of the script so
+it never reads past end.
+================
+*/
+static ID_INLINE const char* Lex_SkipSpaces( const char* p, const char* end, int& lines, bool stopAtNewline )
+{
+	// most white space is a single space or a line break with a few tabs, which
+	// the scalar loops handle faster
+	if( p + 16 > end || p[0] > ' ' || p[1] > ' ' || p[2] > ' ' || p[3] > ' ' )
+	{
+		return p;
+	}
+
+	const __m128i space = _mm_set1_epi8( ' ' );
+	const __m128i newline = _mm_set1_epi8( '\n' );
+	const __m128i zero = _mm_setzero_si128();
+
+	for( ; p + 16 <= end; p += 16 )
+	{
+		const __m128i v = _mm_loadu_si128( ( const __m128i* )p );
+		const __m128i isNewline = _mm_cmpeq_epi8( v, newline );
+		__m128i isStop = _mm_or_si128( _mm_cmpgt_epi8( v, space ), _mm_cmpeq_epi8( v, zero ) );
+		if( stopAtNewline )
+		{
+			isStop = _mm_or_si128( isStop, isNewline );
+		}
+		const int stopMask = _mm_movemask_epi8( isStop );
+		const int newlineMask = _mm_movemask_epi8( isNewline );
+		if( stopMask )
+		{
+			const int n = Lex_FirstBit( stopMask );
+			lines += idMath::BitCount( newlineMask & ( ( 1 << n ) - 1 ) );
+			return p + n;
+		}
+		lines += idMath::BitCount( newlineMask );
+	}
+	return p;
+}
+
+/*
+================
+Lex_SkipCommentText
+
+Skips the inside of a block comment up to the next '/' or '\0', counting newlines.
+================
+*/
+static ID_INLINE const char* Lex_SkipCommentText( const char* p, const char* end, int& lines )
+{
+	const __m128i slash = _mm_set1_epi8( '/' );
+	const __m128i newline = _mm_set1_epi8( '\n' );
+	const __m128i zero = _mm_setzero_si128();
+
+	for( ; p + 16 <= end; p += 16 )
+	{
+		const __m128i v = _mm_loadu_si128( ( const __m128i* )p );
+		const int stopMask = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, slash ), _mm_cmpeq_epi8( v, zero ) ) );
+		const int newlineMask = _mm_movemask_epi8( _mm_cmpeq_epi8( v, newline ) );
+		if( stopMask )
+		{
+			const int n = Lex_FirstBit( stopMask );
+			lines += idMath::BitCount( newlineMask & ( ( 1 << n ) - 1 ) );
+			return p + n;
+		}
+		lines += idMath::BitCount( newlineMask );
+	}
+	return p;
+}
+
+/*
+================
+Lex_SkipUntil
+
+Returns the first occurrence of a, b, c or '\0'.
+================
+*/
+static ID_INLINE const char* Lex_SkipUntil( const char* p, const char* end, char a, char b, char c )
+{
+	const __m128i va = _mm_set1_epi8( a );
+	const __m128i vb = _mm_set1_epi8( b );
+	const __m128i vc = _mm_set1_epi8( c );
+	const __m128i zero = _mm_setzero_si128();
+
+	for( ; p + 16 <= end; p += 16 )
+	{
+		const __m128i v = _mm_loadu_si128( ( const __m128i* )p );
+		const __m128i isStop = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, va ), _mm_cmpeq_epi8( v, vb ) ),
+											 _mm_or_si128( _mm_cmpeq_epi8( v, vc ), _mm_cmpeq_epi8( v, zero ) ) );
+		const int stopMask = _mm_movemask_epi8( isStop );
+		if( stopMask )
+		{
+			return p + Lex_FirstBit( stopMask );
+		}
+	}
+	return p;
+}
+
+#else
+
+static ID_INLINE const char* Lex_SkipSpaces( const char* p, const char* end, int& lines, bool stopAtNewline )
+{
+	return p;
+}
+
+static ID_INLINE const char* Lex_SkipCommentText( const char* p, const char* end, int& lines )
+{
+	return p;
+}
+
+static ID_INLINE const char* Lex_SkipUntil( const char* p, const char* end, char a, char b, char c )
+{
+	return p;
+}
+
+#endif
+
 /*
 ================
 idLexer::CreatePunctuationTable
@@ -321,6 +497,10 @@ int idLexer::ReadWhiteSpace()
 	while( 1 )
 	{
 		// skip white space
+		if( lexerFastScan )
+		{
+			idLexer::script_p = Lex_SkipSpaces( idLexer::script_p, idLexer::end_p, idLexer::line, false );
+		}
 		while( *idLexer::script_p <= ' ' )
 		{
 			if( !*idLexer::script_p )
@@ -339,16 +519,19 @@ int idLexer::ReadWhiteSpace()
 			// comments //
 			if( *( idLexer::script_p + 1 ) == '/' )
 			{
-				idLexer::script_p++;
-				do
+				idLexer::script_p += 2;
+				if( lexerFastScan )
+				{
+					idLexer::script_p = Lex_SkipUntil( idLexer::script_p, idLexer::end_p, '\n', '\n', '\n' );
+				}
+				while( *idLexer::script_p != '\n' )
 				{
-					idLexer::script_p++;
 					if( !*idLexer::script_p )
 					{
 						return 0;
 					}
+					idLexer::script_p++;
 				}
-				while( *idLexer::script_p != '\n' );
 				idLexer::line++;
 				idLexer::script_p++;
 				if( !*idLexer::script_p )
@@ -364,6 +547,10 @@ int idLexer::ReadWhiteSpace()
 				while( 1 )
 				{
 					idLexer::script_p++;
+					if( lexerFastScan )
+					{
+						idLexer::script_p = Lex_SkipCommentText( idLexer::script_p, idLexer::end_p, idLexer::line );
+					}
 					if( !*idLexer::script_p )
 					{
 						return 0;
@@ -420,6 +607,10 @@ bool idLexer::SkipWhiteSpace( bool currentLine )
 			return false;
 		}
 		// skip white space
+		if( lexerFastScan )
+		{
+			script_p = Lex_SkipSpaces( script_p, end_p, line, currentLine );
+		}
 		while( *script_p <= ' ' )
 		{
 			if( script_p == end_p )
@@ -447,16 +638,19 @@ bool idLexer::SkipWhiteSpace( bool currentLine )
 			// comments //
 			if( *( script_p + 1 ) == '/' )
 			{
-				script_p++;
-				do
+				script_p += 2;
+				if( lexerFastScan )
+				{
+					script_p = Lex_SkipUntil( script_p, end_p, '\n', '\n', '\n' );
+				}
+				while( *script_p != '\n' )
 				{
-					script_p++;
 					if( !*script_p )
 					{
 						return false;
 					}
+					script_p++;
 				}
-				while( *script_p != '\n' );
 				line++;
 				script_p++;
 				if( currentLine )
@@ -476,6 +670,10 @@ bool idLexer::SkipWhiteSpace( bool currentLine )
 				while( 1 )
 				{
 					script_p++;
+					if( lexerFastScan )
+					{
+						script_p = Lex_SkipCommentText( script_p, end_p, line );
+					}
 					if( !*script_p )
 					{
 						return false;
@@ -755,22 +953,30 @@ idLexer::ReadName
 */
 int idLexer::ReadName( idToken* token )
 {
-	char c;
+	int nameClasses = LCC_NAME;
+	// if treating all tokens as strings, don't parse '-' as a separate token
+	if( idLexer::flags & LEXFL_ONLYSTRINGS )
+	{
+		nameClasses |= LCC_DASH;
+	}
+	// if special path name characters are allowed
+	if( idLexer::flags & LEXFL_ALLOWPATHNAMES )
+	{
+		nameClasses |= LCC_PATH;
+	}
 
 	token->type = TT_NAME;
+	const char* start = idLexer::script_p;
 	do
 	{
-		token->AppendDirty( *idLexer::script_p++ );
-		c = *idLexer::script_p;
-	}
-	while( ( c >= 'a' && c <= 'z' ) ||
-			( c >= 'A' && c <= 'Z' ) ||
-			( c >= '0' && c <= '9' ) ||
-			c == '_' ||
-			// if treating all tokens as strings, don't parse '-' as a separate token
-			( ( idLexer::flags & LEXFL_ONLYSTRINGS ) && ( c == '-' ) ) ||
-			// if special path name characters are allowed
-			( ( idLexer::flags & LEXFL_ALLOWPATHNAMES ) && ( c == '/' || c == '\\' || c == ':' || c == '.' ) ) );
+		idLexer::script_p++;
+	}
+	while( lexerCharClasses[*idLexer::script_p] & nameClasses );
+
+	const int l = idLexer::script_p - start;
+	token->EnsureAlloced( token->len + l + 1, true );
+	memcpy( token->data + token->len, start, l );
+	token->len += l;
 	token->data[token->len] = '\0';
 	//the sub type is the length of the name
 	token->subtype = token->Length();
@@ -1218,6 +1424,306 @@ int idLexer::ReadToken( idToken* token )
 	return 1;
 }
 
+/*
+================
+idLexer::ReadCopiedTokenView
+
+Reads the token at the start of the last white space with ReadToken() and
+points the view at the copy.
+================
+*/
+int idLexer::ReadCopiedTokenView( idTokenView* token )
+{
+	script_p = lastScript_p;
+	line = lastline;
+
+	if( !ReadToken( &viewToken ) )
+	{
+		return 0;
+	}
+
+	token->text = viewToken.c_str();
+	token->length = viewToken.Length();
+	token->type = viewToken.type;
+	token->subtype = viewToken.subtype;
+	token->line = viewToken.line;
+	token->linesCrossed = viewToken.linesCrossed;
+	return 1;
+}
+
+/*
+================
+idLexer::ReadTokenView
+
+Same as ReadToken() but names, punctuations, plain decimal numbers and plain
+strings are returned in place. Everything else goes through ReadToken().
+================
+*/
+int idLexer::ReadTokenView( idTokenView* token )
+{
+	const char* p;
+	int c;
+
+	if( !loaded )
+	{
+		idLib::common->Error( "idLexer::ReadTokenView: no file loaded" );
+		return 0;
+	}
+
+	if( script_p == NULL )
+	{
+		return 0;
+	}
+
+	// if there is a token available (from unreadToken)
+	if( tokenavailable )
+	{
+		tokenavailable = 0;
+		viewToken = idLexer::token;
+		token->text = viewToken.c_str();
+		token->length = viewToken.Length();
+		token->type = viewToken.type;
+		token->subtype = viewToken.subtype;
+		token->line = viewToken.line;
+		token->linesCrossed = viewToken.linesCrossed;
+		return 1;
+	}
+	// save script pointer
+	lastScript_p = script_p;
+	// save line counter
+	lastline = line;
+	// start of the white space
+	whiteSpaceStart_p = script_p;
+	// read white space before token
+	if( !ReadWhiteSpace() )
+	{
+		return 0;
+	}
+	// end of the white space
+	whiteSpaceEnd_p = script_p;
+	// line the token is on
+	token->line = line;
+	// number of lines crossed before token
+	token->linesCrossed = line - lastline;
+
+	c = *script_p;
+	p = script_p;
+
+	// if there is a number
+	if( ( lexerCharClasses[c] & LCC_DIGIT ) || ( c == '.' && ( lexerCharClasses[p[1]] & LCC_DIGIT ) ) )
+	{
+		int dot = 0;
+
+		if( flags & ( LEXFL_ONLYSTRINGS | LEXFL_ALLOWNUMBERNAMES ) )
+		{
+			return ReadCopiedTokenView( token );
+		}
+
+		if( c == '0' && p[1] != '.' )
+		{
+			// hexadecimal and binary numbers are rare
+			if( p[1] == 'x' || p[1] == 'X' || p[1] == 'b' || p[1] == 'B' )
+			{
+				return ReadCopiedTokenView( token );
+			}
+			do
+			{
+				p++;
+			}
+			while( *p >= '0' && *p <= '7' );
+			token->subtype = TT_OCTAL | TT_INTEGER;
+		}
+		else
+		{
+			while( ( lexerCharClasses[*p] & LCC_DIGIT ) || *p == '.' )
+			{
+				if( *p == '.' )
+				{
+					dot++;
+				}
+				p++;
+			}
+			if( *p == 'e' && dot == 0 )
+			{
+				dot++;
+			}
+			if( dot > 1 || *p == '#' )
+			{
+				// ip addresses, float exceptions and errors
+				return ReadCopiedTokenView( token );
+			}
+			if( dot == 1 )
+			{
+				token->subtype = TT_DECIMAL | TT_FLOAT;
+				// floating point exponent
+				if( *p == 'e' )
+				{
+					p++;
+					if( *p == '-' || *p == '+' )
+					{
+						p++;
+					}
+					while( lexerCharClasses[*p] & LCC_DIGIT )
+					{
+						p++;
+					}
+				}
+			}
+			else
+			{
+				token->subtype = TT_DECIMAL | TT_INTEGER;
+			}
+		}
+
+		token->text = script_p;
+		token->length = p - script_p;
+		token->type = TT_NUMBER;
+		script_p = p;
+
+		// the suffixes aren't part of the token text
+		c = *script_p;
+		if( token->subtype & TT_FLOAT )
+		{
+			if( c == 'f' || c == 'F' )
+			{
+				token->subtype |= TT_SINGLE_PRECISION;
+				script_p++;
+			}
+			else if( c == 'l' || c == 'L' )
+			{
+				token->subtype |= TT_EXTENDED_PRECISION;
+				script_p++;
+			}
+			else
+			{
+				token->subtype |= TT_DOUBLE_PRECISION;
+			}
+		}
+		else
+		{
+			for( int i = 0; i < 2; i++ )
+			{
+				if( c == 'l' || c == 'L' )
+				{
+					token->subtype |= TT_LONG;
+				}
+				else if( c == 'u' || c == 'U' )
+				{
+					token->subtype |= TT_UNSIGNED;
+				}
+				else
+				{
+					break;
+				}
+				c = *( ++script_p );
+			}
+		}
+		return 1;
+	}
+	// if there is a leading double quote
+	else if( c == '\"' )
+	{
+		p++;
+		for( ;; )
+		{
+			if( lexerFastScan )
+			{
+				p = Lex_SkipUntil( p, end_p, '\"', '\\', '\n' );
+			}
+			if( *p == '\"' )
+			{
+				break;
+			}
+			// escape characters, errors and strings broken over several lines are read by ReadString()
+			if( *p == '\0' || *p == '\n' || ( *p == '\\' && !( flags & LEXFL_NOSTRINGESCAPECHARS ) ) )
+			{
+				return ReadCopiedTokenView( token );
+			}
+			p++;
+		}
+
+		token->text = script_p + 1;
+		token->length = p - token->text;
+		token->type = TT_STRING;
+		token->subtype = token->length;
+		script_p = p + 1;
+
+		// check for a following string that would be concatenated
+		if( !( flags & LEXFL_NOSTRINGCONCAT ) || ( flags & LEXFL_ALLOWBACKSLASHSTRINGCONCAT ) )
+		{
+			const char* tmpscript_p = script_p;
+			const int tmpline = line;
+
+			if( ReadWhiteSpace() && ( *script_p == '\"' || *script_p == '\\' ) )
+			{
+				return ReadCopiedTokenView( token );
+			}
+			script_p = tmpscript_p;
+			line = tmpline;
+		}
+		return 1;
+	}
+	// literals are rare
+	else if( c == '\'' )
+	{
+		return ReadCopiedTokenView( token );
+	}
+	// if there is a name
+	else if( ( lexerCharClasses[c] & LCC_NAMESTART ) || ( flags & LEXFL_ONLYSTRINGS ) ||
+			 ( ( flags & LEXFL_ALLOWPATHNAMES ) && ( c == '/' || c == '\\' || c == '.' ) ) )
+	{
+		int nameClasses = LCC_NAME;
+		if( flags & LEXFL_ONLYSTRINGS )
+		{
+			nameClasses |= LCC_DASH;
+		}
+		if( flags & LEXFL_ALLOWPATHNAMES )
+		{
+			nameClasses |= LCC_PATH;
+		}
+
+		do
+		{
+			p++;
+		}
+		while( lexerCharClasses[*p] & nameClasses );
+
+		token->text = script_p;
+		token->length = p - script_p;
+		token->type = TT_NAME;
+		token->subtype = token->length;
+		script_p = p;
+		return 1;
+	}
+
+	// check for punctuations, longest first
+	for( int n = punctuationtable[( byte )c]; n >= 0; n = nextpunctuation[n] )
+	{
+		const char* punc = punctuations[n].p;
+		int l;
+
+		for( l = 0; punc[l] && p[l]; l++ )
+		{
+			if( p[l] != punc[l] )
+			{
+				break;
+			}
+		}
+		if( !punc[l] )
+		{
+			token->text = script_p;
+			token->length = l;
+			token->type = TT_PUNCTUATION;
+			token->subtype = punctuations[n].n;
+			script_p += l;
+			return 1;
+		}
+	}
+
+	Error( "unknown punctuation %c", c );
+	return 0;
+}
+
 /*
 ================
 idLexer::ExpectTokenString
@@ -1466,9 +1972,9 @@ idLexer::SkipUntilString
 */
 int idLexer::SkipUntilString( const char* string )
 {
-	idToken token;
+	idTokenView token;
 
-	while( idLexer::ReadToken( &token ) )
+	while( idLexer::ReadTokenView( &token ) )
 	{
 		if( token == string )
 		{
@@ -1485,9 +1991,9 @@ idLexer::SkipRestOfLine
 */
 int idLexer::SkipRestOfLine()
 {
-	idToken token;
+	idTokenView token;
 
-	while( idLexer::ReadToken( &token ) )
+	while( idLexer::ReadTokenView( &token ) )
 	{
 		if( token.linesCrossed )
 		{
@@ -1509,10 +2015,10 @@ Internal brace depths are properly skipped.
 */
 int idLexer::SkipBracedSection( bool parseFirstBrace, braceSkipMode_t skipMode/* = BRSKIP_BRACE */, int* skipped /*= nullptr*/ )
 {
-	idToken token;
+	idTokenView token;
 	int depth;
-	idStr openTokens[2] = { "{" , "["   };
-	idStr closeTokens[2] = { "}" , "]" };
+	const char* openTokens[2] = { "{" , "["   };
+	const char* closeTokens[2] = { "}" , "]" };
 
 	if( skipped != nullptr )
 	{
@@ -1523,7 +2029,7 @@ int idLexer::SkipBracedSection( bool parseFirstBrace, braceSkipMode_t skipMode/*
 	depth = parseFirstBrace ? 0 : 1;
 	do
 	{
-		if( !ReadToken( &token ) )
+		if( !ReadTokenView( &token ) )
 		{
 			return false;
 		}
@@ -2444,3 +2950,137 @@ bool idLexer::HadError() const
 	return hadError;
 }
 
+
+/*
+================
+Lex_TokenHash
+================
+*/
+static ID_INLINE unsigned int Lex_TokenHash( unsigned int hash, const char* text, int length, int type, int subtype, int line )
+{
+	for( int i = 0; i < length; i++ )
+	{
+		hash = ( hash ^ ( byte )text[i] ) * 16777619u;
+	}
+	return ( ( hash ^ type ) * 16777619u ^ subtype ) * 16777619u + line;
+}
+
+/*
+================
+TestLexer_f
+================
+*/
+CONSOLE_COMMAND( testLexer, "reads all tokens from the text files in a folder and reports MB/s", 0 )
+{
+	static const char* defaultExtensions[] = { ".def", ".mtr", ".map", ".md5mesh", ".md5anim", ".script", ".gui", ".skin", ".sndshd", ".prt", ".fx", ".af", ".pda", ".lipsync" };
+	const int lexFlags = LEXFL_NOSTRINGCONCAT | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS |
+						 LEXFL_ALLOWBACKSLASHSTRINGCONCAT | LEXFL_NOFATALERRORS | LEXFL_NOERRORS | LEXFL_NOWARNINGS;
+
+	idStrList extensions;
+	idStrList fileNames;
+	idList<char*> buffers;
+	idList<int> lengths;
+	int64_t totalBytes = 0;
+
+	const char* folder = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "";
+	for( int i = 2; i < args.Argc(); i++ )
+	{
+		extensions.Append( args.Argv( i ) );
+	}
+	if( extensions.Num() == 0 )
+	{
+		for( int i = 0; i < sizeof( defaultExtensions ) / sizeof( defaultExtensions[0] ); i++ )
+		{
+			extensions.Append( defaultExtensions[i] );
+		}
+	}
+
+	for( int i = 0; i < extensions.Num(); i++ )
+	{
+		idFileList* files = fileSystem->ListFilesTree( folder, extensions[i], true );
+		for( int j = 0; j < files->GetNumFiles(); j++ )
+		{
+			void* buffer;
+			const int length = fileSystem->ReadFile( files->GetFile( j ), &buffer );
+			if( length <= 0 || buffer == NULL )
+			{
+				continue;
+			}
+			fileNames.Append( files->GetFile( j ) );
+			buffers.Append( ( char* )buffer );
+			lengths.Append( length );
+			totalBytes += length;
+		}
+		fileSystem->FreeFileList( files );
+	}
+
+	if( buffers.Num() == 0 )
+	{
+		common->Printf( "usage: testLexer [folder] [extensions...]\n" );
+		return;
+	}
+
+	static const struct
+	{
+		const char*	name;
+		bool		fastScan;
+		bool		views;
+	} tests[] =
+	{
+		{ "ReadToken, scalar scan", false, false },
+		{ "ReadToken, SIMD scan", true, false },
+		{ "ReadTokenView, SIMD scan", true, true },
+	};
+
+	common->Printf( "%d files, %.1f MB\n", buffers.Num(), totalBytes / ( 1024.0f * 1024.0f ) );
+
+	unsigned int referenceHash = 0;
+	for( int t = 0; t < sizeof( tests ) / sizeof( tests[0] ); t++ )
+	{
+		idToken token;
+		idTokenView view;
+		unsigned int hash = 2166136261u;
+		int numTokens = 0;
+
+		lexerFastScan = tests[t].fastScan;
+
+		const uint64_t start = Sys_Microseconds();
+		for( int i = 0; i < buffers.Num(); i++ )
+		{
+			idLexer src( lexFlags );
+			src.LoadMemory( buffers[i], lengths[i], fileNames[i] );
+			if( tests[t].views )
+			{
+				while( src.ReadTokenView( &view ) )
+				{
+					hash = Lex_TokenHash( hash, view.text, view.length, view.type, view.subtype, view.line );
+					numTokens++;
+				}
+			}
+			else
+			{
+				while( src.ReadToken( &token ) )
+				{
+					hash = Lex_TokenHash( hash, token.c_str(), token.Length(), token.type, token.subtype, token.line );
+					numTokens++;
+				}
+			}
+		}
+		const float seconds = ( Sys_Microseconds() - start ) / 1000000.0f;
+
+		if( t == 0 )
+		{
+			referenceHash = hash;
+		}
+
+		common->Printf( "%-26s %9d tokens in %7.1f ms, %7.1f MB/s%s\n", tests[t].name, numTokens, seconds * 1000.0f,
+						totalBytes / ( 1024.0f * 1024.0f ) / Max( seconds, 0.000001f ), ( hash != referenceHash ) ? ", TOKENS DIFFER" : "" );
+	}
+
+	lexerFastScan = true;
+
+	for( int i = 0; i < buffers.Num(); i++ )
+	{
+		fileSystem->FreeFile( buffers[i] );
+	}
+}
@@ -142,6 +142,65 @@ typedef struct punctuation_s
 } punctuation_t;
 
 
+/*
+===============================================================================
+
+	idTokenView is a token read with idLexer::ReadTokenView(). Instead of
+	owning a copy of the token text it points into the script buffer, and the
+	text is not zero terminated. Strings with escape characters or that are
+	concatenated, and other tokens that don't appear literally in the script,
+	point into the lexer instead and are only valid until the next read.
+
+===============================================================================
+*/
+
+class idTokenView
+{
+public:
+	const char* 	text;					// token text, not zero terminated
+	int				length;					// length of the token text
+	int				type;					// token type
+	int				subtype;				// token sub type
+	int				line;					// line in script the token was on
+	int				linesCrossed;			// number of lines crossed in white space before token
+
+	int				Cmp( const char* str ) const;
+	int				Icmp( const char* str ) const;
+	bool			operator==( const char* str ) const
+	{
+		return Cmp( str ) == 0;
+	}
+	bool			operator!=( const char* str ) const
+	{
+		return Cmp( str ) != 0;
+	}
+	// copy the text into a string
+	void			ToString( idStr& out ) const
+	{
+		out.CopyRange( text, 0, length );
+	}
+};
+
+ID_INLINE int idTokenView::Cmp( const char* str ) const
+{
+	int c = idStr::Cmpn( text, str, length );
+	if( c == 0 && str[length] != '\0' )
+	{
+		c = -1;
+	}
+	return c;
+}
+
+ID_INLINE int idTokenView::Icmp( const char* str ) const
+{
+	int c = idStr::Icmpn( text, str, length );
+	if( c == 0 && str[length] != '\0' )
+	{
+		c = -1;
+	}
+	return c;
+}
+
 class idLexer
 {
 
@@ -170,6 +229,8 @@ public:
 	};
 	// read a token
 	int				ReadToken( idToken* token );
+	// read a token without copying its text, see idTokenView
+	int				ReadTokenView( idTokenView* token );
 	// expect a certain token, reads the token when available
 	int				ExpectTokenString( const char* string );
 	// expect a certain token type
@@ -282,6 +343,7 @@ private:
 	int* 			punctuationtable;		// ASCII table with punctuations
 	int* 			nextpunctuation;		// next punctuation in chain
 	idToken			token;					// available token
+	idToken			viewToken;				// copied text of the last idTokenView that isn't in the script
 	idLexer* 		next;					// next script in a chain
 	bool			hadError;				// set by idLexer::Error, even if the error is supressed
 
@@ -296,6 +358,7 @@ private:
 	int				ReadNumber( idToken* token );
 	int				ReadPunctuation( idToken* token );
 	int				ReadPrimitive( idToken* token );
+	int				ReadCopiedTokenView( idTokenView* token );
 	int				CheckString( const char* str ) const;
 	int				NumLinesCrossed();
 };
@@ -336,6 +336,7 @@ public:
 #include "Swap.h"
 #include "Callback.h"
 #include "ParallelJobList.h"
+#include "Profiler.h"
 #include "SoftwareCache.h"
 #include "TileMap.h" // RB
 #include "Serializer.h"
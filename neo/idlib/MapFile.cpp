@@ -1846,6 +1846,10 @@ MapPolygonMesh::MapPolygonMesh()
 	originalType = TYPE_MESH;
 	polygons.Resize( 8, 4 );
 
+	// converted models and terrain meshes can have hundreds of thousands of vertices
+	verts.SetGeometricGrowth( true );
+	polygons.SetGeometricGrowth( true );
+
 	contents = CONTENTS_SOLID;
 	opaque = true;
 }
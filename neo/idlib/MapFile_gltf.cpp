@@ -34,62 +34,426 @@ If you have questions concerning this license or the applicable additional terms
 static const idMat4 blenderToDoomTransform( idAngles( 0.0f, 0.0f, 90 ).ToMat3(), vec3_origin );
 //static const idMat4 blenderToDoomTransform = mat4_identity;
 
-MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* prim, gltfData* _data , const idMat4& transform )
+idCVar gltf_decodeJobs( "gltf_decodeJobs", "1", CVAR_SYSTEM | CVAR_BOOL | CVAR_NEW, "decode glTF vertex attributes straight from the buffers in parallel jobs, 0 = read them through idFile_Memory" );
+
+// one vertex attribute of a primitive as it is laid out in its buffer
+struct gltfAttributeStream_t
 {
-	MapPolygonMesh* mesh = new MapPolygonMesh();
-	gltfAccessor* accessor = _data->AccessorList()[prim->indices];
-	gltfBufferView* bv = _data->BufferViewList()[accessor->bufferView];
-	gltfData* data = bv->parent;
+	gltfMesh_Primitive_Attribute::Type	type;
+	const byte* 	src;
+	int				stride;
+	int				typeSize;
+	int				numComponents;
+	int				count;
+};
 
-	gltfMaterial* mat = NULL;
-	if( prim->material != -1 )
+struct gltfDecodeJob_t
+{
+	const gltfAttributeStream_t* 	streams;
+	int								numStreams;
+	const idMat4* 					transform;
+	idDrawVert* 					verts;
+	int								firstVert;
+	int								numVerts;
+};
+
+// vertices per decode job
+static const int GLTF_DECODE_BATCH = 8192;
+
+/*
+============
+ReadComponentsGltf
+============
+*/
+template< typename T >
+static ID_INLINE void ReadComponentsGltf( const byte* src, int typeSize, T* dst, int numComponents )
+{
+	const int size = Min( typeSize, ( int )sizeof( T ) );
+	for( int c = 0; c < numComponents; c++ )
 	{
-		mat = _data->MaterialList()[prim->material];
+		memcpy( &dst[c], src + c * typeSize, size );
 	}
+}
 
-	gltfBuffer* buff = data->BufferList()[bv->buffer];
-	uint idxDataSize = sizeof( uint ) * accessor->count;
-	uint* indices = ( uint* ) Mem_ClearedAlloc( idxDataSize , TAG_IDLIB_GLTF );
+/*
+============
+AttributeComponentsGltf
+
+Number of components an attribute is decoded from
+============
+*/
+static int AttributeComponentsGltf( gltfMesh_Primitive_Attribute::Type type )
+{
+	switch( type )
+	{
+		case gltfMesh_Primitive_Attribute::Type::TexCoord0:
+			return 2;
+		case gltfMesh_Primitive_Attribute::Type::Position:
+		case gltfMesh_Primitive_Attribute::Type::Normal:
+			return 3;
+		default:
+			return 4;
+	}
+}
+
+/*
+============
+AccessorComponentsGltf
+
+Number of components per element of an accessor, 0 for an unknown type
+============
+*/
+static int AccessorComponentsGltf( const idStr& type )
+{
+	if( type == "SCALAR" )
+	{
+		return 1;
+	}
+	else if( type == "VEC2" )
+	{
+		return 2;
+	}
+	else if( type == "VEC3" )
+	{
+		return 3;
+	}
+	else if( type == "VEC4" || type == "MAT2" )
+	{
+		return 4;
+	}
+	else if( type == "MAT3" )
+	{
+		return 9;
+	}
+	else if( type == "MAT4" )
+	{
+		return 16;
+	}
+	return 0;
+}
 
-	idFile_Memory idxBin = idFile_Memory( "gltfChunkIndices",
-										  ( const char* )( ( data->GetData( bv->buffer ) + bv->byteOffset + accessor->byteOffset ) ), bv->byteLength );
+/*
+============
+DecodeAttributeRangeGltf
+============
+*/
+static void DecodeAttributeRangeGltf( const gltfAttributeStream_t& stream, const idMat4& transform, idDrawVert* verts, int first, int end )
+{
+	end = Min( end, stream.count );
 
-	for( int i = 0; i < accessor->count; i++ )
+	const byte* src = stream.src + first * stream.stride;
+
+	switch( stream.type )
 	{
-		idxBin.Read( ( void* )( &indices[i] ), accessor->typeSize );
-		if( bv->byteStride )
+		case gltfMesh_Primitive_Attribute::Type::Position:
+		{
+			for( int i = first; i < end; i++, src += stream.stride )
+			{
+				idVec3 pos( 0.0f, 0.0f, 0.0f );
+				ReadComponentsGltf( src, stream.typeSize, pos.ToFloatPtr(), stream.numComponents );
+
+				// move into entity space
+				pos *= transform;
+
+				verts[i].xyz = pos;
+			}
+			break;
+		}
+
+		case gltfMesh_Primitive_Attribute::Type::Normal:
+		{
+			for( int i = first; i < end; i++, src += stream.stride )
+			{
+				idVec3 vec( 0.0f, 0.0f, 0.0f );
+				ReadComponentsGltf( src, stream.typeSize, vec.ToFloatPtr(), stream.numComponents );
+
+				// w = 0 because we only want to rotate the normal
+				idVec4 normal4D( vec.x, vec.y, vec.z, 0.0f );
+				normal4D *= transform;
+
+				idVec3 normal = normal4D.ToVec3();
+				// renormalize because previous transforms may contain scale operations
+				normal.Normalize();
+
+				verts[i].SetNormal( normal );
+			}
+			break;
+		}
+
+		case gltfMesh_Primitive_Attribute::Type::TexCoord0:
+		{
+			for( int i = first; i < end; i++, src += stream.stride )
+			{
+				idVec2 vec( 0.0f, 0.0f );
+				ReadComponentsGltf( src, stream.typeSize, vec.ToFloatPtr(), stream.numComponents );
+
+				verts[i].SetTexCoord( vec );
+			}
+			break;
+		}
+
+		case gltfMesh_Primitive_Attribute::Type::Tangent:
+		{
+			for( int i = first; i < end; i++, src += stream.stride )
+			{
+				idVec4 vec( 0.0f, 0.0f, 0.0f, 0.0f );
+				ReadComponentsGltf( src, stream.typeSize, vec.ToFloatPtr(), stream.numComponents );
+
+				idVec4 tangent4D( vec.x, vec.y, vec.z, 0.0f );
+				tangent4D *= transform;
+
+				idVec3 tangent = tangent4D.ToVec3();
+				tangent.Normalize();
+
+				verts[i].SetTangent( tangent );
+				verts[i].SetBiTangentSign( vec.w );
+			}
+			break;
+		}
+
+		case gltfMesh_Primitive_Attribute::Type::Weight:
 		{
-			idxBin.Seek( bv->byteStride - accessor->typeSize, FS_SEEK_CUR );
+			for( int i = first; i < end; i++, src += stream.stride )
+			{
+				idVec4 vec( 0.0f, 0.0f, 0.0f, 0.0f );
+				ReadComponentsGltf( src, stream.typeSize, vec.ToFloatPtr(), stream.numComponents );
+
+				verts[i].SetColor2( PackColor( vec ) );
+			}
+			break;
+		}
+
+		case gltfMesh_Primitive_Attribute::Type::Color0:
+		{
+			for( int i = first; i < end; i++, src += stream.stride )
+			{
+				if( stream.typeSize == 4 )
+				{
+					idVec4 vec( 0.0f, 0.0f, 0.0f, 0.0f );
+					ReadComponentsGltf( src, stream.typeSize, vec.ToFloatPtr(), stream.numComponents );
+
+					verts[i].color[0] = idMath::Ftob( vec.x * 255.0f );
+					verts[i].color[1] = idMath::Ftob( vec.y * 255.0f );
+					verts[i].color[2] = idMath::Ftob( vec.z * 255.0f );
+					verts[i].color[3] = 255;
+				}
+				else if( stream.typeSize == 2 )
+				{
+					uint16_t vec[4] = { 0, 0, 0, 0 };
+					ReadComponentsGltf( src, stream.typeSize, vec, stream.numComponents );
+
+					verts[i].color[0] = idMath::Ftob( ( vec[0] * 1.0f / 65335 ) * 255.0f );
+					verts[i].color[1] = idMath::Ftob( ( vec[1] * 1.0f / 65335 ) * 255.0f );
+					verts[i].color[2] = idMath::Ftob( ( vec[2] * 1.0f / 65335 ) * 255.0f );
+					verts[i].color[3] = 255;
+				}
+				else
+				{
+					uint8_t vec[4] = { 0, 0, 0, 255 };
+					ReadComponentsGltf( src, stream.typeSize, vec, stream.numComponents );
+
+					verts[i].color[0] = vec[0];
+					verts[i].color[1] = vec[1];
+					verts[i].color[2] = vec[2];
+					verts[i].color[3] = vec[3];
+				}
+			}
+			break;
+		}
+
+		case gltfMesh_Primitive_Attribute::Type::Joints:
+		{
+			for( int i = first; i < end; i++, src += stream.stride )
+			{
+				if( stream.typeSize == 2 )
+				{
+					uint16_t vec[4] = { 0, 0, 0, 0 };
+					ReadComponentsGltf( src, stream.typeSize, vec, stream.numComponents );
+
+					verts[i].color[0] = vec[0];
+					verts[i].color[1] = vec[1];
+					verts[i].color[2] = vec[2];
+					verts[i].color[3] = vec[3];
+				}
+				else
+				{
+					uint8_t vec[4] = { 0, 0, 0, 0 };
+					ReadComponentsGltf( src, stream.typeSize, vec, stream.numComponents );
+
+					verts[i].color[0] = vec[0];
+					verts[i].color[1] = vec[1];
+					verts[i].color[2] = vec[2];
+					verts[i].color[3] = vec[3];
+				}
+			}
+			break;
 		}
+
+		default:
+			break;
 	}
+}
 
-	int polyCount = accessor->count / 3;
+/*
+============
+DecodeAttributesGltfJob
 
-	mesh->polygons.AssureSize( polyCount );
-	mesh->polygons.SetNum( polyCount );
+Decodes all attributes for a range of vertices, in the same order as the
+serial reader so attributes that share a vertex field resolve the same way
+============
+*/
+static void DecodeAttributesGltfJob( gltfDecodeJob_t* job )
+{
+	for( int s = 0; s < job->numStreams; s++ )
+	{
+		DecodeAttributeRangeGltf( job->streams[s], *job->transform, job->verts, job->firstVert, job->firstVert + job->numVerts );
+	}
+}
 
-	int cnt = 0;
-	for( int i = 0; i < accessor->count; i += 3 )
+REGISTER_PARALLEL_JOB( DecodeAttributesGltfJob, "DecodeAttributesGltfJob" );
+
+/*
+============
+SetupAttributeStreamGltf
+
+Fills in the stream of an attribute, returns false if the accessor does not fit
+inside its buffer view or the view does not fit inside its buffer
+============
+*/
+static bool SetupAttributeStreamGltf( const gltfMesh_Primitive_Attribute* attrib, gltfData* data, gltfAttributeStream_t& stream )
+{
+	if( attrib->accessorIndex < 0 || attrib->accessorIndex >= data->AccessorList().Num() )
 	{
-		MapPolygon& polygon = mesh->polygons[cnt++];
+		return false;
+	}
+	gltfAccessor* attrAcc = data->AccessorList()[attrib->accessorIndex];
 
-		if( mat != NULL )
+	if( attrAcc->bufferView < 0 || attrAcc->bufferView >= data->BufferViewList().Num() )
+	{
+		return false;
+	}
+	gltfBufferView* attrBv = data->BufferViewList()[attrAcc->bufferView];
+	gltfData* attrData = attrBv->parent;
+
+	if( attrBv->buffer < 0 || attrBv->buffer >= attrData->BufferList().Num() )
+	{
+		return false;
+	}
+	gltfBuffer* attrBuff = attrData->BufferList()[attrBv->buffer];
+
+	const int accessorComponents = AccessorComponentsGltf( attrAcc->type );
+	const int elementComponents = accessorComponents > 0 ? accessorComponents : AttributeComponentsGltf( attrib->type );
+
+	stream.type = attrib->type;
+	stream.typeSize = attrAcc->typeSize;
+	stream.numComponents = Min( AttributeComponentsGltf( attrib->type ), elementComponents );
+	stream.stride = attrBv->byteStride ? attrBv->byteStride : elementComponents * attrAcc->typeSize;
+	stream.count = attrAcc->count;
+
+	if( stream.count < 0 || stream.typeSize <= 0 || stream.stride < 0 || attrBv->byteOffset < 0 || attrBv->byteLength < 0 || attrAcc->byteOffset < 0 )
+	{
+		return false;
+	}
+
+	// the view has to lie inside the buffer
+	if( attrBuff->byteLength >= 0 && ( int64_t )attrBv->byteOffset + attrBv->byteLength > attrBuff->byteLength )
+	{
+		return false;
+	}
+
+	// and every component the decoder reads has to lie inside the view
+	if( stream.count > 0 )
+	{
+		const int64_t extent = ( int64_t )attrAcc->byteOffset + ( int64_t )( stream.count - 1 ) * stream.stride + ( int64_t )stream.numComponents * stream.typeSize;
+		if( extent > attrBv->byteLength )
 		{
-			polygon.SetMaterial( mat->name );
+			return false;
 		}
-		else
+	}
+
+	stream.src = attrData->GetData( attrBv->buffer ) + attrBv->byteOffset + attrAcc->byteOffset;
+
+	return true;
+}
+
+/*
+============
+DecodeAttributesGltf
+
+Converts the vertex attributes of a primitive straight from the buffer data
+without intermediate copies, large primitives are split over parallel jobs.
+Returns false without touching the verts if any attribute stream is out of bounds
+============
+*/
+static bool DecodeAttributesGltf( const gltfMesh_Primitive* prim, gltfData* data, const idMat4& transform, idList<idDrawVert>& verts )
+{
+	idList<gltfAttributeStream_t> streams;
+	streams.SetNum( prim->attributes.Num() );
+
+	for( int a = 0; a < prim->attributes.Num(); a++ )
+	{
+		if( !SetupAttributeStreamGltf( prim->attributes[a], data, streams[a] ) )
 		{
-			polygon.SetMaterial( "textures/base_wall/snpanel2rust" );
+			return false;
 		}
+	}
 
-		polygon.AddIndex( indices[i + 2] );
-		polygon.AddIndex( indices[i + 1] );
-		polygon.AddIndex( indices[i + 0] );
+	if( streams.Num() == 0 )
+	{
+		return true;
 	}
 
-	assert( cnt == polyCount );
+	const int numVerts = streams[0].count;
+	verts.AssureSize( numVerts );
+	memset( verts.Ptr(), 0, numVerts * sizeof( idDrawVert ) );
 
-	Mem_Free( indices );
+	idList<gltfDecodeJob_t> jobs;
+	jobs.SetNum( ( numVerts + GLTF_DECODE_BATCH - 1 ) / GLTF_DECODE_BATCH );
+
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		gltfDecodeJob_t& job = jobs[i];
+		job.streams = streams.Ptr();
+		job.numStreams = streams.Num();
+		job.transform = &transform;
+		job.verts = verts.Ptr();
+		job.firstVert = i * GLTF_DECODE_BATCH;
+		job.numVerts = Min( GLTF_DECODE_BATCH, numVerts - job.firstVert );
+	}
+
+	// nested job lists are not allowed, so only go wide from the main thread
+	if( jobs.Num() > 1 && idLib::IsMainThread() )
+	{
+		idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, jobs.Num(), 0, NULL );
+		for( int i = 0; i < jobs.Num(); i++ )
+		{
+			jobList->AddJob( ( jobRun_t )DecodeAttributesGltfJob, &jobs[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+		parallelJobManager->FreeJobList( jobList );
+	}
+	else
+	{
+		for( int i = 0; i < jobs.Num(); i++ )
+		{
+			DecodeAttributesGltfJob( &jobs[i] );
+		}
+	}
+
+	return true;
+}
+
+/*
+============
+ReadAttributesGltf
+
+Reads the vertex attributes of a primitive through idFile_Memory one component
+at a time, this is the reference for DecodeAttributesGltf
+============
+*/
+static void ReadAttributesGltf( const gltfMesh_Primitive* prim, gltfData* data, const idMat4& transform, idList<idDrawVert>& verts )
+{
 	bool sizeSet = false;
 
 	//for( const auto& attrib : prim->attributes )
@@ -107,7 +471,8 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 
 		if( !sizeSet )
 		{
-			mesh->verts.AssureSize( attrAcc->count );
+			verts.AssureSize( attrAcc->count );
+			memset( verts.Ptr(), 0, verts.Num() * sizeof( idDrawVert ) );
 			sizeSet = true;
 		}
 
@@ -126,9 +491,9 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 					// move into entity space
 					pos *= transform;
 
-					mesh->verts[i].xyz.x = pos.x;
-					mesh->verts[i].xyz.y = pos.y;
-					mesh->verts[i].xyz.z = pos.z;
+					verts[i].xyz.x = pos.x;
+					verts[i].xyz.y = pos.y;
+					verts[i].xyz.z = pos.z;
 
 					if( attrBv->byteStride )
 					{
@@ -161,7 +526,7 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 					// renormalize because previous transforms may contain scale operations
 					normal.Normalize();
 
-					mesh->verts[i].SetNormal( normal );
+					verts[i].SetNormal( normal );
 				}
 
 				break;
@@ -180,7 +545,7 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 					}
 
 					//vec.y = 1.0f - vec.y;
-					mesh->verts[i].SetTexCoord( vec );
+					verts[i].SetTexCoord( vec );
 				}
 
 				break;
@@ -206,8 +571,8 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 					idVec3 tangent = tangent4D.ToVec3();
 					tangent.Normalize();
 
-					mesh->verts[i].SetTangent( tangent );
-					mesh->verts[i].SetBiTangentSign( vec.w );
+					verts[i].SetTangent( tangent );
+					verts[i].SetBiTangentSign( vec.w );
 				}
 				break;
 			}
@@ -226,7 +591,7 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 						bin.Seek( attrBv->byteStride - ( attrib->elementSize * attrAcc->typeSize ), FS_SEEK_CUR );
 					}
 
-					mesh->verts[i].SetColor2( PackColor( vec ) );
+					verts[i].SetColor2( PackColor( vec ) );
 
 				}
 				break;
@@ -254,10 +619,10 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 							bin.Seek( attrBv->byteStride - ( attrib->elementSize * attrAcc->typeSize ), FS_SEEK_CUR );
 						}
 
-						mesh->verts[i].color[0] = idMath::Ftob( vec.x * 255.0f );
-						mesh->verts[i].color[1] = idMath::Ftob( vec.y * 255.0f );
-						mesh->verts[i].color[2] = idMath::Ftob( vec.z * 255.0f );
-						mesh->verts[i].color[3] = 255;
+						verts[i].color[0] = idMath::Ftob( vec.x * 255.0f );
+						verts[i].color[1] = idMath::Ftob( vec.y * 255.0f );
+						verts[i].color[2] = idMath::Ftob( vec.z * 255.0f );
+						verts[i].color[3] = 255;
 					}
 				}
 				else if( attrAcc->typeSize == 2 )
@@ -277,10 +642,10 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 							bin.Seek( attrBv->byteStride - ( attrib->elementSize * attrAcc->typeSize ), FS_SEEK_CUR );
 						}
 
-						mesh->verts[i].color[0] = idMath::Ftob( ( vec[0] * 1.0f / 65335 ) * 255.0f );
-						mesh->verts[i].color[1] = idMath::Ftob( ( vec[1] * 1.0f / 65335 ) * 255.0f );
-						mesh->verts[i].color[2] = idMath::Ftob( ( vec[2] * 1.0f / 65335 ) * 255.0f );
-						mesh->verts[i].color[3] = 255;
+						verts[i].color[0] = idMath::Ftob( ( vec[0] * 1.0f / 65335 ) * 255.0f );
+						verts[i].color[1] = idMath::Ftob( ( vec[1] * 1.0f / 65335 ) * 255.0f );
+						verts[i].color[2] = idMath::Ftob( ( vec[2] * 1.0f / 65335 ) * 255.0f );
+						verts[i].color[3] = 255;
 					}
 				}
 				else
@@ -299,10 +664,10 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 							bin.Seek( attrBv->byteStride - ( attrib->elementSize * attrAcc->typeSize ), FS_SEEK_CUR );
 						}
 
-						mesh->verts[i].color[0] = vec[0];
-						mesh->verts[i].color[1] = vec[1];
-						mesh->verts[i].color[2] = vec[2];
-						mesh->verts[i].color[3] = vec[3];
+						verts[i].color[0] = vec[0];
+						verts[i].color[1] = vec[1];
+						verts[i].color[2] = vec[2];
+						verts[i].color[3] = vec[3];
 					}
 				}
 				break;
@@ -327,10 +692,10 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 							bin.Seek( attrBv->byteStride - ( attrib->elementSize * attrAcc->typeSize ), FS_SEEK_CUR );
 						}
 
-						mesh->verts[i].color[0] = vec[0];
-						mesh->verts[i].color[1] = vec[1];
-						mesh->verts[i].color[2] = vec[2];
-						mesh->verts[i].color[3] = vec[3];
+						verts[i].color[0] = vec[0];
+						verts[i].color[1] = vec[1];
+						verts[i].color[2] = vec[2];
+						verts[i].color[3] = vec[3];
 					}
 				}
 				else
@@ -349,10 +714,10 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 							bin.Seek( attrBv->byteStride - ( attrib->elementSize * attrAcc->typeSize ), FS_SEEK_CUR );
 						}
 
-						mesh->verts[i].color[0] = vec[0];
-						mesh->verts[i].color[1] = vec[1];
-						mesh->verts[i].color[2] = vec[2];
-						mesh->verts[i].color[3] = vec[3];
+						verts[i].color[0] = vec[0];
+						verts[i].color[1] = vec[1];
+						verts[i].color[2] = vec[2];
+						verts[i].color[3] = vec[3];
 					}
 				}
 				break;
@@ -360,6 +725,90 @@ MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* p
 		}
 
 	}
+}
+
+MapPolygonMesh* MapPolygonMesh::ConvertFromMeshGltf( const gltfMesh_Primitive* prim, gltfData* _data , const idMat4& transform )
+{
+	MapPolygonMesh* mesh = new MapPolygonMesh();
+	gltfAccessor* accessor = _data->AccessorList()[prim->indices];
+	gltfBufferView* bv = _data->BufferViewList()[accessor->bufferView];
+	gltfData* data = bv->parent;
+
+	gltfMaterial* mat = NULL;
+	if( prim->material != -1 )
+	{
+		mat = _data->MaterialList()[prim->material];
+	}
+
+	gltfBuffer* buff = data->BufferList()[bv->buffer];
+	uint idxDataSize = sizeof( uint ) * accessor->count;
+	uint* indices = ( uint* ) Mem_ClearedAlloc( idxDataSize , TAG_IDLIB_GLTF );
+
+	if( gltf_decodeJobs.GetBool() )
+	{
+		// read straight from the buffer
+		const byte* src = data->GetData( bv->buffer ) + bv->byteOffset + accessor->byteOffset;
+		const int stride = bv->byteStride ? bv->byteStride : accessor->typeSize;
+		const int typeSize = Min( ( int )accessor->typeSize, ( int )sizeof( uint ) );
+
+		for( int i = 0; i < accessor->count; i++ )
+		{
+			memcpy( &indices[i], src + i * stride, typeSize );
+		}
+	}
+	else
+	{
+		idFile_Memory idxBin = idFile_Memory( "gltfChunkIndices",
+											  ( const char* )( ( data->GetData( bv->buffer ) + bv->byteOffset + accessor->byteOffset ) ), bv->byteLength );
+
+		for( int i = 0; i < accessor->count; i++ )
+		{
+			idxBin.Read( ( void* )( &indices[i] ), accessor->typeSize );
+			if( bv->byteStride )
+			{
+				idxBin.Seek( bv->byteStride - accessor->typeSize, FS_SEEK_CUR );
+			}
+		}
+	}
+
+	int polyCount = accessor->count / 3;
+
+	mesh->polygons.AssureSize( polyCount );
+	mesh->polygons.SetNum( polyCount );
+
+	int cnt = 0;
+	for( int i = 0; i < accessor->count; i += 3 )
+	{
+		MapPolygon& polygon = mesh->polygons[cnt++];
+
+		if( mat != NULL )
+		{
+			polygon.SetMaterial( mat->name );
+		}
+		else
+		{
+			polygon.SetMaterial( "textures/base_wall/snpanel2rust" );
+		}
+
+		polygon.AddIndex( indices[i + 2] );
+		polygon.AddIndex( indices[i + 1] );
+		polygon.AddIndex( indices[i + 0] );
+	}
+
+	assert( cnt == polyCount );
+
+	Mem_Free( indices );
+
+	if( !gltf_decodeJobs.GetBool() )
+	{
+		ReadAttributesGltf( prim, data, transform, mesh->verts );
+	}
+	else if( !DecodeAttributesGltf( prim, data, transform, mesh->verts ) )
+	{
+		// idFile_Memory keeps the reference path inside the buffer views
+		common->Warning( "%s: vertex attributes exceed their buffer views, decoding through the reference path", data->FileName().c_str() );
+		ReadAttributesGltf( prim, data, transform, mesh->verts );
+	}
 
 	mesh->SetContents();
 
@@ -689,3 +1138,84 @@ int idMapEntity::GetEntities( gltfData* data, EntityListRef entities, int sceneI
 
 	return entityCount;
 }
+
+/*
+============
+TestGltfDecode_f
+
+Converts every mesh primitive of a glTF asset with both the idFile_Memory reader
+and the job based decoder, checks that they produce the same verts and reports
+how long each took
+============
+*/
+CONSOLE_COMMAND( testGltfDecode, "compares the job based glTF vertex decoder against the idFile_Memory reader", idCmdSystem::ArgCompletion_MapName )
+{
+	if( args.Argc() < 2 )
+	{
+		common->Printf( "usage: testGltfDecode <file.gltf|file.glb>\n" );
+		return;
+	}
+
+	GLTF_Parser gltf;
+
+	uint64_t start = Sys_Microseconds();
+	if( !gltf.Load( args.Argv( 1 ) ) )
+	{
+		common->Printf( "couldn't load %s\n", args.Argv( 1 ) );
+		return;
+	}
+	const uint64_t loadMicroSec = Sys_Microseconds() - start;
+
+	gltfData* data = gltf.currentAsset;
+	const bool decodeJobs = gltf_decodeJobs.GetBool();
+
+	uint64_t readMicroSec = 0;
+	uint64_t decodeMicroSec = 0;
+	int numPrims = 0;
+	int numVerts = 0;
+	int mismatches = 0;
+
+	for( gltfMesh* gltfMesh : data->MeshList() )
+	{
+		for( gltfMesh_Primitive* prim : gltfMesh->primitives )
+		{
+			if( prim->indices == -1 )
+			{
+				continue;
+			}
+
+			gltf_decodeJobs.SetBool( false );
+			start = Sys_Microseconds();
+			MapPolygonMesh* readMesh = MapPolygonMesh::ConvertFromMeshGltf( prim, data, blenderToDoomTransform );
+			readMicroSec += Sys_Microseconds() - start;
+
+			gltf_decodeJobs.SetBool( true );
+			start = Sys_Microseconds();
+			MapPolygonMesh* decodeMesh = MapPolygonMesh::ConvertFromMeshGltf( prim, data, blenderToDoomTransform );
+			decodeMicroSec += Sys_Microseconds() - start;
+
+			const idList<idDrawVert>& readVerts = readMesh->GetDrawVerts();
+			const idList<idDrawVert>& decodeVerts = decodeMesh->GetDrawVerts();
+
+			if( readVerts.Num() != decodeVerts.Num() || memcmp( readVerts.Ptr(), decodeVerts.Ptr(), readVerts.Num() * sizeof( idDrawVert ) ) != 0 )
+			{
+				if( mismatches++ == 0 )
+				{
+					common->Printf( "mesh %s differs: %d read verts, %d decoded verts\n", gltfMesh->name.c_str(), readVerts.Num(), decodeVerts.Num() );
+				}
+			}
+
+			numPrims++;
+			numVerts += readVerts.Num();
+
+			delete readMesh;
+			delete decodeMesh;
+		}
+	}
+
+	gltf_decodeJobs.SetBool( decodeJobs );
+
+	common->Printf( "%s: loaded in %.2f ms, %d primitives, %d verts, %d mismatched primitives\n", args.Argv( 1 ), loadMicroSec / 1000.0f, numPrims, numVerts, mismatches );
+	common->Printf( "idFile_Memory reader %8.2f ms\n", readMicroSec / 1000.0f );
+	common->Printf( "job decoder          %8.2f ms\n", decodeMicroSec / 1000.0f );
+}
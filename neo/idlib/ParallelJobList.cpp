@@ -42,6 +42,7 @@ const char* jobNames[] =
 {
 	ASSERT_ENUM_STRING( JOBLIST_RENDERER_FRONTEND,	0 ),
 	ASSERT_ENUM_STRING( JOBLIST_RENDERER_BACKEND,	1 ),
+	ASSERT_ENUM_STRING( JOBLIST_GAME,				2 ),
 	ASSERT_ENUM_STRING( JOBLIST_UTILITY,			9 ),
 };
 
@@ -741,10 +742,21 @@ int idParallelJobList_Threads::RunJobsInternal( unsigned int threadNum, threadJo
 		{
 			uint64_t jobStart = Sys_Microseconds();
 
+			const bool profileJob = idProfiler::IsCapturing();
+			if( profileJob )
+			{
+				idProfiler::BeginEvent( GetJobName( jobList[state.nextJobIndex].function ), jobStart );
+			}
+
 			jobList[state.nextJobIndex].function( jobList[state.nextJobIndex].data );
 			jobList[state.nextJobIndex].executed = 1;
 
 			uint64_t jobEnd = Sys_Microseconds();
+
+			if( profileJob )
+			{
+				idProfiler::EndEvent( jobEnd );
+			}
 			deferredThreadStats.threadExecTime[threadNum] += jobEnd - jobStart;
 
 #ifndef _DEBUG
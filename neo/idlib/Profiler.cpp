@@ -0,0 +1,573 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include <atomic>
+
+/*
+================================================================================================
+
+	Per-thread event rings
+
+	A thread takes a ring the first time it records an event during a capture. Only the
+	owning thread writes its ring and publishes new events through numEvents, the capture is
+	read back on the main thread after recording has been switched off and every thread has
+	left Profiler_AddEvent. Rings are reset lazily by their owner when a new capture starts.
+
+	A thread that exits gives its ring back with idProfiler::ReleaseThread. The ring keeps its
+	events for the capture they belong to and is handed to a new thread once that capture is
+	over, so short lived threads don't use up the PROFILE_MAX_THREADS slots.
+
+	If a thread records more than PROFILE_EVENTS_PER_THREAD events in one capture the oldest
+	ones are overwritten.
+
+	Names that don't outlive the capture, like model or material names, are copied into a
+	per-thread name pool that is only reset with the ring, each distinct name is stored once.
+
+================================================================================================
+*/
+
+static const int PROFILE_MAX_THREADS		= 64;
+static const int PROFILE_EVENTS_PER_THREAD	= 1 << 17;
+static const int PROFILE_NAME_BYTES			= 1 << 18;
+static const int PROFILE_NAME_HASH_SIZE		= 1 << 12;	// power of two, at most 3/4 used
+static const int PROFILE_THREAD_NAME_LENGTH	= 64;
+
+struct profileEvent_t
+{
+	const char* 		name;		// NULL for end events
+	uint64_t			time;
+};
+
+struct profileThread_t
+{
+	profileEvent_t* 	events;
+	std::atomic<int>	numEvents;
+	std::atomic<bool>	writing;	// set while the owner is inside Profiler_AddEvent
+	std::atomic<bool>	inUse;		// cleared when the owning thread exits
+	int					captureId;	// capture the events belong to
+	int					threadId;
+	char				name[PROFILE_THREAD_NAME_LENGTH];
+
+	char* 				names;		// copied dynamic names
+	int					namesUsed;
+	int					numNames;
+	int* 				nameHash;	// offsets into names, -1 for free entries
+};
+
+volatile bool idProfiler::capturing = false;
+
+// the exact recording state, capturing is only a cheap early out for callers
+static std::atomic<bool>		profileRecording( false );
+
+static profileThread_t* 		profileThreads[PROFILE_MAX_THREADS];
+static idSysInterlockedInteger	numProfileThreads;
+
+static thread_local profileThread_t* 	localProfileThread = NULL;
+static thread_local char				localProfileThreadName[PROFILE_THREAD_NAME_LENGTH];
+
+static std::atomic<int>			captureId( 0 );
+static int						captureFrames;
+static int						capturedFrames;
+static uint64_t					captureStartTime;
+static idStrStatic< MAX_OSPATH >	captureFileName;
+
+/*
+========================
+Profiler_GetLocalThread
+========================
+*/
+static profileThread_t* Profiler_GetLocalThread()
+{
+	profileThread_t* thread = localProfileThread;
+	if( thread == NULL )
+	{
+		// reuse the ring of an exited thread unless it still holds events of the running capture
+		const int current = captureId.load( std::memory_order_relaxed );
+		const int num = Min( numProfileThreads.GetValue(), PROFILE_MAX_THREADS );
+		for( int i = 0; i < num; i++ )
+		{
+			profileThread_t* ring = profileThreads[i];
+			if( ring == NULL || ring->inUse.load( std::memory_order_relaxed ) || ring->captureId == current )
+			{
+				continue;
+			}
+
+			bool expected = false;
+			if( ring->inUse.compare_exchange_strong( expected, true, std::memory_order_acquire ) )
+			{
+				idStr::Copynz( ring->name, localProfileThreadName, sizeof( ring->name ) );
+				localProfileThread = ring;
+				return ring;
+			}
+		}
+
+		if( numProfileThreads.GetValue() >= PROFILE_MAX_THREADS )
+		{
+			// all slots are taken, try again once a ring has been released and its capture is over
+			return NULL;
+		}
+
+		const int index = numProfileThreads.Increment() - 1;
+		if( index >= PROFILE_MAX_THREADS )
+		{
+			return NULL;
+		}
+
+		thread = new( TAG_IDLIB ) profileThread_t;
+		thread->events = ( profileEvent_t* )Mem_Alloc( PROFILE_EVENTS_PER_THREAD * sizeof( profileEvent_t ), TAG_IDLIB );
+		thread->numEvents.store( 0, std::memory_order_relaxed );
+		thread->writing.store( false, std::memory_order_relaxed );
+		thread->inUse.store( true, std::memory_order_relaxed );
+		thread->captureId = -1;
+		thread->threadId = index;
+		idStr::Copynz( thread->name, localProfileThreadName, sizeof( thread->name ) );
+		thread->names = ( char* )Mem_Alloc( PROFILE_NAME_BYTES, TAG_IDLIB );
+		thread->namesUsed = 0;
+		thread->numNames = 0;
+		thread->nameHash = ( int* )Mem_Alloc( PROFILE_NAME_HASH_SIZE * sizeof( int ), TAG_IDLIB );
+		memset( thread->nameHash, -1, PROFILE_NAME_HASH_SIZE * sizeof( int ) );
+
+		localProfileThread = thread;
+		profileThreads[index] = thread;
+	}
+
+	return thread;
+}
+
+/*
+========================
+Profiler_CopyName
+
+Returns a copy of name in the thread's name pool that stays valid until the next capture.
+========================
+*/
+static const char* Profiler_CopyName( profileThread_t* thread, const char* name )
+{
+	const int length = idStr::Length( name );
+	int index = idStr::Hash( name ) & ( PROFILE_NAME_HASH_SIZE - 1 );
+	while( thread->nameHash[index] != -1 )
+	{
+		const char* copy = thread->names + thread->nameHash[index];
+		if( idStr::Cmp( copy, name ) == 0 )
+		{
+			return copy;
+		}
+		index = ( index + 1 ) & ( PROFILE_NAME_HASH_SIZE - 1 );
+	}
+
+	if( thread->numNames >= PROFILE_NAME_HASH_SIZE * 3 / 4 || thread->namesUsed + length + 1 > PROFILE_NAME_BYTES )
+	{
+		return "too many names";
+	}
+
+	char* copy = thread->names + thread->namesUsed;
+	memcpy( copy, name, length + 1 );
+	thread->nameHash[index] = thread->namesUsed;
+	thread->namesUsed += length + 1;
+	thread->numNames++;
+	return copy;
+}
+
+/*
+========================
+Profiler_AddEvent
+========================
+*/
+static void Profiler_AddEvent( const char* name, bool copyName, uint64_t time )
+{
+	if( !profileRecording.load( std::memory_order_relaxed ) )
+	{
+		return;
+	}
+
+	profileThread_t* thread = Profiler_GetLocalThread();
+	if( thread == NULL )
+	{
+		return;
+	}
+
+	// pairs with the wait in idProfiler::StopCapture, either the capture sees this
+	// thread writing and waits for it, or this thread sees the capture has ended
+	thread->writing.store( true, std::memory_order_seq_cst );
+	if( !profileRecording.load( std::memory_order_seq_cst ) )
+	{
+		thread->writing.store( false, std::memory_order_release );
+		return;
+	}
+
+	const int current = captureId.load( std::memory_order_relaxed );
+	if( thread->captureId != current )
+	{
+		thread->captureId = current;
+		thread->numEvents.store( 0, std::memory_order_relaxed );
+		thread->namesUsed = 0;
+		thread->numNames = 0;
+		memset( thread->nameHash, -1, PROFILE_NAME_HASH_SIZE * sizeof( int ) );
+	}
+
+	if( copyName )
+	{
+		name = Profiler_CopyName( thread, name );
+	}
+
+	const int num = thread->numEvents.load( std::memory_order_relaxed );
+	profileEvent_t& event = thread->events[num & ( PROFILE_EVENTS_PER_THREAD - 1 )];
+	event.name = name;
+	event.time = ( time != 0 ) ? time : Sys_Microseconds();
+	thread->numEvents.store( num + 1, std::memory_order_relaxed );
+
+	thread->writing.store( false, std::memory_order_release );
+}
+
+/*
+========================
+idProfiler::BeginEvent
+========================
+*/
+void idProfiler::BeginEvent( const char* name, uint64_t time )
+{
+	Profiler_AddEvent( ( name != NULL ) ? name : "unnamed", false, time );
+}
+
+/*
+========================
+idProfiler::BeginDynamicEvent
+========================
+*/
+void idProfiler::BeginDynamicEvent( const char* name, uint64_t time )
+{
+	Profiler_AddEvent( ( name != NULL ) ? name : "unnamed", name != NULL, time );
+}
+
+/*
+========================
+idProfiler::EndEvent
+========================
+*/
+void idProfiler::EndEvent( uint64_t time )
+{
+	Profiler_AddEvent( NULL, false, time );
+}
+
+/*
+========================
+idProfiler::SetThreadName
+========================
+*/
+void idProfiler::SetThreadName( const char* name )
+{
+	idStr::Copynz( localProfileThreadName, ( name != NULL ) ? name : "", sizeof( localProfileThreadName ) );
+	if( localProfileThread != NULL )
+	{
+		idStr::Copynz( localProfileThread->name, localProfileThreadName, sizeof( localProfileThread->name ) );
+	}
+}
+
+/*
+========================
+idProfiler::ReleaseThread
+========================
+*/
+void idProfiler::ReleaseThread()
+{
+	profileThread_t* thread = localProfileThread;
+	localProfileThread = NULL;
+	localProfileThreadName[0] = '\0';
+
+	if( thread != NULL )
+	{
+		thread->inUse.store( false, std::memory_order_release );
+	}
+}
+
+/*
+================================================================================================
+
+	Chrome trace export
+
+================================================================================================
+*/
+
+/*
+========================
+Profiler_EscapeName
+
+Event names are mostly literals but may be asset names, so escape anything JSON can't take.
+========================
+*/
+static const char* Profiler_EscapeName( const char* name, char* buffer, int bufferSize )
+{
+	const char* s = name;
+	while( *s != '\0' && *s != '"' && *s != '\\' && ( byte )*s >= ' ' )
+	{
+		s++;
+	}
+	if( *s == '\0' )
+	{
+		return name;
+	}
+
+	int len = 0;
+	for( s = name; *s != '\0' && len < bufferSize - 2; s++ )
+	{
+		if( *s == '"' || *s == '\\' )
+		{
+			buffer[len++] = '\\';
+			buffer[len++] = *s;
+		}
+		else if( ( byte )*s >= ' ' )
+		{
+			buffer[len++] = *s;
+		}
+	}
+	buffer[len] = '\0';
+	return buffer;
+}
+
+/*
+========================
+Profiler_WriteTrace
+========================
+*/
+static bool Profiler_WriteTrace( const char* fileName, uint64_t endTime )
+{
+	idFile* f = idLib::fileSystem->OpenFileWrite( fileName );
+	if( f == NULL )
+	{
+		idLib::Warning( "profiler: couldn't open %s for writing", fileName );
+		return false;
+	}
+
+	char nameBuffer[MAX_OSPATH * 2];
+	int numEvents = 0;
+	int numThreads = 0;
+
+	f->Printf( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+	f->Printf( "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"%s\"}}", GAME_NAME );
+
+	const int num = Min( numProfileThreads.GetValue(), PROFILE_MAX_THREADS );
+	for( int i = 0; i < num; i++ )
+	{
+		const profileThread_t* thread = profileThreads[i];
+		if( thread == NULL )
+		{
+			continue;
+		}
+
+		const int end = thread->numEvents.load( std::memory_order_relaxed );
+		if( thread->captureId != captureId.load( std::memory_order_relaxed ) || end == 0 )
+		{
+			continue;
+		}
+
+		const int tid = thread->threadId + 1;
+		const char* threadName = ( thread->name[0] != '\0' ) ? Profiler_EscapeName( thread->name, nameBuffer, sizeof( nameBuffer ) ) : va( "Thread %i", tid );
+		f->Printf( ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}", tid, threadName );
+		numThreads++;
+
+		int start = 0;
+		if( end > PROFILE_EVENTS_PER_THREAD )
+		{
+			start = end - PROFILE_EVENTS_PER_THREAD;
+			idLib::Warning( "profiler: thread '%s' recorded %i events, the oldest %i were dropped", threadName, end, start );
+		}
+
+		// drop end events whose begin was lost and close events still open at the end of the capture
+		int depth = 0;
+		uint64_t lastTime = captureStartTime;
+		for( int j = start; j < end; j++ )
+		{
+			const profileEvent_t& event = thread->events[j & ( PROFILE_EVENTS_PER_THREAD - 1 )];
+			if( event.time < captureStartTime )
+			{
+				continue;
+			}
+			lastTime = event.time;
+
+			const int ts = ( int )( event.time - captureStartTime );
+			if( event.name != NULL )
+			{
+				f->Printf( ",\n{\"name\":\"%s\",\"ph\":\"B\",\"pid\":1,\"tid\":%i,\"ts\":%i}", Profiler_EscapeName( event.name, nameBuffer, sizeof( nameBuffer ) ), tid, ts );
+				depth++;
+			}
+			else if( depth > 0 )
+			{
+				f->Printf( ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%i,\"ts\":%i}", tid, ts );
+				depth--;
+			}
+			else
+			{
+				continue;
+			}
+			numEvents++;
+		}
+		for( ; depth > 0; depth-- )
+		{
+			f->Printf( ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%i,\"ts\":%i}", tid, ( int )( Max( lastTime, endTime ) - captureStartTime ) );
+		}
+	}
+
+	f->Printf( "\n]}\n" );
+	delete f;
+
+	idLib::Printf( "profiler: wrote %i events from %i threads over %i frames to %s\n", numEvents, numThreads, capturedFrames, fileName );
+	return true;
+}
+
+/*
+================================================================================================
+
+	Capture control
+
+================================================================================================
+*/
+
+/*
+========================
+idProfiler::BeginFrame
+========================
+*/
+void idProfiler::BeginFrame()
+{
+	if( !capturing )
+	{
+		return;
+	}
+
+	if( captureFrames > 0 && capturedFrames >= captureFrames )
+	{
+		StopCapture();
+		return;
+	}
+	capturedFrames++;
+}
+
+/*
+========================
+idProfiler::StartCapture
+========================
+*/
+bool idProfiler::StartCapture( int numFrames, const char* fileName )
+{
+	if( capturing )
+	{
+		idLib::Printf( "profiler: already capturing to %s\n", captureFileName.c_str() );
+		return false;
+	}
+
+	captureFileName = fileName;
+	captureFrames = Max( numFrames, 0 );
+	capturedFrames = 0;
+	captureId.fetch_add( 1, std::memory_order_relaxed );
+	captureStartTime = Sys_Microseconds();
+	profileRecording.store( true, std::memory_order_seq_cst );
+	capturing = true;
+
+	if( captureFrames > 0 )
+	{
+		idLib::Printf( "profiler: capturing %i frames to %s\n", captureFrames, fileName );
+	}
+	else
+	{
+		idLib::Printf( "profiler: capturing to %s until stopped\n", fileName );
+	}
+	return true;
+}
+
+/*
+========================
+idProfiler::StopCapture
+========================
+*/
+bool idProfiler::StopCapture()
+{
+	if( !capturing )
+	{
+		return false;
+	}
+
+	capturing = false;
+	profileRecording.store( false, std::memory_order_seq_cst );
+
+	// job threads may still be in the middle of recording an event, wait until all
+	// of them are out before reading their rings, from now on they won't write
+	const int num = Min( numProfileThreads.GetValue(), PROFILE_MAX_THREADS );
+	for( int i = 0; i < num; i++ )
+	{
+		const profileThread_t* thread = profileThreads[i];
+		if( thread == NULL )
+		{
+			continue;
+		}
+		while( thread->writing.load( std::memory_order_acquire ) )
+		{
+			Sys_Yield();
+		}
+	}
+
+	return Profiler_WriteTrace( captureFileName.c_str(), Sys_Microseconds() );
+}
+
+/*
+========================
+profileCapture
+========================
+*/
+CONSOLE_COMMAND_SHIP( profileCapture, "captures CPU profile events of all threads over N frames to profiles/<name>.json in Chrome trace format", 0 )
+{
+	if( args.Argc() > 3 )
+	{
+		idLib::Printf( "usage: profileCapture [numFrames] [name]\n" );
+		return;
+	}
+
+	const int numFrames = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 60;
+
+	idStr fileName = ( args.Argc() > 2 ) ? args.Argv( 2 ) : "capture";
+	fileName.StripPath();
+	fileName.SetFileExtension( ".json" );
+	fileName = "profiles/" + fileName;
+
+	idProfiler::StartCapture( numFrames, fileName );
+}
+
+/*
+========================
+profileStop
+========================
+*/
+CONSOLE_COMMAND_SHIP( profileStop, "stops a running profileCapture and writes it out", 0 )
+{
+	if( !idProfiler::StopCapture() )
+	{
+		idLib::Printf( "profiler: no capture running\n" );
+	}
+}
@@ -0,0 +1,79 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+/*
+===============================================================================
+
+	Native CPU profiler.
+
+	Every thread that records an event gets its own ring buffer of begin / end
+	events, only written by that thread, so recording needs no locks. Nothing
+	is recorded unless a capture is running, then the captured events are
+	written out as Chrome trace JSON which can be opened in chrome://tracing
+	or ui.perfetto.dev.
+
+	Event names passed to BeginEvent are stored as pointers, they must stay
+	valid until the capture has been written. Names that may be freed before
+	that, like asset names, go through BeginDynamicEvent which copies them.
+
+===============================================================================
+*/
+
+class idProfiler
+{
+public:
+	static bool				IsCapturing()
+	{
+		return capturing;
+	}
+
+	// the time argument allows callers that already read the clock to pass it in
+	static void				BeginEvent( const char* name, uint64_t time = 0 );
+	static void				BeginDynamicEvent( const char* name, uint64_t time = 0 );
+	static void				EndEvent( uint64_t time = 0 );
+
+	// names the calling thread in the trace, the name is copied
+	static void				SetThreadName( const char* name );
+	// called by a thread before it exits so its ring can be used by another thread
+	static void				ReleaseThread();
+
+	// called once at the start of every game frame, ends frame limited captures
+	static void				BeginFrame();
+
+	// numFrames 0 captures until StopCapture is called
+	static bool				StartCapture( int numFrames, const char* fileName );
+	static bool				StopCapture();
+
+private:
+	static volatile bool	capturing;
+};
+
+#endif /* !__PROFILER_H__ */
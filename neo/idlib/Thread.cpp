@@ -239,6 +239,7 @@ int idSysThread::ThreadProc( idSysThread* thread )
 
 				// SRS - generalize thread instrumentation with correct Run() scope
 				OPTICK_THREAD( thread->GetName() );
+				idProfiler::SetThreadName( thread->GetName() );
 
 				retVal = thread->Run();
 			}
@@ -248,6 +249,7 @@ int idSysThread::ThreadProc( idSysThread* thread )
 		{
 			// SRS - generalize thread instrumentation with correct Run() scope
 			OPTICK_THREAD( thread->GetName() );
+			idProfiler::SetThreadName( thread->GetName() );
 
 			retVal = thread->Run();
 		}
@@ -260,6 +262,7 @@ int idSysThread::ThreadProc( idSysThread* thread )
 		exit( 0 );
 	}
 
+	idProfiler::ReleaseThread();
 	thread->isRunning = false;
 
 	return retVal;
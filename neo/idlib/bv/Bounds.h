@@ -487,4 +487,16 @@ ID_INLINE float* idBounds::ToFloatPtr()
 	return &b[0].x;
 }
 
+//===============================================================
+//
+//	idListRelocatable - bounds can be moved by idList with memcpy
+//
+//===============================================================
+
+template<>
+struct idListRelocatable< idBounds >
+{
+	static const bool value = true;
+};
+
 #endif /* !__BV_BOUNDS_H__ */
@@ -28,6 +28,8 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __ARRAY_H__
 #define __ARRAY_H__
 
+#include <type_traits>
+
 /*
 ================================================
 idArray is a replacement for a normal C array.
@@ -141,4 +143,26 @@ struct idTupleSize< idArray< _type_, _num_ > >
 	enum { value = _num_ };
 };
 
+/*
+================================================
+idListRelocatable
+Types whose elements idList may move to a new buffer
+with a memcpy. Trivially copyable types qualify
+automatically. Math and vertex types with a user-provided
+copy constructor or assignment operator opt in with a
+specialization next to the class.
+================================================
+*/
+template< class _type_ >
+struct idListRelocatable
+{
+	static const bool value = std::is_trivially_copyable< _type_ >::value;
+};
+
+template< class _type_, int _num_ >
+struct idListRelocatable< idArray< _type_, _num_ > >
+{
+	static const bool value = idListRelocatable< _type_ >::value;
+};
+
 #endif // !__ARRAY_H__
@@ -32,7 +32,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #include <new>
 #include <initializer_list>
+#include <type_traits>
 #include <algorithm>	// SRS - Needed for clang 14 so std::copy() is defined
+#include "Array.h"		// for idListRelocatable
 
 /*
 ===============================================================================
@@ -86,6 +88,9 @@ ID_INLINE void idListArrayDelete( void* ptr, int num )
 /*
 ========================
 idListArrayResize
+
+Relocatable, trivially destructible types are moved with a single memcpy,
+everything else is moved element by element.
 ========================
 */
 template< typename _type_, memTag_t _tag_ >
@@ -93,6 +98,32 @@ ID_INLINE void* idListArrayResize( void* voldptr, int oldNum, int newNum, bool z
 {
 	_type_ * oldptr = ( _type_* )voldptr;
 	_type_ * newptr = NULL;
+	if constexpr( idListRelocatable< _type_ >::value && std::is_trivially_destructible< _type_ >::value )
+	{
+		if( newNum > 0 )
+		{
+			int overlap = Min( oldNum, newNum );
+			if( zeroBuffer )
+			{
+				newptr = ( _type_* )Mem_ClearedAlloc( sizeof( _type_ ) * newNum, _tag_ );
+			}
+			else
+			{
+				newptr = ( _type_* )Mem_Alloc( sizeof( _type_ ) * newNum, _tag_ );
+			}
+			if( overlap > 0 )
+			{
+				memcpy( ( void* )newptr, oldptr, sizeof( _type_ ) * overlap );
+			}
+			for( int i = overlap; i < newNum; i++ )
+			{
+				new( &newptr[i] ) _type_;
+			}
+		}
+		Mem_Free( voldptr );
+		return newptr;
+	}
+
 	if( newNum > 0 )
 	{
 		newptr = ( _type_* )idListArrayNew<_type_, _tag_>( newNum, zeroBuffer );
@@ -154,11 +185,17 @@ public:
 	void			AssureSize( int newSize );							// assure list has given number of elements, but leave them uninitialized
 	void			AssureSize( int newSize, const _type_ &initValue );	// assure list has given number of elements and initialize any new elements
 	void			AssureSizeAlloc( int newSize, new_t* allocator );	// assure the pointer list has the given number of elements and allocate any new elements
+	void			Reserve( int newSize );								// make room for at least the given number of elements without changing the number of elements
+	void			SetGeometricGrowth( bool geometric );				// grow by half the allocated size instead of the granularity when full
+	bool			GetGeometricGrowth() const;
 
 	_type_* 		Ptr();												// returns a pointer to the list
 	const _type_* 	Ptr() const;										// returns a pointer to the list
 	_type_& 		Alloc();											// returns reference to a new data element at the end of the list
 	int				Append( const _type_ & obj );						// append element
+	int				Append( _type_&& obj );							// append element, moving it into the list
+	template< typename... _args_ >
+	_type_& 		Emplace( _args_&& ... args );						// construct a new element at the end of the list
 	int				Append( const idList& other );						// append list
 	int				AddUnique( const _type_ & obj );					// add unique element
 	int				Insert( const _type_ & obj, int index = 0 );		// insert the element at the given index
@@ -284,11 +321,14 @@ public:
 	}
 	*/
 private:
+	int				GrowSize( int newSize ) const;						// size to allocate to hold at least newSize elements
+
 	int				num;
 	int				size;
 	int				granularity;
 	_type_* 		list;
 	byte			memTag;
+	bool			geometricGrowth;
 };
 
 /*
@@ -304,6 +344,7 @@ ID_INLINE idList<_type_, _tag_>::idList( int newgranularity )
 	list		= NULL;
 	granularity	= newgranularity;
 	memTag		= _tag_;
+	geometricGrowth = false;
 	Clear();
 }
 
@@ -526,6 +567,74 @@ ID_INLINE int idList<_type_, _tag_>::GetGranularity() const
 	return granularity;
 }
 
+/*
+================
+idList<_type_,_tag_>::GrowSize
+
+Returns the number of elements to allocate to hold at least newSize elements.
+
+With the default fixed granularity appending n elements copies the list O(n) times,
+geometric growth adds half of the allocated size at a time instead, which keeps the
+total copying linear for lists that end up with many thousands of elements.
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE int idList<_type_, _tag_>::GrowSize( int newSize ) const
+{
+	// a list cleared with memset has no granularity
+	const int gran = ( granularity > 0 ) ? granularity : 16;
+
+	if( geometricGrowth && newSize < size + ( size >> 1 ) )
+	{
+		newSize = size + ( size >> 1 );
+	}
+
+	newSize += gran - 1;
+	newSize -= newSize % gran;
+	return newSize;
+}
+
+/*
+================
+idList<_type_,_tag_>::Reserve
+
+Makes sure there is room for at least the given number of elements, the number of elements is not changed.
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE void idList<_type_, _tag_>::Reserve( int newSize )
+{
+	if( newSize > size )
+	{
+		Resize( newSize );
+	}
+}
+
+/*
+================
+idList<_type_,_tag_>::SetGeometricGrowth
+
+Lists that will hold many elements should grow geometrically, small lists
+keep the fixed granularity so they don't waste memory.
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE void idList<_type_, _tag_>::SetGeometricGrowth( bool geometric )
+{
+	geometricGrowth = geometric;
+}
+
+/*
+================
+idList<_type_,_tag_>::GetGeometricGrowth
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE bool idList<_type_, _tag_>::GetGeometricGrowth() const
+{
+	return geometricGrowth;
+}
+
 /*
 ================
 idList<_type_,_tag_>::Condense
@@ -628,13 +737,7 @@ ID_INLINE void idList<_type_, _tag_>::AssureSize( int newSize )
 
 	if( newSize > size )
 	{
-		if( granularity == 0 )  	// this is a hack to fix our memset classes
-		{
-			granularity = 16;
-		}
-
-		newSize += granularity - 1;
-		newSize -= newSize % granularity;
+		newSize = GrowSize( newSize );
 		Resize( newSize );
 
 		num = newNum;
@@ -655,14 +758,7 @@ ID_INLINE void idList<_type_, _tag_>::AssureSize( int newSize, const _type_ &ini
 
 	if( newSize > size )
 	{
-
-		if( granularity == 0 )  	// this is a hack to fix our memset classes
-		{
-			granularity = 16;
-		}
-
-		newSize += granularity - 1;
-		newSize -= newSize % granularity;
+		newSize = GrowSize( newSize );
 		num = size;
 		Resize( newSize );
 
@@ -692,14 +788,7 @@ ID_INLINE void idList<_type_, _tag_>::AssureSizeAlloc( int newSize, new_t* alloc
 
 	if( newSize > size )
 	{
-
-		if( granularity == 0 )  	// this is a hack to fix our memset classes
-		{
-			granularity = 16;
-		}
-
-		newSize += granularity - 1;
-		newSize -= newSize % granularity;
+		newSize = GrowSize( newSize );
 		num = size;
 		Resize( newSize );
 
@@ -728,6 +817,7 @@ ID_INLINE idList<_type_, _tag_>& idList<_type_, _tag_>::operator=( idList<_type_
 	size		= other.size;
 	granularity = other.granularity;
 	memTag		= other.memTag;
+	geometricGrowth = other.geometricGrowth;
 	list		= other.list;
 
 	other.list = nullptr;
@@ -754,6 +844,7 @@ ID_INLINE idList<_type_, _tag_>& idList<_type_, _tag_>::operator=( const idList<
 	size		= other.size;
 	granularity	= other.granularity;
 	memTag		= other.memTag;
+	geometricGrowth = other.geometricGrowth;
 
 	if( size )
 	{
@@ -845,14 +936,9 @@ Returns a reference to a new data element at the end of the list.
 template< typename _type_, memTag_t _tag_ >
 ID_INLINE _type_& idList<_type_, _tag_>::Alloc()
 {
-	if( !list )
-	{
-		Resize( granularity );
-	}
-
 	if( num == size )
 	{
-		Resize( size + granularity );
+		Resize( GrowSize( size + 1 ) );
 	}
 
 	return list[ num++ ];
@@ -870,29 +956,67 @@ Returns the index of the new element.
 template< typename _type_, memTag_t _tag_ >
 ID_INLINE int idList<_type_, _tag_>::Append( _type_ const& obj )
 {
-	if( !list )
+	if( num == size )
 	{
-		Resize( granularity );
+		Resize( GrowSize( size + 1 ) );
 	}
 
+	list[ num ] = obj;
+	num++;
+
+	return num - 1;
+}
+
+/*
+================
+idList<_type_,_tag_>::Append
+
+Increases the size of the list by one element and moves the supplied data into it.
+
+Returns the index of the new element.
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+ID_INLINE int idList<_type_, _tag_>::Append( _type_&& obj )
+{
 	if( num == size )
 	{
-		int newsize;
-
-		if( granularity == 0 )  	// this is a hack to fix our memset classes
-		{
-			granularity = 16;
-		}
-		newsize = size + granularity;
-		Resize( newsize - newsize % granularity );
+		Resize( GrowSize( size + 1 ) );
 	}
 
-	list[ num ] = obj;
+	list[ num ] = std::move( obj );
 	num++;
 
 	return num - 1;
 }
 
+/*
+================
+idList<_type_,_tag_>::Emplace
+
+Constructs a new element in place at the end of the list from the given arguments.
+The slots of the list always hold constructed elements, so the old one is destroyed first.
+
+Returns a reference to the new element.
+================
+*/
+template< typename _type_, memTag_t _tag_ >
+template< typename... _args_ >
+ID_INLINE _type_& idList<_type_, _tag_>::Emplace( _args_&& ... args )
+{
+	if( num == size )
+	{
+		Resize( GrowSize( size + 1 ) );
+	}
+
+	_type_* ptr = &list[ num ];
+	ptr->~_type_();
+	new( ptr ) _type_( std::forward< _args_ >( args )... );
+	num++;
+
+	return *ptr;
+}
+
 
 /*
 ================
@@ -907,21 +1031,9 @@ Returns the index of the new element.
 template< typename _type_, memTag_t _tag_ >
 ID_INLINE int idList<_type_, _tag_>::Insert( _type_ const& obj, int index )
 {
-	if( !list )
-	{
-		Resize( granularity );
-	}
-
 	if( num == size )
 	{
-		int newsize;
-
-		if( granularity == 0 )  	// this is a hack to fix our memset classes
-		{
-			granularity = 16;
-		}
-		newsize = size + granularity;
-		Resize( newsize - newsize % granularity );
+		Resize( GrowSize( size + 1 ) );
 	}
 
 	if( index < 0 )
@@ -953,19 +1065,15 @@ Returns the size of the new combined list
 template< typename _type_, memTag_t _tag_ >
 ID_INLINE int idList<_type_, _tag_>::Append( const idList< _type_, _tag_ >& other )
 {
-	if( !list )
+	int n = other.Num();
+	if( num + n > size )
 	{
-		if( granularity == 0 )  	// this is a hack to fix our memset classes
-		{
-			granularity = 16;
-		}
-		Resize( granularity );
+		Resize( GrowSize( num + n ) );
 	}
 
-	int n = other.Num();
 	for( int i = 0; i < n; i++ )
 	{
-		Append( other[i] );
+		list[ num++ ] = other.list[ i ];
 	}
 
 	return Num();
@@ -848,4 +848,16 @@ ID_INLINE void idShadowVertSkinned::Clear()
 }
 #endif
 
+//===============================================================
+//
+//	idListRelocatable - vertices can be moved by idList with memcpy
+//
+//===============================================================
+
+template<>
+struct idListRelocatable< idDrawVert >
+{
+	static const bool value = true;
+};
+
 #endif /* !__DRAWVERT_H__ */
@@ -592,4 +592,22 @@ ID_INLINE void idJointMat::InverseMultiply( idJointMat& result, const idJointMat
 	result.mat[2 * 4 + 3] = m1.mat[2 * 4 + 0] * dst[0] + m1.mat[2 * 4 + 1] * dst[1] + m1.mat[2 * 4 + 2] * dst[2] + m1.mat[2 * 4 + 3];
 }
 
+//===============================================================
+//
+//	idListRelocatable - the joint transforms can be moved by idList with memcpy
+//
+//===============================================================
+
+template<>
+struct idListRelocatable< idJointQuat >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idJointMat >
+{
+	static const bool value = true;
+};
+
 #endif /* !__JOINTTRANSFORM_H__ */
@@ -32,7 +32,7 @@ If you have questions concerning this license or the applicable additional terms
 
 extern idCVar gltf_parseVerbose;
 
-void gltfExtra_Scatter::parse( idToken& token, idLexer* parser )
+void gltfExtra_Scatter::parse( idToken& token, gltfJsonScanner* parser )
 {
 	parser->UnreadToken( &token );
 
@@ -41,7 +41,7 @@ void gltfExtra_Scatter::parse( idToken& token, idLexer* parser )
 	scatterInfo.Parse( parser, true );
 }
 
-void gltfExtra_CameraLensFrames::parse( idToken& token, idLexer* parser )
+void gltfExtra_CameraLensFrames::parse( idToken& token, gltfJsonScanner* parser )
 {
 	item = new idList<double>();
 	auto* numbers = new gltfItem_number_array( "" );
@@ -34,7 +34,7 @@ If you have questions concerning this license or the applicable additional terms
 	{public:																	\
 		gltfExtra_##className( idStr Name ) : name( Name ){ item = nullptr; }	\
 		virtual void parse( idToken &token ) {parse(token,nullptr); }			\
-		virtual void parse( idToken &token , idLexer * parser );				\
+		virtual void parse( idToken &token , gltfJsonScanner * parser );				\
 		virtual idStr &Name() { return name; }									\
 	private:																	\
 		idStr name;}
@@ -0,0 +1,643 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+/*
+================
+gltfJsonScanner::gltfJsonScanner
+================
+*/
+gltfJsonScanner::gltfJsonScanner()
+	: source( this ), buffer( NULL ), length( 0 ), first( 0 ), last( 0 ), cursor( 0 ), lastRead( -1 )
+{
+}
+
+/*
+================
+gltfJsonScanner::LoadMemory
+================
+*/
+bool gltfJsonScanner::LoadMemory( const char* ptr, int length, const char* name, int startLine )
+{
+	FreeSource();
+
+	filename = name;
+	buffer = ptr;
+	this->length = length;
+
+	if( !Tokenize( startLine ) )
+	{
+		FreeSource();
+		return false;
+	}
+
+	first = 0;
+	last = tokens.Num();
+	cursor = 0;
+	return true;
+}
+
+/*
+================
+gltfJsonScanner::FreeSource
+================
+*/
+void gltfJsonScanner::FreeSource()
+{
+	source = this;
+	filename.Clear();
+	buffer = NULL;
+	length = 0;
+	tokens.Clear();
+	first = 0;
+	last = 0;
+	cursor = 0;
+	lastRead = -1;
+}
+
+/*
+================
+gltfJsonScanner::Reset
+================
+*/
+void gltfJsonScanner::Reset()
+{
+	cursor = first;
+	lastRead = -1;
+}
+
+/*
+================
+gltfJsonScanner::Tokenize
+
+Scans the whole buffer once. Open braces and brackets are kept on a stack
+until their close token is found, both then store the index of the other.
+================
+*/
+bool gltfJsonScanner::Tokenize( int startLine )
+{
+	idList<int> openTokens;
+	int line = startLine;
+	const char* p = buffer;
+	const char* end = buffer + length;
+
+	// glTF files average well over four characters per token
+	tokens.Resize( length / 4 + 16, 4096 );
+
+	while( p < end && *p )
+	{
+		const char c = *p;
+
+		if( c == '\n' )
+		{
+			line++;
+			p++;
+			continue;
+		}
+		if( c == ' ' || c == '\t' || c == '\r' )
+		{
+			p++;
+			continue;
+		}
+
+		gltfJsonToken_t& token = tokens.Alloc();
+		token.start = p - buffer;
+		token.line = line;
+		token.match = -1;
+
+		switch( c )
+		{
+			case '{':
+			case '[':
+				token.type = TT_PUNCTUATION;
+				token.subtype = ( c == '{' ) ? P_BRACEOPEN : P_SQBRACKETOPEN;
+				openTokens.Append( tokens.Num() - 1 );
+				p++;
+				break;
+			case '}':
+			case ']':
+			{
+				token.type = TT_PUNCTUATION;
+				token.subtype = ( c == '}' ) ? P_BRACECLOSE : P_SQBRACKETCLOSE;
+				const int open = openTokens.Num() ? openTokens[openTokens.Num() - 1] : -1;
+				if( open == -1 || tokens[open].subtype != ( ( c == '}' ) ? P_BRACEOPEN : P_SQBRACKETOPEN ) )
+				{
+					cursor = tokens.Num() - 1;
+					Error( "unexpected '%c'", c );
+					return false;
+				}
+				openTokens.RemoveIndex( openTokens.Num() - 1 );
+				tokens[open].match = tokens.Num() - 1;
+				token.match = open;
+				p++;
+				break;
+			}
+			case ':':
+				token.type = TT_PUNCTUATION;
+				token.subtype = P_COLON;
+				p++;
+				break;
+			case ',':
+				token.type = TT_PUNCTUATION;
+				token.subtype = P_COMMA;
+				p++;
+				break;
+			case '-':
+				token.type = TT_PUNCTUATION;
+				token.subtype = P_SUB;
+				p++;
+				break;
+			case '\"':
+				token.type = TT_STRING;
+				token.subtype = 0;
+				for( p++; p < end && *p != '\"'; p++ )
+				{
+					if( *p == '\\' && p + 1 < end )
+					{
+						p++;
+					}
+					else if( *p == '\n' )
+					{
+						line++;
+					}
+				}
+				if( p >= end )
+				{
+					cursor = tokens.Num() - 1;
+					Error( "missing trailing quote" );
+					return false;
+				}
+				p++;
+				break;
+			default:
+				if( c >= '0' && c <= '9' )
+				{
+					token.type = TT_NUMBER;
+					token.subtype = TT_DECIMAL | TT_INTEGER;
+					while( p < end && *p >= '0' && *p <= '9' )
+					{
+						p++;
+					}
+					if( p < end && *p == '.' )
+					{
+						token.subtype = TT_DECIMAL | TT_FLOAT | TT_DOUBLE_PRECISION;
+						for( p++; p < end && *p >= '0' && *p <= '9'; p++ )
+						{
+						}
+					}
+					if( p < end && ( *p == 'e' || *p == 'E' ) )
+					{
+						token.subtype = TT_DECIMAL | TT_FLOAT | TT_DOUBLE_PRECISION;
+						p++;
+						if( p < end && ( *p == '+' || *p == '-' ) )
+						{
+							p++;
+						}
+						while( p < end && *p >= '0' && *p <= '9' )
+						{
+							p++;
+						}
+					}
+				}
+				else if( ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || c == '_' )
+				{
+					// true, false and null
+					token.type = TT_NAME;
+					token.subtype = 0;
+					while( p < end && ( ( *p >= 'a' && *p <= 'z' ) || ( *p >= 'A' && *p <= 'Z' ) || ( *p >= '0' && *p <= '9' ) || *p == '_' ) )
+					{
+						p++;
+					}
+				}
+				else
+				{
+					cursor = tokens.Num() - 1;
+					Error( "unknown character '%c'", c );
+					return false;
+				}
+				break;
+		}
+
+		token.end = p - buffer;
+	}
+
+	if( openTokens.Num() )
+	{
+		cursor = openTokens[openTokens.Num() - 1];
+		Error( "missing closing brace" );
+		return false;
+	}
+
+	return true;
+}
+
+/*
+================
+gltfJsonScanner::TokenIs
+================
+*/
+bool gltfJsonScanner::TokenIs( int index, const char* string ) const
+{
+	const gltfJsonToken_t& token = source->tokens[index];
+	int start = token.start;
+	int end = token.end;
+	if( token.type == TT_STRING )
+	{
+		start++;
+		end--;
+	}
+
+	const int len = end - start;
+	return idStr::Cmpn( source->buffer + start, string, len ) == 0 && string[len] == '\0';
+}
+
+/*
+================
+gltfJsonScanner::TokenLine
+================
+*/
+int gltfJsonScanner::TokenLine() const
+{
+	if( cursor < source->tokens.Num() )
+	{
+		return source->tokens[cursor].line;
+	}
+	return source->tokens.Num() ? source->tokens[source->tokens.Num() - 1].line : 0;
+}
+
+/*
+================
+gltfJsonScanner::ReadToken
+================
+*/
+int gltfJsonScanner::ReadToken( idToken* token )
+{
+	if( cursor >= last )
+	{
+		return 0;
+	}
+
+	const gltfJsonToken_t& t = source->tokens[cursor];
+	token->type = t.type;
+	token->subtype = t.subtype;
+	token->line = t.line;
+	token->linesCrossed = ( cursor > first ) ? t.line - source->tokens[cursor - 1].line : 0;
+	token->flags = 0;
+
+	token->Empty();
+	if( t.type == TT_STRING )
+	{
+		token->Append( source->buffer + t.start + 1, t.end - t.start - 2 );
+	}
+	else
+	{
+		token->Append( source->buffer + t.start, t.end - t.start );
+		if( t.type == TT_NUMBER && ( t.subtype & TT_FLOAT ) )
+		{
+			// idToken only knows the lower case exponent
+			token->ToLower();
+		}
+	}
+
+	lastRead = cursor++;
+	return 1;
+}
+
+/*
+================
+gltfJsonScanner::ExpectTokenString
+================
+*/
+int gltfJsonScanner::ExpectTokenString( const char* string )
+{
+	if( cursor >= last )
+	{
+		Error( "couldn't find expected '%s'", string );
+		return 0;
+	}
+
+	if( !TokenIs( cursor, string ) )
+	{
+		idToken token;
+		ReadToken( &token );
+		Error( "expected '%s' but found '%s'", string, token.c_str() );
+		return 0;
+	}
+
+	lastRead = cursor++;
+	return 1;
+}
+
+/*
+================
+gltfJsonScanner::ExpectTokenType
+================
+*/
+int gltfJsonScanner::ExpectTokenType( int type, int subtype, idToken* token )
+{
+	if( !ReadToken( token ) )
+	{
+		Error( "couldn't read expected token" );
+		return 0;
+	}
+
+	if( token->type != type )
+	{
+		Error( "expected token type %d but found '%s'", type, token->c_str() );
+		return 0;
+	}
+
+	if( subtype && ( token->subtype & subtype ) != subtype )
+	{
+		Error( "expected token subtype %d but found '%s'", subtype, token->c_str() );
+		return 0;
+	}
+	return 1;
+}
+
+/*
+================
+gltfJsonScanner::ExpectAnyToken
+================
+*/
+int gltfJsonScanner::ExpectAnyToken( idToken* token )
+{
+	if( !ReadToken( token ) )
+	{
+		Error( "couldn't read expected token" );
+		return 0;
+	}
+	return 1;
+}
+
+/*
+================
+gltfJsonScanner::PeekTokenString
+================
+*/
+int gltfJsonScanner::PeekTokenString( const char* string )
+{
+	return cursor < last && TokenIs( cursor, string );
+}
+
+/*
+================
+gltfJsonScanner::UnreadToken
+
+The tokens are kept, so unreading only moves back to the last token read.
+================
+*/
+void gltfJsonScanner::UnreadToken( const idToken* token )
+{
+	if( lastRead == -1 )
+	{
+		idLib::common->FatalError( "gltfJsonScanner::UnreadToken, unread token twice\n" );
+	}
+	assert( source->tokens[lastRead].type == token->type );
+	cursor = lastRead;
+	lastRead = -1;
+}
+
+/*
+================
+gltfJsonScanner::ParseInt
+================
+*/
+int gltfJsonScanner::ParseInt()
+{
+	idToken token;
+
+	if( !ReadToken( &token ) )
+	{
+		Error( "couldn't read expected integer" );
+		return 0;
+	}
+	if( token.type == TT_PUNCTUATION && token == "-" )
+	{
+		ExpectTokenType( TT_NUMBER, TT_INTEGER, &token );
+		return -( ( signed int ) token.GetIntValue() );
+	}
+	else if( token.type != TT_NUMBER || ( token.subtype & TT_FLOAT ) )
+	{
+		Error( "expected integer value, found '%s'", token.c_str() );
+	}
+	return token.GetIntValue();
+}
+
+/*
+================
+gltfJsonScanner::SkipBracedSection
+
+Jumps to the matching close token. If the next token does not open a
+section of the given type only that token is skipped, like idLexer does.
+================
+*/
+int gltfJsonScanner::SkipBracedSection( bool parseFirstBrace, braceSkipMode_t skipMode, int* skipped )
+{
+	const int openType = ( skipMode == BRSKIP_BRACES ) ? P_BRACEOPEN : P_SQBRACKETOPEN;
+	const int closeType = ( skipMode == BRSKIP_BRACES ) ? P_BRACECLOSE : P_SQBRACKETCLOSE;
+
+	if( skipped != nullptr )
+	{
+		*skipped = 0;
+	}
+
+	if( !parseFirstBrace )
+	{
+		// already inside the section, find its close token
+		int depth = 1;
+		for( ; cursor < last; cursor++ )
+		{
+			const gltfJsonToken_t& t = source->tokens[cursor];
+			if( t.type == TT_PUNCTUATION && t.subtype == closeType && --depth == 0 )
+			{
+				lastRead = cursor++;
+				return true;
+			}
+			if( t.match != -1 && t.subtype == openType )
+			{
+				cursor = t.match;
+			}
+		}
+		return false;
+	}
+
+	if( cursor >= last )
+	{
+		return false;
+	}
+
+	const gltfJsonToken_t& t = source->tokens[cursor];
+	if( t.type == TT_PUNCTUATION && t.subtype == openType )
+	{
+		cursor = t.match;
+		if( skipped != nullptr )
+		{
+			*skipped = 1;
+		}
+	}
+	lastRead = cursor++;
+	return true;
+}
+
+/*
+================
+gltfJsonScanner::ParseBracedSection
+
+The next token should be an open brace.
+Copies the source text up to and including the matching close brace.
+================
+*/
+const char* gltfJsonScanner::ParseBracedSection( idStr& out )
+{
+	return ParseBracedSectionExact( out );
+}
+
+/*
+================
+gltfJsonScanner::ParseBracedSectionExact
+================
+*/
+const char* gltfJsonScanner::ParseBracedSectionExact( idStr& out )
+{
+	out.Empty();
+	if( !ExpectTokenString( "{" ) )
+	{
+		return out.c_str();
+	}
+
+	const gltfJsonToken_t& open = source->tokens[lastRead];
+	const gltfJsonToken_t& close = source->tokens[open.match];
+	out.Append( source->buffer + open.start, close.end - open.start );
+
+	cursor = open.match + 1;
+	lastRead = -1;
+	return out.c_str();
+}
+
+/*
+================
+gltfJsonScanner::ParseBracketSectionExact
+================
+*/
+const char* gltfJsonScanner::ParseBracketSectionExact( idStr& out )
+{
+	out.Empty();
+	if( !ExpectTokenString( "[" ) )
+	{
+		return out.c_str();
+	}
+
+	const gltfJsonToken_t& open = source->tokens[lastRead];
+	const gltfJsonToken_t& close = source->tokens[open.match];
+	out.Append( source->buffer + open.start, close.end - open.start );
+
+	cursor = open.match + 1;
+	lastRead = -1;
+	return out.c_str();
+}
+
+/*
+================
+gltfJsonScanner::ParseBracedSection
+
+The next token should be an open brace.
+The section reads the tokens from the open brace up to and including the
+matching close brace. Nothing is copied or scanned again.
+================
+*/
+bool gltfJsonScanner::ParseBracedSection( gltfJsonScanner& section )
+{
+	section.FreeSource();
+	if( !ExpectTokenString( "{" ) )
+	{
+		return false;
+	}
+
+	const int open = lastRead;
+	section.source = source;
+	section.first = open;
+	section.last = source->tokens[open].match + 1;
+	section.cursor = open;
+
+	cursor = section.last;
+	lastRead = -1;
+	return true;
+}
+
+/*
+================
+gltfJsonScanner::GetSectionText
+================
+*/
+const char* gltfJsonScanner::GetSectionText( idStr& out ) const
+{
+	out.Empty();
+	if( first < last )
+	{
+		const int start = source->tokens[first].start;
+		out.Append( source->buffer + start, source->tokens[last - 1].end - start );
+	}
+	return out.c_str();
+}
+
+/*
+================
+gltfJsonScanner::Error
+================
+*/
+void gltfJsonScanner::Error( const char* str, ... )
+{
+	char text[MAX_STRING_CHARS];
+	va_list ap;
+
+	va_start( ap, str );
+	idStr::vsnPrintf( text, sizeof( text ), str, ap );
+	va_end( ap );
+
+	idLib::common->Error( "file %s, line %d: %s", source->filename.c_str(), TokenLine(), text );
+}
+
+/*
+================
+gltfJsonScanner::Warning
+================
+*/
+void gltfJsonScanner::Warning( const char* str, ... )
+{
+	char text[MAX_STRING_CHARS];
+	va_list ap;
+
+	va_start( ap, str );
+	idStr::vsnPrintf( text, sizeof( text ), str, ap );
+	va_end( ap );
+
+	idLib::common->Warning( "file %s, line %d: %s", source->filename.c_str(), TokenLine(), text );
+}
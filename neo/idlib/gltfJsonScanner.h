@@ -0,0 +1,132 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __GLTF_JSONSCANNER_H__
+#define __GLTF_JSONSCANNER_H__
+
+/*
+===============================================================================
+
+	glTF JSON scanner
+
+	Tokenizes a whole JSON document in a single pass into a flat token list.
+	Braces and brackets store the index of their matching token, so nested
+	objects can be skipped or handed out as sections without scanning them
+	again. A section is a view on the tokens of its source scanner and does
+	not copy any text.
+
+	The interface follows the subset of idLexer that the glTF parser uses,
+	and tokens are returned the way idLexer returns them: strings without
+	quotes, escape characters are kept as is and a minus sign is a separate
+	punctuation token.
+
+	The memory passed to LoadMemory() is not copied and must stay valid as
+	long as the scanner or any of its sections are used.
+
+===============================================================================
+*/
+
+typedef struct gltfJsonToken_s
+{
+	int					type;			// TT_STRING, TT_NUMBER, TT_NAME or TT_PUNCTUATION
+	int					subtype;		// number flags or punctuation id
+	int					start;			// offset of the first character, strings include the quotes
+	int					end;			// offset one past the last character
+	int					line;			// line the token is on
+	int					match;			// index of the matching brace or bracket, -1 for other tokens
+} gltfJsonToken_t;
+
+class gltfJsonScanner
+{
+public:
+	gltfJsonScanner();
+
+	// tokenizes the memory in one pass
+	bool				LoadMemory( const char* ptr, int length, const char* name, int startLine = 1 );
+	// frees the tokens and forgets the source
+	void				FreeSource();
+	// returns true if a source is loaded or this is a section
+	bool				IsLoaded() const
+	{
+		return source->buffer != NULL;
+	}
+	// starts reading the tokens from the beginning again
+	void				Reset();
+	// returns true if all tokens have been read
+	int					EndOfFile() const
+	{
+		return cursor >= last;
+	}
+	// read a token
+	int					ReadToken( idToken* token );
+	// expect a certain token, reads the token when available
+	int					ExpectTokenString( const char* string );
+	// expect a certain token type
+	int					ExpectTokenType( int type, int subtype, idToken* token );
+	// expect a token
+	int					ExpectAnyToken( idToken* token );
+	// returns true if the next token equals the given string but does not remove the token from the source
+	int					PeekTokenString( const char* string );
+	// unread the last token that was read
+	void				UnreadToken( const idToken* token );
+	// read an integer value, a preceding minus sign is handled
+	int					ParseInt();
+	// skip a braced or bracketed section, or a single token if the next token does not open one
+	// skipped is set to 1 if a section was skipped
+	int					SkipBracedSection( bool parseFirstBrace = true, braceSkipMode_t skipMode = BRSKIP_BRACES, int* skipped = nullptr );
+	// the next token should be an open brace, copies the source text up to the matching close brace
+	const char* 		ParseBracedSection( idStr& out );
+	const char* 		ParseBracedSectionExact( idStr& out );
+	// the next token should be an open bracket, copies the source text up to the matching close bracket
+	const char* 		ParseBracketSectionExact( idStr& out );
+	// the next token should be an open brace, section is set to read the tokens up to the matching close brace
+	bool				ParseBracedSection( gltfJsonScanner& section );
+	// copies the source text of all tokens of this scanner or section
+	const char* 		GetSectionText( idStr& out ) const;
+	// print an error message
+	void				Error( VERIFY_FORMAT_STRING const char* str, ... );
+	// print a warning message
+	void				Warning( VERIFY_FORMAT_STRING const char* str, ... );
+
+private:
+	bool				Tokenize( int startLine );
+	bool				TokenIs( int index, const char* string ) const;
+	int					TokenLine() const;
+
+	const gltfJsonScanner* source;		// scanner that owns the tokens, this one if not a section
+	idStr				filename;
+	const char* 		buffer;
+	int					length;
+	idList<gltfJsonToken_t> tokens;
+	int					first;			// first token of this scanner or section
+	int					last;			// one past the last token
+	int					cursor;			// next token to read
+	int					lastRead;		// last token read, -1 if it can't be unread
+};
+
+#endif /* !__GLTF_JSONSCANNER_H__ */
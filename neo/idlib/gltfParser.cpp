@@ -194,7 +194,11 @@ void gltfPropertyArray::Iterator::operator ++()
 		p->array = array;
 		if( array->isArrayOfStructs )
 		{
-			array->parser->ParseBracedSection( p->item );
+			array->parser->ParseBracedSection( p->section );
+			if( gltf_parseVerbose.GetBool() )
+			{
+				p->section.GetSectionText( p->item );
+			}
 		}
 		else
 		{
@@ -233,7 +237,7 @@ gltfPropertyArray::~gltfPropertyArray()
 	properties.DeleteContents( true );
 }
 
-gltfPropertyArray::gltfPropertyArray( idLexer* Parser, bool AoS/* = true */ )
+gltfPropertyArray::gltfPropertyArray( gltfJsonScanner* Parser, bool AoS/* = true */ )
 	: parser( Parser ), iterating( true ), dirty( true ), index( 0 ), isArrayOfStructs( AoS )
 {
 	properties.AssureSizeAlloc( 32, idListNewElement<gltfPropertyItem> );
@@ -263,7 +267,11 @@ gltfPropertyArray::Iterator gltfPropertyArray::begin()
 		start->array = this;
 		if( isArrayOfStructs )
 		{
-			parser->ParseBracedSection( start->item );
+			parser->ParseBracedSection( start->section );
+			if( gltf_parseVerbose.GetBool() )
+			{
+				start->section.GetSectionText( start->item );
+			}
 		}
 		else
 		{
@@ -294,7 +302,7 @@ gltfItemArray::~gltfItemArray()
 	items.DeleteContents( true );
 }
 
-int gltfItemArray::Fill( idLexer* lexer, idDict* strPairs )
+int gltfItemArray::Fill( gltfJsonScanner* lexer, idDict* strPairs )
 {
 	idToken token;
 	bool parsing = true;
@@ -338,7 +346,7 @@ int gltfItemArray::Fill( idLexer* lexer, idDict* strPairs )
 	return parseCount;
 }
 
-int gltfItemArray::Parse( idLexer* lexer, bool forwardLexer/* = false*/ )
+int gltfItemArray::Parse( gltfJsonScanner* lexer, bool forwardLexer/* = false*/ )
 {
 	idToken token;
 	bool parsing = true;
@@ -411,6 +419,34 @@ byte* gltfData::AddData( int size, int* bufferID/*=nullptr*/ )
 	return data[id];
 }
 
+byte* gltfData::AddDataView( byte* chunk, int size, int* bufferID/*=nullptr*/ )
+{
+	assert( size == 0 || ( IsFileData( chunk ) && IsFileData( chunk + size - 1 ) ) );
+
+	if( totalChunks == -1 )
+	{
+		json = chunk;
+		totalChunks++;
+		jsonDataLength = size;
+		return json;
+	}
+
+	int id = totalChunks;
+
+	if( data == nullptr )
+	{
+		data = ( byte** ) Mem_ClearedAlloc( GLTF_MAX_CHUNKS * sizeof( byte* ), TAG_IDLIB_GLTF );
+	}
+	data[totalChunks++] = chunk;
+
+	if( bufferID )
+	{
+		*bufferID = id;
+	}
+
+	return chunk;
+}
+
 bool gltfItem_uri::Convert()
 {
 	//HVG_TODO
@@ -457,12 +493,11 @@ bool gltfItem_uri::Convert()
 void gltfItem_Extra::parse( idToken& token )
 {
 	parser->UnreadToken( &token );
-	parser->ParseBracedSectionExact( item->json );
+	gltfJsonScanner lexer;
+	parser->ParseBracedSection( lexer );
+	lexer.GetSectionText( item->json );
 	gltfItemArray items;
-	idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-	lexer.LoadMemory( item->json, item->json.Size(), "gltfItem_Extra", 0 );
 	items.Fill( &lexer, &item->strPairs );
-	lexer.Reset();
 
 	if( gltf_parseVerbose.GetBool() )
 	{
@@ -482,8 +517,7 @@ void gltfItem_animation_sampler::parse( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfAnimation_Sampler", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		item->AssureSizeAlloc( item->Num() + 1, idListNewElement<gltfAnimation_Sampler> );
 		gltfAnimation_Sampler* gltfAnimSampler = ( *item )[item->Num() - 1];
@@ -539,8 +573,7 @@ void gltfItem_animation_channel::parse( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfAnimation_Channel", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 
 		item->AssureSizeAlloc( item->Num() + 1, idListNewElement<gltfAnimation_Channel> );
@@ -574,8 +607,7 @@ void gltfItem_mesh_primitive::parse( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfItem_mesh_primitiveB", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 
 		item->AssureSizeAlloc( item->Num() + 1, idListNewElement<gltfMesh_Primitive> );
@@ -848,7 +880,8 @@ void gltfItem_camera_orthographic::parse( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( parser );
 	for( auto& prop : array )
 	{
-		common->Printf( "%s", prop.item.c_str() );
+		idStr json;
+		common->Printf( "%s", prop.section.GetSectionText( json ) );
 	}
 	parser->ExpectTokenString( "]" );
 }
@@ -1059,8 +1092,7 @@ void gltfItem_KHR_lights_punctual::parse( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfNode_light", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		item->KHR_lights_punctual.AssureSizeAlloc(
 			item->KHR_lights_punctual.Num() + 1,
@@ -1153,7 +1185,7 @@ void GLTF_Parser::Shutdown()
 	bufferViewsDone = false;
 }
 GLTF_Parser::GLTF_Parser()
-	: parser( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS | LEXFL_ALLOWPATHNAMES ) , buffersDone( false ), bufferViewsDone( false ), currentAsset( nullptr ) { }
+	: buffersDone( false ), bufferViewsDone( false ), currentAsset( nullptr ) { }
 
 void GLTF_Parser::Parse_ASSET( idToken& token )
 {
@@ -1183,8 +1215,7 @@ void GLTF_Parser::Parse_SCENES( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfScene", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfScene* gltfscene = currentAsset->Scene();
 		nodes->Set( &gltfscene->nodes, &lexer );
@@ -1214,8 +1245,7 @@ void GLTF_Parser::Parse_CAMERAS( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfCamera", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfCamera* item = currentAsset->Camera();
 		orthographic->Set( &item->orthographic, &lexer );
@@ -1256,8 +1286,7 @@ void GLTF_Parser::Parse_NODES( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfNode", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfNode* gltfnode = currentAsset->Node();
 
@@ -1302,8 +1331,7 @@ void GLTF_Parser::Parse_MATERIALS( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfMaterial", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfMaterial* gltfmaterial = currentAsset->Material();
 
@@ -1342,8 +1370,7 @@ void GLTF_Parser::Parse_MESHES( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfMesh", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfMesh* gltfmesh = currentAsset->Mesh();
 
@@ -1373,8 +1400,7 @@ void GLTF_Parser::Parse_TEXTURES( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfTexture", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfTexture* gltftexture = currentAsset->Texture();
 
@@ -1414,8 +1440,7 @@ void GLTF_Parser::Parse_IMAGES( idToken& token )
 
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfImage", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfImage* image = currentAsset->Image();
 		uri->Set( &image->uri, &image->bufferView, currentAsset );
@@ -1456,8 +1481,7 @@ void GLTF_Parser::Parse_ACCESSORS( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfAccessor", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfAccessor* item = currentAsset->Accessor();
 		GLTFARRAYITEMREF( item, bufferView );
@@ -1499,8 +1523,7 @@ void GLTF_Parser::Parse_BUFFERVIEWS( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfBufferView", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfBufferView* gltfBV = currentAsset->BufferView();
 		GLTFARRAYITEMREF( gltfBV, buffer	);
@@ -1536,8 +1559,7 @@ void GLTF_Parser::Parse_SAMPLERS( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfSampler", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfSampler* gltfSampl = currentAsset->Sampler();
 		GLTFARRAYITEMREF( gltfSampl, magFilter );
@@ -1569,8 +1591,7 @@ void GLTF_Parser::Parse_BUFFERS( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfBuffer", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfBuffer* gltfBuf = currentAsset->Buffer();
 		gltfBuf->parent = currentAsset;
@@ -1601,8 +1622,7 @@ void GLTF_Parser::Parse_ANIMATIONS( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfAnimation", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfAnimation* gltfanim = currentAsset->Animation();
 
@@ -1634,8 +1654,7 @@ void GLTF_Parser::Parse_SKINS( idToken& token )
 	gltfPropertyArray array = gltfPropertyArray( &parser );
 	for( auto& prop : array )
 	{
-		idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-		lexer.LoadMemory( prop.item.c_str(), prop.item.Size(), "gltfSkin", 0 );
+		gltfJsonScanner& lexer = prop.section;
 
 		gltfSkin* gltfSkin = currentAsset->Skin();
 
@@ -1657,15 +1676,13 @@ void GLTF_Parser::Parse_SKINS( idToken& token )
 
 void GLTF_Parser::Parse_EXTENSIONS( idToken& token )
 {
-	idStr json;
-	parser.ParseBracedSection( json );
+	gltfJsonScanner lexer;
+	parser.ParseBracedSection( lexer );
 
 	gltfItemArray extensions;
 	//GLTFARRAYITEM( extensions, KHR_materials_pbrSpecularGlossiness, gltfItem_KHR_materials_pbrSpecularGlossiness );
 	GLTFARRAYITEM( extensions, KHR_lights_punctual, gltfItem_KHR_lights_punctual );
 
-	idLexer lexer( LEXFL_ALLOWPATHNAMES | LEXFL_ALLOWMULTICHARLITERALS | LEXFL_NOSTRINGESCAPECHARS );
-	lexer.LoadMemory( json.c_str(), json.Size(), "Extensions", 0 );
 	gltfExtensions* gltfextension = currentAsset->Extensions();
 	//KHR_materials_pbrSpecularGlossiness->Set( &gltfextensions, &lexer );
 	KHR_lights_punctual->Set( gltfextension, &lexer );
@@ -1673,7 +1690,8 @@ void GLTF_Parser::Parse_EXTENSIONS( idToken& token )
 
 	if( gltf_parseVerbose.GetBool() )
 	{
-		common->Printf( "%s", json.c_str() );
+		idStr json;
+		common->Printf( "%s", lexer.GetSectionText( json ) );
 	}
 }
 
@@ -1936,56 +1954,79 @@ bool GLTF_Parser::loadGLB( idStr filename )
 
 	idFile* file = fileSystem->OpenFileRead( filename );
 
-	if( file->Length() < 20 )
+	const int fileLength = file->Length();
+	if( fileLength < 20 )
 	{
 		common->FatalError( "Too short data size for glTF Binary." );
 		return false;
 	}
+
+	// read the whole file in one go, the json and bin chunks are used in place
+	byte* fileData = ( byte* ) Mem_Alloc( fileLength, TAG_IDLIB_GLTF );
+	if( file->Read( fileData, fileLength ) != fileLength )
+	{
+		common->FatalError( "Could not read %s", filename.c_str() );
+	}
+	delete file;
+
 	idStr gltfMagic( "glTF" );
-	unsigned char fileMagic[5];
+	char fileMagic[5];
 
-	file->Read( ( void* )&fileMagic, 4 );
+	memcpy( fileMagic, fileData, 4 );
 	fileMagic[4] = 0;
-	if( gltfMagic.Icmp( ( const char* )&fileMagic ) == 0 )
+	if( gltfMagic.Icmp( fileMagic ) == 0 )
 	{
 		common->Printf( "reading %s...\n", filename.c_str() );
 	}
 	else
 	{
+		Mem_Free( fileData );
 		common->Error( "invalid magic" );
 		return false;
 	}
 
-	unsigned int version = 0;	// 4 bytes
-	unsigned int length = 0;	// 4 bytes
-
 	//HVG_TODO
 	//handle 0 bin chunk -> size is chunk[0].size  + 20;
-	file->ReadUnsignedInt( version );
-	file->ReadUnsignedInt( length );
+	unsigned int version = LittleLong( ( ( const int* )fileData )[1] );
+	if( version != 2 )
+	{
+		Mem_Free( fileData );
+		common->Warning( "%s: unsupported glb version %u", filename.c_str(), version );
+		return false;
+	}
+	unsigned int length = LittleLong( ( ( const int* )fileData )[2] );
+	if( length > ( unsigned int )fileLength )
+	{
+		common->FatalError( "corrupt glb file." );
+	}
 	length -= 12; // header size
 
-	unsigned int chunk_type = 0;	// 4 bytes
-	unsigned int chunk_length = 0;	// 4 bytes
-	byte* data = nullptr;
 	gltfData* dataCache = gltfData::Data( filename, true );
+	dataCache->SetFileData( fileData, fileLength );
 	currentAsset = dataCache;
 
+	byte* chunkStart = fileData + 12;
 	int chunkCount = 0;
 	while( length )
 	{
-		unsigned int prev_length = chunk_length;
-		length -= file->ReadUnsignedInt( chunk_length );
-		length -= file->ReadUnsignedInt( chunk_type );
+		if( length < 8 )
+		{
+			common->FatalError( "corrupt glb file." );
+		}
 
-		data = dataCache->AddData( chunk_length );
+		unsigned int chunk_length = LittleLong( ( ( const int* )chunkStart )[0] );
+		unsigned int chunk_type = LittleLong( ( ( const int* )chunkStart )[1] );
+		length -= 8;
 
-		int read = file->Read( ( void* )data, chunk_length );
-		if( read != chunk_length )
+		if( chunk_length > length )
 		{
 			common->FatalError( "Could not read full chunk (%i bytes) in file %s", chunk_length, filename.c_str() );
 		}
-		length -= read;
+
+		byte* data = dataCache->AddDataView( chunkStart + 8, chunk_length );
+		length -= chunk_length;
+		chunkStart += 8 + chunk_length;
+
 		if( chunk_type == gltfChunk_Type_JSON )
 		{
 			currentFile = filename ;
@@ -2006,7 +2047,6 @@ bool GLTF_Parser::loadGLB( idStr filename )
 	}
 
 	Parse();
-	delete file;
 	return true;
 }
 
@@ -2324,18 +2364,28 @@ gltfData::~gltfData()
 	{
 		while( totalChunks )
 		{
-			Mem_Free( data[--totalChunks] );
+			byte* chunk = data[--totalChunks];
+			if( !IsFileData( chunk ) )
+			{
+				Mem_Free( chunk );
+			}
 		}
 		Mem_Free( data );
 	}
 
-	if( json )
+	if( json && !IsFileData( json ) )
 	{
 		Mem_Free( json );
 	}
 
+	if( fileData )
+	{
+		Mem_Free( fileData );
+	}
+
 	data = nullptr;
 	json = nullptr;
+	fileData = nullptr;
 	ClearData( fileName );
 
 }
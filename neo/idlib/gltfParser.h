@@ -30,6 +30,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "containers/StrList.h"
 #include <functional>
 #include "gltfProperties.h"
+#include "gltfJsonScanner.h"
 
 #pragma region GLTF Types parsing
 
@@ -40,7 +41,7 @@ public:
 	virtual ~parsable() {}
 
 	virtual void parse( idToken& token ) = 0;
-	virtual void parse( idToken& token , idLexer* parser ) {};
+	virtual void parse( idToken& token , gltfJsonScanner* parser ) {};
 	virtual idStr& Name() = 0;
 };
 
@@ -80,7 +81,7 @@ class gltfObject : public parsable, public parseType<idStr>
 public:
 	gltfObject( idStr Name ) : name( Name ), object( "null" ) {}
 	virtual void parse( idToken& token ) {}
-	virtual void parse( idToken& token , idLexer* parser )
+	virtual void parse( idToken& token , gltfJsonScanner* parser )
 	{
 		parser->UnreadToken( &token );
 		parser->ParseBracedSection( object );
@@ -106,7 +107,7 @@ public:
 	{
 		return name;
 	}
-	void Set( gltfExtra* type, idLexer* lexer )
+	void Set( gltfExtra* type, gltfJsonScanner* lexer )
 	{
 		parseType::Set( type );
 		parser = lexer;
@@ -115,7 +116,7 @@ public:
 private:
 	idStr name;
 	gltfData* data;
-	idLexer* parser;
+	gltfJsonScanner* parser;
 };
 
 class gltfItem_uri : public parsable, public parseType<idStr>
@@ -157,10 +158,10 @@ class gltfItem_##className : public parsable, public parseType<ptype>					\
 	gltfItem_##className( idStr Name ) : name( Name ){ item = nullptr; }				\
 	virtual void parse( idToken &token );												\
 	virtual idStr &Name() { return name; }												\
-	void Set( ptype *type, idLexer *lexer ) { parseType::Set( type ); parser = lexer; }	\
+	void Set( ptype *type, gltfJsonScanner *lexer ) { parseType::Set( type ); parser = lexer; }	\
 private:																				\
 	idStr name;																			\
-	idLexer *parser;}
+	gltfJsonScanner *parser;}
 #pragma endregion
 
 gltfItemClassParser( animation_sampler,				idList<gltfAnimation_Sampler*> );
@@ -235,8 +236,8 @@ public:
 	{
 		items.Alloc() = item;
 	}
-	int Fill( idLexer* lexer , idDict* strPairs );
-	int Parse( idLexer* lexer , bool forwardLexer = false );
+	int Fill( gltfJsonScanner* lexer , idDict* strPairs );
+	int Parse( gltfJsonScanner* lexer , bool forwardLexer = false );
 	template<class T>
 	T* Get( idStr name )
 	{
@@ -259,12 +260,14 @@ public:
 	gltfPropertyItem() : array( nullptr ) { }
 	gltfPropertyArray* array;
 	idToken item;
+	// tokens of the item when the array holds objects
+	gltfJsonScanner section;
 };
 
 class gltfPropertyArray
 {
 public:
-	gltfPropertyArray( idLexer* Parser, bool AoS = true );
+	gltfPropertyArray( gltfJsonScanner* Parser, bool AoS = true );
 	~gltfPropertyArray();
 	struct Iterator
 	{
@@ -286,7 +289,7 @@ private:
 	bool iterating;
 	bool dirty;
 	int index;
-	idLexer* parser;
+	gltfJsonScanner* parser;
 	idList<gltfPropertyItem*> properties;
 	gltfPropertyItem* endPtr;
 	bool isArrayOfStructs;
@@ -336,7 +339,7 @@ private:
 	gltfProperty ParseProp( idToken& token );
 	gltfProperty ResolveProp( idToken& token );
 
-	idLexer	parser;
+	gltfJsonScanner	parser;
 	idToken	token;
 
 	bool buffersDone;
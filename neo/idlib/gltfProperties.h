@@ -765,9 +765,17 @@ public:
 class gltfData
 {
 public:
-	gltfData() : fileName( "" ), fileNameHash( 0 ), json( nullptr ), data( nullptr ), totalChunks( -1 ) { };
+	gltfData() : fileName( "" ), fileNameHash( 0 ), fileData( nullptr ), fileDataLength( 0 ), json( nullptr ), data( nullptr ), totalChunks( -1 ) { };
 	~gltfData();
 	byte* AddData( int size, int* bufferID = nullptr );
+	// adds a chunk that points into the block given to SetFileData instead of copying it
+	byte* AddDataView( byte* chunk, int size, int* bufferID = nullptr );
+	// takes ownership of a whole .glb file that was read in one go
+	void SetFileData( byte* block, int size )
+	{
+		fileData = block;
+		fileDataLength = size;
+	}
 	byte* GetJsonData( int& size )
 	{
 		size = jsonDataLength;
@@ -1550,6 +1558,13 @@ private:
 	idStr fileName;
 	int	fileNameHash;
 
+	bool IsFileData( const byte* ptr ) const
+	{
+		return fileData != nullptr && ptr >= fileData && ptr < fileData + fileDataLength;
+	}
+
+	byte* fileData;
+	int fileDataLength;
 	byte* json;
 	byte** data;
 	int jsonDataLength;
@@ -2282,4 +2282,40 @@ ID_INLINE float* idMat6::ToFloatPtr()
 	return mat[0].ToFloatPtr();
 }
 
+//===============================================================
+//
+//	idListRelocatable - the fixed size matrices can be moved by idList with memcpy
+//
+//===============================================================
+
+template<>
+struct idListRelocatable< idMat2 >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idMat3 >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idMat4 >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idMat5 >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idMat6 >
+{
+	static const bool value = true;
+};
+
 #endif /* !__MATH_MATRIX_H__ */
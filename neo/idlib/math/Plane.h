@@ -459,4 +459,16 @@ ID_INLINE float* idPlane::ToFloatPtr()
 	return reinterpret_cast<float*>( &a );
 }
 
+//===============================================================
+//
+//	idListRelocatable - planes can be moved by idList with memcpy
+//
+//===============================================================
+
+template<>
+struct idListRelocatable< idPlane >
+{
+	static const bool value = true;
+};
+
 #endif /* !__MATH_PLANE_H__ */
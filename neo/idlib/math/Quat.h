@@ -484,4 +484,22 @@ struct idTupleSize< idCQuat >
 	enum { value = 3 };
 };
 
+//===============================================================
+//
+//	idListRelocatable - the quaternions can be moved by idList with memcpy
+//
+//===============================================================
+
+template<>
+struct idListRelocatable< idQuat >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idCQuat >
+{
+	static const bool value = true;
+};
+
 #endif /* !__MATH_QUAT_H__ */
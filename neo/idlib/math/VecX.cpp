@@ -36,11 +36,11 @@ If you have questions concerning this license or the applicable additional terms
 //
 //===============================================================
 
-float	idVecX::temp[VECX_MAX_TEMP + 4];
+thread_local float	idVecX::temp[VECX_MAX_TEMP + 4];
 // RB: changed int to intptr_t
-float* 	idVecX::tempPtr = ( float* )( ( ( intptr_t ) idVecX::temp + 15 ) & ~15 );
+thread_local float* 	idVecX::tempPtr = ( float* )( ( ( intptr_t ) idVecX::temp + 15 ) & ~15 );
 // RB end
-int		idVecX::tempIndex = 0;
+thread_local int		idVecX::tempIndex = 0;
 
 /*
 =============
@@ -1799,4 +1799,40 @@ inline uint32_t Vec4ToColorInt( const idVec4& vec )
 
 #define	VectorMA( v, s, b, o )		((o)[0]=(v)[0]+(b)[0]*(s),(o)[1]=(v)[1]+(b)[1]*(s),(o)[2]=(v)[2]+(b)[2]*(s))
 
+//===============================================================
+//
+//	idListRelocatable - the vectors are plain floats and can be moved by idList with memcpy
+//
+//===============================================================
+
+template<>
+struct idListRelocatable< idVec2 >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idVec3 >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idVec4 >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idVec5 >
+{
+	static const bool value = true;
+};
+
+template<>
+struct idListRelocatable< idVec6 >
+{
+	static const bool value = true;
+};
+
 #endif /* !__MATH_VECTOR_H__ */
@@ -46,9 +46,20 @@
 #include "BinkDecoder.h"
 #include "LogError.h"
 #include "FFmpeg_includes.h"
+#include <mutex>
 
 std::vector<class BinkDecoder*> classInstances;
 
+// decoders may run on other threads while new files are opened, so the instance
+// vector is only touched under this lock
+static std::mutex classInstancesMutex;
+
+static BinkDecoder* GetInstance(BinkHandle &handle)
+{
+	std::lock_guard<std::mutex> lock(classInstancesMutex);
+	return classInstances[handle.instanceIndex];
+}
+
 BinkHandle Bink_Open(const char* fileName)
 {
 	BinkHandle newHandle;
@@ -75,6 +86,7 @@ BinkHandle Bink_Open(const char* fileName)
 	}
 #endif
 	// add instance to global instance vector
+	std::lock_guard<std::mutex> lock(classInstancesMutex);
 	classInstances.push_back(newDecoder);
 
 	// get a handle ID
@@ -86,15 +98,21 @@ BinkHandle Bink_Open(const char* fileName)
 
 void Bink_Close(BinkHandle &handle)
 {
-	if (!classInstances.at(handle.instanceIndex))
+	BinkDecoder *decoder;
+	{
+		std::lock_guard<std::mutex> lock(classInstancesMutex);
+		decoder = classInstances.at(handle.instanceIndex);
+		classInstances[handle.instanceIndex] = 0;
+	}
+
+	if (!decoder)
 	{
 		// invalid handle
 		return;
 	}
 
 	// close bink decoder
-	delete classInstances[handle.instanceIndex];
-	classInstances[handle.instanceIndex] = 0;
+	delete decoder;
 
 	handle.instanceIndex = -1;
 	handle.isValid = false;
@@ -105,12 +123,12 @@ uint32_t Bink_GetNumAudioTracks(BinkHandle &handle)
 	if (handle.instanceIndex == -1)
 		return 0;
 	else
-		return classInstances[handle.instanceIndex]->GetNumAudioTracks();
+		return GetInstance(handle)->GetNumAudioTracks();
 }
 
 AudioInfo Bink_GetAudioTrackDetails(BinkHandle &handle, uint32_t trackIndex)
 {
-	return classInstances[handle.instanceIndex]->GetAudioTrackDetails(trackIndex);
+	return GetInstance(handle)->GetAudioTrackDetails(trackIndex);
 }
 
 /* Get a frame's worth of audio data. 
@@ -121,28 +139,30 @@ AudioInfo Bink_GetAudioTrackDetails(BinkHandle &handle, uint32_t trackIndex)
  */
 uint32_t Bink_GetAudioData(BinkHandle &handle, uint32_t trackIndex, int16_t *data)
 {
-	return classInstances[handle.instanceIndex]->GetAudioData(trackIndex, data);
+	return GetInstance(handle)->GetAudioData(trackIndex, data);
 }
 
 uint32_t Bink_GetNumFrames(BinkHandle &handle)
 {
-	return classInstances[handle.instanceIndex]->GetNumFrames();
+	return GetInstance(handle)->GetNumFrames();
 }
 
 void Bink_GetFrameSize(BinkHandle &handle, uint32_t &width, uint32_t &height)
 {
-	width  = classInstances[handle.instanceIndex]->frameWidth;
-	height = classInstances[handle.instanceIndex]->frameHeight;
+	BinkDecoder *decoder = GetInstance(handle);
+
+	width  = decoder->frameWidth;
+	height = decoder->frameHeight;
 }
 
 uint32_t Bink_GetCurrentFrameNum(BinkHandle &handle)
 {
-	return classInstances[handle.instanceIndex]->GetCurrentFrameNum();
+	return GetInstance(handle)->GetCurrentFrameNum();
 }
 
 uint32_t Bink_GetNextFrame(BinkHandle &handle, YUVbuffer yuv)
 {
-	BinkDecoder *decoder = classInstances[handle.instanceIndex];
+	BinkDecoder *decoder = GetInstance(handle);
 
 	uint32_t frameIndex = decoder->GetCurrentFrameNum();
 
@@ -153,12 +173,12 @@ uint32_t Bink_GetNextFrame(BinkHandle &handle, YUVbuffer yuv)
 
 float Bink_GetFrameRate(BinkHandle &handle)
 {
-	return classInstances[handle.instanceIndex]->GetFrameRate();
+	return GetInstance(handle)->GetFrameRate();
 }
 
 void Bink_GotoFrame(BinkHandle &handle, uint32_t frameNum)
 {
-	classInstances[handle.instanceIndex]->GotoFrame(frameNum);
+	GetInstance(handle)->GotoFrame(frameNum);
 }
 
 BinkDecoder::BinkDecoder()
@@ -48,6 +48,7 @@
 #include "LogError.h"
 #include "binkdata.h"
 #include <algorithm> // DG: for std::min/max
+#include <mutex>
 
 static const uint8_t bink_rlelens[4] = { 4, 8, 12, 32 };
 
@@ -121,13 +122,20 @@ uint8_t BinkDecoder::GetHuffSymbol(BinkCommon::BitReader &bits, Tree &tree)
 // codes for each symbol in an array sorted by code length and search for a match every time a bit is read in." 
 void BinkDecoder::InitTrees()
 {
-	for (uint32_t i = 0; i < kNumTrees; i++)
+	// the trees are shared by all decoders, build them only once so opening a file
+	// can't modify them while another decoder is reading them on a different thread
+	static std::once_flag treesInitialized;
+
+	std::call_once(treesInitialized, []()
 	{
-		// get max code length
-		const int maxBits = bink_tree_lens[i][15];
+		for (uint32_t i = 0; i < kNumTrees; i++)
+		{
+			// get max code length
+			const int maxBits = bink_tree_lens[i][15];
 
-		VLC_InitTable(bink_trees[i], maxBits, 16, &bink_tree_lens[i][0], &bink_tree_bits[i][0]);
-	}
+			VLC_InitTable(bink_trees[i], maxBits, 16, &bink_tree_lens[i][0], &bink_tree_bits[i][0]);
+		}
+	});
 }
 
 /**
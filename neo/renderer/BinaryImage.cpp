@@ -833,6 +833,50 @@ ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime )
 	return FILE_NOT_FOUND_TIMESTAMP;
 }
 
+/*
+==========================
+idBinaryImage::LoadFromGeneratedFileThreaded
+
+Same as LoadFromGeneratedFile, but may run in several jobs at once. The file system
+is not thread safe, so only reading the file into memory is serialized, the parsing
+and format conversion run in parallel.
+==========================
+*/
+ID_TIME_T idBinaryImage::LoadFromGeneratedFileThreaded( ID_TIME_T sourceFileTime )
+{
+	static idSysMutex fileMutex;
+
+	idStr binaryFileName;
+	MakeGeneratedFileName( binaryFileName );
+
+	ID_TIME_T timeStamp;
+	int length;
+	byte* buffer;
+	{
+		idScopedCriticalSection lock( fileMutex );
+
+		idFileLocal bFile = fileSystem->OpenFileRead( binaryFileName );
+		if( bFile == NULL )
+		{
+			return FILE_NOT_FOUND_TIMESTAMP;
+		}
+		timeStamp = bFile->Timestamp();
+		length = bFile->Length();
+		buffer = ( byte* )Mem_Alloc( length, TAG_TEMP );
+		if( bFile->Read( buffer, length ) != length )
+		{
+			Mem_Free( buffer );
+			return FILE_NOT_FOUND_TIMESTAMP;
+		}
+	}
+
+	idFile_Memory memFile( binaryFileName, ( const char* )buffer, length );
+	const bool loaded = LoadFromGeneratedFile( &memFile, sourceFileTime );
+	Mem_Free( buffer );
+
+	return loaded ? timeStamp : FILE_NOT_FOUND_TIMESTAMP;
+}
+
 /*
 ==========================
 idBinaryImage::LoadFromGeneratedFile
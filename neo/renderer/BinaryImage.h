@@ -58,6 +58,7 @@ public:
 
 	bool				LoadFromGeneratedFile( idFile* f, ID_TIME_T sourceFileTime );
 	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime );
+	ID_TIME_T			LoadFromGeneratedFileThreaded( ID_TIME_T sourceFileTime );
 	ID_TIME_T			WriteGeneratedFile( ID_TIME_T sourceFileTime );
 
 	const bimageFile_t& GetFileHeader()
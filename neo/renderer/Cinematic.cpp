@@ -39,6 +39,7 @@ If you have questions concerning this license or the applicable additional terms
 
 // SRS - Add cvar to control whether cinematic audio is played: default is ON
 idCVar s_playCinematicAudio( "s_playCinematicAudio", "1", CVAR_BOOL | CVAR_NEW, "Play audio if available in cinematic video files" );
+idCVar r_cinematicDecodeThread( "r_cinematicDecodeThread", "1", CVAR_RENDERER | CVAR_BOOL, "decode Bink cinematics ahead of playback on a background thread" );
 
 // DG: get rid of libjpeg; as far as I can tell no roqs that actually use it exist
 //#define ID_USE_LIBJPEG 1
@@ -89,6 +90,23 @@ extern "C"
 	#include <BinkDecoder.h>
 #endif // USE_BINKDEC
 
+#ifdef USE_BINKDEC
+// number of frames the decode thread may run ahead of playback
+const int CIN_DECODE_AHEAD_FRAMES = 4;
+
+// a decoded frame waiting in the decode ring
+typedef struct
+{
+	int						frameNum;
+	YUVbuffer				planes;				// tightly packed copies of the decoder planes
+	uint32_t				planeBytes[3];
+	int16_t*				audio;				// handed over to PlayAudio() when the frame is shown
+	uint32_t				audioBytes;
+} cinDecodedFrame_t;
+
+class idCinematicDecodeThread;
+#endif // USE_BINKDEC
+
 class idCinematicLocal : public idCinematic
 {
 public:
@@ -107,6 +125,11 @@ public:
 	// SRS end
 	virtual void			ResetTime( int time );
 
+#ifdef USE_BINKDEC
+	// decodes every frame into memory without uploading, returns the number of frames
+	int						DecodeAllFrames( bool simdConvert );
+#endif
+
 private:
 
 #if defined(USE_FFMPEG)
@@ -154,6 +177,22 @@ private:
 	uint32_t				audioTracks;
 	uint32_t				trackIndex;
 	AudioInfo				binkInfo;
+
+	// frames are decoded ahead of playback into a small ring, either by the
+	// decode thread or on demand when r_cinematicDecodeThread is off
+	friend class			idCinematicDecodeThread;
+	idCinematicDecodeThread*	decodeThread;
+	cinDecodedFrame_t		decodedFrames[CIN_DECODE_AHEAD_FRAMES];
+	idSysInterlockedInteger	decodeWritePos;
+	idSysInterlockedInteger	decodeReadPos;
+	idSysInterlockedInteger	decodeFrameNum;		// next frame to decode, written by the decoding thread
+	idSysSignal				decodeFrameReady[CIN_DECODE_AHEAD_FRAMES];	// raised when a slot has been filled
+
+	void					DecodeFrames( int maxFrames );
+	cinDecodedFrame_t*		NextDecodedFrame();
+	void					ReleaseDecodedFrame();
+	void					FlushDecodedFrames();
+	void					StopDecodeThread();
 #endif
 	idImage*				img;
 	bool					isRoQ;
@@ -227,6 +266,19 @@ private:
 	CinematicAudio*			cinematicAudio = NULL;
 };
 
+#ifdef USE_BINKDEC
+class idCinematicDecodeThread : public idSysThread
+{
+public:
+	virtual int				Run()
+	{
+		cinematic->DecodeFrames( CIN_DECODE_AHEAD_FRAMES );
+		return 0;
+	}
+	idCinematicLocal*		cinematic;
+};
+#endif
+
 // Carl: ROQ files from original Doom 3
 const int DEFAULT_CIN_WIDTH		= 512;
 const int DEFAULT_CIN_HEIGHT	= 512;
@@ -484,6 +536,8 @@ idCinematicLocal::idCinematicLocal()
 	audioTracks = 0;
 	trackIndex = -1;
 	binkInfo = {};
+	decodeThread = NULL;
+	memset( decodedFrames, 0, sizeof( decodedFrames ) );
 
 	imgY = globalImages->AllocStandaloneImage( "_cinematicY" );
 	imgCr = globalImages->AllocStandaloneImage( "_cinematicCr" );
@@ -950,6 +1004,7 @@ bool idCinematicLocal::InitFromBinkDecFile( const char* qpath, bool amilooping,
 	common->Printf( "Loaded Bink file: '%s', looping=%d, %dx%d, %3.2f FPS, %4.1f sec\n", qpath, looping, CIN_WIDTH, CIN_HEIGHT, frameRate, durationSec );
 
 	memset( yuvBuffer, 0, sizeof( yuvBuffer ) );
+	FlushDecodedFrames();
 
 	status = FMV_PLAY;
 	hasFrame = false;                               // SRS - Implemented hasFrame for BinkDec behaviour consistency with FFMPEG
@@ -969,6 +1024,9 @@ void idCinematicLocal::BinkDecReset()
 {
 	framePos = -1;
 
+	// the decoder can't be repositioned while it is decoding ahead
+	FlushDecodedFrames();
+
 	// SRS - If we have cinematic audio, reset audio to release any stale buffers (even if looping)
 	if( cinematicAudio )
 	{
@@ -1195,6 +1253,18 @@ void idCinematicLocal::Close()
 #elif defined(USE_BINKDEC)
 	else //if( !isRoQ )
 	{
+		StopDecodeThread();
+		FlushDecodedFrames();
+		for( int i = 0; i < CIN_DECODE_AHEAD_FRAMES; i++ )
+		{
+			for( int j = 0; j < 3; j++ )
+			{
+				Mem_Free( decodedFrames[i].planes[j].data );
+			}
+			Mem_Free( decodedFrames[i].audio );
+		}
+		memset( decodedFrames, 0, sizeof( decodedFrames ) );
+
 		if( binkHandle.isValid )
 		{
 			memset( yuvBuffer, 0 , sizeof( yuvBuffer ) );
@@ -1595,9 +1665,8 @@ idCinematicLocal::ImageForTimeBinkDec
 #ifdef USE_BINKDEC
 cinData_t idCinematicLocal::ImageForTimeBinkDec( int thisTime, nvrhi::ICommandList* commandList )
 {
-	cinData_t	cinData;
-	int16_t*	audioBuffer = NULL;
-	uint32_t	num_bytes = 0;
+	cinData_t			cinData;
+	cinDecodedFrame_t*	decoded = NULL;
 
 	memset( &cinData, 0, sizeof( cinData ) );
 	if( !binkHandle.isValid )
@@ -1664,12 +1733,32 @@ cinData_t idCinematicLocal::ImageForTimeBinkDec( int thisTime, nvrhi::ICommandLi
 
 	// Bink_GotoFrame(binkHandle, desiredFrame);
 	// apparently Bink_GotoFrame() doesn't work super well, so skip frames
-	// (if necessary) by calling Bink_GetNextFrame()
+	// (if necessary) by taking every decoded frame up to the desired one
 	while( framePos < desiredFrame )
 	{
-		framePos = Bink_GetNextFrame( binkHandle, yuvBuffer );
+		decoded = NextDecodedFrame();
+		if( decoded == NULL )
+		{
+			break;
+		}
+
+		framePos = decoded->frameNum;
+		if( framePos < desiredFrame )
+		{
+			// the audio of skipped frames is dropped
+			ReleaseDecodedFrame();
+			decoded = NULL;
+		}
+	}
+
+	if( decoded == NULL )
+	{
+		hasFrame = false;
+		return cinData;
 	}
 
+	memcpy( yuvBuffer, decoded->planes, sizeof( yuvBuffer ) );
+
 	cinData.imageWidth = CIN_WIDTH;
 	cinData.imageHeight = CIN_HEIGHT;
 	cinData.status = status;
@@ -1723,26 +1812,365 @@ cinData_t idCinematicLocal::ImageForTimeBinkDec( int thisTime, nvrhi::ICommandLi
 	cinData.imageCr = imgCr;
 	cinData.imageCb = imgCb;
 
-	if( cinematicAudio )
+	// SRS - If we have cinematic audio data, start playing it now
+	if( cinematicAudio && decoded->audioBytes > 0 )
 	{
-		audioBuffer = ( int16_t* )Mem_Alloc( binkInfo.idealBufferSize, TAG_AUDIO );
-		num_bytes = Bink_GetAudioData( binkHandle, trackIndex, audioBuffer );
+		// SRS - Note that PlayAudio() is responsible for releasing any audio buffers sent to it
+		cinematicAudio->PlayAudio( ( uint8_t* )decoded->audio, decoded->audioBytes );
+		decoded->audio = NULL;
+		decoded->audioBytes = 0;
+	}
+
+	// the planes have been uploaded, let the decoder reuse the slot
+	ReleaseDecodedFrame();
+
+	return cinData;
+}
+
+/*
+==============
+idCinematicLocal::DecodeFrames
+
+Decodes up to maxFrames frames into the free slots of the decode ring.
+==============
+*/
+void idCinematicLocal::DecodeFrames( int maxFrames )
+{
+	YUVbuffer yuv;
 
-		// SRS - If we have cinematic audio data, start playing it now
-		if( num_bytes > 0 )
+	for( int i = 0; i < maxFrames; i++ )
+	{
+		const int writePos = decodeWritePos.GetValue();
+		if( writePos - decodeReadPos.GetValue() >= CIN_DECODE_AHEAD_FRAMES || decodeFrameNum.GetValue() >= numFrames )
+		{
+			break;
+		}
+
+		const int slot = writePos % CIN_DECODE_AHEAD_FRAMES;
+		cinDecodedFrame_t& decoded = decodedFrames[slot];
+
+		decoded.frameNum = Bink_GetNextFrame( binkHandle, yuv );
+
+		// the decoder reuses its planes for the next frame, so copy them out
+		for( int j = 0; j < 3; j++ )
+		{
+			ImagePlane& plane = decoded.planes[j];
+			const uint32_t bytes = yuv[j].width * yuv[j].height;
+
+			if( bytes > decoded.planeBytes[j] )
+			{
+				Mem_Free( plane.data );
+				plane.data = ( uint8_t* )Mem_Alloc( bytes, TAG_CINEMATIC );
+				decoded.planeBytes[j] = bytes;
+			}
+
+			plane.width = yuv[j].width;
+			plane.height = yuv[j].height;
+			plane.pitch = yuv[j].width;
+
+			for( uint32_t y = 0; y < plane.height; y++ )
+			{
+				memcpy( plane.data + y * plane.pitch, yuv[j].data + y * yuv[j].pitch, plane.width );
+			}
+		}
+
+		decoded.audioBytes = 0;
+		if( cinematicAudio )
+		{
+			if( decoded.audio == NULL )
+			{
+				decoded.audio = ( int16_t* )Mem_Alloc( binkInfo.idealBufferSize, TAG_AUDIO );
+			}
+			decoded.audioBytes = Bink_GetAudioData( binkHandle, trackIndex, decoded.audio );
+		}
+
+		// publish the slot before the frame number, so a reader that sees the
+		// last frame number also sees the last frame
+		decodeWritePos.Increment();
+		decodeFrameNum.SetValue( decoded.frameNum + 1 );
+		decodeFrameReady[slot].Raise();
+	}
+}
+
+/*
+==============
+idCinematicLocal::NextDecodedFrame
+
+Returns the oldest decoded frame, waiting for the decoder if the ring is empty.
+Returns NULL when there are no frames left to decode.
+==============
+*/
+cinDecodedFrame_t* idCinematicLocal::NextDecodedFrame()
+{
+	if( decodeReadPos.GetValue() == decodeWritePos.GetValue() )
+	{
+		if( decodeThread == NULL && r_cinematicDecodeThread.GetBool() )
+		{
+			decodeThread = new( TAG_CINEMATIC ) idCinematicDecodeThread;
+			decodeThread->cinematic = this;
+			decodeThread->StartWorkerThread( "CinematicDecode", CORE_ANY, THREAD_NORMAL );
+		}
+
+		if( decodeThread != NULL )
 		{
-			// SRS - Note that PlayAudio() is responsible for releasing any audio buffers sent to it
-			cinematicAudio->PlayAudio( ( uint8_t* )audioBuffer, num_bytes );
+			// playback caught up with the decoder, only wait for the slot
+			// we are about to read instead of the whole decode-ahead pass
+			const int readPos = decodeReadPos.GetValue();
+			decodeThread->SignalWork();
+			while( readPos == decodeWritePos.GetValue() && decodeFrameNum.GetValue() < numFrames )
+			{
+				decodeFrameReady[readPos % CIN_DECODE_AHEAD_FRAMES].Wait( idSysSignal::WAIT_INFINITE );
+			}
 		}
 		else
 		{
-			// SRS - Even though we have no audio data to play, still need to free the audio buffer
-			Mem_Free( audioBuffer );
-			audioBuffer = NULL;
+			DecodeFrames( 1 );
+		}
+
+		if( decodeReadPos.GetValue() == decodeWritePos.GetValue() )
+		{
+			return NULL;
 		}
 	}
 
-	return cinData;
+	return &decodedFrames[decodeReadPos.GetValue() % CIN_DECODE_AHEAD_FRAMES];
+}
+
+/*
+==============
+idCinematicLocal::ReleaseDecodedFrame
+
+Hands the slot returned by NextDecodedFrame() back to the decoder.
+==============
+*/
+void idCinematicLocal::ReleaseDecodedFrame()
+{
+	decodeReadPos.Increment();
+
+	if( decodeThread != NULL )
+	{
+		decodeThread->SignalWork();
+	}
+}
+
+/*
+==============
+idCinematicLocal::FlushDecodedFrames
+==============
+*/
+void idCinematicLocal::FlushDecodedFrames()
+{
+	if( decodeThread != NULL )
+	{
+		decodeThread->WaitForThread();
+	}
+
+	decodeReadPos.SetValue( 0 );
+	decodeWritePos.SetValue( 0 );
+	decodeFrameNum.SetValue( 0 );
+	for( int i = 0; i < CIN_DECODE_AHEAD_FRAMES; i++ )
+	{
+		decodeFrameReady[i].Clear();
+	}
+}
+
+/*
+==============
+idCinematicLocal::StopDecodeThread
+==============
+*/
+void idCinematicLocal::StopDecodeThread()
+{
+	if( decodeThread != NULL )
+	{
+		decodeThread->StopThread();
+		delete decodeThread;
+		decodeThread = NULL;
+	}
+}
+
+/*
+==============
+Cin_ClampByte
+==============
+*/
+static ID_INLINE byte Cin_ClampByte( int v )
+{
+	return ( byte )( v < 0 ? 0 : ( v > 255 ? 255 : v ) );
+}
+
+/*
+==============
+Cin_YUV420ToRGBA
+
+Converts planar 4:2:0 YCbCr (planes in Y, Cb, Cr order) to RGBA with the same
+BT.601 coefficients as the bink shaders, in 6 bit fixed point. The SSE2 path
+handles 16 pixels at a time and matches the scalar path bit for bit.
+==============
+*/
+static void Cin_YUV420ToRGBA( const ImagePlane* planes, byte* rgba, bool simd )
+{
+	const int width = planes[0].width;
+	const int height = planes[0].height;
+
+	for( int y = 0; y < height; y++ )
+	{
+		const byte* yRow = planes[0].data + y * planes[0].pitch;
+		const byte* cbRow = planes[1].data + ( y >> 1 ) * planes[1].pitch;
+		const byte* crRow = planes[2].data + ( y >> 1 ) * planes[2].pitch;
+		byte* dst = rgba + y * width * 4;
+		int x = 0;
+
+#if defined(USE_INTRINSICS_SSE)
+		if( simd )
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i alpha = _mm_set1_epi8( -1 );
+			const __m128i lumaBias = _mm_set1_epi16( 16 );
+			const __m128i chromaBias = _mm_set1_epi16( 128 );
+			const __m128i round = _mm_set1_epi16( 32 );
+			const __m128i lumaScale = _mm_set1_epi16( 75 );
+			const __m128i crToR = _mm_set1_epi16( 102 );
+			const __m128i crToG = _mm_set1_epi16( -52 );
+			const __m128i cbToG = _mm_set1_epi16( -25 );
+			const __m128i cbToB = _mm_set1_epi16( 129 );
+
+			for( ; x + 16 <= width; x += 16 )
+			{
+				const __m128i lumaBytes = _mm_loadu_si128( ( const __m128i* )( yRow + x ) );
+				const __m128i cb = _mm_sub_epi16( _mm_unpacklo_epi8( _mm_loadl_epi64( ( const __m128i* )( cbRow + ( x >> 1 ) ) ), zero ), chromaBias );
+				const __m128i cr = _mm_sub_epi16( _mm_unpacklo_epi8( _mm_loadl_epi64( ( const __m128i* )( crRow + ( x >> 1 ) ) ), zero ), chromaBias );
+
+				// chroma contributions for 8 horizontal pixel pairs, with rounding folded in
+				const __m128i rc = _mm_add_epi16( _mm_mullo_epi16( cr, crToR ), round );
+				const __m128i gc = _mm_add_epi16( _mm_add_epi16( _mm_mullo_epi16( cr, crToG ), _mm_mullo_epi16( cb, cbToG ) ), round );
+				const __m128i bc = _mm_add_epi16( _mm_mullo_epi16( cb, cbToB ), round );
+
+				const __m128i lumaLo = _mm_mullo_epi16( _mm_sub_epi16( _mm_unpacklo_epi8( lumaBytes, zero ), lumaBias ), lumaScale );
+				const __m128i lumaHi = _mm_mullo_epi16( _mm_sub_epi16( _mm_unpackhi_epi8( lumaBytes, zero ), lumaBias ), lumaScale );
+
+				// saturation only happens for values that clamp to 255 anyway
+				const __m128i r = _mm_packus_epi16( _mm_srai_epi16( _mm_adds_epi16( lumaLo, _mm_unpacklo_epi16( rc, rc ) ), 6 ),
+													_mm_srai_epi16( _mm_adds_epi16( lumaHi, _mm_unpackhi_epi16( rc, rc ) ), 6 ) );
+				const __m128i g = _mm_packus_epi16( _mm_srai_epi16( _mm_adds_epi16( lumaLo, _mm_unpacklo_epi16( gc, gc ) ), 6 ),
+													_mm_srai_epi16( _mm_adds_epi16( lumaHi, _mm_unpackhi_epi16( gc, gc ) ), 6 ) );
+				const __m128i b = _mm_packus_epi16( _mm_srai_epi16( _mm_adds_epi16( lumaLo, _mm_unpacklo_epi16( bc, bc ) ), 6 ),
+													_mm_srai_epi16( _mm_adds_epi16( lumaHi, _mm_unpackhi_epi16( bc, bc ) ), 6 ) );
+
+				const __m128i rgLo = _mm_unpacklo_epi8( r, g );
+				const __m128i rgHi = _mm_unpackhi_epi8( r, g );
+				const __m128i baLo = _mm_unpacklo_epi8( b, alpha );
+				const __m128i baHi = _mm_unpackhi_epi8( b, alpha );
+
+				_mm_storeu_si128( ( __m128i* )( dst + x * 4 + 0 ), _mm_unpacklo_epi16( rgLo, baLo ) );
+				_mm_storeu_si128( ( __m128i* )( dst + x * 4 + 16 ), _mm_unpackhi_epi16( rgLo, baLo ) );
+				_mm_storeu_si128( ( __m128i* )( dst + x * 4 + 32 ), _mm_unpacklo_epi16( rgHi, baHi ) );
+				_mm_storeu_si128( ( __m128i* )( dst + x * 4 + 48 ), _mm_unpackhi_epi16( rgHi, baHi ) );
+			}
+		}
+#endif
+
+		for( ; x < width; x++ )
+		{
+			const int cb = cbRow[x >> 1] - 128;
+			const int cr = crRow[x >> 1] - 128;
+			const int luma = ( yRow[x] - 16 ) * 75;
+
+			dst[x * 4 + 0] = Cin_ClampByte( ( luma + 102 * cr + 32 ) >> 6 );
+			dst[x * 4 + 1] = Cin_ClampByte( ( luma - 52 * cr - 25 * cb + 32 ) >> 6 );
+			dst[x * 4 + 2] = Cin_ClampByte( ( luma + 129 * cb + 32 ) >> 6 );
+			dst[x * 4 + 3] = 255;
+		}
+	}
+}
+
+/*
+==============
+idCinematicLocal::DecodeAllFrames
+
+Runs the whole file through the decode ring and converts every frame to RGBA
+in memory. Nothing is uploaded, so this works without a renderer.
+==============
+*/
+int idCinematicLocal::DecodeAllFrames( bool simdConvert )
+{
+	idList<byte, TAG_CINEMATIC> rgba;
+	cinDecodedFrame_t* decoded;
+	int frames = 0;
+
+	if( isRoQ || !binkHandle.isValid )
+	{
+		return 0;
+	}
+
+	BinkDecReset();
+
+	while( ( decoded = NextDecodedFrame() ) != NULL )
+	{
+		rgba.SetNum( decoded->planes[0].width * decoded->planes[0].height * 4 );
+		Cin_YUV420ToRGBA( decoded->planes, rgba.Ptr(), simdConvert );
+		ReleaseDecodedFrame();
+		frames++;
+	}
+
+	BinkDecReset();
+	StopDecodeThread();
+
+	return frames;
+}
+
+/*
+==============
+TestCinematicDecode_f
+==============
+*/
+CONSOLE_COMMAND( testCinematicDecode, "decodes a Bink cinematic into memory and reports frames per second", idCmdSystem::ArgCompletion_VideoName )
+{
+	if( args.Argc() < 2 )
+	{
+		common->Printf( "usage: testCinematicDecode <file>\n" );
+		return;
+	}
+
+	const bool decodeThread = r_cinematicDecodeThread.GetBool();
+	const bool playAudio = s_playCinematicAudio.GetBool();
+	s_playCinematicAudio.SetBool( false );
+
+	idCinematicLocal* cin = new( TAG_CINEMATIC ) idCinematicLocal;
+	if( cin->InitFromFile( args.Argv( 1 ), false, NULL ) )
+	{
+		static const struct
+		{
+			const char*	name;
+			bool		thread;
+			bool		simd;
+		} tests[] =
+		{
+			{ "serial decode, scalar convert", false, false },
+			{ "serial decode, SIMD convert", false, true },
+			{ "threaded decode, SIMD convert", true, true },
+		};
+
+		for( int i = 0; i < sizeof( tests ) / sizeof( tests[0] ); i++ )
+		{
+			r_cinematicDecodeThread.SetBool( tests[i].thread );
+
+			const uint64_t start = Sys_Microseconds();
+			const int frames = cin->DecodeAllFrames( tests[i].simd );
+			const float msec = ( Sys_Microseconds() - start ) / 1000.0f;
+
+			common->Printf( "%-32s %5d frames in %8.1f ms, %7.1f fps\n", tests[i].name, frames, msec, frames * 1000.0f / Max( msec, 0.001f ) );
+		}
+	}
+	else
+	{
+		common->Printf( "couldn't open %s\n", args.Argv( 1 ) );
+	}
+
+	delete cin;
+
+	r_cinematicDecodeThread.SetBool( decodeThread );
+	s_playCinematicAudio.SetBool( playAudio );
 }
 #endif
 
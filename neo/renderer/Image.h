@@ -254,6 +254,7 @@ typedef enum
 typedef void ( *ImageGeneratorFunction )( idImage* image, nvrhi::ICommandList* commandList );
 
 #include "BinaryImage.h"
+#include "ImageResidency.h"
 
 #define	MAX_IMAGE_NAME	256
 
@@ -329,6 +330,22 @@ public:
 
 	void		ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandList );
 
+	// ActuallyLoadImage split up for LoadLevelImages, which reads and converts the binary
+	// images in jobs and uploads them on the calling thread. LoadBinaryImage is the only
+	// thread safe part, it returns false if the image has to go through ActuallyLoadImage.
+	void		PrepareBinaryImage( idStrStatic< MAX_OSPATH >& generatedName );
+	bool		LoadBinaryImage( idBinaryImage& im );
+	bool		BinaryImageIsCurrent( const bimageFile_t& header ) const;
+	void		SetOptsFromBinaryImage( const bimageFile_t& header );
+	void		UploadBinaryImage( idBinaryImage& im, nvrhi::ICommandList* commandList );
+
+	// number of top mip levels UploadBinaryImage leaves out to get below streamMaxSize
+	int			StreamSkipMips() const;
+
+	// recreates a streamed image with fewer top levels by copying the remaining levels
+	// on the gpu, returns false if the image has to be read again instead
+	bool		DropStreamedMips( int skipMips, nvrhi::ICommandList* commandList );
+
 	// Adds the image to the list of images to load on the main thread to the gpu.
 	void		DeferredLoadImage();
 
@@ -475,6 +492,11 @@ private:
 
 	int					refCount;				// overall ref count
 
+	// mip streaming, see idImageResidency
+	int					streamMaxSize;			// 0 uploads all levels, otherwise the larger top levels are left out
+	int					streamSkippedMips;		// top levels left out by the last upload
+	int					residencyIndex;			// -1 if the residency manager doesn't track this image
+
 	static const uint32_t TEXTURE_NOT_LOADED = 0xFFFFFFFF;
 
 	nvrhi::TextureHandle	texture;
@@ -503,6 +525,26 @@ void	R_WritePNG( const char* filename, const byte* data, int bytesPerPixel, int
 void	R_WriteEXR( const char* filename, const void* data, int channelsPerPixel, int width, int height, const char* basePath = "fs_savepath" );
 // RB end
 
+// A streamed image that gets more levels, the binary image is read in a job and
+// uploaded on a later frame once the read has finished.
+struct residencyLoad_t
+{
+	idImage* 		image;
+	idBinaryImage* 	binaryImage;
+	int				index;			// residency index
+	int				skipMips;
+	bool			loaded;			// the binary image is current and can be uploaded
+};
+
+// The upload step of idImageManager::LoadImagesInJobs, the default one records the
+// uploads into a command list and a stub lets the loading run without a gpu.
+class idImageUploader
+{
+public:
+	virtual				~idImageUploader() {}
+	virtual void		Upload( idImage* image, idBinaryImage& im ) = 0;
+};
+
 class idImageManager
 {
 public:
@@ -512,6 +554,7 @@ public:
 		insideLevelLoad = false;
 		preloadingMapImages = false;
 		commandList = nullptr;
+		residencyJobList = NULL;
 	}
 
 	void				Init();
@@ -560,10 +603,32 @@ public:
 	// Loads unloaded level images
 	int					LoadLevelImages( bool pacifier );
 
+	// Reads and converts the binary images of the list in parallel jobs and hands them to
+	// the uploader in list order. Images that have to be binarized first are added to
+	// fallback. Returns the number of bytes of image data.
+	int64_t				LoadImagesInJobs( const idList<idImage*>& list, idImageUploader& uploader, idList<idImage*>& fallback, bool pacifier );
+
+	// Loads the level images into standalone copies with a stub uploader
+	void				TestLevelImageLoad();
+
 	void				PrintMemInfo( MemInfo_t* mi );
 
 	void				LoadDeferredImages( nvrhi::ICommandList* commandList = nullptr );
 
+	// mip streaming, the front end reports the screen size of the surfaces using an image
+	// and once per frame the images get their levels raised or dropped by idImageResidency
+	void				ResidencyFeedback( const idImage* image, int pixels )
+	{
+		if( image->residencyIndex >= 0 )
+		{
+			residency.Feedback( image->residencyIndex, pixels );
+		}
+	}
+	void				UpdateResidency( int frameNum );
+	void				PrintResidency( bool all ) const;
+	bool				FinishResidencyLoads();
+	void				CancelResidencyLoads();
+
 	// built-in images
 	void				CreateIntrinsicImages();
 	idImage* 			defaultImage;
@@ -633,6 +698,7 @@ public:
 	idImage* 			AllocStandaloneImage( const char* name );
 
 	bool				ExcludePreloadImage( const char* name );
+	bool				IsStreamedImage( const idImage* image ) const;
 
 	idList<idImage*, TAG_IDLIB_LIST_IMAGE>	images;
 	idHashIndex								imageHash;
@@ -640,6 +706,13 @@ public:
 	// Transient list of images to load on the main thread to the gpu. Freed after images are loaded.
 	idList<idImage*, TAG_IDLIB_LIST_IMAGE>	imagesToLoad;
 
+	// streamed level images, indexed by idImage::residencyIndex
+	idImageResidency						residency;
+	idList<idImage*, TAG_IDLIB_LIST_IMAGE>	residencyImages;
+	idList<residencyChange_t>				residencyChanges;
+	idList<residencyLoad_t>					residencyLoads;				// reads in flight
+	idParallelJobList* 						residencyJobList;
+
 	bool									insideLevelLoad;			// don't actually load images now
 	bool									preloadingMapImages;		// unless this is set
 
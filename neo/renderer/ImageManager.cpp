@@ -47,6 +47,12 @@ idImageManager* globalImages = &imageManager;
 
 idCVar preLoad_Images( "preLoad_Images", "1", CVAR_SYSTEM | CVAR_BOOL, "preload images during beginlevelload" );
 
+idCVar image_streamMips( "image_streamMips", "0", CVAR_RENDERER | CVAR_BOOL, "load the material images of a level with their low mip levels first and raise them when they are seen up close, takes effect on the next level load" );
+idCVar image_streamBaseSize( "image_streamBaseSize", "256", CVAR_RENDERER | CVAR_INTEGER, "largest mip level of a streamed image that is loaded with the level" );
+idCVar image_streamBudgetMB( "image_streamBudgetMB", "1024", CVAR_RENDERER | CVAR_INTEGER, "memory budget for the streamed images, the least recently used ones drop back to their base levels to stay below it" );
+idCVar image_streamMaxLoads( "image_streamMaxLoads", "8", CVAR_RENDERER | CVAR_INTEGER, "maximum number of streamed images that get their levels raised per frame" );
+idCVar image_streamMipBias( "image_streamMipBias", "1", CVAR_RENDERER | CVAR_INTEGER, "number of levels kept above the screen size of the surfaces using a streamed image" );
+
 /*
 ===============
 R_ReloadImages_f
@@ -132,6 +138,32 @@ static int R_QsortImageName( const void* a, const void* b )
 	return idStr::Icmp( ea->image->GetName(), eb->image->GetName() );
 }
 
+/*
+===============
+R_TestImageLoad_f
+===============
+*/
+#if !defined( DMAP )
+static void R_TestImageLoad_f( const idCmdArgs& args )
+{
+	globalImages->TestLevelImageLoad();
+}
+#endif
+
+/*
+===============
+R_ListImageResidency_f
+
+listImageResidency [all]
+===============
+*/
+#if !defined( DMAP )
+static void R_ListImageResidency_f( const idCmdArgs& args )
+{
+	globalImages->PrintResidency( args.Argc() > 1 && !idStr::Icmp( args.Argv( 1 ), "all" ) );
+}
+#endif
+
 /*
 ===============
 R_ListImages_f
@@ -633,6 +665,10 @@ PurgeAllImages
 */
 void idImageManager::PurgeAllImages()
 {
+#if !defined( DMAP )
+	CancelResidencyLoads();
+#endif
+
 	for( int i = 0; i < images.Num() ; i++ )
 	{
 		images[ i ]->PurgeImage();
@@ -668,6 +704,8 @@ void idImageManager::Init()
 	CreateIntrinsicImages();
 
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
+	cmdSystem->AddCommand( "testImageLoad", R_TestImageLoad_f, CMD_FL_RENDERER, "times the level image loading without uploading the images" );
+	cmdSystem->AddCommand( "listImageResidency", R_ListImageResidency_f, CMD_FL_RENDERER, "lists the resident mip levels of the streamed images" );
 #endif
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 
@@ -682,6 +720,14 @@ Shutdown
 */
 void idImageManager::Shutdown()
 {
+#if !defined( DMAP )
+	CancelResidencyLoads();
+	if( residencyJobList != NULL )
+	{
+		parallelJobManager->FreeJobList( residencyJobList );
+		residencyJobList = NULL;
+	}
+#endif
 	images.DeleteContents( true );
 	imageHash.Clear();
 	commandList.Reset();
@@ -697,6 +743,10 @@ void idImageManager::BeginLevelLoad()
 {
 	insideLevelLoad = true;
 
+#if !defined( DMAP )
+	CancelResidencyLoads();
+#endif
+
 	for( int i = 0 ; i < images.Num() ; i++ )
 	{
 		idImage*	image = images[ i ];
@@ -707,7 +757,8 @@ void idImageManager::BeginLevelLoad()
 			continue;
 		}
 
-		if( !image->referencedOutsideLevelLoad && image->IsLoaded() )
+		// streamed images are missing levels and have to be loaded again in any case
+		if( ( !image->referencedOutsideLevelLoad || image->residencyIndex >= 0 ) && image->IsLoaded() )
 		{
 			image->PurgeImage();
 			//idLib::Printf( "purging %s\n", image->GetName() );
@@ -718,7 +769,12 @@ void idImageManager::BeginLevelLoad()
 		}
 
 		image->levelLoadReferenced = false;
+		image->streamMaxSize = 0;
+		image->residencyIndex = -1;
 	}
+
+	residency.Clear();
+	residencyImages.Clear();
 }
 
 
@@ -796,9 +852,207 @@ void idImageManager::Preload( const idPreloadManifest& manifest, const bool& map
 	}
 }
 
+/*
+===============
+Level image jobs
+===============
+*/
+#if !defined( DMAP )
+
+// images per batch, the jobs work on one batch while the previous one is uploaded
+#define LEVEL_IMAGE_BATCH	64
+
+struct levelImageJob_t
+{
+	idImage* 		image;
+	idBinaryImage* 	binaryImage;
+	bool			loaded;			// the binary image is current and can be uploaded
+};
+
+static void LoadLevelImageJob( levelImageJob_t* job )
+{
+	job->loaded = job->image->LoadBinaryImage( *job->binaryImage );
+}
+
+REGISTER_PARALLEL_JOB( LoadLevelImageJob, "LoadLevelImageJob" );
+
+static void LoadResidencyImageJob( residencyLoad_t* load )
+{
+	load->loaded = load->image->LoadBinaryImage( *load->binaryImage );
+}
+
+REGISTER_PARALLEL_JOB( LoadResidencyImageJob, "LoadResidencyImageJob" );
+
+class idImageUploaderCommandList : public idImageUploader
+{
+public:
+	idImageUploaderCommandList( nvrhi::ICommandList* commandList_ ) : commandList( commandList_ ) {}
+
+	virtual void Upload( idImage* image, idBinaryImage& im )
+	{
+		image->SetOptsFromBinaryImage( im.GetFileHeader() );
+		image->UploadBinaryImage( im, commandList );
+	}
+
+private:
+	nvrhi::ICommandList* 	commandList;
+};
+
+class idImageUploaderStub : public idImageUploader
+{
+public:
+	virtual void Upload( idImage* image, idBinaryImage& im ) {}
+};
+
+/*
+===============
+idImageManager::LoadImagesInJobs
+===============
+*/
+int64_t idImageManager::LoadImagesInJobs( const idList<idImage*>& list, idImageUploader& uploader, idList<idImage*>& fallback, bool pacifier )
+{
+	idList<levelImageJob_t> jobs;
+	jobs.SetNum( list.Num() );
+
+	// the preparation looks up the source file times, which the file system can't do in parallel
+	for( int i = 0; i < list.Num(); i++ )
+	{
+		idStrStatic< MAX_OSPATH > generatedName;
+		list[i]->PrepareBinaryImage( generatedName );
+
+		jobs[i].image = list[i];
+		jobs[i].binaryImage = new( TAG_IMAGE ) idBinaryImage( generatedName );
+		jobs[i].loaded = false;
+	}
+
+	idParallelJobList* jobLists[2];
+	jobLists[0] = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, LEVEL_IMAGE_BATCH, 0, NULL );
+	jobLists[1] = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, LEVEL_IMAGE_BATCH, 0, NULL );
+
+	const int numBatches = ( jobs.Num() + LEVEL_IMAGE_BATCH - 1 ) / LEVEL_IMAGE_BATCH;
+	const uint64_t startTime = Sys_Microseconds();
+	int64_t bytes = 0;
+
+	for( int batch = 0; batch <= numBatches; batch++ )
+	{
+		// start reading the next batch
+		if( batch < numBatches )
+		{
+			idParallelJobList* jobList = jobLists[batch & 1];
+			const int last = Min( ( batch + 1 ) * LEVEL_IMAGE_BATCH, jobs.Num() );
+			for( int i = batch * LEVEL_IMAGE_BATCH; i < last; i++ )
+			{
+				jobList->AddJob( ( jobRun_t )LoadLevelImageJob, &jobs[i] );
+			}
+			jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+		}
+
+		if( batch == 0 )
+		{
+			continue;
+		}
+
+		// upload the previous batch while the jobs read the next one
+		const int prev = batch - 1;
+		jobLists[prev & 1]->Wait();
+
+		const int last = Min( batch * LEVEL_IMAGE_BATCH, jobs.Num() );
+		for( int i = prev * LEVEL_IMAGE_BATCH; i < last; i++ )
+		{
+			idBinaryImage& im = *jobs[i].binaryImage;
+			if( jobs[i].loaded )
+			{
+				for( int j = 0; j < im.NumImages(); j++ )
+				{
+					bytes += im.GetImageHeader( j ).dataSize;
+				}
+				uploader.Upload( jobs[i].image, im );
+			}
+			else
+			{
+				fallback.Append( jobs[i].image );
+			}
+			delete jobs[i].binaryImage;
+			jobs[i].binaryImage = NULL;
+		}
+
+		if( pacifier )
+		{
+			const float seconds = ( Sys_Microseconds() - startTime ) * 0.000001f;
+			common->LoadPacifierInfo( "Loading level images %.1f MB/s", ( seconds > 0.0f ) ? bytes / ( 1024.0f * 1024.0f * seconds ) : 0.0f );
+			common->LoadPacifierProgressIncrement( last - prev * LEVEL_IMAGE_BATCH );
+		}
+	}
+
+	parallelJobManager->FreeJobList( jobLists[0] );
+	parallelJobManager->FreeJobList( jobLists[1] );
+
+	return bytes;
+}
+
+/*
+===============
+idImageManager::TestLevelImageLoad
+
+Runs the level image loading on standalone copies of the images, the stub uploader
+throws the image data away so this works without touching the gpu
+===============
+*/
+void idImageManager::TestLevelImageLoad()
+{
+	idList<idImage*> copies;
+	bool levelOnly = false;
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		if( images[i]->levelLoadReferenced && !images[i]->generatorFunction )
+		{
+			levelOnly = true;
+			break;
+		}
+	}
+
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		const idImage* image = images[i];
+		if( image->generatorFunction || ( levelOnly && !image->levelLoadReferenced ) )
+		{
+			continue;
+		}
+
+		idImage* copy = AllocStandaloneImage( image->GetName() );
+		copy->cubeFiles = image->cubeFiles;
+		copy->cubeMapSize = image->cubeMapSize;
+		copy->usage = image->usage;
+		copy->filter = image->filter;
+		copy->repeat = image->repeat;
+		copies.Append( copy );
+	}
+
+	idImageUploaderStub uploader;
+	idList<idImage*> fallback;
+
+	const uint64_t start = Sys_Microseconds();
+	const int64_t bytes = LoadImagesInJobs( copies, uploader, fallback, false );
+	const float seconds = ( Sys_Microseconds() - start ) * 0.000001f;
+
+	common->Printf( "%i %s, %.1f MB in %.2f seconds, %.1f MB/s\n", copies.Num() - fallback.Num(), levelOnly ? "level images" : "images",
+					bytes / ( 1024.0f * 1024.0f ), seconds, ( seconds > 0.0f ) ? bytes / ( 1024.0f * 1024.0f * seconds ) : 0.0f );
+	if( fallback.Num() )
+	{
+		common->Printf( "%i images need binarizing and were skipped\n", fallback.Num() );
+	}
+
+	copies.DeleteContents( true );
+}
+
+#endif
+
 /*
 ===============
 idImageManager::LoadLevelImages
+
+The binary images are read and converted by LoadImagesInJobs, the uploads are
+recorded into the command list on this thread
 ===============
 */
 #if !defined( DMAP )
@@ -827,16 +1081,11 @@ int idImageManager::LoadLevelImages( bool pacifier )
 		common->LoadPacifierProgressTotal( images.Num() );
 	}
 
-	int	loadCount = 0;
+	idList<idImage*> levelImages;
 	for( int i = 0 ; i < images.Num() ; i++ )
 	{
 		idImage* image = images[ i ];
 
-		if( pacifier )
-		{
-			common->LoadPacifierProgressIncrement( 1 );
-		}
-
 		if( image->generatorFunction )
 		{
 			continue;
@@ -844,20 +1093,306 @@ int idImageManager::LoadLevelImages( bool pacifier )
 
 		if( image->levelLoadReferenced && !image->IsLoaded() )
 		{
-			loadCount++;
-			image->ActuallyLoadImage( false, commandList );
+			if( image_streamMips.GetBool() && IsStreamedImage( image ) )
+			{
+				image->streamMaxSize = Max( image_streamBaseSize.GetInteger(), 1 );
+			}
+			levelImages.Append( image );
 		}
 	}
 
+	if( pacifier )
+	{
+		common->LoadPacifierProgressIncrement( images.Num() - levelImages.Num() );
+	}
+
+	idImageUploaderCommandList uploader( commandList );
+	idList<idImage*> fallback;
+	LoadImagesInJobs( levelImages, uploader, fallback, pacifier );
+
+	// images without a current binary image are binarized, this uses the file system
+	for( int i = 0 ; i < fallback.Num() ; i++ )
+	{
+		fallback[i]->ActuallyLoadImage( false, commandList );
+	}
+
 	globalImages->LoadDeferredImages( commandList );
 
 	commandList->close();
 
 	deviceManager->GetDevice()->executeCommandList( commandList );
 
+	// the streamed images that actually left out levels are tracked from now on
+	for( int i = 0 ; i < levelImages.Num() ; i++ )
+	{
+		idImage* image = levelImages[ i ];
+		if( image->streamMaxSize <= 0 )
+		{
+			continue;
+		}
+
+		const int skipMips = image->streamSkippedMips;
+		if( !image->IsLoaded() || image->IsDefaulted() || skipMips == 0 )
+		{
+			image->streamMaxSize = 0;
+			continue;
+		}
+
+		const int size = Max( image->opts.width, image->opts.height ) << skipMips;
+		const int64_t fullBytes = ( int64_t )image->StorageSize() << ( 2 * skipMips );
+		image->residencyIndex = residency.Track( size, image->opts.numLevels + skipMips, fullBytes, skipMips );
+		residencyImages.Append( image );
+	}
+
 	common->UpdateLevelLoadPacifier();
 
-	return loadCount;
+	return levelImages.Num();
+}
+#endif
+
+/*
+===============
+idImageManager::IsStreamedImage
+
+Only the material images are streamed, everything else keeps all of its levels
+===============
+*/
+bool idImageManager::IsStreamedImage( const idImage* image ) const
+{
+	if( image->referencedOutsideLevelLoad || image->cubeFiles != CF_2D )
+	{
+		return false;
+	}
+
+	switch( image->usage )
+	{
+		case TD_DIFFUSE:
+		case TD_SPECULAR:
+		case TD_BUMP:
+		case TD_SPECULAR_PBR_RMAO:
+		case TD_SPECULAR_PBR_RMAOD:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+===============
+idImageManager::UpdateResidency
+
+Applies the residency changes for the feedback of the last frames. Images that drop
+levels are copied into smaller textures right away, images that get more levels are
+read in jobs and uploaded by a later update once all reads have finished. No new
+changes are made while reads are in flight, the feedback keeps adding up until then.
+===============
+*/
+#if !defined( DMAP )
+void idImageManager::UpdateResidency( int frameNum )
+{
+	if( insideLevelLoad || residency.Num() == 0 )
+	{
+		return;
+	}
+
+	if( !FinishResidencyLoads() )
+	{
+		return;
+	}
+
+	const int64_t budget = ( int64_t )Max( image_streamBudgetMB.GetInteger(), 0 ) * 1024 * 1024;
+	residency.Update( frameNum, budget, image_streamMipBias.GetInteger(), Max( image_streamMaxLoads.GetInteger(), 0 ), residencyChanges );
+	if( residencyChanges.Num() == 0 )
+	{
+		return;
+	}
+
+	SCOPED_PROFILE_EVENT( "UpdateResidency" );
+
+	if( !commandList )
+	{
+		nvrhi::CommandListParameters params = {};
+		params.enableImmediateExecution = false;
+		if( deviceManager->GetGraphicsAPI() == nvrhi::GraphicsAPI::VULKAN )
+		{
+			// SRS - set upload buffer size to avoid Vulkan staging buffer fragmentation
+			size_t maxBufferSize = ( size_t )( r_vkUploadBufferSizeMB.GetInteger() * 1024 * 1024 );
+			params.setUploadChunkSize( maxBufferSize );
+		}
+		commandList = deviceManager->GetDevice()->createCommandList( params );
+	}
+
+	if( residencyJobList == NULL )
+	{
+		residencyJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_LOW, 64, 0, NULL );
+	}
+
+	bool dropped = false;
+	commandList->open();
+
+	for( int i = 0; i < residencyChanges.Num(); i++ )
+	{
+		const residencyChange_t& change = residencyChanges[i];
+		idImage* image = residencyImages[change.index];
+
+		// the lower levels are already resident
+		if( image->DropStreamedMips( change.skipMips, commandList ) )
+		{
+			image->streamMaxSize = Max( residency.GetSize( change.index ) >> change.skipMips, 1 );
+			if( image->streamSkippedMips != change.skipMips )
+			{
+				residency.SetSkipMips( change.index, image->streamSkippedMips );
+			}
+			dropped = true;
+			continue;
+		}
+
+		// the preparation looks up the source file times, which the file system can't do in parallel
+		idStrStatic< MAX_OSPATH > generatedName;
+		image->PrepareBinaryImage( generatedName );
+
+		residencyLoad_t& load = residencyLoads.Alloc();
+		load.image = image;
+		load.binaryImage = new( TAG_IMAGE ) idBinaryImage( generatedName );
+		load.index = change.index;
+		load.skipMips = change.skipMips;
+		load.loaded = false;
+	}
+
+	commandList->close();
+	if( dropped )
+	{
+		deviceManager->GetDevice()->executeCommandList( commandList );
+
+		// the cached binding sets still reference the old textures
+		tr.backend.ClearBindingSets();
+	}
+
+	// the list doesn't move until the jobs are done
+	for( int i = 0; i < residencyLoads.Num(); i++ )
+	{
+		residencyJobList->AddJob( ( jobRun_t )LoadResidencyImageJob, &residencyLoads[i] );
+	}
+	if( residencyLoads.Num() > 0 )
+	{
+		residencyJobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+	}
+}
+
+/*
+===============
+idImageManager::FinishResidencyLoads
+
+Uploads the images read by the jobs of an earlier update, returns false while the
+reads are still running
+===============
+*/
+bool idImageManager::FinishResidencyLoads()
+{
+	if( residencyLoads.Num() == 0 )
+	{
+		return true;
+	}
+
+	if( !residencyJobList->TryWait() )
+	{
+		return false;
+	}
+
+	SCOPED_PROFILE_EVENT( "FinishResidencyLoads" );
+
+	commandList->open();
+
+	idImageUploaderCommandList uploader( commandList );
+	for( int i = 0; i < residencyLoads.Num(); i++ )
+	{
+		residencyLoad_t& load = residencyLoads[i];
+		idImage* image = load.image;
+
+		image->streamMaxSize = Max( residency.GetSize( load.index ) >> load.skipMips, 1 );
+		if( load.loaded )
+		{
+			uploader.Upload( image, *load.binaryImage );
+		}
+		else
+		{
+			// images without a current binary image are binarized, this uses the file system
+			image->PurgeImage();
+			image->ActuallyLoadImage( false, commandList );
+		}
+
+		delete load.binaryImage;
+		load.binaryImage = NULL;
+
+		// compressed images can't always leave out as many levels as requested
+		if( image->streamSkippedMips != load.skipMips )
+		{
+			residency.SetSkipMips( load.index, image->streamSkippedMips );
+		}
+	}
+
+	commandList->close();
+	deviceManager->GetDevice()->executeCommandList( commandList );
+
+	residencyLoads.SetNum( 0 );
+
+	// the cached binding sets still reference the old textures
+	tr.backend.ClearBindingSets();
+
+	return true;
+}
+
+/*
+===============
+idImageManager::CancelResidencyLoads
+
+Waits for the reads in flight and throws them away, the images keep their current levels
+===============
+*/
+void idImageManager::CancelResidencyLoads()
+{
+	if( residencyLoads.Num() == 0 )
+	{
+		return;
+	}
+
+	residencyJobList->Wait();
+
+	for( int i = 0; i < residencyLoads.Num(); i++ )
+	{
+		residencyLoad_t& load = residencyLoads[i];
+		residency.SetSkipMips( load.index, load.image->streamSkippedMips );
+		delete load.binaryImage;
+	}
+	residencyLoads.SetNum( 0 );
+}
+
+/*
+===============
+idImageManager::PrintResidency
+===============
+*/
+void idImageManager::PrintResidency( bool all ) const
+{
+	if( all )
+	{
+		common->Printf( " size  res  req   age      MB name\n" );
+		for( int i = 0; i < residency.Num(); i++ )
+		{
+			const int size = residency.GetSize( i );
+			const int lastUsed = residency.GetLastUsedFrame( i );
+			common->Printf( "%5i %4i %4i %5s %7.2f %s\n", size, size >> residency.GetSkipMips( i ), size >> residency.GetRequestedSkipMips( i ),
+							( lastUsed < 0 ) ? "-" : va( "%i", tr.frameCount - lastUsed ), residency.GetResidentBytes( i ) / ( 1024 * 1024.0 ), residencyImages[i]->GetName() );
+		}
+	}
+
+	residencyStats_t stats;
+	residency.GetStats( stats );
+
+	common->Printf( "%i streamed images, %i with raised levels\n", stats.numImages, stats.numRaised );
+	common->Printf( "%.1f MB resident, %i MB budget, %.1f MB at base levels, %.1f MB with all levels\n", stats.residentBytes / ( 1024 * 1024.0 ),
+					image_streamBudgetMB.GetInteger(), stats.baseBytes / ( 1024 * 1024.0 ), stats.fullBytes / ( 1024 * 1024.0 ) );
+	common->Printf( "%i loads, %i evictions, %i loads over budget\n", stats.totalLoads, stats.totalEvictions, stats.deniedLoads );
 }
 #endif
 
@@ -0,0 +1,395 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "ImageResidency.h"
+
+struct residencyCandidate_t
+{
+	int					index;
+	int					key;
+};
+
+// larger keys first, the index keeps the order stable
+class idSort_ResidencyCandidate : public idSort_Quick< residencyCandidate_t, idSort_ResidencyCandidate >
+{
+public:
+	int Compare( const residencyCandidate_t& a, const residencyCandidate_t& b ) const
+	{
+		if( a.key != b.key )
+		{
+			return ( a.key > b.key ) ? -1 : 1;
+		}
+		return a.index - b.index;
+	}
+};
+
+/*
+====================
+idImageResidency::idImageResidency
+====================
+*/
+idImageResidency::idImageResidency()
+{
+	Clear();
+}
+
+/*
+====================
+idImageResidency::Clear
+====================
+*/
+void idImageResidency::Clear()
+{
+	entries.Clear();
+	residentBytes = 0;
+	totalLoads = 0;
+	totalEvictions = 0;
+	deniedLoads = 0;
+}
+
+/*
+====================
+idImageResidency::Track
+====================
+*/
+int idImageResidency::Track( int size, int numLevels, int64_t fullBytes, int baseSkipMips )
+{
+	entry_t& e = entries.Alloc();
+	e.fullBytes = fullBytes;
+	e.size = size;
+	e.numLevels = numLevels;
+	e.baseSkipMips = baseSkipMips;
+	e.skipMips = baseSkipMips;
+	e.requestedSkipMips = baseSkipMips;
+	e.lastUsedFrame = -1;
+	e.pixels = 0;
+	e.feedback = 0;
+
+	residentBytes += BytesForSkipMips( e, e.skipMips );
+
+	return entries.Num() - 1;
+}
+
+/*
+====================
+idImageResidency::SetSkipMips
+====================
+*/
+void idImageResidency::SetSkipMips( int index, int skipMips )
+{
+	entry_t& e = entries[index];
+	residentBytes += BytesForSkipMips( e, skipMips ) - BytesForSkipMips( e, e.skipMips );
+	e.skipMips = skipMips;
+}
+
+/*
+====================
+idImageResidency::Feedback
+====================
+*/
+void idImageResidency::Feedback( int index, int pixels )
+{
+	interlockedInt_t& feedback = entries[index].feedback;
+	for( interlockedInt_t current = feedback; pixels > current; current = feedback )
+	{
+		if( Sys_InterlockedCompareExchange( feedback, current, pixels ) == current )
+		{
+			break;
+		}
+	}
+}
+
+/*
+====================
+idImageResidency::SkipMipsForPixels
+====================
+*/
+int idImageResidency::SkipMipsForPixels( int size, int numLevels, int pixels, int mipBias )
+{
+	const int wanted = pixels << Max( mipBias, 0 );
+
+	int skipMips = 0;
+	while( skipMips < numLevels - 1 && ( size >> ( skipMips + 1 ) ) >= wanted )
+	{
+		skipMips++;
+	}
+	return skipMips;
+}
+
+/*
+====================
+idImageResidency::Evict
+====================
+*/
+void idImageResidency::Evict( int index, idList<residencyChange_t>& changes )
+{
+	entry_t& e = entries[index];
+	residentBytes -= BytesForSkipMips( e, e.skipMips ) - BytesForSkipMips( e, e.baseSkipMips );
+	e.skipMips = e.baseSkipMips;
+
+	residencyChange_t& change = changes.Alloc();
+	change.index = index;
+	change.skipMips = e.skipMips;
+
+	totalEvictions++;
+}
+
+/*
+====================
+idImageResidency::Update
+====================
+*/
+void idImageResidency::Update( int frameNum, int64_t budgetBytes, int mipBias, int maxLoads, idList<residencyChange_t>& changes )
+{
+	changes.SetNum( 0 );
+
+	idList<residencyCandidate_t> loads;
+	idList<residencyCandidate_t> evictions;
+
+	for( int i = 0; i < entries.Num(); i++ )
+	{
+		entry_t& e = entries[i];
+
+		e.pixels = e.feedback;
+		e.feedback = 0;
+
+		if( e.pixels > 0 )
+		{
+			e.lastUsedFrame = frameNum;
+			e.requestedSkipMips = Min( SkipMipsForPixels( e.size, e.numLevels, e.pixels, mipBias ), e.baseSkipMips );
+
+			if( e.requestedSkipMips < e.skipMips )
+			{
+				residencyCandidate_t& c = loads.Alloc();
+				c.index = i;
+				c.key = e.pixels;
+			}
+		}
+		else if( e.skipMips < e.baseSkipMips )
+		{
+			// the longest unused image gets the largest key
+			residencyCandidate_t& c = evictions.Alloc();
+			c.index = i;
+			c.key = frameNum - e.lastUsedFrame;
+		}
+	}
+
+	// the largest surfaces on screen get their levels first
+	loads.SortWithTemplate( idSort_ResidencyCandidate() );
+	evictions.SortWithTemplate( idSort_ResidencyCandidate() );
+
+	int nextEviction = 0;
+
+	// the budget might have been lowered
+	while( residentBytes > budgetBytes && nextEviction < evictions.Num() )
+	{
+		Evict( evictions[nextEviction++].index, changes );
+	}
+
+	const int numLoads = Min( loads.Num(), maxLoads );
+	for( int i = 0; i < numLoads; i++ )
+	{
+		const int index = loads[i].index;
+		entry_t& e = entries[index];
+		const int64_t currentBytes = BytesForSkipMips( e, e.skipMips );
+
+		while( residentBytes + BytesForSkipMips( e, e.requestedSkipMips ) - currentBytes > budgetBytes && nextEviction < evictions.Num() )
+		{
+			Evict( evictions[nextEviction++].index, changes );
+		}
+
+		// take as many of the requested levels as fit
+		int skipMips = e.requestedSkipMips;
+		while( skipMips < e.skipMips && residentBytes + BytesForSkipMips( e, skipMips ) - currentBytes > budgetBytes )
+		{
+			skipMips++;
+		}
+
+		if( skipMips == e.skipMips )
+		{
+			deniedLoads++;
+			continue;
+		}
+
+		residentBytes += BytesForSkipMips( e, skipMips ) - currentBytes;
+		e.skipMips = skipMips;
+
+		residencyChange_t& change = changes.Alloc();
+		change.index = index;
+		change.skipMips = skipMips;
+
+		totalLoads++;
+	}
+}
+
+/*
+====================
+idImageResidency::GetStats
+====================
+*/
+void idImageResidency::GetStats( residencyStats_t& stats ) const
+{
+	memset( &stats, 0, sizeof( stats ) );
+
+	stats.numImages = entries.Num();
+	stats.residentBytes = residentBytes;
+	stats.totalLoads = totalLoads;
+	stats.totalEvictions = totalEvictions;
+	stats.deniedLoads = deniedLoads;
+
+	for( int i = 0; i < entries.Num(); i++ )
+	{
+		const entry_t& e = entries[i];
+		if( e.skipMips < e.baseSkipMips )
+		{
+			stats.numRaised++;
+		}
+		stats.baseBytes += BytesForSkipMips( e, e.baseSkipMips );
+		stats.fullBytes += e.fullBytes;
+	}
+}
+
+#if !defined( DMAP )
+
+/*
+====================
+R_CheckResidency
+====================
+*/
+static bool R_CheckResidency( bool ok, const char* check, int& numFailed )
+{
+	common->Printf( "%s: %s\n", ok ? "passed" : "FAILED", check );
+	if( !ok )
+	{
+		numFailed++;
+	}
+	return ok;
+}
+
+/*
+====================
+testImageResidency
+
+Runs the residency bookkeeping on made up images, nothing is loaded or uploaded
+====================
+*/
+CONSOLE_COMMAND( testImageResidency, "checks the budget enforcement and eviction order of the mip streaming without a device", NULL )
+{
+	const int size = 1024;
+	const int numLevels = 11;
+	const int64_t fullBytes = 4 * 1024 * 1024;
+	const int baseSkipMips = 3;
+	const int64_t baseBytes = fullBytes >> ( 2 * baseSkipMips );
+
+	idImageResidency residency;
+	idList<residencyChange_t> changes;
+	residencyStats_t stats;
+	int numFailed = 0;
+
+	// budget, the images seen largest get their levels first and the rest stays below the budget
+	{
+		const int numImages = 8;
+		for( int i = 0; i < numImages; i++ )
+		{
+			residency.Track( size, numLevels, fullBytes, baseSkipMips );
+			residency.Feedback( i, size - i );
+		}
+
+		const int64_t budget = numImages * baseBytes + 2 * fullBytes;
+		residency.Update( 1, budget, 0, numImages, changes );
+		residency.GetStats( stats );
+
+		R_CheckResidency( stats.residentBytes <= budget, "resident bytes stay below the budget", numFailed );
+		R_CheckResidency( changes.Num() == 2 && changes[0].index == 0 && changes[1].index == 1 && changes[0].skipMips == 0 && changes[1].skipMips == 0,
+						  "the largest surfaces on screen get all of their levels first", numFailed );
+		R_CheckResidency( stats.deniedLoads == numImages - 2, "loads that don't fit are denied", numFailed );
+	}
+
+	// at most maxLoads images get more levels per update
+	{
+		residency.Clear();
+		for( int i = 0; i < 4; i++ )
+		{
+			residency.Track( size, numLevels, fullBytes, baseSkipMips );
+			residency.Feedback( i, 128 << i );
+		}
+
+		residency.Update( 1, 16 * fullBytes, 0, 1, changes );
+		R_CheckResidency( changes.Num() == 1 && changes[0].index == 3, "loads are limited per update", numFailed );
+	}
+
+	// the least recently used images are evicted first, images in use are kept
+	{
+		residency.Clear();
+		const int numImages = 4;
+		for( int i = 0; i < numImages; i++ )
+		{
+			residency.Track( size, numLevels, fullBytes, baseSkipMips );
+		}
+
+		const int64_t budget = numImages * baseBytes + 2 * ( fullBytes - baseBytes );
+
+		residency.Feedback( 0, size );
+		residency.Update( 1, budget, 0, numImages, changes );
+		residency.Feedback( 1, size );
+		residency.Update( 2, budget, 0, numImages, changes );
+
+		residency.Feedback( 2, size );
+		residency.Update( 3, budget, 0, numImages, changes );
+		R_CheckResidency( changes.Num() == 2 && changes[0].index == 0 && changes[0].skipMips == baseSkipMips && changes[1].index == 2 && changes[1].skipMips == 0,
+						  "the oldest image is evicted for a new load", numFailed );
+
+		residency.Feedback( 2, size );
+		residency.Feedback( 3, size );
+		residency.Update( 4, budget, 0, numImages, changes );
+		R_CheckResidency( changes.Num() == 2 && changes[0].index == 1 && changes[1].index == 3,
+						  "images seen this frame are not evicted", numFailed );
+
+		residency.GetStats( stats );
+		R_CheckResidency( stats.residentBytes <= budget && stats.totalEvictions == 2, "evictions keep the loads within the budget", numFailed );
+
+		// a lowered budget drops the unused images back to their base levels
+		residency.Update( 5, numImages * baseBytes, 0, numImages, changes );
+		residency.GetStats( stats );
+		R_CheckResidency( changes.Num() == 2 && stats.residentBytes == stats.baseBytes, "a lowered budget evicts the unused images", numFailed );
+	}
+
+	if( numFailed )
+	{
+		common->Printf( "%i residency checks FAILED\n", numFailed );
+	}
+	else
+	{
+		common->Printf( "all residency checks passed\n" );
+	}
+}
+
+#endif
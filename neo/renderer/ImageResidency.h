@@ -0,0 +1,156 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __IMAGERESIDENCY_H__
+#define __IMAGERESIDENCY_H__
+
+/*
+===============================================================================
+
+	Mip residency of streamed images.
+
+	Streamed images start out with only their lower mip levels resident. The front
+	end reports the screen size of every drawn surface that uses an image, and once
+	per frame Update turns that feedback into residency changes. Images that are
+	seen larger than their resident levels allow get more levels, and when that
+	would go over the memory budget the least recently used images drop back to
+	their base levels.
+
+	All sizes are in texels of the largest dimension and all changes are counted in
+	left out top mip levels. Nothing in here touches the device, the image manager
+	applies the changes.
+
+===============================================================================
+*/
+
+struct residencyChange_t
+{
+	int					index;
+	int					skipMips;			// new number of left out top levels
+};
+
+struct residencyStats_t
+{
+	int					numImages;
+	int					numRaised;			// images with more than their base levels resident
+	int64_t				residentBytes;
+	int64_t				baseBytes;			// if all images were at their base levels
+	int64_t				fullBytes;			// if all levels of all images were resident
+	int					totalLoads;
+	int					totalEvictions;
+	int					deniedLoads;		// loads that didn't fit into the budget
+};
+
+class idImageResidency
+{
+public:
+	idImageResidency();
+
+	void				Clear();
+
+	// fullBytes is the size of the complete mip chain, baseSkipMips the number of top levels
+	// that are left out while the image isn't seen up close. Returns the index for Feedback.
+	int					Track( int size, int numLevels, int64_t fullBytes, int baseSkipMips );
+
+	// the image manager couldn't apply a change exactly
+	void				SetSkipMips( int index, int skipMips );
+
+	// pixels is the larger screen dimension of a surface that uses the image, may be called
+	// from parallel jobs but not at the same time as Update
+	void				Feedback( int index, int pixels );
+
+	// turns the feedback since the last update into residency changes, at most maxLoads images
+	// get more levels per call and the resident bytes are kept below budgetBytes
+	void				Update( int frameNum, int64_t budgetBytes, int mipBias, int maxLoads, idList<residencyChange_t>& changes );
+
+	int					Num() const
+	{
+		return entries.Num();
+	}
+
+	int					GetSize( int index ) const
+	{
+		return entries[index].size;
+	}
+
+	int					GetSkipMips( int index ) const
+	{
+		return entries[index].skipMips;
+	}
+
+	int					GetRequestedSkipMips( int index ) const
+	{
+		return entries[index].requestedSkipMips;
+	}
+
+	int					GetLastUsedFrame( int index ) const
+	{
+		return entries[index].lastUsedFrame;
+	}
+
+	int64_t				GetResidentBytes( int index ) const
+	{
+		return BytesForSkipMips( entries[index], entries[index].skipMips );
+	}
+
+	void				GetStats( residencyStats_t& stats ) const;
+
+	// number of top levels that can be left out of a size x size image that covers
+	// pixels on screen, mipBias keeps that many more levels
+	static int			SkipMipsForPixels( int size, int numLevels, int pixels, int mipBias );
+
+private:
+	struct entry_t
+	{
+		int64_t				fullBytes;
+		int					size;
+		int					numLevels;
+		int					baseSkipMips;
+		int					skipMips;
+		int					requestedSkipMips;
+		int					lastUsedFrame;
+		int					pixels;				// feedback of the last update
+		interlockedInt_t	feedback;			// largest screen size since the last update
+	};
+
+	static int64_t		BytesForSkipMips( const entry_t& e, int skipMips )
+	{
+		// every level is a quarter of the one above
+		return e.fullBytes >> ( 2 * skipMips );
+	}
+
+	void				Evict( int index, idList<residencyChange_t>& changes );
+
+	idList<entry_t>		entries;
+	int64_t				residentBytes;
+	int					totalLoads;
+	int					totalEvictions;
+	int					deniedLoads;
+};
+
+#endif /* !__IMAGERESIDENCY_H__ */
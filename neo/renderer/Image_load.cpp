@@ -525,33 +525,13 @@ void idImage::GetGeneratedName( idStr& _name, const textureUsage_t& _usage, cons
 
 /*
 ===============
-ActuallyLoadImage
+PrepareBinaryImage
 
-Absolutely every image goes through this path
-On exit, the idImage will have a valid OpenGL texture number that can be bound
+Sets up the options the binary image has to match and the name of the binary image
 ===============
 */
-void idImage::ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandList )
+void idImage::PrepareBinaryImage( idStrStatic< MAX_OSPATH >& generatedName )
 {
-	// RB: might have been called doubled by nested LoadDeferredImages
-	if( isLoaded )
-	{
-		return;
-	}
-
-	// if we don't have a rendering context yet, just return
-	//if( !tr.IsInitialized() )
-	//{
-	//	return;
-	//}
-
-	// this is the ONLY place generatorFunction will ever be called
-	if( generatorFunction )
-	{
-		generatorFunction( this, commandList );
-		return;
-	}
-
 	// RB: the following does not load the source images from disk because pic is NULL
 	// but it tries to get the timestamp to see if we have a newer file than the one in the compressed .bimage
 
@@ -603,8 +583,115 @@ void idImage::ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandL
 	// Figure out opts.colorFormat and opts.format so we can make sure the binary image is up to date
 	DeriveOpts();
 
-	idStrStatic< MAX_OSPATH > generatedName = GetName();
+	generatedName = GetName();
 	GetGeneratedName( generatedName, usage, cubeFiles );
+}
+
+/*
+===============
+BinaryImageIsCurrent
+
+Returns true if the loaded binary image can be used as it is
+===============
+*/
+bool idImage::BinaryImageIsCurrent( const bimageFile_t& header ) const
+{
+	if( binaryFileTime == FILE_NOT_FOUND_TIMESTAMP )
+	{
+		return false;
+	}
+
+	if( fileSystem->InProductionMode() )
+	{
+		return true;
+	}
+
+	return ( header.colorFormat == opts.colorFormat )
+#if ( defined( __APPLE__ ) && defined( USE_VULKAN ) ) || defined( USE_NVRHI )
+		   // SRS - Handle case when image read is cached and RGB565 format conversion is already done
+		   && ( header.format == opts.format || ( header.format == FMT_RGB565 && opts.format == FMT_RGBA8 ) )
+#else
+		   && ( header.format == opts.format )
+#endif
+		   && ( header.textureType == opts.textureType );
+}
+
+/*
+===============
+SetOptsFromBinaryImage
+===============
+*/
+void idImage::SetOptsFromBinaryImage( const bimageFile_t& header )
+{
+	opts.width = header.width;
+	opts.height = header.height;
+	opts.numLevels = header.numLevels;
+	opts.colorFormat = ( textureColor_t )header.colorFormat;
+#if ( defined( __APPLE__ ) && defined( USE_VULKAN ) ) || defined( USE_NVRHI )
+	// SRS - Set in-memory format to FMT_RGBA8 for converted FMT_RGB565 image
+	if( header.format == FMT_RGB565 )
+	{
+		opts.format = FMT_RGBA8;
+	}
+	else
+#endif
+	{
+		opts.format = ( textureFormat_t )header.format;
+	}
+
+	opts.textureType = ( textureType_t )header.textureType;
+
+	if( cvarSystem->GetCVarBool( "fs_buildresources" ) )
+	{
+		// for resource gathering write this image to the preload file for this map
+		fileSystem->AddImagePreload( GetName(), filter, repeat, usage, cubeFiles );
+	}
+}
+
+/*
+===============
+LoadBinaryImage
+
+Reads and converts the binary image named by PrepareBinaryImage, may run in several jobs at once
+===============
+*/
+bool idImage::LoadBinaryImage( idBinaryImage& im )
+{
+	binaryFileTime = im.LoadFromGeneratedFileThreaded( sourceFileTime );
+	return BinaryImageIsCurrent( im.GetFileHeader() );
+}
+
+/*
+===============
+ActuallyLoadImage
+
+Absolutely every image goes through this path
+On exit, the idImage will have a valid OpenGL texture number that can be bound
+===============
+*/
+void idImage::ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandList )
+{
+	// RB: might have been called doubled by nested LoadDeferredImages
+	if( isLoaded )
+	{
+		return;
+	}
+
+	// if we don't have a rendering context yet, just return
+	//if( !tr.IsInitialized() )
+	//{
+	//	return;
+	//}
+
+	// this is the ONLY place generatorFunction will ever be called
+	if( generatorFunction )
+	{
+		generatorFunction( this, commandList );
+		return;
+	}
+
+	idStrStatic< MAX_OSPATH > generatedName;
+	PrepareBinaryImage( generatedName );
 
 	// RB: try to load the .bimage and skip if sourceFileTime is newer
 	idBinaryImage im( generatedName );
@@ -655,40 +742,9 @@ void idImage::ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandL
 	}
 	const bimageFile_t& header = im.GetFileHeader();
 
-	if( ( fileSystem->InProductionMode() && binaryFileTime != FILE_NOT_FOUND_TIMESTAMP ) || ( ( binaryFileTime != FILE_NOT_FOUND_TIMESTAMP )
-			&& ( header.colorFormat == opts.colorFormat )
-#if ( defined( __APPLE__ ) && defined( USE_VULKAN ) ) || defined( USE_NVRHI )
-			// SRS - Handle case when image read is cached and RGB565 format conversion is already done
-			&& ( header.format == opts.format || ( header.format == FMT_RGB565 && opts.format == FMT_RGBA8 ) )
-#else
-			&& ( header.format == opts.format )
-#endif
-			&& ( header.textureType == opts.textureType )
-																							) )
+	if( BinaryImageIsCurrent( header ) )
 	{
-		opts.width = header.width;
-		opts.height = header.height;
-		opts.numLevels = header.numLevels;
-		opts.colorFormat = ( textureColor_t )header.colorFormat;
-#if ( defined( __APPLE__ ) && defined( USE_VULKAN ) ) || defined( USE_NVRHI )
-		// SRS - Set in-memory format to FMT_RGBA8 for converted FMT_RGB565 image
-		if( header.format == FMT_RGB565 )
-		{
-			opts.format = FMT_RGBA8;
-		}
-		else
-#endif
-		{
-			opts.format = ( textureFormat_t )header.format;
-		}
-
-		opts.textureType = ( textureType_t )header.textureType;
-
-		if( cvarSystem->GetCVarBool( "fs_buildresources" ) )
-		{
-			// for resource gathering write this image to the preload file for this map
-			fileSystem->AddImagePreload( GetName(), filter, repeat, usage, cubeFiles );
-		}
+		SetOptsFromBinaryImage( header );
 	}
 	else
 	{
@@ -867,6 +923,25 @@ void idImage::ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandL
 	}
 #endif
 
+	UploadBinaryImage( im, commandList );
+}
+
+/*
+===============
+UploadBinaryImage
+===============
+*/
+void idImage::UploadBinaryImage( idBinaryImage& im, nvrhi::ICommandList* commandList )
+{
+	// streamed images start out without their top levels
+	streamSkippedMips = StreamSkipMips();
+	if( streamSkippedMips > 0 )
+	{
+		opts.width = Max( 1, opts.width >> streamSkippedMips );
+		opts.height = Max( 1, opts.height >> streamSkippedMips );
+		opts.numLevels -= streamSkippedMips;
+	}
+
 	AllocImage();
 
 #if defined( USE_NVRHI ) && !defined( DMAP )
@@ -880,6 +955,12 @@ void idImage::ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandL
 		const bimageImage_t& img = im.GetImageHeader( i );
 		const byte* pic = im.GetImageData( i );
 
+		if( img.level < streamSkippedMips )
+		{
+			continue;
+		}
+		const int level = img.level - streamSkippedMips;
+
 #if 0
 		if( opts.format == FMT_RGB565 )
 		{
@@ -917,10 +998,18 @@ void idImage::ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandL
 				bufferW = ( img.width + 3 ) & ~3;
 			}
 
-			commandList->writeTexture( texture, img.destZ, img.level, pic, GetRowPitch( opts.format, img.width ) );
+			commandList->writeTexture( texture, img.destZ, level, pic, GetRowPitch( opts.format, img.width ) );
 		}
 	}
-	commandList->setPermanentTextureState( texture, nvrhi::ResourceStates::ShaderResource );
+	if( streamMaxSize > 0 )
+	{
+		// streamed images are copied from when they drop levels, see DropStreamedMips
+		commandList->setTextureState( texture, nvrhi::AllSubresources, nvrhi::ResourceStates::ShaderResource );
+	}
+	else
+	{
+		commandList->setPermanentTextureState( texture, nvrhi::ResourceStates::ShaderResource );
+	}
 	commandList->commitBarriers();
 #else
 	/*
@@ -936,6 +1025,82 @@ void idImage::ActuallyLoadImage( bool fromBackEnd, nvrhi::ICommandList* commandL
 	isLoaded = true;
 }
 
+/*
+===============
+StreamSkipMips
+===============
+*/
+int idImage::StreamSkipMips() const
+{
+	if( streamMaxSize <= 0 || opts.textureType != TT_2D || opts.numLevels <= 1 )
+	{
+		return 0;
+	}
+
+	int skipMips = 0;
+	while( skipMips < opts.numLevels - 1 && ( Max( opts.width, opts.height ) >> skipMips ) > streamMaxSize )
+	{
+		skipMips++;
+	}
+
+	// the top level of a compressed texture has to be made of whole blocks
+	if( IsCompressed() )
+	{
+		while( skipMips > 0 && ( ( ( opts.width >> skipMips ) & 3 ) != 0 || ( ( opts.height >> skipMips ) & 3 ) != 0 ) )
+		{
+			skipMips--;
+		}
+	}
+
+	return skipMips;
+}
+
+/*
+===============
+DropStreamedMips
+===============
+*/
+bool idImage::DropStreamedMips( int skipMips, nvrhi::ICommandList* commandList )
+{
+#if defined( USE_NVRHI ) && !defined( DMAP )
+	const int dropMips = skipMips - streamSkippedMips;
+	if( !isLoaded || !texture || dropMips <= 0 || dropMips >= opts.numLevels )
+	{
+		return false;
+	}
+
+	const int width = Max( 1, opts.width >> dropMips );
+	const int height = Max( 1, opts.height >> dropMips );
+	if( IsCompressed() && ( ( width & 3 ) != 0 || ( height & 3 ) != 0 ) )
+	{
+		return false;
+	}
+
+	// the handle keeps the old texture alive for the copy
+	nvrhi::TextureHandle oldTexture = texture;
+
+	opts.width = width;
+	opts.height = height;
+	opts.numLevels -= dropMips;
+
+	AllocImage();
+
+	commandList->beginTrackingTextureState( texture, nvrhi::AllSubresources, nvrhi::ResourceStates::Common );
+	for( int level = 0; level < opts.numLevels; level++ )
+	{
+		commandList->copyTexture( texture, nvrhi::TextureSlice().setMipLevel( level ), oldTexture, nvrhi::TextureSlice().setMipLevel( level + dropMips ) );
+	}
+	commandList->setTextureState( texture, nvrhi::AllSubresources, nvrhi::ResourceStates::ShaderResource );
+	commandList->commitBarriers();
+
+	streamSkippedMips = skipMips;
+	isLoaded = true;
+	return true;
+#else
+	return false;
+#endif
+}
+
 void idImage::DeferredLoadImage()
 {
 	globalImages->imagesToLoad.AddUnique( this );
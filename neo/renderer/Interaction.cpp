@@ -417,14 +417,13 @@ idInteraction* idInteraction::AllocAndLink( idRenderEntityLocal* edef, idRenderL
 	}
 
 	// update the interaction table
-	if( renderWorld->interactionTable != NULL )
+	if( renderWorld->interactionTable.IsActive() )
 	{
-		int index = ldef->index * renderWorld->interactionTableWidth + edef->index;
-		if( renderWorld->interactionTable[index] != NULL )
+		if( renderWorld->interactionTable.Get( ldef->index, edef->index ) != NULL )
 		{
 			common->Error( "idInteraction::AllocAndLink: non NULL table entry" );
 		}
-		renderWorld->interactionTable[ index ] = interaction;
+		renderWorld->interactionTable.Set( ldef->index, edef->index, interaction );
 	}
 
 	return interaction;
@@ -510,14 +509,14 @@ void idInteraction::UnlinkAndFree()
 	// clear the table pointer
 	idRenderWorldLocal* renderWorld = this->lightDef->world;
 	// RB: added check for NULL
-	if( renderWorld->interactionTable != NULL )
+	if( renderWorld->interactionTable.IsActive() )
 	{
-		int index = this->lightDef->index * renderWorld->interactionTableWidth + this->entityDef->index;
-		if( renderWorld->interactionTable[index] != this && renderWorld->interactionTable[index] != INTERACTION_EMPTY )
+		const idInteraction* entry = renderWorld->interactionTable.Get( this->lightDef->index, this->entityDef->index );
+		if( entry != this && entry != INTERACTION_EMPTY )
 		{
 			common->Error( "idInteraction::UnlinkAndFree: interactionTable wasn't set" );
 		}
-		renderWorld->interactionTable[index] = NULL;
+		renderWorld->interactionTable.Set( this->lightDef->index, this->entityDef->index, NULL );
 	}
 	// RB end
 
@@ -574,9 +573,8 @@ void idInteraction::MakeEmpty()
 	}
 
 	// store the special marker in the interaction table
-	const int interactionIndex = lightDef->index * entityDef->world->interactionTableWidth + entityDef->index;
-	assert( entityDef->world->interactionTable[ interactionIndex ] == this );
-	entityDef->world->interactionTable[ interactionIndex ] = INTERACTION_EMPTY;
+	assert( entityDef->world->interactionTable.Get( lightDef->index, entityDef->index ) == this );
+	entityDef->world->interactionTable.Set( lightDef->index, entityDef->index, INTERACTION_EMPTY );
 }
 
 /*
@@ -597,14 +595,31 @@ Called by idRenderWorldLocal::GenerateAllInteractions
 ======================
 */
 void idInteraction::CreateStaticInteraction( nvrhi::ICommandList* commandList )
+{
+	srfTriangles_t** lightTris = GenerateStaticLightTris();
+	FinishStaticInteraction( lightTris, commandList );
+}
+
+/*
+======================
+idInteraction::GenerateStaticLightTris
+
+Culls the entity surfaces against the light and builds the lit triangle
+lists without touching any state shared with other interactions, so
+interactions can be processed in parallel.
+
+Returns an array with a light tris surface for each model surface, or
+NULL if nothing interacts. The array has to be passed to FinishStaticInteraction.
+======================
+*/
+srfTriangles_t** idInteraction::GenerateStaticLightTris()
 {
 	// note that it is a static interaction
 	staticInteraction = true;
 	const idRenderModel* model = entityDef->parms.hModel;
 	if( model == NULL || model->NumSurfaces() <= 0 || model->IsDynamicModel() != DM_STATIC )
 	{
-		MakeEmpty();
-		return;
+		return NULL;
 	}
 
 	const idBounds bounds = model->Bounds( &entityDef->parms );
@@ -612,8 +627,7 @@ void idInteraction::CreateStaticInteraction( nvrhi::ICommandList* commandList )
 	// if it doesn't contact the light frustum, none of the surfaces will
 	if( R_CullModelBoundsToLight( lightDef, bounds, entityDef->modelRenderMatrix ) )
 	{
-		MakeEmpty();
-		return;
+		return NULL;
 	}
 
 	//
@@ -622,6 +636,7 @@ void idInteraction::CreateStaticInteraction( nvrhi::ICommandList* commandList )
 	numSurfaces = model->NumSurfaces();
 	surfaces = ( surfaceInteraction_t* )R_ClearedStaticAlloc( sizeof( *surfaces ) * numSurfaces );
 
+	srfTriangles_t** lightTris = ( srfTriangles_t** )R_ClearedStaticAlloc( sizeof( *lightTris ) * numSurfaces );
 	bool interactionGenerated = false;
 
 	// check each surface in the model
@@ -650,30 +665,387 @@ void idInteraction::CreateStaticInteraction( nvrhi::ICommandList* commandList )
 			continue;
 		}
 
-		surfaceInteraction_t* sint = &surfaces[c];
-
 		// generate a set of indexes for the lit surfaces, culling away triangles that are
 		// not at least partially inside the light
 		if( shader->ReceivesLighting() )
 		{
-			srfTriangles_t* lightTris = R_CreateInteractionLightTris( entityDef, tri, lightDef, shader );
-			if( lightTris != NULL )
+			lightTris[c] = R_CreateInteractionLightTris( entityDef, tri, lightDef, shader );
+			if( lightTris[c] != NULL )
 			{
-				// make a static index cache
-				sint->numLightTrisIndexes = lightTris->numIndexes;
-				sint->lightTrisIndexCache = vertexCache.AllocStaticIndex( lightTris->indexes, lightTris->numIndexes * sizeof( lightTris->indexes[0] ), commandList );
-
 				interactionGenerated = true;
-				R_FreeStaticTriSurf( lightTris );
 			}
 		}
 	}
 
 	// if none of the surfaces generated anything, don't even bother checking?
 	if( !interactionGenerated )
+	{
+		R_StaticFree( lightTris );
+		return NULL;
+	}
+
+	return lightTris;
+}
+
+/*
+======================
+idInteraction::FinishStaticInteraction
+
+Uploads the light tris created by GenerateStaticLightTris into static index
+caches, or relinks the interaction as empty. This must run on the main thread.
+======================
+*/
+void idInteraction::FinishStaticInteraction( srfTriangles_t** lightTris, nvrhi::ICommandList* commandList )
+{
+	if( lightTris == NULL )
 	{
 		MakeEmpty();
+		return;
+	}
+
+	for( int c = 0; c < numSurfaces; c++ )
+	{
+		if( lightTris[c] == NULL )
+		{
+			continue;
+		}
+
+		// make a static index cache
+		surfaceInteraction_t* sint = &surfaces[c];
+		sint->numLightTrisIndexes = lightTris[c]->numIndexes;
+		sint->lightTrisIndexCache = vertexCache.AllocStaticIndex( lightTris[c]->indexes, lightTris[c]->numIndexes * sizeof( lightTris[c]->indexes[0] ), commandList );
+
+		R_FreeStaticTriSurf( lightTris[c] );
 	}
+
+	R_StaticFree( lightTris );
+}
+
+/*
+===============================================================================
+
+	idInteractionTable
+
+===============================================================================
+*/
+
+static const int INTERACTION_ROW_MIN_CAPACITY = 8;
+
+/*
+===================
+idInteractionTable::idInteractionTable
+===================
+*/
+idInteractionTable::idInteractionTable()
+{
+	active = false;
+}
+
+/*
+===================
+idInteractionTable::~idInteractionTable
+===================
+*/
+idInteractionTable::~idInteractionTable()
+{
+	Shutdown();
+}
+
+/*
+===================
+idInteractionTable::Init
+===================
+*/
+void idInteractionTable::Init( int numLightDefs )
+{
+	Shutdown();
+
+	rows.AssureSize( numLightDefs );
+	for( int i = 0; i < rows.Num(); i++ )
+	{
+		memset( &rows[i], 0, sizeof( rows[i] ) );
+	}
+	active = true;
+}
+
+/*
+===================
+idInteractionTable::Shutdown
+===================
+*/
+void idInteractionTable::Shutdown()
+{
+	for( int i = 0; i < rows.Num(); i++ )
+	{
+		// the entity keys share the allocation of the interactions
+		Mem_Free( rows[i].interactions );
+	}
+	rows.Clear();
+	active = false;
+}
+
+/*
+===================
+idInteractionTable::Resize
+
+Reinserts all pairs of the row into a table of newCapacity slots,
+newCapacity must be a power of two.
+===================
+*/
+void idInteractionTable::Resize( lightRow_t& row, int newCapacity )
+{
+	const lightRow_t oldRow = row;
+	const int oldCapacity = ( oldRow.entities != NULL ) ? oldRow.mask + 1 : 0;
+
+	byte* mem = ( byte* )Mem_Alloc( newCapacity * ( sizeof( int ) + sizeof( idInteraction* ) ), TAG_RENDER_INTERACTION );
+	row.interactions = ( idInteraction** )mem;
+	row.entities = ( int* )( mem + newCapacity * sizeof( idInteraction* ) );
+	row.mask = newCapacity - 1;
+	row.shift = 32 - idMath::ILog2( newCapacity );
+	memset( row.entities, -1, newCapacity * sizeof( int ) );
+
+	for( int i = 0; i < oldCapacity; i++ )
+	{
+		const int e = oldRow.entities[i];
+		if( e == -1 )
+		{
+			continue;
+		}
+		int j = Hash( e, row.shift );
+		while( row.entities[j] != -1 )
+		{
+			j = ( j + 1 ) & row.mask;
+		}
+		row.entities[j] = e;
+		row.interactions[j] = oldRow.interactions[i];
+	}
+
+	Mem_Free( oldRow.interactions );
+}
+
+/*
+===================
+idInteractionTable::Remove
+
+Linear probing without tombstones, so the following entries of the
+cluster are shifted back over the removed slot.
+===================
+*/
+void idInteractionTable::Remove( lightRow_t& row, int entityIndex )
+{
+	if( row.num == 0 )
+	{
+		return;
+	}
+
+	int i = Hash( entityIndex, row.shift );
+	while( row.entities[i] != entityIndex )
+	{
+		if( row.entities[i] == -1 )
+		{
+			return;
+		}
+		i = ( i + 1 ) & row.mask;
+	}
+
+	for( int j = ( i + 1 ) & row.mask; row.entities[j] != -1; j = ( j + 1 ) & row.mask )
+	{
+		// the entry at j may move into the hole if the hole lies between its home slot and j
+		const int home = Hash( row.entities[j], row.shift );
+		if( ( ( i - home ) & row.mask ) <= ( ( j - home ) & row.mask ) )
+		{
+			row.entities[i] = row.entities[j];
+			row.interactions[i] = row.interactions[j];
+			i = j;
+		}
+	}
+	row.entities[i] = -1;
+	row.interactions[i] = NULL;
+	row.num--;
+}
+
+/*
+===================
+idInteractionTable::Set
+===================
+*/
+void idInteractionTable::Set( int lightIndex, int entityIndex, idInteraction* interaction )
+{
+	assert( active && lightIndex >= 0 && entityIndex >= 0 );
+
+	if( lightIndex >= rows.Num() )
+	{
+		if( interaction == NULL )
+		{
+			return;
+		}
+		const int oldNum = rows.Num();
+		rows.AssureSize( lightIndex + 1 );
+		for( int i = oldNum; i < rows.Num(); i++ )
+		{
+			memset( &rows[i], 0, sizeof( rows[i] ) );
+		}
+	}
+
+	lightRow_t& row = rows[lightIndex];
+
+	if( interaction == NULL )
+	{
+		Remove( row, entityIndex );
+		return;
+	}
+
+	// keep the load factor at or below one half so probe sequences stay short
+	const int capacity = ( row.entities != NULL ) ? row.mask + 1 : 0;
+	if( ( row.num + 1 ) * 2 > capacity )
+	{
+		Resize( row, Max( capacity * 2, INTERACTION_ROW_MIN_CAPACITY ) );
+	}
+
+	int i = Hash( entityIndex, row.shift );
+	while( row.entities[i] != -1 && row.entities[i] != entityIndex )
+	{
+		i = ( i + 1 ) & row.mask;
+	}
+	if( row.entities[i] == -1 )
+	{
+		row.entities[i] = entityIndex;
+		row.num++;
+	}
+	row.interactions[i] = interaction;
+}
+
+/*
+===================
+idInteractionTable::Num
+===================
+*/
+int idInteractionTable::Num() const
+{
+	int num = 0;
+	for( int i = 0; i < rows.Num(); i++ )
+	{
+		num += rows[i].num;
+	}
+	return num;
+}
+
+/*
+===================
+idInteractionTable::Allocated
+===================
+*/
+size_t idInteractionTable::Allocated() const
+{
+	size_t size = rows.Allocated();
+	for( int i = 0; i < rows.Num(); i++ )
+	{
+		if( rows[i].entities != NULL )
+		{
+			size += ( rows[i].mask + 1 ) * ( sizeof( int ) + sizeof( idInteraction* ) );
+		}
+	}
+	return size;
+}
+
+/*
+===================
+idInteractionTable::DenseSize
+===================
+*/
+size_t idInteractionTable::DenseSize( int numLightDefs, int numEntityDefs )
+{
+	// the dense table was padded by 100 entries in each direction to make resizes rare
+	return ( size_t )( numLightDefs + 100 ) * ( numEntityDefs + 100 ) * sizeof( idInteraction* );
+}
+
+/*
+===================
+R_ReportInteractionTable
+
+Compares the sparse interaction index against the dense lightDefs x entityDefs
+table it replaced, both in memory and in the cost of the lookups R_AddSingleLight
+does every frame.
+===================
+*/
+static void R_ReportInteractionTable( const idRenderWorldLocal* world )
+{
+	const idInteractionTable& table = world->interactionTable;
+	if( !table.IsActive() )
+	{
+		common->Printf( "interaction table not built, GenerateAllInteractions hasn't been called\n" );
+		return;
+	}
+
+	const int numLights = world->lightDefs.Num();
+	const int numEntities = world->entityDefs.Num();
+	const size_t denseSize = idInteractionTable::DenseSize( numLights, numEntities );
+
+	common->Printf( "%i table entries, sparse index %i kB, dense table %i kB\n", table.Num(), ( int )( table.Allocated() >> 10 ), ( int )( denseSize >> 10 ) );
+
+	// gather the light / entity pairs in the order the front end looks them up
+	idList<int> pairs;
+	for( int i = 0; i < numLights; i++ )
+	{
+		const idRenderLightLocal* light = world->lightDefs[i];
+		if( light == NULL )
+		{
+			continue;
+		}
+		for( const areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+		{
+			const portalArea_t* area = lref->area;
+			for( const areaReference_t* eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext )
+			{
+				pairs.Append( i );
+				pairs.Append( eref->entity->index );
+			}
+		}
+	}
+	const int numPairs = pairs.Num() / 2;
+	if( numPairs == 0 )
+	{
+		return;
+	}
+
+	const int denseWidth = numEntities + 100;
+	idInteraction** dense = ( idInteraction** )R_ClearedStaticAlloc( ( int )denseSize );
+	for( int i = 0; i < numPairs; i++ )
+	{
+		const int l = pairs[i * 2 + 0];
+		const int e = pairs[i * 2 + 1];
+		dense[l * denseWidth + e] = table.Get( l, e );
+	}
+
+	const int passes = Max( 1, 1000000 / numPairs );
+	uintptr_t sparseHash = 0;
+	uintptr_t denseHash = 0;
+
+	const int64_t sparseStart = Sys_Microseconds();
+	for( int p = 0; p < passes; p++ )
+	{
+		for( int i = 0; i < numPairs; i++ )
+		{
+			sparseHash += ( uintptr_t )table.Get( pairs[i * 2 + 0], pairs[i * 2 + 1] );
+		}
+	}
+	const int64_t sparseEnd = Sys_Microseconds();
+
+	for( int p = 0; p < passes; p++ )
+	{
+		for( int i = 0; i < numPairs; i++ )
+		{
+			denseHash += ( uintptr_t )dense[pairs[i * 2 + 0] * denseWidth + pairs[i * 2 + 1]];
+		}
+	}
+	const int64_t denseEnd = Sys_Microseconds();
+
+	R_StaticFree( dense );
+
+	const float numLookups = ( float )passes * numPairs;
+	common->Printf( "%i lookups: sparse %.2f ns, dense %.2f ns per lookup%s\n", ( int )numLookups,
+					( sparseEnd - sparseStart ) * 1000.0f / numLookups, ( denseEnd - sparseEnd ) * 1000.0f / numLookups,
+					( sparseHash != denseHash ) ? " (MISMATCH)" : "" );
 }
 
 /*
@@ -772,4 +1144,6 @@ void R_ShowInteractionMemory_f( const idCmdArgs& args )
 	common->Printf( "%5i indexes in %5i shadow tris\n", shadowTriIndexes, shadowTris );
 	common->Printf( "%i maxInteractionsForEntity\n", maxInteractionsForEntity );
 	common->Printf( "%i maxInteractionsForLight\n", maxInteractionsForLight );
+
+	R_ReportInteractionTable( tr.primaryWorld );
 }
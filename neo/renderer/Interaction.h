@@ -141,11 +141,103 @@ public:
 	// called by GenerateAllInteractions
 	void					CreateStaticInteraction( nvrhi::ICommandList* commandList );
 
+	// CreateStaticInteraction split in two, the first part only writes to this interaction
+	// and may run in parallel jobs, the second part links and uploads on the main thread
+	srfTriangles_t** 		GenerateStaticLightTris();
+	void					FinishStaticInteraction( srfTriangles_t** lightTris, nvrhi::ICommandList* commandList );
+
 private:
 	// unlink from entity and light lists
 	void					Unlink();
 };
 
+/*
+===============================================================================
+
+	Sparse light / entity interaction index.
+
+	Replaces the dense lightDefs x entityDefs pointer table. Each lightDef
+	owns a small open addressing hash set keyed by entityDef index, so memory
+	scales with the number of interactions instead of the product of the def
+	counts, and adding defs never has to copy the whole table.
+
+	Get() returns NULL for pairs that have not been tested yet, just like an
+	untouched slot of the old table did.
+
+===============================================================================
+*/
+
+class idInteractionTable
+{
+public:
+	idInteractionTable();
+	~idInteractionTable();
+
+	// allocates the rows and starts tracking interactions
+	void					Init( int numLightDefs );
+	// frees all rows and stops tracking
+	void					Shutdown();
+
+	bool					IsActive() const
+	{
+		return active;
+	}
+
+	idInteraction* 			Get( int lightIndex, int entityIndex ) const
+	{
+		if( lightIndex >= rows.Num() )
+		{
+			return NULL;
+		}
+		const lightRow_t& row = rows[lightIndex];
+		if( row.num == 0 )
+		{
+			return NULL;
+		}
+		for( int i = Hash( entityIndex, row.shift ); ; i = ( i + 1 ) & row.mask )
+		{
+			const int e = row.entities[i];
+			if( e == entityIndex )
+			{
+				return row.interactions[i];
+			}
+			if( e == -1 )
+			{
+				return NULL;
+			}
+		}
+	}
+
+	// a NULL interaction removes the pair
+	void					Set( int lightIndex, int entityIndex, idInteraction* interaction );
+
+	int						Num() const;
+	size_t					Allocated() const;
+	// bytes the old dense table would have needed for the same def counts
+	static size_t			DenseSize( int numLightDefs, int numEntityDefs );
+
+private:
+	struct lightRow_t
+	{
+		int* 				entities;		// -1 for free slots
+		idInteraction** 	interactions;
+		int					mask;			// capacity - 1
+		int					shift;			// 32 - log2( capacity )
+		int					num;
+	};
+
+	static int				Hash( int entityIndex, int shift )
+	{
+		return ( int )( ( ( unsigned int )entityIndex * 2654435769u ) >> shift );
+	}
+
+	void					Remove( lightRow_t& row, int entityIndex );
+	void					Resize( lightRow_t& row, int newCapacity );
+
+	idList<lightRow_t, TAG_RENDER_INTERACTION>	rows;
+	bool					active;
+};
+
 void R_ShowInteractionMemory_f( const idCmdArgs& args );
 
 #endif /* !__INTERACTION_H__ */
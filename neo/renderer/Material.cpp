@@ -35,6 +35,7 @@ If you have questions concerning this license or the applicable additional terms
 #include "RenderCommon.h"
 
 idCVar r_useConstantMaterials( "r_useConstantMaterials", "1", CVAR_RENDERER | CVAR_BOOL, "use pre-calculated material registers if possible" );
+idCVar r_useMaterialRegisterCache( "r_useMaterialRegisterCache", "1", CVAR_RENDERER | CVAR_BOOL, "reuse material registers evaluated earlier in the frame with the same inputs" );
 
 /*
 
@@ -99,6 +100,9 @@ void idMaterial::CommonInit()
 	numRegisters = 0;
 	expressionRegisters = NULL;
 	constantRegisters = NULL;
+	inputRegisterBits = 0;
+	readsSoundAmplitude = false;
+	memset( &registerCache, 0, sizeof( registerCache ) );
 	numStages = 0;
 	numAmbientStages = 0;
 	stages = NULL;
@@ -116,6 +120,7 @@ void idMaterial::CommonInit()
 	mikktspace = false; // RB
 	gui = NULL;
 	memset( deformRegisters, 0, sizeof( deformRegisters ) );
+	memset( texGenRegisters, 0, sizeof( texGenRegisters ) );
 	editorAlpha = 1.0;
 	spectrum = 0;
 	polygonOffset = 0;
@@ -3229,6 +3234,9 @@ bool idMaterial::Parse( const char* text, const int textLength, bool allowBinary
 		memcpy( stages, pd->parseStages, numStages * sizeof( stages[0] ) );
 	}
 
+	// fold the constant ops and remove the ones nothing reads
+	OptimizeExpressions();
+
 	if( numOps )
 	{
 		ops = ( expOp_t* )R_StaticAlloc( numOps * sizeof( ops[0] ), TAG_MATERIAL );
@@ -3335,6 +3343,86 @@ void idMaterial::AddReference()
 	}
 }
 
+/*
+===============
+R_EvaluateExpressionOp
+===============
+*/
+static ID_INLINE void R_EvaluateExpressionOp( const expOp_t* op, float* registers, idSoundEmitter* soundEmitter )
+{
+	int		b;
+
+	switch( op->opType )
+	{
+		case OP_TYPE_ADD:
+			registers[op->c] = registers[op->a] + registers[op->b];
+			break;
+		case OP_TYPE_SUBTRACT:
+			registers[op->c] = registers[op->a] - registers[op->b];
+			break;
+		case OP_TYPE_MULTIPLY:
+			registers[op->c] = registers[op->a] * registers[op->b];
+			break;
+		case OP_TYPE_DIVIDE:
+			registers[op->c] = registers[op->a] / registers[op->b];
+			break;
+		case OP_TYPE_MOD:
+			b = ( int )registers[op->b];
+			b = b != 0 ? b : 1;
+			registers[op->c] = ( int )registers[op->a] % b;
+			break;
+		case OP_TYPE_TABLE:
+		{
+			const idDeclTable* table = static_cast<const idDeclTable*>( declManager->DeclByIndex( DECL_TABLE, op->a ) );
+			registers[op->c] = table->TableLookup( registers[op->b] );
+		}
+		break;
+		case OP_TYPE_SOUND:
+			if( r_forceSoundOpAmplitude.GetFloat() > 0 )
+			{
+				registers[op->c] = r_forceSoundOpAmplitude.GetFloat();
+			}
+			else if( soundEmitter )
+			{
+				registers[op->c] = soundEmitter->CurrentAmplitude();
+			}
+			else
+			{
+				registers[op->c] = 0;
+			}
+			break;
+		case OP_TYPE_GT:
+			registers[op->c] = registers[ op->a ] > registers[op->b];
+			break;
+		case OP_TYPE_GE:
+			registers[op->c] = registers[ op->a ] >= registers[op->b];
+			break;
+		case OP_TYPE_LT:
+			registers[op->c] = registers[ op->a ] < registers[op->b];
+			break;
+		case OP_TYPE_LE:
+			registers[op->c] = registers[ op->a ] <= registers[op->b];
+			break;
+		case OP_TYPE_EQ:
+			registers[op->c] = registers[ op->a ] == registers[op->b];
+			break;
+		case OP_TYPE_NE:
+			registers[op->c] = registers[ op->a ] != registers[op->b];
+			break;
+		case OP_TYPE_AND:
+			registers[op->c] = registers[ op->a ] && registers[op->b];
+			break;
+		case OP_TYPE_OR:
+			registers[op->c] = registers[ op->a ] || registers[op->b];
+			break;
+		default:
+			common->FatalError( "R_EvaluateExpression: bad opcode" );
+	}
+}
+
+static idSysInterlockedInteger	materialEvaluations;
+static idSysInterlockedInteger	materialEvaluationsSaved;
+
 /*
 ===============
 idMaterial::EvaluateRegisters
@@ -3351,14 +3439,12 @@ void idMaterial::EvaluateRegisters(
 	const float		floatTime,
 	idSoundEmitter* soundEmitter ) const
 {
-
-	int		i, b;
-	expOp_t*	op;
+	materialEvaluations.Increment();
 
 	// copy the material constants
-	for( i = EXP_REG_NUM_PREDEFINED ; i < numRegisters ; i++ )
+	if( numRegisters > EXP_REG_NUM_PREDEFINED )
 	{
-		registers[i] = expressionRegisters[i];
+		memcpy( &registers[EXP_REG_NUM_PREDEFINED], &expressionRegisters[EXP_REG_NUM_PREDEFINED], ( numRegisters - EXP_REG_NUM_PREDEFINED ) * sizeof( registers[0] ) );
 	}
 
 	// copy the local and global parameters
@@ -3384,77 +3470,105 @@ void idMaterial::EvaluateRegisters(
 	registers[EXP_REG_GLOBAL6] = globalShaderParms[6];
 	registers[EXP_REG_GLOBAL7] = globalShaderParms[7];
 
-	op = ops;
-	for( i = 0 ; i < numOps ; i++, op++ )
+	const expOp_t* op = ops;
+	for( int i = 0 ; i < numOps ; i++, op++ )
+	{
+		R_EvaluateExpressionOp( op, registers, soundEmitter );
+	}
+}
+
+/*
+===============
+idMaterial::CollectEvaluationCounters
+===============
+*/
+void idMaterial::CollectEvaluationCounters( performanceCounters_t& pc )
+{
+	const int evaluations = materialEvaluations.GetValue();
+	materialEvaluations.Sub( evaluations );
+	pc.c_materialEvaluations += evaluations;
+
+	const int saved = materialEvaluationsSaved.GetValue();
+	materialEvaluationsSaved.Sub( saved );
+	pc.c_materialEvaluationsSaved += saved;
+}
+
+/*
+===============
+idMaterial::EvaluateFrameRegisters
+
+Many surfaces in a frame use the same material with the same inputs, like all
+the particles of a system or the lights sharing a flicker table, so the last
+result is kept and compared against the inputs the expressions read.
+
+The cache is a single entry guarded by a try lock, a thread that finds
+it busy just evaluates the registers itself.
+===============
+*/
+const float* idMaterial::EvaluateFrameRegisters(
+	const float		localShaderParms[MAX_ENTITY_SHADER_PARMS],
+	const float		globalShaderParms[MAX_GLOBAL_SHADER_PARMS],
+	const float		floatTime,
+	idSoundEmitter* soundEmitter ) const
+{
+	if( constantRegisters != NULL )
+	{
+		return constantRegisters;
+	}
+
+	float inputs[EXP_REG_NUM_PREDEFINED];
+	inputs[EXP_REG_TIME] = floatTime;
+	for( int i = 0; i < EXP_REG_GLOBAL0 - EXP_REG_PARM0; i++ )
+	{
+		inputs[EXP_REG_PARM0 + i] = localShaderParms[i];
+	}
+	for( int i = 0; i < EXP_REG_NUM_PREDEFINED - EXP_REG_GLOBAL0; i++ )
+	{
+		inputs[EXP_REG_GLOBAL0 + i] = globalShaderParms[i];
+	}
+
+	const bool useCache = r_useMaterialRegisterCache.GetBool();
+	const bool ownsCache = useCache && ( registerCacheLock.Increment() == 1 );
+
+	if( ownsCache && registerCache.registers != NULL && registerCache.frame == smpFrame &&
+			( !readsSoundAmplitude || registerCache.soundEmitter == soundEmitter ) )
 	{
-		switch( op->opType )
+		bool sameInputs = true;
+		for( int i = 0; i < EXP_REG_NUM_PREDEFINED; i++ )
 		{
-			case OP_TYPE_ADD:
-				registers[op->c] = registers[op->a] + registers[op->b];
-				break;
-			case OP_TYPE_SUBTRACT:
-				registers[op->c] = registers[op->a] - registers[op->b];
-				break;
-			case OP_TYPE_MULTIPLY:
-				registers[op->c] = registers[op->a] * registers[op->b];
-				break;
-			case OP_TYPE_DIVIDE:
-				registers[op->c] = registers[op->a] / registers[op->b];
-				break;
-			case OP_TYPE_MOD:
-				b = ( int )registers[op->b];
-				b = b != 0 ? b : 1;
-				registers[op->c] = ( int )registers[op->a] % b;
-				break;
-			case OP_TYPE_TABLE:
+			if( ( inputRegisterBits & BIT( i ) ) && registerCache.inputs[i] != inputs[i] )
 			{
-				const idDeclTable* table = static_cast<const idDeclTable*>( declManager->DeclByIndex( DECL_TABLE, op->a ) );
-				registers[op->c] = table->TableLookup( registers[op->b] );
-			}
-			break;
-			case OP_TYPE_SOUND:
-				if( r_forceSoundOpAmplitude.GetFloat() > 0 )
-				{
-					registers[op->c] = r_forceSoundOpAmplitude.GetFloat();
-				}
-				else if( soundEmitter )
-				{
-					registers[op->c] = soundEmitter->CurrentAmplitude();
-				}
-				else
-				{
-					registers[op->c] = 0;
-				}
-				break;
-			case OP_TYPE_GT:
-				registers[op->c] = registers[ op->a ] > registers[op->b];
-				break;
-			case OP_TYPE_GE:
-				registers[op->c] = registers[ op->a ] >= registers[op->b];
-				break;
-			case OP_TYPE_LT:
-				registers[op->c] = registers[ op->a ] < registers[op->b];
+				sameInputs = false;
 				break;
-			case OP_TYPE_LE:
-				registers[op->c] = registers[ op->a ] <= registers[op->b];
-				break;
-			case OP_TYPE_EQ:
-				registers[op->c] = registers[ op->a ] == registers[op->b];
-				break;
-			case OP_TYPE_NE:
-				registers[op->c] = registers[ op->a ] != registers[op->b];
-				break;
-			case OP_TYPE_AND:
-				registers[op->c] = registers[ op->a ] && registers[op->b];
-				break;
-			case OP_TYPE_OR:
-				registers[op->c] = registers[ op->a ] || registers[op->b];
-				break;
-			default:
-				common->FatalError( "R_EvaluateExpression: bad opcode" );
+			}
+		}
+
+		if( sameInputs )
+		{
+			const float* registers = registerCache.registers;
+			registerCacheLock.Decrement();
+
+			materialEvaluationsSaved.Increment();
+			return registers;
 		}
 	}
 
+	float* registers = ( float* )R_FrameAlloc( numRegisters * sizeof( float ), FRAME_ALLOC_SHADER_REGISTER );
+	EvaluateRegisters( registers, localShaderParms, globalShaderParms, floatTime, soundEmitter );
+
+	if( ownsCache )
+	{
+		registerCache.frame = smpFrame;
+		memcpy( registerCache.inputs, inputs, sizeof( inputs ) );
+		registerCache.soundEmitter = soundEmitter;
+		registerCache.registers = registers;
+	}
+	if( useCache )
+	{
+		registerCacheLock.Decrement();
+	}
+
+	return registers;
 }
 
 /*
@@ -3586,6 +3700,157 @@ bool idMaterial::CinematicIsPlaying() const
 }
 // RB end
 
+/*
+==================
+R_MarkRegisterUsed
+==================
+*/
+static void R_MarkRegisterUsed( bool* used, int numRegisters, int reg )
+{
+	if( reg >= 0 && reg < numRegisters )
+	{
+		used[reg] = true;
+	}
+}
+
+/*
+==================
+idMaterial::OptimizeExpressions
+
+Ops that only read constants are evaluated once here and their result register
+becomes a constant, ops whose result is never read by a later op or a stage are
+dropped. Registers are never renumbered, so the stages don't need to be touched.
+==================
+*/
+void idMaterial::OptimizeExpressions()
+{
+	bool	used[MAX_EXPRESSION_REGISTERS];
+	int		i, j;
+
+	if( TestMaterialFlag( MF_DEFAULTED ) )
+	{
+		return;
+	}
+
+	// fold the ops with constant inputs, ops are always emitted after the
+	// ops they read so a single pass folds whole constant subexpressions
+	for( i = 0; i < numOps; i++ )
+	{
+		expOp_t* op = &pd->shaderOps[i];
+		if( op->opType == OP_TYPE_SOUND )
+		{
+			continue;
+		}
+		if( pd->registerIsTemporary[op->b] || ( op->opType != OP_TYPE_TABLE && pd->registerIsTemporary[op->a] ) )
+		{
+			continue;
+		}
+		R_EvaluateExpressionOp( op, pd->shaderRegisters, NULL );
+		pd->registerIsTemporary[op->c] = false;
+	}
+
+	// find the registers read by the stages and the deforms
+	memset( used, 0, sizeof( used ) );
+
+	for( i = 0; i < numStages; i++ )
+	{
+		const shaderStage_t* ss = &pd->parseStages[i];
+
+		R_MarkRegisterUsed( used, numRegisters, ss->conditionRegister );
+		for( j = 0; j < 4; j++ )
+		{
+			R_MarkRegisterUsed( used, numRegisters, ss->color.registers[j] );
+		}
+		if( ss->hasAlphaTest )
+		{
+			R_MarkRegisterUsed( used, numRegisters, ss->alphaTestRegister );
+		}
+		if( ss->texture.hasMatrix )
+		{
+			for( j = 0; j < 3; j++ )
+			{
+				R_MarkRegisterUsed( used, numRegisters, ss->texture.matrix[0][j] );
+				R_MarkRegisterUsed( used, numRegisters, ss->texture.matrix[1][j] );
+			}
+		}
+		if( ss->texture.texgen == TG_WOBBLESKY_CUBE )
+		{
+			for( j = 0; j < MAX_TEXGEN_REGISTERS; j++ )
+			{
+				R_MarkRegisterUsed( used, numRegisters, texGenRegisters[j] );
+			}
+		}
+		if( ss->newStage != NULL )
+		{
+			for( j = 0; j < ss->newStage->numVertexParms; j++ )
+			{
+				for( int k = 0; k < 4; k++ )
+				{
+					R_MarkRegisterUsed( used, numRegisters, ss->newStage->vertexParms[j][k] );
+				}
+			}
+		}
+	}
+	if( deform != DFRM_NONE )
+	{
+		for( j = 0; j < 4; j++ )
+		{
+			R_MarkRegisterUsed( used, numRegisters, deformRegisters[j] );
+		}
+	}
+
+	// walk the ops backwards so an op that is only read by dead ops is dead as well
+	bool live[MAX_EXPRESSION_OPS];
+	for( i = numOps - 1; i >= 0; i-- )
+	{
+		const expOp_t* op = &pd->shaderOps[i];
+		live[i] = pd->registerIsTemporary[op->c] && used[op->c];
+		if( !live[i] || op->opType == OP_TYPE_SOUND )
+		{
+			continue;
+		}
+		if( op->opType != OP_TYPE_TABLE )
+		{
+			R_MarkRegisterUsed( used, numRegisters, op->a );
+		}
+		R_MarkRegisterUsed( used, numRegisters, op->b );
+	}
+
+	int numLiveOps = 0;
+	for( i = 0; i < numOps; i++ )
+	{
+		if( live[i] )
+		{
+			pd->shaderOps[numLiveOps++] = pd->shaderOps[i];
+		}
+	}
+	numOps = numLiveOps;
+
+	// remember which inputs the remaining expressions depend on
+	inputRegisterBits = 0;
+	for( i = 0; i < EXP_REG_NUM_PREDEFINED; i++ )
+	{
+		if( used[i] )
+		{
+			inputRegisterBits |= BIT( i );
+		}
+	}
+	readsSoundAmplitude = false;
+	for( i = 0; i < numOps; i++ )
+	{
+		if( pd->shaderOps[i].opType == OP_TYPE_SOUND )
+		{
+			readsSoundAmplitude = true;
+		}
+	}
+
+	// a parm or time reference may have been folded away, like "parm0 * 0"
+	if( inputRegisterBits == 0 && !readsSoundAmplitude )
+	{
+		pd->registersAreConstant = true;
+	}
+}
+
 /*
 ==================
 idMaterial::CheckForConstantRegisters
@@ -47,6 +47,7 @@ If you have questions concerning this license or the applicable additional terms
 class idImage;
 class idCinematic;
 class idUserInterface;
+struct performanceCounters_t;
 
 // moved from image.h for default parm
 typedef enum
@@ -928,6 +929,21 @@ public:
 		return constantRegisters;
 	};
 
+	// Evaluates the registers into frame memory. The result of the last call is kept
+	// for the rest of the frame and returned again if none of the parms, globals, time
+	// or sound amplitude the expressions actually read have changed.
+	// The returned registers must not be modified.
+	const float* 		EvaluateFrameRegisters(
+		const float		localShaderParms[MAX_ENTITY_SHADER_PARMS],
+		const float		globalShaderParms[MAX_GLOBAL_SHADER_PARMS],
+		const float		floatTime,
+		idSoundEmitter* soundEmitter ) const;
+
+	// moves the EvaluateRegisters and EvaluateFrameRegisters counts since the last call
+	// into the performance counters, the counts are kept with interlocked adds because
+	// the registers are evaluated from the front end jobs
+	static void			CollectEvaluationCounters( performanceCounters_t& pc );
+
 	bool				SuppressInSubview() const
 	{
 		return suppressInSubview;
@@ -990,6 +1006,7 @@ private:
 	void				MultiplyTextureMatrix( textureStage_t* ts, int registers[2][3] );	// FIXME: for some reason the const is bad for gcc and Mac
 	void				SortInteractionStages();
 	void				AddImplicitStages( const textureRepeat_t trpDefault = TR_REPEAT );
+	void				OptimizeExpressions();
 	void				CheckForConstantRegisters();
 	void				SetFastPathImages();
 
@@ -1048,6 +1065,20 @@ private:
 
 	float* 				constantRegisters;	// NULL if ops ever reference globalParms or entityParms
 
+	int					inputRegisterBits;	// bit for each predefined register the ops or stages read
+	bool				readsSoundAmplitude;
+
+	// the last registers returned by EvaluateFrameRegisters
+	struct registerCache_t
+	{
+		unsigned int	frame;				// smpFrame the registers were allocated in
+		float			inputs[EXP_REG_NUM_PREDEFINED];
+		idSoundEmitter* soundEmitter;
+		const float* 	registers;
+	};
+	mutable registerCache_t				registerCache;
+	mutable idSysInterlockedInteger		registerCacheLock;
+
 	int					numStages;
 	int					numAmbientStages;
 
@@ -76,6 +76,15 @@ objModel_t* OBJ_Parse( const char* fileName, const char* objFileBuffer, int leng
 
 	idStrStatic< MAX_OSPATH >	material;
 
+	// these get very large for detailed models
+	vertexes.SetGeometricGrowth( true );
+	texCoords.SetGeometricGrowth( true );
+	normals.SetGeometricGrowth( true );
+	objVertexes.SetGeometricGrowth( true );
+	objTexCoords.SetGeometricGrowth( true );
+	objNormals.SetGeometricGrowth( true );
+	objIndices.SetGeometricGrowth( true );
+
 	src.LoadMemory( objFileBuffer, length, fileName, 0 );
 
 	while( true )
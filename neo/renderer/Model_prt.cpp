@@ -66,6 +66,193 @@ void idRenderModelPrt::TouchData()
 	particleSystem = static_cast<const idDeclParticle*>( declManager->FindType( DECL_PARTICLE, name ) );
 }
 
+/*
+====================
+R_CreateParticlesScalar
+
+Steps CreateParticle over every index of the stage, this is the reference
+for idParticleStage::CreateParticles
+====================
+*/
+static int R_CreateParticlesScalar( particleGen_t* g, const idParticleStage* stage, int stageAge, idDrawVert* verts )
+{
+	const renderEntity_t* renderEntity = g->renderEnt;
+
+	idRandom steppingRandom, steppingRandom2;
+
+	int	stageCycle = stageAge / stage->cycleMsec;
+
+	// some particles will be in this cycle, some will be in the previous cycle
+	steppingRandom.SetSeed( ( ( stageCycle << 10 ) & idRandom::MAX_RAND ) ^ ( int )( renderEntity->shaderParms[SHADERPARM_DIVERSITY] * idRandom::MAX_RAND ) );
+	steppingRandom2.SetSeed( ( ( ( stageCycle - 1 ) << 10 ) & idRandom::MAX_RAND ) ^ ( int )( renderEntity->shaderParms[SHADERPARM_DIVERSITY] * idRandom::MAX_RAND ) );
+
+	int numVerts = 0;
+
+	for( int index = 0; index < stage->totalParticles; index++ )
+	{
+		g->index = index;
+
+		// bump the random
+		steppingRandom.RandomInt();
+		steppingRandom2.RandomInt();
+
+		// calculate local age for this index
+		int	bunchOffset = stage->particleLife * 1000 * stage->spawnBunching * index / stage->totalParticles;
+
+		int particleAge = stageAge - bunchOffset;
+		int	particleCycle = particleAge / stage->cycleMsec;
+		if( particleCycle < 0 )
+		{
+			// before the particleSystem spawned
+			continue;
+		}
+		if( stage->cycles && particleCycle >= stage->cycles )
+		{
+			// cycled systems will only run cycle times
+			continue;
+		}
+
+		if( particleCycle == stageCycle )
+		{
+			g->random = steppingRandom;
+		}
+		else
+		{
+			g->random = steppingRandom2;
+		}
+
+		int	inCycleTime = particleAge - particleCycle * stage->cycleMsec;
+
+		if( renderEntity->shaderParms[SHADERPARM_PARTICLE_STOPTIME] &&
+				g->renderView->time[renderEntity->timeGroup] - inCycleTime >= renderEntity->shaderParms[SHADERPARM_PARTICLE_STOPTIME] * 1000 )
+		{
+			// don't fire any more particles
+			continue;
+		}
+
+		// supress particles before or after the age clamp
+		g->frac = ( float )inCycleTime / ( stage->particleLife * 1000 );
+		if( g->frac < 0.0f )
+		{
+			// yet to be spawned
+			continue;
+		}
+		if( g->frac > 1.0f )
+		{
+			// this particle is in the deadTime band
+			continue;
+		}
+
+		// this is needed so aimed particles can calculate origins at different times
+		g->originalRandom = g->random;
+
+		g->age = g->frac * stage->particleLife;
+
+		// if the particle doesn't get drawn because it is faded out or beyond a kill region, don't increment the verts
+		numVerts += stage->CreateParticle( g, verts + numVerts );
+	}
+
+	return numVerts;
+}
+
+/*
+====================
+TestParticleBatch_f
+
+Runs every stage of a particle system through both the scalar and the batched
+generator over a range of times, checks that they create the same verts and
+reports how long each took
+====================
+*/
+CONSOLE_COMMAND( testParticleBatch, "compares and benchmarks the scalar and batched particle generators", idCmdSystem::ArgCompletion_Decl<DECL_PARTICLE> )
+{
+	if( args.Argc() < 2 )
+	{
+		common->Printf( "usage: testParticleBatch <particle> [frames] [scale]\n" );
+		return;
+	}
+
+	const idDeclParticle* particleSystem = static_cast<const idDeclParticle*>( declManager->FindType( DECL_PARTICLE, args.Argv( 1 ), false ) );
+	if( particleSystem == NULL )
+	{
+		common->Printf( "couldn't find particle %s\n", args.Argv( 1 ) );
+		return;
+	}
+
+	const int frames = ( args.Argc() > 2 ) ? Max( atoi( args.Argv( 2 ) ), 1 ) : 1000;
+	// multiplies the particle counts to stress the generators
+	const int scale = ( args.Argc() > 3 ) ? Max( atoi( args.Argv( 3 ) ), 1 ) : 1;
+
+	renderEntity_t renderEntity;
+	memset( &renderEntity, 0, sizeof( renderEntity ) );
+	renderEntity.axis.Identity();
+	renderEntity.shaderParms[0] = renderEntity.shaderParms[1] = renderEntity.shaderParms[2] = renderEntity.shaderParms[3] = 1.0f;
+	renderEntity.shaderParms[SHADERPARM_DIVERSITY] = 0.37f;
+
+	renderView_t renderView;
+	memset( &renderView, 0, sizeof( renderView ) );
+	renderView.viewaxis.Identity();
+
+	particleGen_t g;
+	g.renderEnt = &renderEntity;
+	g.renderView = &renderView;
+	g.origin.Zero();
+	g.axis.Identity();
+
+	uint64_t scalarMicroSec = 0;
+	uint64_t batchMicroSec = 0;
+	int totalVerts = 0;
+	int mismatches = 0;
+
+	for( int stageNum = 0; stageNum < particleSystem->stages.Num(); stageNum++ )
+	{
+		// work on a copy so the particle counts can be scaled
+		idParticleStage stage;
+		stage = *particleSystem->stages[stageNum];
+		stage.totalParticles *= scale;
+
+		if( !stage.cycleMsec || stage.totalParticles <= 0 )
+		{
+			continue;
+		}
+
+		const int maxVerts = 4 * stage.totalParticles * stage.NumQuadsPerParticle();
+		idDrawVert* scalarVerts = ( idDrawVert* )Mem_Alloc16( maxVerts * sizeof( idDrawVert ), TAG_MODEL );
+		idDrawVert* batchVerts = ( idDrawVert* )Mem_Alloc16( maxVerts * sizeof( idDrawVert ), TAG_MODEL );
+
+		for( int frame = 0; frame < frames; frame++ )
+		{
+			renderView.time[0] = renderView.time[1] = frame * 16;
+			const int stageAge = renderView.time[0] - stage.timeOffset * 1000;
+
+			uint64_t start = Sys_Microseconds();
+			const int numScalar = R_CreateParticlesScalar( &g, &stage, stageAge, scalarVerts );
+			scalarMicroSec += Sys_Microseconds() - start;
+
+			start = Sys_Microseconds();
+			const int numBatch = stage.CreateParticles( &g, stageAge, batchVerts );
+			batchMicroSec += Sys_Microseconds() - start;
+
+			totalVerts += numScalar;
+
+			if( numScalar != numBatch || memcmp( scalarVerts, batchVerts, numScalar * sizeof( idDrawVert ) ) != 0 )
+			{
+				if( mismatches++ == 0 )
+				{
+					common->Printf( "stage %d differs at %d msec: %d scalar verts, %d batched verts\n", stageNum, renderView.time[0], numScalar, numBatch );
+				}
+			}
+		}
+
+		Mem_Free16( scalarVerts );
+		Mem_Free16( batchVerts );
+	}
+
+	common->Printf( "%s: %d frames, %d verts, %d mismatched stage frames\n", particleSystem->GetName(), frames, totalVerts, mismatches );
+	common->Printf( "scalar  %8.2f ms\n", scalarMicroSec / 1000.0f );
+	common->Printf( "batched %8.2f ms\n", batchMicroSec / 1000.0f );
+}
+
 /*
 ====================
 idRenderModelPrt::InstantiateDynamicModel
@@ -143,14 +330,7 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			continue;
 		}
 
-		idRandom steppingRandom, steppingRandom2;
-
 		int stageAge = g.renderView->time[renderEntity->timeGroup] + renderEntity->shaderParms[SHADERPARM_TIMEOFFSET] * 1000 - stage->timeOffset * 1000;
-		int	stageCycle = stageAge / stage->cycleMsec;
-
-		// some particles will be in this cycle, some will be in the previous cycle
-		steppingRandom.SetSeed( ( ( stageCycle << 10 ) & idRandom::MAX_RAND ) ^ ( int )( renderEntity->shaderParms[SHADERPARM_DIVERSITY] * idRandom::MAX_RAND ) );
-		steppingRandom2.SetSeed( ( ( ( stageCycle - 1 ) << 10 ) & idRandom::MAX_RAND ) ^ ( int )( renderEntity->shaderParms[SHADERPARM_DIVERSITY] * idRandom::MAX_RAND ) );
 
 		int	count = stage->totalParticles * stage->NumQuadsPerParticle();
 
@@ -172,71 +352,16 @@ idRenderModel* idRenderModelPrt::InstantiateDynamicModel( const struct renderEnt
 			R_AllocStaticTriSurfIndexes( surf->geometry, 6 * count );
 		}
 
-		int numVerts = 0;
 		idDrawVert* verts = surf->geometry->verts;
 
-		for( int index = 0; index < stage->totalParticles; index++ )
+		int numVerts;
+		if( r_useParticleBatching.GetBool() )
 		{
-			g.index = index;
-
-			// bump the random
-			steppingRandom.RandomInt();
-			steppingRandom2.RandomInt();
-
-			// calculate local age for this index
-			int	bunchOffset = stage->particleLife * 1000 * stage->spawnBunching * index / stage->totalParticles;
-
-			int particleAge = stageAge - bunchOffset;
-			int	particleCycle = particleAge / stage->cycleMsec;
-			if( particleCycle < 0 )
-			{
-				// before the particleSystem spawned
-				continue;
-			}
-			if( stage->cycles && particleCycle >= stage->cycles )
-			{
-				// cycled systems will only run cycle times
-				continue;
-			}
-
-			if( particleCycle == stageCycle )
-			{
-				g.random = steppingRandom;
-			}
-			else
-			{
-				g.random = steppingRandom2;
-			}
-
-			int	inCycleTime = particleAge - particleCycle * stage->cycleMsec;
-
-			if( renderEntity->shaderParms[SHADERPARM_PARTICLE_STOPTIME] &&
-					g.renderView->time[renderEntity->timeGroup] - inCycleTime >= renderEntity->shaderParms[SHADERPARM_PARTICLE_STOPTIME] * 1000 )
-			{
-				// don't fire any more particles
-				continue;
-			}
-
-			// supress particles before or after the age clamp
-			g.frac = ( float )inCycleTime / ( stage->particleLife * 1000 );
-			if( g.frac < 0.0f )
-			{
-				// yet to be spawned
-				continue;
-			}
-			if( g.frac > 1.0f )
-			{
-				// this particle is in the deadTime band
-				continue;
-			}
-
-			// this is needed so aimed particles can calculate origins at different times
-			g.originalRandom = g.random;
-
-			g.age = g.frac * stage->particleLife;
-
-			// if the particle doesn't get drawn because it is faded out or beyond a kill region, don't increment the verts
-			numVerts += stage->CreateParticle( &g, verts + numVerts );
+			numVerts = stage->CreateParticles( &g, stageAge, verts );
+		}
+		else
+		{
+			numVerts = R_CreateParticlesScalar( &g, stage, stageAge, verts );
 		}
 
 		// numVerts must be a multiple of 4
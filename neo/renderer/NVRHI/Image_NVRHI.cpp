@@ -132,6 +132,10 @@ idImage::idImage( const char* name ) : imgName( name )
 	binaryFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	refCount = 0;
 
+	streamMaxSize = 0;
+	streamSkippedMips = 0;
+	residencyIndex = -1;
+
 #if 0
 	// debugging code
 	idStr ext;
@@ -556,6 +560,12 @@ void idImage::AllocImage()
 			textureDesc.setIsUAV( true );
 		}
 	}
+	else if( streamMaxSize > 0 )
+	{
+		// streamed images stay tracked so they can be copied into smaller textures
+		textureDesc.setInitialState( nvrhi::ResourceStates::ShaderResource )
+		.setKeepInitialState( true );
+	}
 
 	if( opts.textureType == TT_2D )
 	{
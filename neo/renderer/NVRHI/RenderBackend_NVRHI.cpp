@@ -1889,6 +1889,18 @@ void idRenderBackend::ClearCaches()
 	currentPipeline = nullptr;
 }
 
+/*
+=============
+idRenderBackend::ClearBindingSets
+
+Clear the cached binding sets when images got new textures but the pipelines are still valid.
+=============
+*/
+void idRenderBackend::ClearBindingSets()
+{
+	bindingCache.Clear();
+}
+
 /*
 ============================================================================
 
@@ -61,6 +61,10 @@ idImage::idImage( const char* name ) : imgName( name )
 	sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	binaryFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	refCount = 0;
+
+	streamMaxSize = 0;
+	streamSkippedMips = 0;
+	residencyIndex = -1;
 }
 
 /*
@@ -140,6 +140,7 @@ public:
 	void				CheckCVars();
 
 	void				ClearCaches();
+	void				ClearBindingSets();
 
 	static void			ImGui_Init();
 	static void			ImGui_Shutdown();
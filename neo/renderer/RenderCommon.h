@@ -164,6 +164,17 @@ public:
 };
 
 
+// an entity in the areas of a light with the view independent culling results,
+// cached so R_AddSingleLight only has to re-test entities that changed
+struct lightCaster_t
+{
+	idRenderEntityLocal* 	edef;
+	int						entityIndex;
+	uint64_t				referenceVersion;		// edef->referenceVersion the results belong to
+	bool					culledToLight;			// R_CullModelBoundsToLight()
+	idBounds				shadowBounds;
+};
+
 class idRenderLightLocal : public idRenderLight
 {
 public:
@@ -215,6 +226,14 @@ public:
 	idInteraction* 			lastInteraction;
 
 	struct doublePortal_s* 	foggedPortals;
+
+	// entities in the light's areas, rebuilt by R_AddSingleLight when an entity
+	// is added to one of the areas, a portal changes or the light is moved
+	idList<lightCaster_t, TAG_RENDER_LIGHT>	casterCache;
+	idList<int, TAG_RENDER_LIGHT>	casterAreas;	// areas that were walked for the cache
+	uint64_t				casterCacheVersion;		// world->referenceVersion when built, 0 if invalid
+	int						casterCacheConnectedAreaNum;
+	int						casterCacheAreasConnected;	// r_useAreasConnectedForShadowCulling when built
 };
 
 
@@ -294,6 +313,8 @@ public:
 	// and should go in the dynamic frame memory, or kept
 	// in the cached memory
 
+	uint64_t				referenceVersion;		// changes every time the entityRefs are freed
+
 	idRenderModel* 			dynamicModel;			// if parms.model->IsDynamicModel(), this is the generated data
 	int						dynamicModelFrameCount;	// continuously animating dynamic models will recreate
 	// dynamicModel if this doesn't == tr.viewCount
@@ -353,6 +374,10 @@ struct viewLight_t
 	// the view, even though the aren't directly visible
 	shadowOnlyEntity_t* 	shadowOnlyViewEntities;
 
+	// light caster cache stats, summed up serially in R_AddLights
+	bool					casterCacheHit;
+	int						casterRetests;
+
 	enum interactionState_t
 	{
 		INTERACTION_UNCHECKED,
@@ -767,6 +792,7 @@ public:
 };
 
 extern	idFrameData*	frameData;
+extern	unsigned int	smpFrame;			// incremented each time the frame data is switched
 
 //=======================================================================
 
@@ -1123,6 +1149,7 @@ extern idCVar r_skipSuppress;				// ignore the per-view suppressions
 extern idCVar r_skipInteractions;			// skip all light/surface interaction drawing
 extern idCVar r_skipFrontEnd;				// bypasses all front end work, but 2D gui rendering still draws
 extern idCVar r_skipBackEnd;				// don't draw anything
+extern idCVar r_nullRender;					// front end only, command buffers are discarded and nothing is presented
 extern idCVar r_skipCopyTexture;			// do all rendering, but don't actually copyTexSubImage2D
 extern idCVar r_skipRender;					// skip 3D rendering, but pass 2D
 extern idCVar r_skipTranslucent;			// skip the translucent interaction rendering
@@ -1133,6 +1160,7 @@ extern idCVar r_skipFogLights;				// skip all fog lights
 extern idCVar r_skipSubviews;				// 1 = don't render any mirrors / cameras / etc
 extern idCVar r_skipGuiShaders;				// 1 = don't render any gui elements on surfaces
 extern idCVar r_skipParticles;				// 1 = don't render any particles
+extern idCVar r_useParticleBatching;			// 1 = generate parametric particles in SIMD batches
 extern idCVar r_skipUpdates;				// 1 = don't accept any entity or light updates, making everything static
 extern idCVar r_skipDeforms;				// leave all deform materials in their original state
 extern idCVar r_skipDynamicTextures;		// don't dynamically create textures
@@ -1690,6 +1718,11 @@ struct localTrace_t
 
 localTrace_t R_LocalTrace( const idVec3& start, const idVec3& end, const float radius, const srfTriangles_t* tri );
 
+// building blocks of R_LocalTrace, used to trace the area model BVHs with the same precision
+void R_TracePlanes( const idVec3& start, const idVec3& end, idPlane planes[4] );
+byte R_TracePointCullBits( const idPlane* planes, const float radius, const idVec3& v );
+bool R_LineIntersectsTriangleExpandedWithCircle( localTrace_t& hit, const idVec3& start, const idVec3& end, const float circleRadius, const idVec3& triVert0, const idVec3& triVert1, const idVec3& triVert2 );
+
 
 /*
 ============================================================
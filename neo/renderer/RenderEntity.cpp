@@ -41,6 +41,7 @@ idRenderEntityLocal::idRenderEntityLocal()
 	world					= NULL;
 	index					= 0;
 	lastModifiedFrameNum	= 0;
+	referenceVersion		= 0;
 	dynamicModel			= NULL;
 	dynamicModelFrameCount	= 0;
 	cachedDynamicModel		= NULL;
@@ -106,6 +107,9 @@ idRenderLightLocal::idRenderLightLocal()
 	foggedPortals			= NULL;
 	firstInteraction		= NULL;
 	lastInteraction			= NULL;
+	casterCacheVersion		= 0;
+	casterCacheConnectedAreaNum = 0;
+	casterCacheAreasConnected = 0;
 
 	baseLightProject.Zero();
 	inverseBaseLightProject.Zero();
@@ -72,6 +72,13 @@ void idRenderSystemLocal::PrintPerformanceCounters()
 						pc.c_tangentIndexes / 3,
 						pc.c_guiSurfs
 					  );
+		common->Printf( "guisCulled:%i guisParallel:%i guiCull:%i usec guiEvents:%i usec guiRedraw:%i usec\n",
+						pc.c_guiSurfsCulled,
+						pc.c_guiParallelEvents,
+						( int )pc.guiCullMicroSec,
+						( int )pc.guiEventsMicroSec,
+						( int )pc.guiRedrawMicroSec
+					  );
 	}
 
 	if( r_showCull.GetBool() )
@@ -86,6 +93,14 @@ void idRenderSystemLocal::PrintPerformanceCounters()
 						pc.c_entityDefCallbacks, pc.c_createInteractions, pc.c_createShadowVolumes );
 		common->Printf( "viewEntities:%i  shadowEntities:%i  viewLights:%i\n", pc.c_visibleViewEntities,
 						pc.c_shadowViewEntities, pc.c_viewLights );
+		common->Printf( "casterCacheHits:%i  casterCacheMisses:%i  casterRetests:%i\n", pc.c_casterCacheHits,
+						pc.c_casterCacheMisses, pc.c_casterRetests );
+		common->Printf( "materialEvaluations:%i  materialEvaluationsSaved:%i\n", pc.c_materialEvaluations,
+						pc.c_materialEvaluationsSaved );
+		common->Printf( "viewFloodCacheHits:%i  viewFloodCacheMisses:%i  viewFloodBuild:%i usec  viewFloodReplay:%i usec\n", pc.c_viewFloodCacheHits,
+						pc.c_viewFloodCacheMisses, ( int )pc.viewFloodBuildMicroSec, ( int )pc.viewFloodReplayMicroSec );
+		common->Printf( "entityCullTested:%i  entityCullRejected:%i  entityCullSkipped:%i  entityCull:%i usec\n", pc.c_entityCullTested,
+						pc.c_entityCullRejected, pc.c_entityCullSkipped, ( int )pc.entityCullMicroSec );
 	}
 	if( r_showUpdates.GetBool() )
 	{
@@ -132,7 +147,8 @@ void idRenderSystemLocal::RenderCommandBuffers( const emptyCommand_t* const cmdH
 
 	// r_skipRender is usually more usefull, because it will still
 	// draw 2D graphics
-	if( !r_skipBackEnd.GetBool() )
+	// r_nullRender does the same for headless front end benchmarks
+	if( !r_skipBackEnd.GetBool() && !r_nullRender.GetBool() )
 	{
 		backend.ExecuteBackEndCommands( cmdHead );
 	}
@@ -648,7 +664,13 @@ void idRenderSystemLocal::SwapCommandBuffers_FinishRendering(
 
 	// keep capturing envprobes completely in the background
 	// and only update the screen when we update the progress bar in the console
-	if( !omitSwapBuffers )
+	if( r_nullRender.GetBool() )
+	{
+		// nothing was submitted, so there is nothing to wait for or present,
+		// but upload resources still have to be released
+		deviceManager->GetDevice()->runGarbageCollection();
+	}
+	else if( !omitSwapBuffers )
 	{
 		// wait for our fence to hit, which means the swap has actually happened
 		// We must do this before clearing any resources the GPU may be using
@@ -684,6 +706,9 @@ void idRenderSystemLocal::SwapCommandBuffers_FinishRendering(
 		*bc = backend.pc;
 	}
 
+	// the front end jobs are done, so all material evaluations of the frame are counted
+	idMaterial::CollectEvaluationCounters( this->pc );
+
 	if( pc != NULL )
 	{
 		*pc = this->pc;
@@ -697,6 +722,9 @@ void idRenderSystemLocal::SwapCommandBuffers_FinishRendering(
 
 	// RB: resize HDR buffers
 	Framebuffer::CheckFramebuffers();
+
+	// the previous frame is done, raise or drop the levels of the streamed images
+	globalImages->UpdateResidency( frameCount );
 }
 
 /*
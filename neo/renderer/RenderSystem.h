@@ -125,6 +125,8 @@ struct performanceCounters_t
 	int		c_entityReferences;
 	int		c_lightReferences;
 	int		c_guiSurfs;
+	int		c_guiSurfsCulled;	// gui surfaces rejected by R_PreciseCullSurface
+	int		c_guiParallelEvents;	// guis that ran their time events in jobs
 
 	int		c_mocVerts;
 	int		c_mocIndexes;
@@ -132,7 +134,27 @@ struct performanceCounters_t
 	int		c_mocCulledSurfaces;
 	int		c_mocCulledLights;
 
+	int		c_casterCacheHits;		// lights that reused their cached caster list
+	int		c_casterCacheMisses;	// lights that rebuilt it
+	int		c_casterRetests;		// cached entities re-culled because they changed
+
+	int		c_materialEvaluations;		// idMaterial::EvaluateRegisters calls
+	int		c_materialEvaluationsSaved;	// registers reused by EvaluateFrameRegisters
+
+	int		c_viewFloodCacheHits;		// views that re-clipped a cached portal tree
+	int		c_viewFloodCacheMisses;		// views that had to build the portal tree first
+
+	int		c_entityCullTested;			// view entities packed for R_CullViewEntities
+	int		c_entityCullRejected;		// portal visible entities outside the view frustum
+	int		c_entityCullSkipped;		// view entities not handed to R_AddSingleModel
+
 	uint64_t	mocMicroSec;
+	uint64_t	guiCullMicroSec;	// R_AddInGameGuis culling
+	uint64_t	guiEventsMicroSec;	// R_AddInGameGuis time events run in jobs
+	uint64_t	guiRedrawMicroSec;	// R_AddInGameGuis gui redraws
+	uint64_t	viewFloodBuildMicroSec;	// building the cached portal trees
+	uint64_t	viewFloodReplayMicroSec;	// re-clipping the cached portal trees against the views
+	uint64_t	entityCullMicroSec;	// R_CullViewEntities packing and culling
 	uint64_t	frontEndMicroSec;	// sum of time in all RE_RenderScene's in a frame
 };
 
@@ -35,6 +35,9 @@ If you have questions concerning this license or the applicable additional terms
 #include <sys/DeviceManager.h>
 extern DeviceManager* deviceManager;
 
+idCVar r_useParallelGenerateInteractions( "r_useParallelGenerateInteractions", "1", CVAR_RENDERER | CVAR_BOOL, "create the static interactions of each light in parallel with jobs at level load" );
+idCVar r_showInteractionLoadTime( "r_showInteractionLoadTime", "0", CVAR_RENDERER | CVAR_BOOL, "print a breakdown of the time spent in GenerateAllInteractions" );
+
 /*
 ===================
 R_ListRenderLightDefs_f
@@ -156,9 +159,9 @@ idRenderWorldLocal::idRenderWorldLocal()
 	doublePortals = NULL;
 	numInterAreaPortals = 0;
 
-	interactionTable = 0;
-	interactionTableWidth = 0;
-	interactionTableHeight = 0;
+	referenceVersion = 0;
+
+	ClearViewFloodCaches();
 
 	for( int i = 0; i < decals.Num(); i++ )
 	{
@@ -201,37 +204,6 @@ idRenderWorldLocal::~idRenderWorldLocal()
 	RB_ClearDebugText( 0 );
 }
 
-/*
-===================
-ResizeInteractionTable
-===================
-*/
-void idRenderWorldLocal::ResizeInteractionTable()
-{
-	// we overflowed the interaction table, so make it larger
-	common->Printf( "idRenderWorldLocal::ResizeInteractionTable: overflowed interactionTable, resizing\n" );
-
-	const int oldInteractionTableWidth = interactionTableWidth;
-	const int oldIinteractionTableHeight = interactionTableHeight;
-	idInteraction** oldInteractionTable = interactionTable;
-
-	// build the interaction table
-	// this will be dynamically resized if the entity / light counts grow too much
-	interactionTableWidth = entityDefs.Num() + 100;
-	interactionTableHeight = lightDefs.Num() + 100;
-	const int	size =  interactionTableWidth * interactionTableHeight * sizeof( *interactionTable );
-	interactionTable = ( idInteraction** )R_ClearedStaticAlloc( size );
-	for( int l = 0; l < oldIinteractionTableHeight; l++ )
-	{
-		for( int e = 0; e < oldInteractionTableWidth; e++ )
-		{
-			interactionTable[ l * interactionTableWidth + e ] = oldInteractionTable[ l * oldInteractionTableWidth + e ];
-		}
-	}
-
-	R_StaticFree( oldInteractionTable );
-}
-
 /*
 ===================
 AddEntityDef
@@ -244,11 +216,6 @@ qhandle_t idRenderWorldLocal::AddEntityDef( const renderEntity_t* re )
 	if( entityHandle == -1 )
 	{
 		entityHandle = entityDefs.Append( NULL );
-
-		if( interactionTable && entityDefs.Num() > interactionTableWidth )
-		{
-			ResizeInteractionTable();
-		}
 	}
 
 	UpdateEntityDef( entityHandle, re );
@@ -345,6 +312,7 @@ void idRenderWorldLocal::UpdateEntityDef( qhandle_t entityHandle, const renderEn
 
 		def->world = this;
 		def->index = entityHandle;
+		def->referenceVersion = ++referenceVersion;
 	}
 
 	def->parms = *re;
@@ -446,10 +414,6 @@ qhandle_t idRenderWorldLocal::AddLightDef( const renderLight_t* rlight )
 	if( lightHandle == -1 )
 	{
 		lightHandle = lightDefs.Append( NULL );
-		if( interactionTable && lightDefs.Num() > interactionTableHeight )
-		{
-			ResizeInteractionTable();
-		}
 	}
 	UpdateLightDef( lightHandle, rlight );
 
@@ -1641,6 +1605,14 @@ bool idRenderWorldLocal::Trace( modelTrace_t& trace, const idVec3& start, const
 				continue;
 			}
 
+			// area models are traced through their BVH instead of culling every surface
+			const areaTraceBVH_t* bvh = AreaTraceBVH( areas[i], def, radius );
+			if( bvh != NULL )
+			{
+				TraceAreaBVH( trace, traceBounds, bvh, def, start, end, skipPlayer );
+				continue;
+			}
+
 			// check all model surfaces
 			for( int j = 0; j < model->NumSurfaces(); j++ )
 			{
@@ -1826,6 +1798,13 @@ void idRenderWorldLocal::AddEntityRefToArea( idRenderEntityLocal* def, portalAre
 		}
 	}
 
+	// an entity that is relinked to an area it was just unlinked from is not new
+	// to the lights of the area, their cached casters only need to re-test it
+	if( area->unlinkedReferenceVersion != def->referenceVersion )
+	{
+		area->entityAddVersion = ++referenceVersion;
+	}
+
 	ref = areaReferenceAllocator.Alloc();
 
 	tr.pc.c_entityReferences++;
@@ -1905,12 +1884,39 @@ void idRenderWorldLocal::AddEnvprobeRefToArea( RenderEnvprobeLocal* probe, porta
 }
 // RB end
 
+/*
+===================
+R_GenerateStaticLightInteractions
+
+Job that creates the light tris of all new interactions of a single light.
+===================
+*/
+struct staticLightInteractions_t
+{
+	idInteraction** 	interactions;
+	srfTriangles_t*** 	lightTris;
+	int					numInteractions;
+};
+
+static void R_GenerateStaticLightInteractions( staticLightInteractions_t* parms )
+{
+	for( int i = 0; i < parms->numInteractions; i++ )
+	{
+		parms->lightTris[i] = parms->interactions[i]->GenerateStaticLightTris();
+	}
+}
+
+REGISTER_PARALLEL_JOB( R_GenerateStaticLightInteractions, "R_GenerateStaticLightInteractions" );
+
 /*
 ===================
 idRenderWorldLocal::GenerateAllInteractions
 
 Force the generation of all light / surface interactions at the start of a level
 If this isn't called, they will all be dynamically generated
+
+The interactions are linked serially, the light tris of each light are created
+in parallel jobs and the index buffer uploads are batched afterwards.
 ===================
 */
 void idRenderWorldLocal::GenerateAllInteractions()
@@ -1929,16 +1935,16 @@ void idRenderWorldLocal::GenerateAllInteractions()
 	tr.viewDef = NULL;
 
 	// build the interaction table
-	// this will be dynamically resized if the entity / light counts grow too much
-	interactionTableWidth = entityDefs.Num() + 100;
-	interactionTableHeight = lightDefs.Num() + 100;
-	int	size =  interactionTableWidth * interactionTableHeight * sizeof( *interactionTable );
-	interactionTable = ( idInteraction** )R_ClearedStaticAlloc( size );
+	// rows are added on demand if lightDefs are created later
+	interactionTable.Init( lightDefs.Num() );
 
-	tr.commandList->open();
+	//-------------------------------------------------
+	// link an interaction for every light / entity pair that shares an area
+	//-------------------------------------------------
+
+	idList<idInteraction*> interactions;
+	idList<staticLightInteractions_t> lightJobs;
 
-	// iterate through all lights
-	int	count = 0;
 	for( int i = 0; i < this->lightDefs.Num(); i++ )
 	{
 		idRenderLightLocal*	ldef = this->lightDefs[i];
@@ -1947,6 +1953,8 @@ void idRenderWorldLocal::GenerateAllInteractions()
 			continue;
 		}
 
+		const int firstInteraction = interactions.Num();
+
 		// check all areas the light touches
 		for( areaReference_t* lref = ldef->references; lref; lref = lref->ownerNext )
 		{
@@ -1957,49 +1965,118 @@ void idRenderWorldLocal::GenerateAllInteractions()
 			{
 				idRenderEntityLocal* 	edef = eref->entity;
 
-				// scan the doubly linked lists, which may have several dozen entries
-				idInteraction*	inter;
-
-				// we could check either model refs or light refs for matches, but it is
-				// assumed that there will be less lights in an area than models
-				// so the entity chains should be somewhat shorter (they tend to be fairly close).
-				for( inter = edef->firstInteraction; inter != NULL; inter = inter->entityNext )
-				{
-					if( inter->lightDef == ldef )
-					{
-						break;
-					}
-				}
-
 				// if we already have an interaction, we don't need to do anything
-				if( inter != NULL )
+				if( interactionTable.Get( ldef->index, edef->index ) != NULL )
 				{
 					continue;
 				}
 
 				// make an interaction for this light / entity pair
 				// and add a pointer to it in the table
-				inter = idInteraction::AllocAndLink( edef, ldef );
-				count++;
+				interactions.Append( idInteraction::AllocAndLink( edef, ldef ) );
+			}
+		}
 
-				// the interaction may create geometry
-				inter->CreateStaticInteraction( tr.commandList );
+		const int numInteractions = interactions.Num() - firstInteraction;
+		if( numInteractions > 0 )
+		{
+			// the pointers are set once all interactions are gathered and the lists don't move anymore
+			staticLightInteractions_t job;
+			job.interactions = NULL;
+			job.lightTris = NULL;
+			job.numInteractions = numInteractions;
+			lightJobs.Append( job );
+		}
+	}
+
+	const int count = interactions.Num();
+
+	idList<srfTriangles_t**> lightTris;
+	lightTris.SetNum( count );
+
+	int first = 0;
+	for( int i = 0; i < lightJobs.Num(); i++ )
+	{
+		lightJobs[i].interactions = interactions.Ptr() + first;
+		lightJobs[i].lightTris = lightTris.Ptr() + first;
+		first += lightJobs[i].numInteractions;
+	}
+
+	session->Pump();
+
+	const int linkEnd = Sys_Milliseconds();
+
+	//-------------------------------------------------
+	// cull the surfaces and create the light tris, possibly in parallel
+	//-------------------------------------------------
+
+	if( r_useParallelGenerateInteractions.GetBool() )
+	{
+		// keep each submission below the size of the job list
+		const int MAX_LIGHT_JOBS = 1024;
+		for( int i = 0; i < lightJobs.Num(); i += MAX_LIGHT_JOBS )
+		{
+			const int end = Min( i + MAX_LIGHT_JOBS, lightJobs.Num() );
+			for( int j = i; j < end; j++ )
+			{
+				tr.frontEndJobList->AddJob( ( jobRun_t )R_GenerateStaticLightInteractions, &lightJobs[j] );
 			}
+			tr.frontEndJobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+			tr.frontEndJobList->Wait();
+
+			session->Pump();
+		}
+	}
+	else
+	{
+		for( int i = 0; i < lightJobs.Num(); i++ )
+		{
+			R_GenerateStaticLightInteractions( &lightJobs[i] );
+		}
+	}
+
+	const int generateEnd = Sys_Milliseconds();
+
+	//-------------------------------------------------
+	// upload the light tris indexes in one batch
+	//-------------------------------------------------
+
+	tr.commandList->open();
+
+	int numEmpty = 0;
+	for( int i = 0; i < count; i++ )
+	{
+		if( lightTris[i] == NULL )
+		{
+			numEmpty++;
 		}
 
-		session->Pump();
+		// the interaction may create geometry
+		interactions[i]->FinishStaticInteraction( lightTris[i], tr.commandList );
 	}
 
 	tr.commandList->close();
+
+	const int uploadEnd = Sys_Milliseconds();
+
 	deviceManager->GetDevice()->executeCommandList( tr.commandList );
 
 	int end = Sys_Milliseconds();
 	int	msec = end - start;
 
 	common->Printf( "idRenderWorld::GenerateAllInteractions, msec = %i\n", msec );
-	common->Printf( "interactionTable size: %i bytes\n", size );
+	common->Printf( "interactionTable size: %i bytes (dense table would take %i bytes)\n", ( int )interactionTable.Allocated(), ( int )idInteractionTable::DenseSize( lightDefs.Num(), entityDefs.Num() ) );
 	common->Printf( "%i interactions take %i bytes\n", count, count * sizeof( idInteraction ) );
 
+	if( r_showInteractionLoadTime.GetBool() )
+	{
+		common->Printf( "%5i lights, %6i interactions, %6i empty\n", lightJobs.Num(), count, numEmpty );
+		common->Printf( "%5i msec link\n", linkEnd - start );
+		common->Printf( "%5i msec generate light tris (%s)\n", generateEnd - linkEnd, r_useParallelGenerateInteractions.GetBool() ? "parallel" : "serial" );
+		common->Printf( "%5i msec upload\n", uploadEnd - generateEnd );
+		common->Printf( "%5i msec execute command list\n", end - uploadEnd );
+	}
+
 	// entities flagged as noDynamicInteractions will no longer make any
 	generateAllInteractionsCalled = true;
 }
@@ -446,6 +446,10 @@ public:
 	// Traces vs the world model bsp tree.
 	virtual bool			FastWorldTrace( modelTrace_t& trace, const idVec3& start, const idVec3& end ) const = 0;
 
+	// Traces a batch of rays vs the whole rendered world, with the same results as calling Trace for each
+	// of them, and returns the number of rays that hit something.
+	virtual int				TraceBatch( modelTrace_t* traces, const idVec3* starts, const idVec3* ends, const int numTraces, const float radius, bool skipDynamic = true, bool skipPlayer = false ) const = 0;
+
 	//-------------- Demo Control  -----------------
 
 	// this is used to regenerate all interactions ( which is currently only done during influences ), there may be a less
@@ -93,12 +93,17 @@ void R_FreeEntityDefDerivedData( idRenderEntityLocal* def, bool keepDecals, bool
 		def->cachedDynamicModel = NULL;
 	}
 
+	// the cached light casters re-test the entity when they see the new version
+	def->referenceVersion = ++def->world->referenceVersion;
+
 	// free the entityRefs from the areas
 	areaReference_t* next = NULL;
 	for( areaReference_t* ref = def->entityRefs; ref != NULL; ref = next )
 	{
 		next = ref->ownerNext;
 
+		ref->area->unlinkedReferenceVersion = def->referenceVersion;
+
 		// unlink from the area
 		ref->areaNext->areaPrev = ref->areaPrev;
 		ref->areaPrev->areaNext = ref->areaNext;
@@ -503,6 +508,8 @@ void R_FreeLightDefDerivedData( idRenderLightLocal* ldef )
 		ldef->world->areaReferenceAllocator.Free( lref );
 	}
 	ldef->references = NULL;
+
+	ldef->casterCacheVersion = 0;
 }
 
 // RB begin
@@ -80,6 +80,9 @@ void idRenderWorldLocal::FreeWorld()
 		areaScreenRect = NULL;
 	}
 
+	ClearViewFloodCaches();
+	FreeAreaTraceBVHs();
+
 	if( doublePortals )
 	{
 		R_StaticFree( doublePortals );
@@ -436,6 +439,9 @@ void idRenderWorldLocal::SetupAreaRefs()
 
 		portalAreas[i].envprobeRefs.areaNext =
 			portalAreas[i].envprobeRefs.areaPrev = &portalAreas[i].envprobeRefs;
+
+		portalAreas[i].entityAddVersion = ++referenceVersion;
+		portalAreas[i].unlinkedReferenceVersion = 0;
 	}
 }
 
@@ -768,11 +774,7 @@ void idRenderWorldLocal::FreeDefs()
 {
 	generateAllInteractionsCalled = false;
 
-	if( interactionTable )
-	{
-		R_StaticFree( interactionTable );
-		interactionTable = NULL;
-	}
+	interactionTable.Shutdown();
 
 	// free all lightDefs
 	for( int i = 0; i < lightDefs.Num(); i++ )
@@ -1151,6 +1153,8 @@ void idRenderWorldLocal::AddWorldModelEntities()
 		// RB: remember BSP area AABB for quick lookup later
 		area->globalBounds = def->globalReferenceBounds;
 	}
+
+	BuildAreaTraceBVHs();
 }
 
 /*
@@ -126,6 +126,9 @@ typedef struct portalArea_s
 	areaReference_t	entityRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	lightRefs;		// head/tail of doubly linked list, may change
 	areaReference_t	envprobeRefs;	// head/tail of doubly linked list, may change
+
+	uint64_t		entityAddVersion;			// world referenceVersion when an entity was last added
+	uint64_t		unlinkedReferenceVersion;	// referenceVersion of the entity last unlinked from the area
 } portalArea_t;
 
 
@@ -205,6 +208,7 @@ public:
 	virtual bool			ModelTrace( modelTrace_t& trace, qhandle_t entityHandle, const idVec3& start, const idVec3& end, const float radius ) const;
 	virtual bool			Trace( modelTrace_t& trace, const idVec3& start, const idVec3& end, const float radius, bool skipDynamic = true, bool skipPlayer = false ) const;
 	virtual bool			FastWorldTrace( modelTrace_t& trace, const idVec3& start, const idVec3& end ) const;
+	virtual int				TraceBatch( modelTrace_t* traces, const idVec3* starts, const idVec3* ends, const int numTraces, const float radius, bool skipDynamic = true, bool skipPlayer = false ) const;
 
 	virtual void			DebugClearLines( int time );
 	virtual void			DebugLine( const idVec4& color, const idVec3& start, const idVec3& end, const int lifetime = 0, const bool depthTest = false );
@@ -234,6 +238,7 @@ public:
 	portalArea_t* 			portalAreas;
 	int						numPortalAreas;
 	int						connectedAreaNum;		// incremented every time a door portal state changes
+	uint64_t				referenceVersion;		// incremented for entity reference changes, see lightCaster_t
 
 	idScreenRect* 			areaScreenRect;
 
@@ -258,13 +263,9 @@ public:
 	idArray<reusableOverlay_t, MAX_DECAL_SURFACES>	overlays;
 
 	// all light / entity interactions are referenced here for fast lookup without
-	// having to crawl the doubly linked lists.  EnntityDefs are sequential for better
-	// cache access, because the table is accessed by light in idRenderWorldLocal::CreateLightDefInteractions()
-	// Growing this table is time consuming, so we add a pad value to the number
-	// of entityDefs and lightDefs
-	idInteraction** 		interactionTable;
-	int						interactionTableWidth;		// entityDefs
-	int						interactionTableHeight;		// lightDefs
+	// having to crawl the doubly linked lists.  The index is sparse and grouped by
+	// lightDef, because it is accessed by light in R_AddSingleLight()
+	idInteractionTable		interactionTable;
 
 	bool					generateAllInteractionsCalled;
 
@@ -288,6 +289,52 @@ public:
 	idRenderModel* 			ReadBinaryModel( idFile* file );
 	idRenderModel* 			ReadBinaryShadowModel( idFile* file );
 
+	//--------------------------
+	// RenderWorld_trace.cpp
+
+	// four wide bounding volume hierarchy over the triangles of an area model,
+	// so Trace doesn't have to cull every vertex of every world surface in the
+	// areas a ray touches
+	static const int TRACE_BVH_LEAF_TRIS = 4;
+
+	struct traceBVHNode_t
+	{
+		float					mins[3][4];			// x, y and z of the four child bounds
+		float					maxs[3][4];
+		int						children[4];		// node number, or first triangle for leaves
+		int						numTris[4];			// 0 for inner nodes
+		int						numChildren;
+	};
+
+	struct traceBVHTri_t
+	{
+		int						surfaceNum;
+		int						firstIndex;
+	};
+
+	struct traceBVHSurface_t
+	{
+		const srfTriangles_t* 	geometry;
+		const idMaterial* 		shader;
+		bool					playerExcluded;		// in playerMaterialExcludeList
+	};
+
+	struct areaTraceBVH_t
+	{
+		const idRenderModel* 	model;
+		idList<traceBVHNode_t, TAG_RENDER>		nodes;
+		idList<traceBVHTri_t, TAG_RENDER>		tris;
+		idList<traceBVHSurface_t, TAG_RENDER>	surfaces;
+	};
+
+	idList<areaTraceBVH_t*, TAG_RENDER>	areaTraceBVHs;	// indexed by area, NULL if the area model can't use one
+
+	void					BuildAreaTraceBVHs();
+	void					FreeAreaTraceBVHs();
+	const areaTraceBVH_t* 	AreaTraceBVH( int areaNum, const idRenderEntityLocal* def, const float radius ) const;
+	void					TraceAreaBVH( modelTrace_t& trace, idBounds& traceBounds, const areaTraceBVH_t* bvh, const idRenderEntityLocal* def,
+										  const idVec3& start, const idVec3& end, bool skipPlayer ) const;
+
 	//--------------------------
 	// RenderWorld_portals.cpp
 
@@ -305,6 +352,38 @@ public:
 		idScreenRect			rect;
 	};
 
+	// the portals a recent view origin can see through with an unbounded frustum, a
+	// following view from the same origin only re-clips the cached portal windings
+	// against its own frustum instead of searching every portal of the flooded areas
+	static const int MAX_VIEW_FLOOD_CACHES = 4;
+	static const int MAX_VIEW_FLOOD_NODES = 16384;
+
+	struct viewFloodCache_t
+	{
+		struct floodNode_t
+		{
+			const portal_t* 	p;
+			int					numNodes;			// size of the subtree including this node
+		};
+
+		bool					valid;
+		bool					complete;			// false if the tree hit MAX_VIEW_FLOOD_NODES, the views flood normally then
+		int						lastUsedFrame;
+		int						areaNum;
+		int						connectedAreaNum;
+		idVec3					origin;
+
+		idList<floodNode_t, TAG_RENDER>	nodes;		// depth first
+	};
+
+	viewFloodCache_t		viewFloodCaches[MAX_VIEW_FLOOD_CACHES];
+
+	bool					ViewFloodCacheMatches( const viewFloodCache_t& cache, const idVec3& origin ) const;
+	bool					BuildViewFloodTree_r( viewFloodCache_t& cache, const idVec3& origin, int areaNum, const portalStack_t* ps );
+	void					ReplayViewFlood_r( const viewFloodCache_t& cache, const idVec3& origin, int areaNum, const portalStack_t* ps, int firstNode, int endNode );
+	void					FlowViewThroughPortalsCached( const idVec3& origin, int numPlanes, const idPlane* planes );
+	void					ClearViewFloodCaches();
+
 	bool					CullEntityByPortals( const idRenderEntityLocal* entity, const portalStack_t* ps );
 	void					AddAreaViewEntities( int areaNum, const portalStack_t* ps );
 
@@ -319,6 +398,7 @@ public:
 	void					AddAreaToView( int areaNum, const portalStack_t* ps );
 	idScreenRect			ScreenRectFromWinding( const idWinding* w, const viewEntity_t* space );
 	bool					PortalIsFoggedOut( const portal_t* p );
+	bool					PortalStackThroughPortal( const idVec3& origin, const portal_t* p, const portalStack_t* ps, portalStack_t& newStack, bool checkFog );
 	void					FloodViewThroughArea_r( const idVec3& origin, int areaNum, const portalStack_t* ps );
 	void					FlowViewThroughPortals( const idVec3& origin, int numPlanes, const idPlane* planes );
 	void					BuildConnectedAreas_r( int areaNum );
@@ -343,8 +423,6 @@ public:
 	//--------------------------
 	// RenderWorld.cpp
 
-	void					ResizeInteractionTable();
-
 	void					AddEntityRefToArea( idRenderEntityLocal* def, portalArea_t* area );
 	void					AddLightRefToArea( idRenderLightLocal* light, portalArea_t* area );
 	void					AddEnvprobeRefToArea( RenderEnvprobeLocal* probe, portalArea_t* area ); // RB
@@ -32,6 +32,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "RenderCommon.h"
 
+idCVar r_useViewFloodCache( "r_useViewFloodCache", "1", CVAR_RENDERER | CVAR_BOOL, "reuse the portal tree of a recent view origin while the origin and the portal states don't change" );
+idCVar r_viewFloodCacheMoveThreshold( "r_viewFloodCacheMoveThreshold", "0", CVAR_RENDERER | CVAR_FLOAT, "distance the view origin may move and still reuse a cached portal tree, above 0 may miss portals that only come into view after the move" );
+
 // if we hit this many planes, we will just stop cropping the
 // view down, which is still correct, just conservative
 const int MAX_PORTAL_PLANES	= 20;
@@ -465,11 +468,8 @@ bool idRenderWorldLocal::PortalIsFoggedOut( const portal_t* p )
 
 	// find the current density of the fog
 	const idMaterial* lightShader = ldef->lightShader;
-	const int size = lightShader->GetNumRegisters() * sizeof( float );
-	float* regs = ( float* )_alloca( size );
-
-	lightShader->EvaluateRegisters( regs, ldef->parms.shaderParms,
-									tr.viewDef->renderView.shaderParms, tr.viewDef->renderView.time[0] * 0.001f, ldef->parms.referenceSound );
+	const float* regs = lightShader->EvaluateFrameRegisters( ldef->parms.shaderParms,
+						tr.viewDef->renderView.shaderParms, tr.viewDef->renderView.time[0] * 0.001f, ldef->parms.referenceSound );
 
 	const shaderStage_t*	stage = lightShader->GetStage( 0 );
 
@@ -536,13 +536,6 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3& origin, int areaN
 			continue;
 		}
 
-		// make sure this portal is facing away from the view
-		const float d = p->plane.Distance( origin );
-		if( d < -0.1f )
-		{
-			continue;
-		}
-
 		// make sure the portal isn't in our stack trace,
 		// which would cause an infinite loop
 		const portalStack_t* check = ps;
@@ -558,92 +551,114 @@ void idRenderWorldLocal::FloodViewThroughArea_r( const idVec3& origin, int areaN
 			continue;	// already in stack
 		}
 
-		// if we are very close to the portal surface, don't bother clipping
-		// it, which tends to give epsilon problems that make the area vanish
-		if( d < 1.0f )
+		// go through this portal
+		portalStack_t newStack;
+		if( !PortalStackThroughPortal( origin, p, ps, newStack, true ) )
 		{
-
-			// go through this portal
-			portalStack_t newStack;
-			newStack = *ps;
-			newStack.p = p;
-			newStack.next = ps;
-			FloodViewThroughArea_r( origin, p->intoArea, &newStack );
 			continue;
 		}
 
-		// clip the portal winding to all of the planes
-		idFixedWinding w;		// we won't overflow because MAX_PORTAL_PLANES = 20
-		w = *p->w;
-		for( int j = 0; j < ps->numPortalPlanes; j++ )
-		{
-			if( !w.ClipInPlace( -ps->portalPlanes[j], 0 ) )
-			{
-				break;
-			}
-		}
-		if( !w.GetNumPoints() )
-		{
-			continue;	// portal not visible
-		}
+		FloodViewThroughArea_r( origin, p->intoArea, &newStack );
+	}
+}
 
-		// see if it is fogged out
-		if( PortalIsFoggedOut( p ) )
-		{
-			continue;
-		}
+/*
+===================
+idRenderWorldLocal::PortalStackThroughPortal
 
-		// go through this portal
-		portalStack_t newStack;
+Sets up newStack for the view through portal p as seen through ps.
+Returns false if the portal faces the view, is clipped away by the
+planes of ps or, with checkFog, is fogged out.
+===================
+*/
+bool idRenderWorldLocal::PortalStackThroughPortal( const idVec3& origin, const portal_t* p, const portalStack_t* ps, portalStack_t& newStack, bool checkFog )
+{
+	// make sure this portal is facing away from the view
+	const float d = p->plane.Distance( origin );
+	if( d < -0.1f )
+	{
+		return false;
+	}
+
+	// if we are very close to the portal surface, don't bother clipping
+	// it, which tends to give epsilon problems that make the area vanish
+	if( d < 1.0f )
+	{
+		newStack = *ps;
 		newStack.p = p;
 		newStack.next = ps;
+		return true;
+	}
 
-		// find the screen pixel bounding box of the remaining portal
-		// so we can scissor things outside it
-		newStack.rect = ScreenRectFromWinding( &w, &tr.identitySpace );
+	// clip the portal winding to all of the planes
+	idFixedWinding w;		// we won't overflow because MAX_PORTAL_PLANES = 20
+	w = *p->w;
+	for( int j = 0; j < ps->numPortalPlanes; j++ )
+	{
+		if( !w.ClipInPlace( -ps->portalPlanes[j], 0 ) )
+		{
+			break;
+		}
+	}
+	if( !w.GetNumPoints() )
+	{
+		return false;	// portal not visible
+	}
 
-		// slop might have spread it a pixel outside, so trim it back
-		newStack.rect.Intersect( ps->rect );
+	// see if it is fogged out
+	if( checkFog && PortalIsFoggedOut( p ) )
+	{
+		return false;
+	}
 
-		// generate a set of clipping planes that will further restrict
-		// the visible view beyond just the scissor rect
+	newStack.p = p;
+	newStack.next = ps;
 
-		int addPlanes = w.GetNumPoints();
-		if( addPlanes > MAX_PORTAL_PLANES )
-		{
-			addPlanes = MAX_PORTAL_PLANES;
-		}
+	// find the screen pixel bounding box of the remaining portal
+	// so we can scissor things outside it
+	newStack.rect = ScreenRectFromWinding( &w, &tr.identitySpace );
 
-		newStack.numPortalPlanes = 0;
-		for( int i = 0; i < addPlanes; i++ )
-		{
-			int j = i + 1;
-			if( j == w.GetNumPoints() )
-			{
-				j = 0;
-			}
+	// slop might have spread it a pixel outside, so trim it back
+	newStack.rect.Intersect( ps->rect );
 
-			const idVec3& v1 = origin - w[i].ToVec3();
-			const idVec3& v2 = origin - w[j].ToVec3();
+	// generate a set of clipping planes that will further restrict
+	// the visible view beyond just the scissor rect
 
-			newStack.portalPlanes[newStack.numPortalPlanes].Normal().Cross( v2, v1 );
+	int addPlanes = w.GetNumPoints();
+	if( addPlanes > MAX_PORTAL_PLANES )
+	{
+		addPlanes = MAX_PORTAL_PLANES;
+	}
 
-			// if it is degenerate, skip the plane
-			if( newStack.portalPlanes[newStack.numPortalPlanes].Normalize() < 0.01f )
-			{
-				continue;
-			}
-			newStack.portalPlanes[newStack.numPortalPlanes].FitThroughPoint( origin );
+	newStack.numPortalPlanes = 0;
+	for( int i = 0; i < addPlanes; i++ )
+	{
+		int j = i + 1;
+		if( j == w.GetNumPoints() )
+		{
+			j = 0;
+		}
 
-			newStack.numPortalPlanes++;
+		const idVec3& v1 = origin - w[i].ToVec3();
+		const idVec3& v2 = origin - w[j].ToVec3();
+
+		newStack.portalPlanes[newStack.numPortalPlanes].Normal().Cross( v2, v1 );
+
+		// if it is degenerate, skip the plane
+		if( newStack.portalPlanes[newStack.numPortalPlanes].Normalize() < 0.01f )
+		{
+			continue;
 		}
+		newStack.portalPlanes[newStack.numPortalPlanes].FitThroughPoint( origin );
 
-		// the last stack plane is the portal plane
-		newStack.portalPlanes[newStack.numPortalPlanes] = p->plane;
 		newStack.numPortalPlanes++;
-
-		FloodViewThroughArea_r( origin, p->intoArea, &newStack );
 	}
+
+	// the last stack plane is the portal plane
+	newStack.portalPlanes[newStack.numPortalPlanes] = p->plane;
+	newStack.numPortalPlanes++;
+
+	return true;
 }
 
 /*
@@ -686,6 +701,230 @@ void idRenderWorldLocal::FlowViewThroughPortals( const idVec3& origin, int numPl
 	}
 }
 
+/*
+=======================
+idRenderWorldLocal::ViewFloodCacheMatches
+=======================
+*/
+bool idRenderWorldLocal::ViewFloodCacheMatches( const viewFloodCache_t& cache, const idVec3& origin ) const
+{
+	if( !cache.valid )
+	{
+		return false;
+	}
+
+	// the view crossed into another area or a door opened or closed
+	if( cache.areaNum != tr.viewDef->areaNum || cache.connectedAreaNum != connectedAreaNum )
+	{
+		return false;
+	}
+
+	const float moveThreshold = r_viewFloodCacheMoveThreshold.GetFloat();
+	if( moveThreshold > 0.0f )
+	{
+		return ( ( cache.origin - origin ).LengthSqr() <= Square( moveThreshold ) );
+	}
+	return cache.origin.Compare( origin );
+}
+
+/*
+=======================
+idRenderWorldLocal::BuildViewFloodTree_r
+
+Records every portal chain the origin can see through without any view frustum,
+the same chains a full flood would follow for any view direction. Fogged portals
+are kept, they are tested when the tree is replayed. Returns false if the tree
+doesn't fit in MAX_VIEW_FLOOD_NODES.
+=======================
+*/
+bool idRenderWorldLocal::BuildViewFloodTree_r( viewFloodCache_t& cache, const idVec3& origin, int areaNum, const portalStack_t* ps )
+{
+	for( const portal_t* p = portalAreas[areaNum].portals; p != NULL; p = p->next )
+	{
+		if( p->doublePortal->blockingBits & PS_BLOCK_VIEW )
+		{
+			continue;
+		}
+
+		const portalStack_t* check = ps;
+		for( ; check != NULL; check = check->next )
+		{
+			if( check->p == p )
+			{
+				break;
+			}
+		}
+		if( check )
+		{
+			continue;
+		}
+
+		portalStack_t newStack;
+		if( !PortalStackThroughPortal( origin, p, ps, newStack, false ) )
+		{
+			continue;
+		}
+
+		if( cache.nodes.Num() >= MAX_VIEW_FLOOD_NODES )
+		{
+			return false;
+		}
+
+		const int node = cache.nodes.Num();
+		cache.nodes.Alloc().p = p;
+
+		if( !BuildViewFloodTree_r( cache, origin, p->intoArea, &newStack ) )
+		{
+			return false;
+		}
+
+		cache.nodes[node].numNodes = cache.nodes.Num() - node;
+	}
+	return true;
+}
+
+/*
+=======================
+idRenderWorldLocal::ReplayViewFlood_r
+
+Same as FloodViewThroughArea_r, but only follows the portals of the cached tree.
+The portal windings are still clipped against the planes of the current view, so
+for an unchanged origin the result is exactly that of a full flood.
+=======================
+*/
+void idRenderWorldLocal::ReplayViewFlood_r( const viewFloodCache_t& cache, const idVec3& origin, int areaNum, const portalStack_t* ps, int firstNode, int endNode )
+{
+	// cull models and lights to the current collection of planes
+	AddAreaToView( areaNum, ps );
+
+	if( areaScreenRect[areaNum].IsEmpty() )
+	{
+		areaScreenRect[areaNum] = ps->rect;
+	}
+	else
+	{
+		areaScreenRect[areaNum].Union( ps->rect );
+	}
+
+	for( int i = firstNode; i < endNode; i += cache.nodes[i].numNodes )
+	{
+		const portal_t* p = cache.nodes[i].p;
+
+		portalStack_t newStack;
+		if( !PortalStackThroughPortal( origin, p, ps, newStack, true ) )
+		{
+			continue;
+		}
+
+		ReplayViewFlood_r( cache, origin, p->intoArea, &newStack, i + 1, i + cache.nodes[i].numNodes );
+	}
+}
+
+/*
+=======================
+idRenderWorldLocal::FlowViewThroughPortalsCached
+
+Floods the view through the cached portal tree of its origin, building the tree
+first if no recent view had the same origin and portal states. Only the portals
+the origin can see through at all are clipped against the view, the portals that
+face the origin or are hidden behind others in every direction are skipped.
+=======================
+*/
+void idRenderWorldLocal::FlowViewThroughPortalsCached( const idVec3& origin, int numPlanes, const idPlane* planes )
+{
+	if( !r_useViewFloodCache.GetBool() || tr.viewDef->areaNum < 0 )
+	{
+		FlowViewThroughPortals( origin, numPlanes, planes );
+		return;
+	}
+
+	portalStack_t ps;
+	ps.next = NULL;
+	ps.p = NULL;
+	ps.numPortalPlanes = 0;
+	ps.rect = tr.viewDef->scissor;
+
+	viewFloodCache_t* cache = NULL;
+	for( int i = 0; i < MAX_VIEW_FLOOD_CACHES; i++ )
+	{
+		if( ViewFloodCacheMatches( viewFloodCaches[i], origin ) )
+		{
+			cache = &viewFloodCaches[i];
+			break;
+		}
+	}
+
+	if( cache != NULL )
+	{
+		tr.pc.c_viewFloodCacheHits++;
+	}
+	else
+	{
+		// build into the least recently used slot
+		cache = &viewFloodCaches[0];
+		for( int i = 1; i < MAX_VIEW_FLOOD_CACHES && cache->valid; i++ )
+		{
+			if( !viewFloodCaches[i].valid || viewFloodCaches[i].lastUsedFrame < cache->lastUsedFrame )
+			{
+				cache = &viewFloodCaches[i];
+			}
+		}
+
+		const uint64_t start = Sys_Microseconds();
+
+		cache->valid = true;
+		cache->areaNum = tr.viewDef->areaNum;
+		cache->connectedAreaNum = connectedAreaNum;
+		cache->origin = origin;
+		cache->nodes.SetNum( 0 );
+		cache->complete = BuildViewFloodTree_r( *cache, origin, tr.viewDef->areaNum, &ps );
+		if( !cache->complete )
+		{
+			cache->nodes.Clear();
+		}
+
+		tr.pc.viewFloodBuildMicroSec += Sys_Microseconds() - start;
+		tr.pc.c_viewFloodCacheMisses++;
+	}
+
+	cache->lastUsedFrame = tr.frameCount;
+
+	if( !cache->complete )
+	{
+		FlowViewThroughPortals( origin, numPlanes, planes );
+		return;
+	}
+
+	const uint64_t start = Sys_Microseconds();
+
+	assert( numPlanes <= MAX_PORTAL_PLANES );
+	for( int i = 0; i < numPlanes; i++ )
+	{
+		ps.portalPlanes[i] = planes[i];
+	}
+	ps.numPortalPlanes = numPlanes;
+
+	ReplayViewFlood_r( *cache, origin, tr.viewDef->areaNum, &ps, 0, cache->nodes.Num() );
+
+	tr.pc.viewFloodReplayMicroSec += Sys_Microseconds() - start;
+}
+
+/*
+=======================
+idRenderWorldLocal::ClearViewFloodCaches
+=======================
+*/
+void idRenderWorldLocal::ClearViewFloodCaches()
+{
+	for( int i = 0; i < MAX_VIEW_FLOOD_CACHES; i++ )
+	{
+		viewFloodCaches[i].valid = false;
+		viewFloodCaches[i].complete = false;
+		viewFloodCaches[i].lastUsedFrame = 0;
+		viewFloodCaches[i].nodes.Clear();
+	}
+}
+
 /*
 ===================
 idRenderWorldLocal::BuildConnectedAreas_r
@@ -817,7 +1056,7 @@ void idRenderWorldLocal::FindViewLightsAndEntities()
 		// note that the center of projection for flowing through portals may
 		// be a different point than initialViewAreaOrigin for subviews that
 		// may have the viewOrigin in a solid/invalid area
-		FlowViewThroughPortals( tr.viewDef->renderView.vieworg, 5, tr.viewDef->frustums[FRUSTUM_PRIMARY] );
+		FlowViewThroughPortalsCached( tr.viewDef->renderView.vieworg, 5, tr.viewDef->frustums[FRUSTUM_PRIMARY] );
 	}
 }
 
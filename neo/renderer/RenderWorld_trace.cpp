@@ -0,0 +1,813 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "RenderCommon.h"
+
+idCVar r_useTraceBVH( "r_useTraceBVH", "1", CVAR_RENDERER | CVAR_BOOL, "trace the area models through their bounding volume hierarchies instead of culling every surface" );
+
+extern const char* playerMaterialExcludeList[];
+
+// the child bounds are expanded by this much so rounding can never cull a triangle
+static const float	TRACE_BVH_EPSILON		= 0.25f;
+// below this depth the triangles are split at the median to bound the tree depth
+static const int	TRACE_BVH_MAX_DEPTH		= 32;
+static const int	TRACE_BVH_STACK_SIZE	= 256;
+// rays per TraceBatch job
+static const int	TRACE_BATCH_JOB_RAYS	= 16;
+
+/*
+===============================================================================
+
+	Area model BVH construction
+
+===============================================================================
+*/
+
+struct traceBVHBuildTri_t
+{
+	idBounds							bounds;
+	idVec3								center;
+	idRenderWorldLocal::traceBVHTri_t	tri;
+};
+
+class idSort_TraceBVHBuildTri : public idSort_Quick< traceBVHBuildTri_t, idSort_TraceBVHBuildTri >
+{
+public:
+	idSort_TraceBVHBuildTri( int axis ) : axis( axis ) {}
+
+	int Compare( const traceBVHBuildTri_t& a, const traceBVHBuildTri_t& b ) const
+	{
+		if( a.center[axis] < b.center[axis] )
+		{
+			return -1;
+		}
+		if( a.center[axis] > b.center[axis] )
+		{
+			return 1;
+		}
+		return 0;
+	}
+
+private:
+	int		axis;
+};
+
+/*
+====================
+R_SplitTraceBVHTris
+
+Splits the triangles at the middle of their centers along the major axis, or at
+the median if that doesn't separate them or the tree is getting too deep.
+Returns the number of triangles in the first half.
+====================
+*/
+static int R_SplitTraceBVHTris( traceBVHBuildTri_t* tris, const int numTris, const int depth )
+{
+	idBounds centers;
+	centers.Clear();
+	for( int i = 0; i < numTris; i++ )
+	{
+		centers.AddPoint( tris[i].center );
+	}
+
+	const idVec3 size = centers[1] - centers[0];
+	const int axis = ( size.x >= size.y && size.x >= size.z ) ? 0 : ( ( size.y >= size.z ) ? 1 : 2 );
+
+	if( depth < TRACE_BVH_MAX_DEPTH )
+	{
+		const float mid = ( centers[0][axis] + centers[1][axis] ) * 0.5f;
+
+		int numFront = 0;
+		for( int i = 0; i < numTris; i++ )
+		{
+			if( tris[i].center[axis] < mid )
+			{
+				SwapValues( tris[i], tris[numFront] );
+				numFront++;
+			}
+		}
+
+		if( numFront > 0 && numFront < numTris )
+		{
+			return numFront;
+		}
+	}
+
+	idSort_TraceBVHBuildTri( axis ).Sort( tris, numTris );
+
+	return numTris / 2;
+}
+
+/*
+====================
+R_BuildTraceBVHNode_r
+
+Splits the triangles in up to four children, children with few
+enough triangles become leaves, the others get their own node.
+====================
+*/
+static int R_BuildTraceBVHNode_r( idRenderWorldLocal::areaTraceBVH_t* bvh, traceBVHBuildTri_t* tris, const int firstTri, const int numTris, const int depth )
+{
+	const int nodeNum = bvh->nodes.Num();
+	bvh->nodes.Alloc();
+
+	int childFirst[4];
+	int childNum[4];
+	int numChildren = 1;
+
+	childFirst[0] = firstTri;
+	childNum[0] = numTris;
+
+	while( numChildren < 4 )
+	{
+		// split the largest child that is too big for a leaf
+		int split = -1;
+		for( int c = 0; c < numChildren; c++ )
+		{
+			if( childNum[c] > idRenderWorldLocal::TRACE_BVH_LEAF_TRIS && ( split == -1 || childNum[c] > childNum[split] ) )
+			{
+				split = c;
+			}
+		}
+		if( split == -1 )
+		{
+			break;
+		}
+
+		const int numFront = R_SplitTraceBVHTris( tris + childFirst[split], childNum[split], depth );
+
+		childFirst[numChildren] = childFirst[split] + numFront;
+		childNum[numChildren] = childNum[split] - numFront;
+		childNum[split] = numFront;
+		numChildren++;
+	}
+
+	// the recursion appends to the node list, so fill in a copy
+	idRenderWorldLocal::traceBVHNode_t node;
+	memset( &node, 0, sizeof( node ) );
+	node.numChildren = numChildren;
+
+	for( int c = 0; c < numChildren; c++ )
+	{
+		idBounds bounds;
+		bounds.Clear();
+		for( int i = childFirst[c]; i < childFirst[c] + childNum[c]; i++ )
+		{
+			bounds.AddBounds( tris[i].bounds );
+		}
+		bounds.ExpandSelf( TRACE_BVH_EPSILON );
+
+		for( int i = 0; i < 3; i++ )
+		{
+			node.mins[i][c] = bounds[0][i];
+			node.maxs[i][c] = bounds[1][i];
+		}
+
+		if( childNum[c] <= idRenderWorldLocal::TRACE_BVH_LEAF_TRIS )
+		{
+			node.children[c] = childFirst[c];
+			node.numTris[c] = childNum[c];
+		}
+		else
+		{
+			node.children[c] = R_BuildTraceBVHNode_r( bvh, tris, childFirst[c], childNum[c], depth + 1 );
+			node.numTris[c] = 0;
+		}
+	}
+
+	bvh->nodes[nodeNum] = node;
+
+	return nodeNum;
+}
+
+/*
+====================
+R_BuildAreaTraceBVH
+
+Returns NULL if the model has no triangles, or if it has surfaces
+R_LocalTrace has to trace through their joints.
+====================
+*/
+static idRenderWorldLocal::areaTraceBVH_t* R_BuildAreaTraceBVH( const idRenderModel* model )
+{
+	idRenderWorldLocal::areaTraceBVH_t* bvh = new( TAG_RENDER ) idRenderWorldLocal::areaTraceBVH_t;
+	bvh->model = model;
+	bvh->surfaces.SetNum( model->NumSurfaces() );
+
+	idList<traceBVHBuildTri_t, TAG_RENDER> buildTris;
+
+	for( int j = 0; j < model->NumSurfaces(); j++ )
+	{
+		const modelSurface_t* surf = model->Surface( j );
+
+		idRenderWorldLocal::traceBVHSurface_t& traceSurf = bvh->surfaces[j];
+		traceSurf.geometry = surf->geometry;
+		traceSurf.shader = surf->shader;
+		traceSurf.playerExcluded = false;
+
+		// if no geometry or no shader
+		if( surf->geometry == NULL || surf->shader == NULL )
+		{
+			continue;
+		}
+
+		const srfTriangles_t* tri = surf->geometry;
+		if( tri->verts == NULL || tri->staticModelWithJoints != NULL )
+		{
+			delete bvh;
+			return NULL;
+		}
+
+		for( int k = 0; playerMaterialExcludeList[k] != NULL; k++ )
+		{
+			if( idStr::Cmp( surf->shader->GetName(), playerMaterialExcludeList[k] ) == 0 )
+			{
+				traceSurf.playerExcluded = true;
+				break;
+			}
+		}
+
+		for( int i = 0; i + 2 < tri->numIndexes; i += 3 )
+		{
+			traceBVHBuildTri_t& buildTri = buildTris.Alloc();
+			buildTri.bounds.Clear();
+			buildTri.bounds.AddPoint( tri->verts[tri->indexes[i + 0]].xyz );
+			buildTri.bounds.AddPoint( tri->verts[tri->indexes[i + 1]].xyz );
+			buildTri.bounds.AddPoint( tri->verts[tri->indexes[i + 2]].xyz );
+			buildTri.center = buildTri.bounds.GetCenter();
+			buildTri.tri.surfaceNum = j;
+			buildTri.tri.firstIndex = i;
+		}
+	}
+
+	if( buildTris.Num() == 0 )
+	{
+		delete bvh;
+		return NULL;
+	}
+
+	R_BuildTraceBVHNode_r( bvh, buildTris.Ptr(), 0, buildTris.Num(), 0 );
+
+	// the leaves reference the triangles in the order the build left them
+	bvh->tris.SetNum( buildTris.Num() );
+	for( int i = 0; i < buildTris.Num(); i++ )
+	{
+		bvh->tris[i] = buildTris[i].tri;
+	}
+
+	return bvh;
+}
+
+struct traceBVHBuildJob_t
+{
+	const idRenderModel* 				model;
+	idRenderWorldLocal::areaTraceBVH_t* bvh;
+};
+
+/*
+====================
+BuildAreaTraceBVHJob
+====================
+*/
+static void BuildAreaTraceBVHJob( traceBVHBuildJob_t* job )
+{
+	job->bvh = R_BuildAreaTraceBVH( job->model );
+}
+
+REGISTER_PARALLEL_JOB( BuildAreaTraceBVHJob, "BuildAreaTraceBVHJob" );
+
+/*
+===================
+idRenderWorldLocal::BuildAreaTraceBVHs
+
+Called after the area model entities have been added.
+===================
+*/
+void idRenderWorldLocal::BuildAreaTraceBVHs()
+{
+	FreeAreaTraceBVHs();
+
+	idList<traceBVHBuildJob_t, TAG_RENDER> jobs;
+	jobs.SetNum( numPortalAreas );
+	for( int i = 0; i < numPortalAreas; i++ )
+	{
+		jobs[i].model = renderModelManager->FindModel( va( "_area%i", i ) );
+		jobs[i].bvh = NULL;
+	}
+
+	// nested job lists are not allowed, so only go wide from the main thread
+	if( jobs.Num() > 1 && idLib::IsMainThread() )
+	{
+		idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, jobs.Num(), 0, NULL );
+		for( int i = 0; i < jobs.Num(); i++ )
+		{
+			jobList->AddJob( ( jobRun_t )BuildAreaTraceBVHJob, &jobs[i] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+		parallelJobManager->FreeJobList( jobList );
+	}
+	else
+	{
+		for( int i = 0; i < jobs.Num(); i++ )
+		{
+			BuildAreaTraceBVHJob( &jobs[i] );
+		}
+	}
+
+	areaTraceBVHs.SetNum( numPortalAreas );
+	for( int i = 0; i < numPortalAreas; i++ )
+	{
+		areaTraceBVHs[i] = jobs[i].bvh;
+	}
+}
+
+/*
+===================
+idRenderWorldLocal::FreeAreaTraceBVHs
+===================
+*/
+void idRenderWorldLocal::FreeAreaTraceBVHs()
+{
+	areaTraceBVHs.DeleteContents( true );
+}
+
+/*
+===============================================================================
+
+	Area model BVH tracing
+
+===============================================================================
+*/
+
+/*
+===================
+idRenderWorldLocal::AreaTraceBVH
+
+Returns the BVH Trace can use for an entity referenced by the area, or NULL
+if the entity isn't the unskinned area model.
+===================
+*/
+const idRenderWorldLocal::areaTraceBVH_t* idRenderWorldLocal::AreaTraceBVH( int areaNum, const idRenderEntityLocal* def, const float radius ) const
+{
+	// the surface bounds tests of Trace skip surfaces that are only hit by the circle
+	// expansion of their triangles, the BVH can't reproduce that for expanded traces
+	if( !r_useTraceBVH.GetBool() || radius != 0.0f )
+	{
+		return NULL;
+	}
+
+	if( areaNum < 0 || areaNum >= areaTraceBVHs.Num() )
+	{
+		return NULL;
+	}
+
+	const areaTraceBVH_t* bvh = areaTraceBVHs[areaNum];
+	if( bvh == NULL || bvh->model != def->parms.hModel )
+	{
+		return NULL;
+	}
+
+	if( def->parms.customSkin != NULL || def->parms.customShader != NULL )
+	{
+		return NULL;
+	}
+
+	return bvh;
+}
+
+/*
+====================
+R_TraceBVHChildren
+
+Returns a bit mask of the node children the ray enters before maxFraction.
+====================
+*/
+static int R_TraceBVHChildren( const idRenderWorldLocal::traceBVHNode_t& node, const idVec3& start, const idVec3& invDir, const float maxFraction )
+{
+#if defined(USE_INTRINSICS_SSE)
+	__m128 tMin = _mm_setzero_ps();
+	__m128 tMax = _mm_set1_ps( maxFraction );
+
+	for( int i = 0; i < 3; i++ )
+	{
+		const __m128 s = _mm_set1_ps( start[i] );
+		const __m128 inv = _mm_set1_ps( invDir[i] );
+
+		const __m128 t0 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( node.mins[i] ), s ), inv );
+		const __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( node.maxs[i] ), s ), inv );
+
+		tMin = _mm_max_ps( tMin, _mm_min_ps( t0, t1 ) );
+		tMax = _mm_min_ps( tMax, _mm_max_ps( t0, t1 ) );
+	}
+
+	return _mm_movemask_ps( _mm_cmple_ps( tMin, tMax ) ) & ( ( 1 << node.numChildren ) - 1 );
+#else
+	int mask = 0;
+	for( int c = 0; c < node.numChildren; c++ )
+	{
+		float tMin = 0.0f;
+		float tMax = maxFraction;
+
+		for( int i = 0; i < 3; i++ )
+		{
+			const float t0 = ( node.mins[i][c] - start[i] ) * invDir[i];
+			const float t1 = ( node.maxs[i][c] - start[i] ) * invDir[i];
+
+			tMin = Max( tMin, Min( t0, t1 ) );
+			tMax = Min( tMax, Max( t0, t1 ) );
+		}
+
+		if( tMin <= tMax )
+		{
+			mask |= 1 << c;
+		}
+	}
+	return mask;
+#endif
+}
+
+/*
+===================
+idRenderWorldLocal::TraceAreaBVH
+
+Gives the same result as the surface loop in Trace for a trace without radius:
+the triangles are culled with the same planes and cull bits as R_LocalTrace, and
+equally close hits go to the earlier surface and triangle.
+===================
+*/
+void idRenderWorldLocal::TraceAreaBVH( modelTrace_t& trace, idBounds& traceBounds, const areaTraceBVH_t* bvh, const idRenderEntityLocal* def,
+									   const idVec3& start, const idVec3& end, bool skipPlayer ) const
+{
+	// transform the points into local space
+	float modelMatrix[16];
+	idVec3 localStart, localEnd;
+	R_AxisToModelMatrix( def->parms.axis, def->parms.origin, modelMatrix );
+	R_GlobalPointToLocal( modelMatrix, start, localStart );
+	R_GlobalPointToLocal( modelMatrix, end, localEnd );
+
+	ALIGNTYPE16 idPlane planes[4];
+	R_TracePlanes( localStart, localEnd, planes );
+
+	const idVec3 dir = localEnd - localStart;
+	idVec3 invDir;
+	for( int i = 0; i < 3; i++ )
+	{
+		// a huge scale instead of an infinity so a ray along a slab boundary doesn't produce NaNs
+		invDir[i] = ( idMath::Fabs( dir[i] ) > 1e-12f ) ? ( 1.0f / dir[i] ) : ( ( dir[i] < 0.0f ) ? -1e12f : 1e12f );
+	}
+
+	localTrace_t best;
+	best.fraction = 1.0f;
+	int bestSurface = -1;
+	int bestIndex = 0;
+
+	int stack[TRACE_BVH_STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while( stackSize > 0 )
+	{
+		const traceBVHNode_t& node = bvh->nodes[stack[--stackSize]];
+
+		// a hit as close as the best one can still win if it is on an earlier surface
+		const int childMask = R_TraceBVHChildren( node, localStart, invDir, Min( best.fraction, trace.fraction ) );
+
+		for( int c = 0; c < node.numChildren; c++ )
+		{
+			if( ( childMask & ( 1 << c ) ) == 0 )
+			{
+				continue;
+			}
+
+			if( node.numTris[c] == 0 )
+			{
+				assert( stackSize < TRACE_BVH_STACK_SIZE );
+				stack[stackSize++] = node.children[c];
+				continue;
+			}
+
+			for( int t = node.children[c]; t < node.children[c] + node.numTris[c]; t++ )
+			{
+				const traceBVHTri_t& bvhTri = bvh->tris[t];
+				const traceBVHSurface_t& surf = bvh->surfaces[bvhTri.surfaceNum];
+
+				if( skipPlayer && surf.playerExcluded )
+				{
+					continue;
+				}
+
+				const srfTriangles_t* tri = surf.geometry;
+				const int i0 = tri->indexes[bvhTri.firstIndex + 0];
+				const int i1 = tri->indexes[bvhTri.firstIndex + 1];
+				const int i2 = tri->indexes[bvhTri.firstIndex + 2];
+
+				const idVec3& triVert0 = tri->verts[i0].xyz;
+				const idVec3& triVert1 = tri->verts[i1].xyz;
+				const idVec3& triVert2 = tri->verts[i2].xyz;
+
+				// get sidedness info for the triangle
+				const byte triOr = R_TracePointCullBits( planes, 0.0f, triVert0 ) | R_TracePointCullBits( planes, 0.0f, triVert1 ) | R_TracePointCullBits( planes, 0.0f, triVert2 );
+
+				// if we don't have points on both sides of both the ray planes, no intersection
+				if( ( triOr ^ ( triOr >> 4 ) ) & 3 )
+				{
+					continue;
+				}
+
+				// if we don't have any points between front and end, no intersection
+				if( ( triOr ^ ( triOr >> 1 ) ) & 4 )
+				{
+					continue;
+				}
+
+				localTrace_t hit;
+				hit.fraction = 1.0f;
+				if( !R_LineIntersectsTriangleExpandedWithCircle( hit, localStart, localEnd, 0.0f, triVert0, triVert1, triVert2 ) )
+				{
+					continue;
+				}
+
+				if( hit.fraction < best.fraction || ( hit.fraction == best.fraction &&
+													  ( bvhTri.surfaceNum < bestSurface || ( bvhTri.surfaceNum == bestSurface && bvhTri.firstIndex < bestIndex ) ) ) )
+				{
+					best = hit;
+					best.indexes[0] = i0;
+					best.indexes[1] = i1;
+					best.indexes[2] = i2;
+					bestSurface = bvhTri.surfaceNum;
+					bestIndex = bvhTri.firstIndex;
+				}
+			}
+		}
+	}
+
+	if( bestSurface == -1 || best.fraction >= trace.fraction )
+	{
+		return;
+	}
+
+	trace.fraction = best.fraction;
+	R_LocalPointToGlobal( modelMatrix, best.point, trace.point );
+	trace.normal = best.normal * def->parms.axis;
+	trace.material = bvh->surfaces[bestSurface].shader;
+	trace.entity = &def->parms;
+	trace.jointNumber = bvh->model->NearestJoint( bestSurface, best.indexes[0], best.indexes[1], best.indexes[2] );
+
+	traceBounds.Clear();
+	traceBounds.AddPoint( start );
+	traceBounds.AddPoint( start + trace.fraction * ( end - start ) );
+}
+
+/*
+===============================================================================
+
+	Batched traces
+
+===============================================================================
+*/
+
+struct traceBatchJob_t
+{
+	const idRenderWorldLocal* 	world;
+	modelTrace_t* 				traces;
+	const idVec3* 				starts;
+	const idVec3* 				ends;
+	int							numTraces;
+	float						radius;
+	bool						skipPlayer;
+	int							numHits;
+};
+
+/*
+====================
+TraceBatchJob
+====================
+*/
+static void TraceBatchJob( traceBatchJob_t* job )
+{
+	job->numHits = 0;
+	for( int i = 0; i < job->numTraces; i++ )
+	{
+		if( job->world->Trace( job->traces[i], job->starts[i], job->ends[i], job->radius, true, job->skipPlayer ) )
+		{
+			job->numHits++;
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB( TraceBatchJob, "TraceBatchJob" );
+
+/*
+===================
+idRenderWorldLocal::TraceBatch
+
+Traces against static models only touch data that doesn't change while the
+game waits for the result, so those are spread over parallel jobs.
+===================
+*/
+int idRenderWorldLocal::TraceBatch( modelTrace_t* traces, const idVec3* starts, const idVec3* ends, const int numTraces, const float radius, bool skipDynamic, bool skipPlayer ) const
+{
+	// dynamic models are instantiated on demand, which can only be done from one thread,
+	// and nested job lists are not allowed
+	if( !skipDynamic || numTraces < TRACE_BATCH_JOB_RAYS * 2 || !idLib::IsMainThread() )
+	{
+		int numHits = 0;
+		for( int i = 0; i < numTraces; i++ )
+		{
+			if( Trace( traces[i], starts[i], ends[i], radius, skipDynamic, skipPlayer ) )
+			{
+				numHits++;
+			}
+		}
+		return numHits;
+	}
+
+	const int numJobs = ( numTraces + TRACE_BATCH_JOB_RAYS - 1 ) / TRACE_BATCH_JOB_RAYS;
+	idList<traceBatchJob_t, TAG_RENDER> jobs;
+	jobs.SetNum( numJobs );
+
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, numJobs, 0, NULL );
+	for( int i = 0; i < numJobs; i++ )
+	{
+		const int first = i * TRACE_BATCH_JOB_RAYS;
+
+		traceBatchJob_t& job = jobs[i];
+		job.world = this;
+		job.traces = traces + first;
+		job.starts = starts + first;
+		job.ends = ends + first;
+		job.numTraces = Min( TRACE_BATCH_JOB_RAYS, numTraces - first );
+		job.radius = radius;
+		job.skipPlayer = skipPlayer;
+		job.numHits = 0;
+
+		jobList->AddJob( ( jobRun_t )TraceBatchJob, &job );
+	}
+	jobList->Submit();
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+
+	int numHits = 0;
+	for( int i = 0; i < numJobs; i++ )
+	{
+		numHits += jobs[i].numHits;
+	}
+	return numHits;
+}
+
+/*
+====================
+R_CompareModelTraces
+====================
+*/
+static bool R_CompareModelTraces( const modelTrace_t& a, const modelTrace_t& b )
+{
+	if( a.fraction != b.fraction || a.point != b.point )
+	{
+		return false;
+	}
+	if( a.fraction >= 1.0f )
+	{
+		// nothing else is set for a miss
+		return true;
+	}
+	return ( a.normal == b.normal && a.material == b.material && a.entity == b.entity && a.jointNumber == b.jointNumber );
+}
+
+/*
+====================
+testTraceBatch
+====================
+*/
+CONSOLE_COMMAND( testTraceBatch, "compares and benchmarks the per surface, BVH and batched world traces", NULL )
+{
+	const idRenderWorldLocal* world = tr.primaryWorld;
+	if( world == NULL || tr.primaryView == NULL )
+	{
+		common->Printf( "no primary view\n" );
+		return;
+	}
+
+	const int numRays = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 1000;
+	// BoundsInAreas expects less than 1e4 units
+	const float length = ( args.Argc() > 2 ) ? idMath::ClampFloat( 1.0f, 8192.0f, atof( args.Argv( 2 ) ) ) : 4096.0f;
+
+	// rays in all directions from the view, like hitscan and decal traces
+	idRandom random( 0 );
+	const idVec3 origin = tr.primaryView->renderView.vieworg;
+
+	idList<idVec3> starts;
+	idList<idVec3> ends;
+	starts.SetNum( numRays );
+	ends.SetNum( numRays );
+	for( int i = 0; i < numRays; i++ )
+	{
+		idVec3 dir( random.CRandomFloat(), random.CRandomFloat(), random.CRandomFloat() );
+		if( dir.Normalize() == 0.0f )
+		{
+			dir.Set( 1.0f, 0.0f, 0.0f );
+		}
+		starts[i] = origin;
+		ends[i] = origin + dir * length;
+	}
+
+	idList<modelTrace_t> surfaceTraces;
+	idList<modelTrace_t> bvhTraces;
+	idList<modelTrace_t> batchTraces;
+	surfaceTraces.SetNum( numRays );
+	bvhTraces.SetNum( numRays );
+	batchTraces.SetNum( numRays );
+	memset( surfaceTraces.Ptr(), 0, numRays * sizeof( modelTrace_t ) );
+	memset( bvhTraces.Ptr(), 0, numRays * sizeof( modelTrace_t ) );
+	memset( batchTraces.Ptr(), 0, numRays * sizeof( modelTrace_t ) );
+
+	const bool useTraceBVH = r_useTraceBVH.GetBool();
+
+	r_useTraceBVH.SetBool( false );
+	uint64_t start = Sys_Microseconds();
+	int numHits = 0;
+	for( int i = 0; i < numRays; i++ )
+	{
+		numHits += world->Trace( surfaceTraces[i], starts[i], ends[i], 0.0f ) ? 1 : 0;
+	}
+	const uint64_t surfaceMicroSec = Sys_Microseconds() - start;
+
+	r_useTraceBVH.SetBool( true );
+	start = Sys_Microseconds();
+	for( int i = 0; i < numRays; i++ )
+	{
+		world->Trace( bvhTraces[i], starts[i], ends[i], 0.0f );
+	}
+	const uint64_t bvhMicroSec = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	world->TraceBatch( batchTraces.Ptr(), starts.Ptr(), ends.Ptr(), numRays, 0.0f );
+	const uint64_t batchMicroSec = Sys_Microseconds() - start;
+
+	r_useTraceBVH.SetBool( useTraceBVH );
+
+	int bvhMismatches = 0;
+	int batchMismatches = 0;
+	for( int i = 0; i < numRays; i++ )
+	{
+		if( !R_CompareModelTraces( surfaceTraces[i], bvhTraces[i] ) )
+		{
+			if( bvhMismatches++ == 0 )
+			{
+				common->Printf( "ray %d differs: fraction %f per surface, %f bvh\n", i, surfaceTraces[i].fraction, bvhTraces[i].fraction );
+			}
+		}
+		if( !R_CompareModelTraces( surfaceTraces[i], batchTraces[i] ) )
+		{
+			batchMismatches++;
+		}
+	}
+
+	int numBVHs = 0;
+	int numNodes = 0;
+	int numTris = 0;
+	for( int i = 0; i < world->areaTraceBVHs.Num(); i++ )
+	{
+		if( world->areaTraceBVHs[i] != NULL )
+		{
+			numBVHs++;
+			numNodes += world->areaTraceBVHs[i]->nodes.Num();
+			numTris += world->areaTraceBVHs[i]->tris.Num();
+		}
+	}
+
+	common->Printf( "%d area BVHs, %d nodes, %d triangles\n", numBVHs, numNodes, numTris );
+	common->Printf( "%d rays, %d hits, %d bvh mismatches, %d batch mismatches\n", numRays, numHits, bvhMismatches, batchMismatches );
+	common->Printf( "per surface %8.2f ms\n", surfaceMicroSec / 1000.0f );
+	common->Printf( "bvh         %8.2f ms\n", bvhMicroSec / 1000.0f );
+	common->Printf( "batched     %8.2f ms\n", batchMicroSec / 1000.0f );
+}
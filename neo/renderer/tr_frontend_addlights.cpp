@@ -47,6 +47,7 @@ extern idCVar r_useShadowPreciseInsideTest;
 
 idCVar r_useAreasConnectedForShadowCulling( "r_useAreasConnectedForShadowCulling", "2", CVAR_RENDERER | CVAR_INTEGER, "cull entities cut off by doors" );
 idCVar r_useParallelAddLights( "r_useParallelAddLights", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_NOCHEAT, "aadd all lights in parallel with jobs" );
+idCVar r_useLightCasterCache( "r_useLightCasterCache", "1", CVAR_RENDERER | CVAR_BOOL, "reuse the entities found in the areas of a light until something changes" );
 
 /*
 ============================
@@ -91,6 +92,127 @@ bool idRenderEntityLocal::IsDirectlyVisible() const
 	return true;
 }
 
+/*
+===================
+R_LightCasterCacheValid
+
+The cache is dropped when the light is moved, when an entity is newly added to one
+of the light's areas, or when a portal changes and the areas connected test is used.
+Entities that are only moved inside the areas are re-tested by R_AddSingleLight.
+===================
+*/
+static bool R_LightCasterCacheValid( const idRenderLightLocal* light, int areasConnected )
+{
+	if( light->casterCacheVersion == 0 || light->casterCacheAreasConnected != areasConnected )
+	{
+		return false;
+	}
+	if( areasConnected == 2 && light->casterCacheConnectedAreaNum != light->world->connectedAreaNum )
+	{
+		return false;
+	}
+	for( const areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	{
+		if( lref->area->entityAddVersion > light->casterCacheVersion )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+===================
+R_UpdateLightCaster
+
+Calculates the view independent culling results of a cached entity.
+===================
+*/
+static void R_UpdateLightCaster( const idRenderLightLocal* light, lightCaster_t& caster )
+{
+	const idRenderEntityLocal* edef = caster.edef;
+	caster.referenceVersion = edef->referenceVersion;
+
+	// do a check of the entity reference bounds against the light frustum to see if they can't
+	// possibly interact, despite sharing one or more world areas
+	caster.culledToLight = R_CullModelBoundsToLight( light, edef->localReferenceBounds, edef->modelRenderMatrix );
+
+	// should we use the shadow bounds from pre-calculated interactions?
+	R_ShadowBounds( edef->globalReferenceBounds, light->globalLightBounds, light->globalLightOrigin, caster.shadowBounds );
+}
+
+/*
+===================
+R_BuildLightCasterCache
+
+Collects every entity in the areas of the light once.
+Marks the entities in entityInteractionState as INTERACTION_NO.
+===================
+*/
+static void R_BuildLightCasterCache( idRenderLightLocal* light, viewLight_t* vLight, int areasConnected )
+{
+	light->casterCache.SetNum( 0 );
+	light->casterAreas.SetNum( 0 );
+
+	for( areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	{
+		portalArea_t* area = lref->area;
+
+		// some lights have their center of projection outside the world, but otherwise
+		// we want to ignore areas that are not connected to the light center due to a closed door
+		if( light->areaNum != -1 && areasConnected == 2 )
+		{
+			if( !light->world->AreasAreConnected( light->areaNum, area->areaNum, PS_BLOCK_VIEW ) )
+			{
+				// can't possibly be seen or shadowed
+				continue;
+			}
+		}
+
+		light->casterAreas.Append( area->areaNum );
+
+		// check all the models in this area
+		for( areaReference_t* eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext )
+		{
+			idRenderEntityLocal* edef = eref->entity;
+
+			if( vLight->entityInteractionState[ edef->index ] != viewLight_t::INTERACTION_UNCHECKED )
+			{
+				continue;
+			}
+			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
+
+			lightCaster_t& caster = light->casterCache.Alloc();
+			caster.edef = edef;
+			caster.entityIndex = edef->index;
+			R_UpdateLightCaster( light, caster );
+		}
+	}
+
+	light->casterCacheVersion = light->world->referenceVersion;
+	light->casterCacheConnectedAreaNum = light->world->connectedAreaNum;
+	light->casterCacheAreasConnected = areasConnected;
+}
+
+/*
+===================
+R_LightCasterInAreas
+
+True if a changed entity still references one of the areas walked for the cache.
+===================
+*/
+static bool R_LightCasterInAreas( const idRenderLightLocal* light, const idRenderEntityLocal* edef )
+{
+	for( const areaReference_t* eref = edef->entityRefs; eref != NULL; eref = eref->ownerNext )
+	{
+		if( light->casterAreas.FindIndex( eref->area->areaNum ) != -1 )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 /*
 ===================
 R_AddSingleLight
@@ -112,11 +234,13 @@ static void R_AddSingleLight( viewLight_t* vLight )
 	// until proven otherwise
 	vLight->removeFromList = true;
 	vLight->shadowOnlyViewEntities = NULL;
+	vLight->casterCacheHit = false;
+	vLight->casterRetests = 0;
 
 	// globals we really should pass in...
 	const viewDef_t* viewDef = tr.viewDef;
 
-	const idRenderLightLocal* light = vLight->lightDef;
+	idRenderLightLocal* light = vLight->lightDef;
 	const idMaterial* lightShader = light->lightShader;
 	if( lightShader == NULL )
 	{
@@ -124,7 +248,7 @@ static void R_AddSingleLight( viewLight_t* vLight )
 		return;
 	}
 
-	SCOPED_PROFILE_EVENT( lightShader->GetName() );
+	SCOPED_PROFILE_EVENT_DYNAMIC( lightShader->GetName() );
 
 	// see if we are suppressing the light in this view
 	if( !r_skipSuppress.GetBool() )
@@ -472,155 +596,165 @@ static void R_AddSingleLight( viewLight_t* vLight )
 	// this bool array will be set true whenever the entity will visibly interact with the light
 	vLight->entityInteractionState = ( byte* )R_ClearedFrameAlloc( light->world->entityDefs.Num() * sizeof( vLight->entityInteractionState[0] ), FRAME_ALLOC_INTERACTION_STATE );
 
-	idInteraction** const interactionTableRow = light->world->interactionTable + light->index * light->world->interactionTableWidth;
+	const idInteractionTable& interactionTable = light->world->interactionTable;
 
-	for( areaReference_t* lref = light->references; lref != NULL; lref = lref->ownerNext )
+	// only walk the areas again if the cached entities may be incomplete
+	const int areasConnected = r_useAreasConnectedForShadowCulling.GetInteger();
+	if( r_useLightCasterCache.GetBool() && R_LightCasterCacheValid( light, areasConnected ) )
 	{
-		portalArea_t* area = lref->area;
+		vLight->casterCacheHit = true;
+	}
+	else
+	{
+		R_BuildLightCasterCache( light, vLight, areasConnected );
+	}
 
-		// some lights have their center of projection outside the world, but otherwise
-		// we want to ignore areas that are not connected to the light center due to a closed door
-		if( light->areaNum != -1 && r_useAreasConnectedForShadowCulling.GetInteger() == 2 )
+	const idList<idRenderEntityLocal*, TAG_ENTITY>& entityDefs = light->world->entityDefs;
+
+	for( int i = 0; i < light->casterCache.Num(); i++ )
+	{
+		lightCaster_t& caster = light->casterCache[i];
+
+		// the entity was freed since the cache was built
+		if( caster.entityIndex >= entityDefs.Num() || entityDefs[caster.entityIndex] != caster.edef )
 		{
-			if( !light->world->AreasAreConnected( light->areaNum, area->areaNum, PS_BLOCK_VIEW ) )
-			{
-				// can't possibly be seen or shadowed
-				continue;
-			}
+			light->casterCache.RemoveIndexFast( i );
+			i--;
+			continue;
 		}
 
-		// check all the models in this area
-		for( areaReference_t* eref = area->entityRefs.areaNext; eref != &area->entityRefs; eref = eref->areaNext )
-		{
-			idRenderEntityLocal* edef = eref->entity;
+		idRenderEntityLocal* edef = caster.edef;
 
-			if( vLight->entityInteractionState[ edef->index ] != viewLight_t::INTERACTION_UNCHECKED )
+		// the entity was updated, so it may have moved out of the light's areas
+		if( caster.referenceVersion != edef->referenceVersion )
+		{
+			if( !R_LightCasterInAreas( light, edef ) )
 			{
+				light->casterCache.RemoveIndexFast( i );
+				i--;
 				continue;
 			}
-			// until proven otherwise
-			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
-
-			// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
-
-			// TODO(Stephen): interactionTableRow is null if renderDef is used in a gui.sub
-			const idInteraction* inter = interactionTableRow[ edef->index ];
+			R_UpdateLightCaster( light, caster );
+			vLight->casterRetests++;
+		}
 
-			const renderEntity_t& eParms = edef->parms;
-			const idRenderModel* eModel = eParms.hModel;
+		// until proven otherwise
+		vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_NO;
 
-			// a large fraction of static entity / light pairs will still have no interactions even though
-			// they are both present in the same area(s)
-			if( eModel != NULL && !eModel->IsDynamicModel() && inter == INTERACTION_EMPTY )
-			{
-				// the interaction was statically checked, and it didn't generate any surfaces,
-				// so there is no need to force the entity onto the view list if it isn't
-				// already there
-				continue;
-			}
+		// The table is updated at interaction::AllocAndLink() and interaction::UnlinkAndFree()
 
-			// We don't want the lights on weapons to illuminate anything else.
-			// There are two assumptions here -- that allowLightInViewID is only
-			// used for weapon lights, and that all weapons will have weaponDepthHack.
-			// A more general solution would be to have an allowLightOnEntityID field.
-			// HACK: the armor-mounted flashlight is a private spot light, which is probably
-			// wrong -- you would expect to see them in multiplayer.
-			//	if( light->parms.allowLightInViewID && light->parms.pointLight && !eParms.weaponDepthHack )
-			//	{
-			//		continue;
-			//	}
-
-			// non-shadow casting entities don't need to be added if they aren't
-			// directly visible
-			if( ( eParms.noShadow || ( eModel && !eModel->ModelHasShadowCastingSurfaces() ) ) && !edef->IsDirectlyVisible() )
-			{
-				continue;
-			}
+		// lookups in a world without generated interactions, like a gui.sub renderDef, return NULL
+		const idInteraction* inter = interactionTable.Get( light->index, edef->index );
 
-			// if the model doesn't accept lighting or cast shadows, it doesn't need to be added
-			if( eModel && !eModel->ModelHasInteractingSurfaces() && !eModel->ModelHasShadowCastingSurfaces() )
-			{
-				continue;
-			}
+		const renderEntity_t& eParms = edef->parms;
+		const idRenderModel* eModel = eParms.hModel;
 
-			// no interaction present, so either the light or entity has moved
-			// assert( lightHasMoved || edef->entityHasMoved );
-			if( inter == NULL )
-			{
-				// some big outdoor meshes are flagged to not create any dynamic interactions
-				// when the level designer knows that nearby moving lights shouldn't actually hit them
-				if( eParms.noDynamicInteractions )
-				{
-					continue;
-				}
+		// a large fraction of static entity / light pairs will still have no interactions even though
+		// they are both present in the same area(s)
+		if( eModel != NULL && !eModel->IsDynamicModel() && inter == INTERACTION_EMPTY )
+		{
+			// the interaction was statically checked, and it didn't generate any surfaces,
+			// so there is no need to force the entity onto the view list if it isn't
+			// already there
+			continue;
+		}
 
-				// do a check of the entity reference bounds against the light frustum to see if they can't
-				// possibly interact, despite sharing one or more world areas
-				if( R_CullModelBoundsToLight( light, edef->localReferenceBounds, edef->modelRenderMatrix ) )
-				{
-					continue;
-				}
-			}
+		// We don't want the lights on weapons to illuminate anything else.
+		// There are two assumptions here -- that allowLightInViewID is only
+		// used for weapon lights, and that all weapons will have weaponDepthHack.
+		// A more general solution would be to have an allowLightOnEntityID field.
+		// HACK: the armor-mounted flashlight is a private spot light, which is probably
+		// wrong -- you would expect to see them in multiplayer.
+		//	if( light->parms.allowLightInViewID && light->parms.pointLight && !eParms.weaponDepthHack )
+		//	{
+		//		continue;
+		//	}
+
+		// non-shadow casting entities don't need to be added if they aren't
+		// directly visible
+		if( ( eParms.noShadow || ( eModel && !eModel->ModelHasShadowCastingSurfaces() ) ) && !edef->IsDirectlyVisible() )
+		{
+			continue;
+		}
 
-			// we now know that the entity and light do overlap
+		// if the model doesn't accept lighting or cast shadows, it doesn't need to be added
+		if( eModel && !eModel->ModelHasInteractingSurfaces() && !eModel->ModelHasShadowCastingSurfaces() )
+		{
+			continue;
+		}
 
-			if( edef->IsDirectlyVisible() )
+		// no interaction present, so either the light or entity has moved
+		// assert( lightHasMoved || edef->entityHasMoved );
+		if( inter == NULL )
+		{
+			// some big outdoor meshes are flagged to not create any dynamic interactions
+			// when the level designer knows that nearby moving lights shouldn't actually hit them
+			if( eParms.noDynamicInteractions )
 			{
-				// entity is directly visible, so the interaction is definitely needed
-				vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
 				continue;
 			}
 
-			// the entity is not directly visible, but if we can tell that it may cast
-			// shadows onto visible surfaces, we must make a viewEntity for it
-			if( !lightCastsShadows )
+			// the entity reference bounds were checked against the light frustum by R_UpdateLightCaster
+			if( caster.culledToLight )
 			{
-				// surfaces are never shadowed in this light
 				continue;
 			}
-			// if we are suppressing its shadow in this view (player shadows, etc), skip
-			if( !r_skipSuppress.GetBool() )
-			{
-				if( eParms.suppressShadowInViewID && eParms.suppressShadowInViewID == renderViewID )
-				{
-					continue;
-				}
-				if( eParms.suppressShadowInLightID && eParms.suppressShadowInLightID == light->parms.lightId )
-				{
-					continue;
-				}
-			}
+		}
 
-			// should we use the shadow bounds from pre-calculated interactions?
-			idBounds shadowBounds;
-			R_ShadowBounds( edef->globalReferenceBounds, light->globalLightBounds, light->globalLightOrigin, shadowBounds );
+		// we now know that the entity and light do overlap
 
-			// this test is pointless if we knew the light was completely contained
-			// in the view frustum, but the entity would also be directly visible in most
-			// of those cases.
+		if( edef->IsDirectlyVisible() )
+		{
+			// entity is directly visible, so the interaction is definitely needed
+			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
+			continue;
+		}
 
-			// this doesn't say that the shadow can't effect anything, only that it can't
-			// effect anything in the view, so we shouldn't set up a view entity
-			if( idRenderMatrix::CullBoundsToMVP( viewDef->worldSpace.mvp, shadowBounds ) )
+		// the entity is not directly visible, but if we can tell that it may cast
+		// shadows onto visible surfaces, we must make a viewEntity for it
+		if( !lightCastsShadows )
+		{
+			// surfaces are never shadowed in this light
+			continue;
+		}
+		// if we are suppressing its shadow in this view (player shadows, etc), skip
+		if( !r_skipSuppress.GetBool() )
+		{
+			if( eParms.suppressShadowInViewID && eParms.suppressShadowInViewID == renderViewID )
 			{
 				continue;
 			}
-
-			// debug tool to allow viewing of only one entity at a time
-			if( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index )
+			if( eParms.suppressShadowInLightID && eParms.suppressShadowInLightID == light->parms.lightId )
 			{
 				continue;
 			}
+		}
 
-			// we do need it for shadows
-			vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
+		// this test is pointless if we knew the light was completely contained
+		// in the view frustum, but the entity would also be directly visible in most
+		// of those cases.
+
+		// this doesn't say that the shadow can't effect anything, only that it can't
+		// effect anything in the view, so we shouldn't set up a view entity
+		if( idRenderMatrix::CullBoundsToMVP( viewDef->worldSpace.mvp, caster.shadowBounds ) )
+		{
+			continue;
+		}
 
-			// we will need to create a viewEntity_t for it in the serial code section
-			shadowOnlyEntity_t* shadEnt = ( shadowOnlyEntity_t* )R_FrameAlloc( sizeof( shadowOnlyEntity_t ), FRAME_ALLOC_SHADOW_ONLY_ENTITY );
-			shadEnt->next = vLight->shadowOnlyViewEntities;
-			shadEnt->edef = edef;
-			vLight->shadowOnlyViewEntities = shadEnt;
+		// debug tool to allow viewing of only one entity at a time
+		if( r_singleEntity.GetInteger() >= 0 && r_singleEntity.GetInteger() != edef->index )
+		{
+			continue;
 		}
+
+		// we do need it for shadows
+		vLight->entityInteractionState[ edef->index ] = viewLight_t::INTERACTION_YES;
+
+		// we will need to create a viewEntity_t for it in the serial code section
+		shadowOnlyEntity_t* shadEnt = ( shadowOnlyEntity_t* )R_FrameAlloc( sizeof( shadowOnlyEntity_t ), FRAME_ALLOC_SHADOW_ONLY_ENTITY );
+		shadEnt->next = vLight->shadowOnlyViewEntities;
+		shadEnt->edef = edef;
+		vLight->shadowOnlyViewEntities = shadEnt;
 	}
 }
 
@@ -678,6 +812,16 @@ void R_AddLights()
 		// serial work
 		tr.pc.c_viewLights++;
 
+		if( vLight->casterCacheHit )
+		{
+			tr.pc.c_casterCacheHits++;
+		}
+		else
+		{
+			tr.pc.c_casterCacheMisses++;
+		}
+		tr.pc.c_casterRetests += vLight->casterRetests;
+
 		for( shadowOnlyEntity_t* shadEnt = vLight->shadowOnlyViewEntities; shadEnt != NULL; shadEnt = shadEnt->next )
 		{
 			// this will add it to the viewEntities list, but with an empty scissor rect
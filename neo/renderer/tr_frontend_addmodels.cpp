@@ -44,6 +44,7 @@ If you have questions concerning this license or the applicable additional terms
 idCVar r_skipStaticShadows( "r_skipStaticShadows", "0", CVAR_RENDERER | CVAR_BOOL, "skip static shadows" );
 idCVar r_skipDynamicShadows( "r_skipDynamicShadows", "0", CVAR_RENDERER | CVAR_BOOL, "skip dynamic shadows" );
 idCVar r_useParallelAddModels( "r_useParallelAddModels", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_NOCHEAT, "add all models in parallel with jobs" );
+idCVar r_useViewEntityCull( "r_useViewEntityCull", "1", CVAR_RENDERER | CVAR_BOOL, "cull the view entities against the view frustum four at a time before adding models" );
 idCVar r_useParallelAddShadows( "r_useParallelAddShadows", "1", CVAR_RENDERER | CVAR_INTEGER | CVAR_NOCHEAT, "0 = off, 1 = threaded", 0, 1 );
 idCVar r_forceShadowCaps( "r_forceShadowCaps", "0", CVAR_RENDERER | CVAR_BOOL, "0 = skip rendering shadow caps if view is outside shadow volume, 1 = always render shadow caps" );
 // RB begin
@@ -248,10 +249,9 @@ void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, cons
 		if( unlikely( renderEntity->referenceShader != NULL ) )
 		{
 			// evaluate the reference shader to find our shader parms
-			float refRegs[MAX_EXPRESSION_REGISTERS];
-			renderEntity->referenceShader->EvaluateRegisters( refRegs, renderEntity->shaderParms,
-					tr.viewDef->renderView.shaderParms,
-					tr.viewDef->renderView.time[renderEntity->timeGroup] * 0.001f, renderEntity->referenceSound );
+			const float* refRegs = renderEntity->referenceShader->EvaluateFrameRegisters( renderEntity->shaderParms,
+								   tr.viewDef->renderView.shaderParms,
+								   tr.viewDef->renderView.time[renderEntity->timeGroup] * 0.001f, renderEntity->referenceSound );
 
 			const shaderStage_t* pStage = renderEntity->referenceShader->GetStage( 0 );
 
@@ -263,13 +263,10 @@ void R_SetupDrawSurfShader( drawSurf_t* drawSurf, const idMaterial* shader, cons
 			shaderParms = generatedShaderParms;
 		}
 
-		// allocate frame memory for the shader register values
-		float* regs = ( float* )R_FrameAlloc( shader->GetNumRegisters() * sizeof( float ), FRAME_ALLOC_SHADER_REGISTER );
-		drawSurf->shaderRegisters = regs;
-
-		// process the shader expressions for conditionals / color / texcoords
-		shader->EvaluateRegisters( regs, shaderParms, tr.viewDef->renderView.shaderParms,
-								   tr.viewDef->renderView.time[renderEntity->timeGroup] * 0.001f, renderEntity->referenceSound );
+		// process the shader expressions for conditionals / color / texcoords,
+		// surfaces with the same inputs share the registers in frame memory
+		drawSurf->shaderRegisters = shader->EvaluateFrameRegisters( shaderParms, tr.viewDef->renderView.shaderParms,
+									tr.viewDef->renderView.time[renderEntity->timeGroup] * 0.001f, renderEntity->referenceSound );
 	}
 }
 
@@ -298,6 +295,32 @@ void R_SetupDrawSurfJoints( drawSurf_t* drawSurf, const srfTriangles_t* tri, con
 	drawSurf->jointCache = model->jointsInvertedBuffer;
 }
 
+/*
+===================
+R_AddResidencyFeedback
+
+Reports the screen size of a drawn surface to the mip streaming of its images.
+May be run in parallel.
+===================
+*/
+static void R_AddResidencyFeedback( const idMaterial* shader, const idScreenRect& rect )
+{
+	if( globalImages->residency.Num() == 0 )
+	{
+		return;
+	}
+
+	const int pixels = Max( rect.GetWidth(), rect.GetHeight() );
+	for( int i = 0; i < shader->GetNumStages(); i++ )
+	{
+		const idImage* image = shader->GetStage( i )->texture.image;
+		if( image != NULL )
+		{
+			globalImages->ResidencyFeedback( image, pixels );
+		}
+	}
+}
+
 /*
 ===================
 R_AddSingleModel
@@ -335,7 +358,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 		return;
 	}
 
-	SCOPED_PROFILE_EVENT( renderEntity->hModel == NULL ? "Unknown Model" : renderEntity->hModel->Name() );
+	SCOPED_PROFILE_EVENT_DYNAMIC( renderEntity->hModel == NULL ? "Unknown Model" : renderEntity->hModel->Name() );
 
 	// calculate the znear for testing whether or not the view is inside a shadow projection
 	const float znear = ( viewDef->renderView.cramZNear ) ? ( r_znear.GetFloat() * 0.25f ) : r_znear.GetFloat();
@@ -375,7 +398,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 				if( vLight->entityInteractionState[entityIndex] == viewLight_t::INTERACTION_YES )
 				{
 					contactedLights[numContactedLights] = vLight;
-					staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
+					staticInteractions[numContactedLights] = world->interactionTable.Get( vLight->lightDef->index, entityIndex );
 					if( ++numContactedLights == MAX_CONTACTED_LIGHTS )
 					{
 						break;
@@ -431,7 +454,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 				}
 			}
 			contactedLights[numContactedLights] = vLight;
-			staticInteractions[numContactedLights] = world->interactionTable[vLight->lightDef->index * world->interactionTableWidth + entityIndex];
+			staticInteractions[numContactedLights] = world->interactionTable.Get( vLight->lightDef->index, entityIndex );
 			if( ++numContactedLights == MAX_CONTACTED_LIGHTS )
 			{
 				break;
@@ -642,7 +665,7 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 			shader = tr.primaryRenderView.globalMaterial;
 		}
 
-		SCOPED_PROFILE_EVENT( shader->GetName() );
+		SCOPED_PROFILE_EVENT_DYNAMIC( shader->GetName() );
 
 		// debugging tool to make sure we have the correct pre-calculated bounds
 		if( r_checkBounds.GetBool() )
@@ -802,6 +825,8 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 
 			shaderRegisters = baseDrawSurf->shaderRegisters;
 
+			R_AddResidencyFeedback( shader, baseDrawSurf->scissorRect );
+
 			// Check for deformations (eyeballs, flares, etc)
 			const deform_t shaderDeform = shader->Deform();
 			if( shaderDeform != DFRM_NONE )
@@ -1134,6 +1159,298 @@ void R_LinkDrawSurfToView( drawSurf_t* drawSurf, viewDef_t* viewDef )
 	viewDef->numDrawSurfs++;
 }
 
+/*
+===================
+viewEntityCull_t
+
+The reference bounds of the view entities packed as a structure of arrays,
+so the frustum test can run on four entities at a time without chasing the
+viewEntity_t and idRenderEntityLocal pointers. Each box is stored as its world
+space center and the three model axes scaled by the half extents, which also
+handles rotated and scaled models.
+===================
+*/
+struct viewEntityCull_t
+{
+	int					numEntities;
+	int					numPadded;			// numEntities rounded up to a multiple of 4
+	float* 				center[3];
+	float* 				axis[3][3];			// [axis][x,y,z]
+	byte* 				culled;				// 1 if outside one of the planes
+};
+
+/*
+===================
+R_AllocViewEntityCull
+===================
+*/
+static void R_AllocViewEntityCull( viewEntityCull_t& cull, const int numEntities, const bool frameMemory )
+{
+	cull.numEntities = numEntities;
+	cull.numPadded = ( numEntities + 3 ) & ~3;
+
+	// one block for all the arrays, every array stays 16 byte aligned
+	const int numFloats = cull.numPadded * 12;
+	const int bytes = numFloats * sizeof( float ) + cull.numPadded;
+	float* block = ( float* )( frameMemory ? R_FrameAlloc( bytes, FRAME_ALLOC_VIEW_ENTITY ) : Mem_Alloc16( bytes, TAG_RENDER ) );
+
+	for( int i = 0; i < 3; i++ )
+	{
+		cull.center[i] = block + i * cull.numPadded;
+		for( int j = 0; j < 3; j++ )
+		{
+			cull.axis[i][j] = block + ( 3 + i * 3 + j ) * cull.numPadded;
+		}
+	}
+	cull.culled = ( byte* )( block + numFloats );
+
+	// the padding is never reported, but keep it finite
+	memset( block, 0, numFloats * sizeof( float ) );
+}
+
+/*
+===================
+R_SetViewEntityCullBounds
+===================
+*/
+static void R_SetViewEntityCullBounds( viewEntityCull_t& cull, const int index, const idRenderEntityLocal* def )
+{
+	const idBounds& bounds = def->localReferenceBounds;
+	const idRenderMatrix& m = def->modelRenderMatrix;
+
+	const idVec3 center = bounds.GetCenter();
+	const idVec3 extents = ( bounds[1] - bounds[0] ) * 0.5f;
+
+	for( int i = 0; i < 3; i++ )
+	{
+		cull.center[i][index] = m[i][0] * center[0] + m[i][1] * center[1] + m[i][2] * center[2] + m[i][3];
+		for( int j = 0; j < 3; j++ )
+		{
+			cull.axis[i][j][index] = m[j][i] * extents[i];
+		}
+	}
+}
+
+/*
+===================
+R_CullViewEntitiesToPlanesGeneric
+
+The planes face outward, a box is culled when it is completely on the front
+side of any plane.
+===================
+*/
+static void R_CullViewEntitiesToPlanesGeneric( viewEntityCull_t& cull, const idPlane* planes, const int numPlanes )
+{
+	for( int i = 0; i < cull.numPadded; i++ )
+	{
+		byte culled = 0;
+		for( int p = 0; p < numPlanes; p++ )
+		{
+			const idPlane& plane = planes[p];
+
+			const float dist = plane[0] * cull.center[0][i] + plane[1] * cull.center[1][i] + plane[2] * cull.center[2][i] + plane[3];
+			float radius = 0.0f;
+			for( int k = 0; k < 3; k++ )
+			{
+				radius += idMath::Fabs( plane[0] * cull.axis[k][0][i] + plane[1] * cull.axis[k][1][i] + plane[2] * cull.axis[k][2][i] );
+			}
+			culled |= ( dist > radius );
+		}
+		cull.culled[i] = culled;
+	}
+}
+
+#if defined(USE_INTRINSICS_SSE)
+/*
+===================
+R_CullViewEntitiesToPlanesSSE
+
+Same as the generic version, with the same order of operations, so both give
+the same results.
+===================
+*/
+static void R_CullViewEntitiesToPlanesSSE( viewEntityCull_t& cull, const idPlane* planes, const int numPlanes )
+{
+	const __m128 absMask = _mm_castsi128_ps( _mm_set1_epi32( 0x7FFFFFFF ) );
+
+	for( int i = 0; i < cull.numPadded; i += 4 )
+	{
+		const __m128 cx = _mm_load_ps( cull.center[0] + i );
+		const __m128 cy = _mm_load_ps( cull.center[1] + i );
+		const __m128 cz = _mm_load_ps( cull.center[2] + i );
+
+		__m128 ax[3], ay[3], az[3];
+		for( int k = 0; k < 3; k++ )
+		{
+			ax[k] = _mm_load_ps( cull.axis[k][0] + i );
+			ay[k] = _mm_load_ps( cull.axis[k][1] + i );
+			az[k] = _mm_load_ps( cull.axis[k][2] + i );
+		}
+
+		__m128 culled = _mm_setzero_ps();
+		for( int p = 0; p < numPlanes; p++ )
+		{
+			const __m128 nx = _mm_set1_ps( planes[p][0] );
+			const __m128 ny = _mm_set1_ps( planes[p][1] );
+			const __m128 nz = _mm_set1_ps( planes[p][2] );
+			const __m128 nd = _mm_set1_ps( planes[p][3] );
+
+			__m128 dist = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, cx ), _mm_mul_ps( ny, cy ) ), _mm_mul_ps( nz, cz ) ), nd );
+			__m128 radius = _mm_setzero_ps();
+			for( int k = 0; k < 3; k++ )
+			{
+				const __m128 d = _mm_add_ps( _mm_add_ps( _mm_mul_ps( nx, ax[k] ), _mm_mul_ps( ny, ay[k] ) ), _mm_mul_ps( nz, az[k] ) );
+				radius = _mm_add_ps( radius, _mm_and_ps( d, absMask ) );
+			}
+			culled = _mm_or_ps( culled, _mm_cmpgt_ps( dist, radius ) );
+		}
+
+		const int mask = _mm_movemask_ps( culled );
+		cull.culled[i + 0] = ( mask >> 0 ) & 1;
+		cull.culled[i + 1] = ( mask >> 1 ) & 1;
+		cull.culled[i + 2] = ( mask >> 2 ) & 1;
+		cull.culled[i + 3] = ( mask >> 3 ) & 1;
+	}
+}
+#endif
+
+/*
+===================
+R_CullViewEntitiesToPlanes
+===================
+*/
+static void R_CullViewEntitiesToPlanes( viewEntityCull_t& cull, const idPlane* planes, const int numPlanes )
+{
+#if defined(USE_INTRINSICS_SSE)
+	R_CullViewEntitiesToPlanesSSE( cull, planes, numPlanes );
+#else
+	R_CullViewEntitiesToPlanesGeneric( cull, planes, numPlanes );
+#endif
+}
+
+/*
+===================
+R_CullViewEntities
+
+Culls the reference bounds of all view entities against the view frustum in
+one packed pass before any R_AddSingleModel job is started.
+
+An entity that was accepted through a portal chain but is completely outside
+the view frustum can't have any directly visible surface, so it is demoted to
+a shadow only entity by clearing its scissor rect. Shadow only entities that
+no visible light wants an interaction with would return right away from
+R_AddSingleModel, so they are not handed to it at all. The light frustums were
+already tested per caster in R_AddSingleLight, which left the result in
+entityInteractionState.
+
+Returns the entities that still have to go through R_AddSingleModel.
+===================
+*/
+static viewEntity_t** R_CullViewEntities( int& numAdded )
+{
+	const viewDef_t* viewDef = tr.viewDef;
+
+	int numEntities = 0;
+	for( viewEntity_t* vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+	{
+		numEntities++;
+	}
+
+	viewEntity_t** addEntities = ( viewEntity_t** )R_FrameAlloc( Max( numEntities, 1 ) * sizeof( addEntities[0] ), FRAME_ALLOC_VIEW_ENTITY );
+	numEntities = 0;
+	for( viewEntity_t* vEntity = viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+	{
+		addEntities[numEntities++] = vEntity;
+	}
+
+	numAdded = numEntities;
+	if( !r_useViewEntityCull.GetBool() || numEntities == 0 )
+	{
+		return addEntities;
+	}
+
+	const uint64_t startTime = Sys_Microseconds();
+
+	viewEntityCull_t cull;
+	R_AllocViewEntityCull( cull, numEntities, true );
+	for( int i = 0; i < numEntities; i++ )
+	{
+		R_SetViewEntityCullBounds( cull, i, addEntities[i]->entityDef );
+	}
+
+	R_CullViewEntitiesToPlanes( cull, viewDef->frustums[FRUSTUM_PRIMARY], FRUSTUM_PLANES );
+
+	// the lights a shadow only entity could still be added for
+	int numLights = 0;
+	for( viewLight_t* vLight = viewDef->viewLights; vLight != NULL; vLight = vLight->next )
+	{
+		numLights++;
+	}
+	const byte** interactionStates = ( const byte** )R_FrameAlloc( Max( numLights, 1 ) * sizeof( interactionStates[0] ), FRAME_ALLOC_INTERACTION_STATE );
+	bool allLightsHaveState = true;
+	numLights = 0;
+	for( viewLight_t* vLight = viewDef->viewLights; vLight != NULL; vLight = vLight->next )
+	{
+		if( vLight->scissorRect.IsEmpty() )
+		{
+			continue;
+		}
+		if( vLight->entityInteractionState == NULL )
+		{
+			allLightsHaveState = false;
+			break;
+		}
+		interactionStates[numLights++] = vLight->entityInteractionState;
+	}
+
+	numAdded = 0;
+	int numRejected = 0;
+	for( int i = 0; i < numEntities; i++ )
+	{
+		viewEntity_t* vEntity = addEntities[i];
+
+		if( cull.culled[i] && !vEntity->scissorRect.IsEmpty() )
+		{
+			const renderEntity_t& parms = vEntity->entityDef->parms;
+
+			// depth hacked models are drawn with a modified projection
+			if( !parms.weaponDepthHack && parms.modelDepthHack == 0.0f && ( parms.hModel == NULL || parms.hModel->DepthHack() == 0.0f ) )
+			{
+				vEntity->scissorRect.Clear();
+				numRejected++;
+			}
+		}
+
+		if( vEntity->scissorRect.IsEmpty() && allLightsHaveState )
+		{
+			const int entityIndex = vEntity->entityDef->index;
+
+			bool contacted = false;
+			for( int j = 0; j < numLights; j++ )
+			{
+				if( interactionStates[j][entityIndex] == viewLight_t::INTERACTION_YES )
+				{
+					contacted = true;
+					break;
+				}
+			}
+			if( !contacted )
+			{
+				continue;
+			}
+		}
+
+		addEntities[numAdded++] = vEntity;
+	}
+
+	tr.pc.c_entityCullTested += numEntities;
+	tr.pc.c_entityCullRejected += numRejected;
+	tr.pc.c_entityCullSkipped += numEntities - numAdded;
+	tr.pc.entityCullMicroSec += Sys_Microseconds() - startTime;
+
+	return addEntities;
+}
+
 /*
 ===================
 R_AddModels
@@ -1155,20 +1472,23 @@ void R_AddModels()
 	// any light that intersects the view (for shadows).
 	//-------------------------------------------------
 
+	int numAddEntities = 0;
+	viewEntity_t** addEntities = R_CullViewEntities( numAddEntities );
+
 	if( r_useParallelAddModels.GetBool() )
 	{
-		for( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+		for( int i = 0; i < numAddEntities; i++ )
 		{
-			tr.frontEndJobList->AddJob( ( jobRun_t )R_AddSingleModel, vEntity );
+			tr.frontEndJobList->AddJob( ( jobRun_t )R_AddSingleModel, addEntities[i] );
 		}
 		tr.frontEndJobList->Submit();
 		tr.frontEndJobList->Wait();
 	}
 	else
 	{
-		for( viewEntity_t* vEntity = tr.viewDef->viewEntitys; vEntity != NULL; vEntity = vEntity->next )
+		for( int i = 0; i < numAddEntities; i++ )
 		{
-			R_AddSingleModel( vEntity );
+			R_AddSingleModel( addEntities[i] );
 		}
 	}
 
@@ -1205,3 +1525,117 @@ void R_AddModels()
 		vEntity->drawSurfs = NULL;
 	}
 }
+
+/*
+====================
+testEntityCull
+
+Packs the reference bounds of all entityDefs in the primary world, culls them
+against the last primary view frustum with the generic and the SSE code and
+with CullBoundsToMVP on each entity, and reports the throughput of each
+====================
+*/
+CONSOLE_COMMAND( testEntityCull, "compares and benchmarks the packed view entity culling", NULL )
+{
+	const idRenderWorldLocal* world = tr.primaryWorld;
+	if( world == NULL || tr.primaryView == NULL )
+	{
+		common->Printf( "no primary view\n" );
+		return;
+	}
+
+	const int passes = ( args.Argc() > 1 ) ? Max( atoi( args.Argv( 1 ) ), 1 ) : 100;
+
+	idList<const idRenderEntityLocal*> defs;
+	for( int i = 0; i < world->entityDefs.Num(); i++ )
+	{
+		if( world->entityDefs[i] != NULL )
+		{
+			defs.Append( world->entityDefs[i] );
+		}
+	}
+	if( defs.Num() == 0 )
+	{
+		common->Printf( "no entities\n" );
+		return;
+	}
+
+	const idPlane* planes = tr.primaryView->frustums[FRUSTUM_PRIMARY];
+	const idRenderMatrix& mvp = tr.primaryView->worldSpace.mvp;
+
+	viewEntityCull_t cull;
+	R_AllocViewEntityCull( cull, defs.Num(), false );
+	idList<byte> genericCulled;
+	idList<byte> referenceCulled;
+	genericCulled.SetNum( defs.Num() );
+	referenceCulled.SetNum( defs.Num() );
+
+	// reference, a full matrix multiply and eight transformed corners per entity
+	uint64_t start = Sys_Microseconds();
+	for( int pass = 0; pass < passes; pass++ )
+	{
+		for( int i = 0; i < defs.Num(); i++ )
+		{
+			idRenderMatrix modelMVP;
+			idRenderMatrix::Multiply( mvp, defs[i]->modelRenderMatrix, modelMVP );
+			referenceCulled[i] = idRenderMatrix::CullBoundsToMVP( modelMVP, defs[i]->localReferenceBounds );
+		}
+	}
+	const uint64_t referenceMicroSec = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	for( int pass = 0; pass < passes; pass++ )
+	{
+		for( int i = 0; i < defs.Num(); i++ )
+		{
+			R_SetViewEntityCullBounds( cull, i, defs[i] );
+		}
+	}
+	const uint64_t packMicroSec = Sys_Microseconds() - start;
+
+	start = Sys_Microseconds();
+	for( int pass = 0; pass < passes; pass++ )
+	{
+		R_CullViewEntitiesToPlanesGeneric( cull, planes, FRUSTUM_PLANES );
+	}
+	const uint64_t genericMicroSec = Sys_Microseconds() - start;
+	memcpy( genericCulled.Ptr(), cull.culled, defs.Num() );
+
+	start = Sys_Microseconds();
+	for( int pass = 0; pass < passes; pass++ )
+	{
+		R_CullViewEntitiesToPlanes( cull, planes, FRUSTUM_PLANES );
+	}
+	const uint64_t packedMicroSec = Sys_Microseconds() - start;
+
+	int numCulled = 0;
+	int numReferenceCulled = 0;
+	int mismatches = 0;
+	int notCulledByReference = 0;
+	for( int i = 0; i < defs.Num(); i++ )
+	{
+		numCulled += cull.culled[i];
+		numReferenceCulled += referenceCulled[i];
+		if( cull.culled[i] != genericCulled[i] )
+		{
+			mismatches++;
+		}
+		// the view frustum near plane is pulled back by r_znear, so this should stay 0
+		if( cull.culled[i] && !referenceCulled[i] )
+		{
+			if( notCulledByReference++ == 0 )
+			{
+				common->Printf( "entity %d culled by the packed test but not by CullBoundsToMVP\n", defs[i]->index );
+			}
+		}
+	}
+
+	Mem_Free16( cull.center[0] );
+
+	const float numTests = ( float )defs.Num() * passes;
+	common->Printf( "%d entities, %d passes, %d culled, %d culled by CullBoundsToMVP, %d generic mismatches\n", defs.Num(), passes, numCulled, numReferenceCulled, mismatches );
+	common->Printf( "CullBoundsToMVP %8.2f ms %8.2f Mentities/s\n", referenceMicroSec / 1000.0f, numTests / Max( referenceMicroSec, ( uint64_t )1 ) );
+	common->Printf( "pack            %8.2f ms %8.2f Mentities/s\n", packMicroSec / 1000.0f, numTests / Max( packMicroSec, ( uint64_t )1 ) );
+	common->Printf( "generic         %8.2f ms %8.2f Mentities/s\n", genericMicroSec / 1000.0f, numTests / Max( genericMicroSec, ( uint64_t )1 ) );
+	common->Printf( "packed          %8.2f ms %8.2f Mentities/s\n", packedMicroSec / 1000.0f, numTests / Max( packedMicroSec, ( uint64_t )1 ) );
+}
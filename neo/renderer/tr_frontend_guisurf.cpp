@@ -195,13 +195,46 @@ static void R_RenderGuiSurf( idUserInterface* gui, const drawSurf_t* drawSurf )
 /*
 ================
 R_AddInGameGuis
+
+Before the visible guis are drawn, their time events, frame scripts and
+expressions are run in parallel jobs, one job per gui. Only guis whose scripts
+don't reach outside the gui are run in jobs, see idUserInterface::TimeEventsAreJobSafe.
+The guis themselves are drawn afterwards in draw surface order, drawing goes
+through the shared device context and the current 2D state of the render system,
+so only one gui at a time can be redrawn.
 ================
 */
+idCVar r_useParallelAddGuis( "r_useParallelAddGuis", "1", CVAR_RENDERER | CVAR_BOOL | CVAR_NOCHEAT, "run the time events and expressions of the visible guis in parallel with jobs" );
+
+struct guiTimeEvents_t
+{
+	idUserInterface* 	gui;
+	int					time;
+};
+
+static void R_RunGuiTimeEvents( guiTimeEvents_t* events )
+{
+	events->gui->RunTimeEvents( events->time );
+}
+
+REGISTER_PARALLEL_JOB( R_RunGuiTimeEvents, "R_RunGuiTimeEvents" );
+
 void R_AddInGameGuis( const drawSurf_t* const drawSurfs[], const int numDrawSurfs )
 {
 	SCOPED_PROFILE_EVENT( "R_AddInGameGuis" );
 
-	// check for gui surfaces
+	if( numDrawSurfs == 0 )
+	{
+		return;
+	}
+
+	const uint64_t cullStartTime = Sys_Microseconds();
+
+	// find the visible gui surfaces
+	const drawSurf_t** guiDrawSurfs = ( const drawSurf_t** )R_FrameAlloc( numDrawSurfs * sizeof( guiDrawSurfs[0] ), FRAME_ALLOC_UNKNOWN );
+	idUserInterface** guis = ( idUserInterface** )R_FrameAlloc( numDrawSurfs * sizeof( guis[0] ), FRAME_ALLOC_UNKNOWN );
+	int numGuiSurfs = 0;
+
 	for( int i = 0; i < numDrawSurfs; i++ )
 	{
 		const drawSurf_t* drawSurf = drawSurfs[i];
@@ -222,13 +255,79 @@ void R_AddInGameGuis( const drawSurf_t* const drawSurfs[], const int numDrawSurf
 		}
 
 		idBounds ndcBounds;
-		if( !R_PreciseCullSurface( drawSurf, ndcBounds ) )
+		if( R_PreciseCullSurface( drawSurf, ndcBounds ) )
 		{
-			// did we ever use this to forward an entity color to a gui that didn't set color?
-			//	memcpy( tr.guiShaderParms, shaderParms, sizeof( tr.guiShaderParms ) );
-			R_RenderGuiSurf( gui, drawSurf );
+			tr.pc.c_guiSurfsCulled++;
+			continue;
 		}
+
+		guiDrawSurfs[numGuiSurfs] = drawSurf;
+		guis[numGuiSurfs] = gui;
+		numGuiSurfs++;
 	}
+
+	const uint64_t eventsStartTime = Sys_Microseconds();
+
+	// run the time events of each gui once, a gui can be on several surfaces
+	if( r_useParallelAddGuis.GetBool() && numGuiSurfs > 1 )
+	{
+		guiTimeEvents_t* events = ( guiTimeEvents_t* )R_FrameAlloc( numGuiSurfs * sizeof( events[0] ), FRAME_ALLOC_UNKNOWN );
+		int numEvents = 0;
+
+		for( int i = 0; i < numGuiSurfs; i++ )
+		{
+			if( !guis[i]->TimeEventsAreJobSafe() )
+			{
+				continue;
+			}
+
+			bool found = false;
+			for( int j = 0; j < numEvents; j++ )
+			{
+				if( events[j].gui == guis[i] )
+				{
+					found = true;
+					break;
+				}
+			}
+			if( found )
+			{
+				continue;
+			}
+
+			events[numEvents].gui = guis[i];
+			events[numEvents].time = tr.viewDef->renderView.time[0];
+			numEvents++;
+		}
+
+		if( numEvents > 1 )
+		{
+			for( int i = 0; i < numEvents; i++ )
+			{
+				tr.frontEndJobList->AddJob( ( jobRun_t )R_RunGuiTimeEvents, &events[i] );
+			}
+			tr.frontEndJobList->Submit();
+			tr.frontEndJobList->Wait();
+
+			tr.pc.c_guiParallelEvents += numEvents;
+		}
+	}
+
+	const uint64_t redrawStartTime = Sys_Microseconds();
+
+	// the guis that weren't run in jobs run their time events in Redraw
+	for( int i = 0; i < numGuiSurfs; i++ )
+	{
+		// did we ever use this to forward an entity color to a gui that didn't set color?
+		//	memcpy( tr.guiShaderParms, shaderParms, sizeof( tr.guiShaderParms ) );
+		R_RenderGuiSurf( guis[i], guiDrawSurfs[i] );
+	}
+
+	const uint64_t endTime = Sys_Microseconds();
+
+	tr.pc.guiCullMicroSec += eventsStartTime - cullStartTime;
+	tr.pc.guiEventsMicroSec += redrawStartTime - eventsStartTime;
+	tr.pc.guiRedrawMicroSec += endTime - redrawStartTime;
 }
 
 /*
@@ -137,7 +137,7 @@ void R_RenderSingleModel( viewEntity_t* vEntity )
 		return;
 	}
 
-	SCOPED_PROFILE_EVENT( renderEntity->hModel == NULL ? "Unknown Model" : renderEntity->hModel->Name() );
+	SCOPED_PROFILE_EVENT_DYNAMIC( renderEntity->hModel == NULL ? "Unknown Model" : renderEntity->hModel->Name() );
 
 	// calculate the znear for testing whether or not the view is inside a shadow projection
 	const float znear = ( viewDef->renderView.cramZNear ) ? ( r_znear.GetFloat() * 0.25f ) : r_znear.GetFloat();
@@ -308,7 +308,7 @@ void R_RenderSingleModel( viewEntity_t* vEntity )
 			shader = tr.primaryRenderView.globalMaterial;
 		}
 
-		SCOPED_PROFILE_EVENT( shader->GetName() );
+		SCOPED_PROFILE_EVENT_DYNAMIC( shader->GetName() );
 
 		// debugging tool to make sure we have the correct pre-calculated bounds
 		if( r_checkBounds.GetBool() )
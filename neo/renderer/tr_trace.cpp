@@ -405,6 +405,61 @@ static void R_TracePointCullSkinned( byte* cullBits, byte& totalOr, const float
 #endif
 }
 
+/*
+====================
+R_TracePlanes
+
+Two planes orthogonal to each other that intersect along the trace,
+and front and end planes so the trace is on the positive sides of both.
+====================
+*/
+void R_TracePlanes( const idVec3& start, const idVec3& end, idPlane planes[4] )
+{
+	idVec3 startDir = end - start;
+	startDir.Normalize();
+	startDir.NormalVectors( planes[0].Normal(), planes[1].Normal() );
+	planes[0][3] = - start * planes[0].Normal();
+	planes[1][3] = - start * planes[1].Normal();
+	planes[2] = startDir;
+	planes[2][3] = - start * planes[2].Normal();
+	planes[3] = -startDir;
+	planes[3][3] = - end * planes[3].Normal();
+}
+
+/*
+====================
+R_TracePointCullBits
+
+The cull bits R_TracePointCullStatic calculates for a single point, evaluated
+in the same order so the results are bit identical.
+====================
+*/
+byte R_TracePointCullBits( const idPlane* planes, const float radius, const idVec3& v )
+{
+	byte bits = 0;
+
+#if defined(USE_INTRINSICS_SSE)
+	for( int i = 0; i < 4; i++ )
+	{
+		const float d = v.x * planes[i][0] + ( v.y * planes[i][1] + ( v.z * planes[i][2] + planes[i][3] ) );
+		bits |= ( ( d + radius ) > 0.0f ) << i;
+		bits |= ( ( d - radius ) < 0.0f ) << ( i + 4 );
+	}
+#else
+	for( int i = 0; i < 4; i++ )
+	{
+		const float d = planes[i].Distance( v );
+		const float t = d + radius;
+		const float s = d - radius;
+		bits |= IEEE_FLT_SIGNBITSET( t ) << i;
+		bits |= IEEE_FLT_SIGNBITSET( s ) << ( i + 4 );
+	}
+	bits ^= 0x0F;		// flip lower four bits
+#endif
+
+	return bits;
+}
+
 /*
 ====================
 R_LineIntersectsTriangleExpandedWithCircle
@@ -412,7 +467,7 @@ R_LineIntersectsTriangleExpandedWithCircle
 The triangle is expanded in the plane with a circle of the given radius.
 ====================
 */
-static bool R_LineIntersectsTriangleExpandedWithCircle( localTrace_t& hit, const idVec3& start, const idVec3& end, const float circleRadius, const idVec3& triVert0, const idVec3& triVert1, const idVec3& triVert2 )
+bool R_LineIntersectsTriangleExpandedWithCircle( localTrace_t& hit, const idVec3& start, const idVec3& end, const float circleRadius, const idVec3& triVert0, const idVec3& triVert1, const idVec3& triVert2 )
 {
 	const idPlane plane( triVert0, triVert1, triVert2 );
 
@@ -603,17 +658,7 @@ localTrace_t R_LocalTrace( const idVec3& start, const idVec3& end, const float r
 	hit.fraction = 1.0f;
 
 	ALIGNTYPE16 idPlane planes[4];
-	// create two planes orthogonal to each other that intersect along the trace
-	idVec3 startDir = end - start;
-	startDir.Normalize();
-	startDir.NormalVectors( planes[0].Normal(), planes[1].Normal() );
-	planes[0][3] = - start * planes[0].Normal();
-	planes[1][3] = - start * planes[1].Normal();
-	// create front and end planes so the trace is on the positive sides of both
-	planes[2] = startDir;
-	planes[2][3] = - start * planes[2].Normal();
-	planes[3] = -startDir;
-	planes[3][3] = - end * planes[3].Normal();
+	R_TracePlanes( start, end, planes );
 
 	// catagorize each point against the four planes
 	byte* cullBits = ( byte* ) _alloca16( ALIGN( tri->numVerts, 4 ) );	// round up to a multiple of 4 for SIMD
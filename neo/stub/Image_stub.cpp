@@ -60,6 +60,10 @@ idImage::idImage( const char* name ) : imgName( name )
 	binaryFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	refCount = 0;
 
+	streamMaxSize = 0;
+	streamSkippedMips = 0;
+	residencyIndex = -1;
+
 	DeferredLoadImage();
 }
 
@@ -128,6 +128,8 @@ public:
 	}
 
 	void Render( idRenderSystem* gui, int time = 0, bool isSplitscreen = false );
+	// advances the timeline by one frame and runs its actions without drawing anything
+	void RunFrame();
 	bool HandleEvent( const sysEvent_t* event );
 	bool InhibitControl();
 	void ForceInhibitControl( bool val )
@@ -484,6 +484,21 @@ void idSWF::Activate( bool b )
 	isActive = b;
 }
 
+/*
+===================
+idSWF::RunFrame
+===================
+*/
+void idSWF::RunFrame()
+{
+	if( !IsLoaded() )
+	{
+		return;
+	}
+	mainspriteInstance->Run();
+	mainspriteInstance->RunActions();
+}
+
 /*
 ===================
 idSWF::InhibitControl
@@ -1033,4 +1048,64 @@ CONSOLE_COMMAND_SHIP( exportFlash, "Export all .bswf files to the exported/swf/
 
 	fileSystem->FreeFileList( files );
 }
-// RB end
\ No newline at end of file
+// RB end
+
+/*
+===================
+swfScriptBenchmark
+
+Runs the timeline of a flash file without rendering and reports how much time the action
+scripts take per frame, once with the member inline caches and once without them.
+===================
+*/
+CONSOLE_COMMAND( swfScriptBenchmark, "<swf> <numFrames> - times the action scripts of a flash file, defaults to the hud", NULL )
+{
+	extern idCVar swf_inlineCache;
+
+	const char* swfName = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "hud";
+	const int numFrames = ( args.Argc() > 2 ) ? idMath::ClampInt( 1, 100000, atoi( args.Argv( 2 ) ) ) : 1000;
+
+	const bool oldInlineCache = swf_inlineCache.GetBool();
+	for( int pass = 0; pass < 2; pass++ )
+	{
+		swf_inlineCache.SetBool( pass == 0 );
+
+		idSWF* swf = new idSWF( swfName, NULL );
+		if( !swf->IsLoaded() )
+		{
+			idLib::Printf( "couldn't load %s\n", swfName );
+			delete swf;
+			break;
+		}
+		swf->Activate( true );
+
+		idSWFScriptFunction_Script::inlineCacheHits = 0;
+		idSWFScriptFunction_Script::inlineCacheMisses = 0;
+
+		int minTime = INT_MAX;
+		int maxTime = 0;
+		int64_t totalTime = 0;
+		for( int i = 0; i < numFrames; i++ )
+		{
+			const uint64_t start = Sys_Microseconds();
+			swf->RunFrame();
+			const int frameTime = ( int )( Sys_Microseconds() - start );
+
+			minTime = Min( minTime, frameTime );
+			maxTime = Max( maxTime, frameTime );
+			totalTime += frameTime;
+		}
+
+		const int lookups = idSWFScriptFunction_Script::inlineCacheHits + idSWFScriptFunction_Script::inlineCacheMisses;
+		idLib::Printf( "%s, inline caches %s: %d frames, %.3f ms/frame avg, %.3f min, %.3f max\n", swfName, ( pass == 0 ) ? "on" : "off",
+					   numFrames, totalTime / ( numFrames * 1000.0f ), minTime / 1000.0f, maxTime / 1000.0f );
+		if( lookups > 0 )
+		{
+			idLib::Printf( "    %d cached member lookups, %.1f%% hits, %d atoms\n", lookups,
+						   100.0f * idSWFScriptFunction_Script::inlineCacheHits / lookups, idSWFScriptAtoms::Num() );
+		}
+
+		delete swf;
+	}
+	swf_inlineCache.SetBool( oldInlineCache );
+}
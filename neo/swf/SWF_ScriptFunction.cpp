@@ -31,6 +31,10 @@ If you have questions concerning this license or the applicable additional terms
 
 idCVar swf_debug( "swf_debug", "0", CVAR_INTEGER | CVAR_ARCHIVE, "debug swf scripts.  1 shows traces/errors.  2 also shows warnings.  3 also shows disassembly.  4 shows parameters in the disassembly." );
 idCVar swf_debugInvoke( "swf_debugInvoke", "0", CVAR_INTEGER, "debug swf functions being called from game." );
+idCVar swf_inlineCache( "swf_inlineCache", "1", CVAR_BOOL, "cache member lookups per action script call site" );
+
+int idSWFScriptFunction_Script::inlineCacheHits = 0;
+int idSWFScriptFunction_Script::inlineCacheMisses = 0;
 
 idSWFConstantPool::idSWFConstantPool()
 {
@@ -699,6 +703,30 @@ const char* GetSwfActionName( swfAction_t code )
 }
 }
 
+/*
+========================
+idSWFScriptFunction_Script::GetInlineCache
+========================
+*/
+swfInlineCache_t* idSWFScriptFunction_Script::GetInlineCache( const byte* site )
+{
+	if( !swf_inlineCache.GetBool() )
+	{
+		return NULL;
+	}
+	if( inlineCaches.Num() == 0 )
+	{
+		inlineCaches.SetNum( INLINE_CACHE_SIZE );
+	}
+	inlineCacheEntry_t& entry = inlineCaches[( uintptr_t )site & ( INLINE_CACHE_SIZE - 1 ) ];
+	if( entry.site != site )
+	{
+		entry.site = site;
+		entry.cache = swfInlineCache_t();
+	}
+	return &entry.cache;
+}
+
 /*
 ========================
 idSWFScriptFunction_Script::Run
@@ -967,10 +995,19 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 			}
 			case Action_GetVariable:
 			{
-				idStr variableName = stack.A().ToString();
+				// hold a reference to the name, stack.A() gets overwritten by the lookup
+				idSWFScriptVar variableName = stack.A();
+				const idSWFScriptString* atomName = variableName.GetScriptString();
 				for( int i = scope.Num() - 1; i >= 0; i-- )
 				{
-					stack.A() = scope[i]->Get( variableName );
+					if( atomName != NULL )
+					{
+						stack.A() = scope[i]->Get( atomName );
+					}
+					else
+					{
+						stack.A() = scope[i]->Get( variableName.ToString() );
+					}
 					if( !stack.A().IsUndefined() )
 					{
 						break;
@@ -978,12 +1015,32 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				}
 				if( stack.A().IsUndefined() && swf_debug.GetInteger() > 1 )
 				{
-					idLib::Printf( "SWF: unknown variable %s\n", variableName.c_str() );
+					idLib::Printf( "SWF: unknown variable %s\n", variableName.ToString().c_str() );
 				}
 				break;
 			}
 			case Action_SetVariable:
 			{
+				const idSWFScriptString* atomName = stack.B().GetScriptString();
+				if( atomName != NULL )
+				{
+					bool found = false;
+					for( int i = scope.Num() - 1; i >= 0; i-- )
+					{
+						if( scope[i]->HasProperty( atomName ) )
+						{
+							scope[i]->Set( atomName, stack.A() );
+							found = true;
+							break;
+						}
+					}
+					if( !found )
+					{
+						thisObject->Set( atomName, stack.A() );
+					}
+					stack.Pop( 2 );
+					break;
+				}
 				idStr variableName = stack.B().ToString();
 				bool found = false;
 				for( int i = scope.Num() - 1; i >= 0; i-- )
@@ -1088,11 +1145,19 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 			case Action_CallFunction:
 			{
 				idStr functionName = stack.A().ToString();
+				const idSWFScriptString* atomName = stack.A().GetScriptString();
 				idSWFScriptVar function;
 				idSWFScriptObject* object = NULL;
 				for( int i = scope.Num() - 1; i >= 0; i-- )
 				{
-					function = scope[i]->Get( functionName );
+					if( atomName != NULL )
+					{
+						function = scope[i]->Get( atomName );
+					}
+					else
+					{
+						function = scope[i]->Get( functionName );
+					}
 					if( !function.IsUndefined() )
 					{
 						object = scope[i];
@@ -1135,7 +1200,15 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 				if( stack.B().IsObject() )
 				{
 					object = stack.B().GetObject();
-					function = object->Get( functionName );
+					const idSWFScriptString* atomName = stack.A().GetScriptString();
+					if( atomName != NULL && !atomName->IsEmpty() )
+					{
+						function = object->Get( atomName, GetInlineCache( bitstream.Ptr() + bitstream.Tell() ) );
+					}
+					else
+					{
+						function = object->Get( functionName );
+					}
 					if( !function.IsFunction() )
 					{
 						idLib::PrintfIf( swf_debug.GetInteger() > 1, "SWF: unknown method %s on %s\n", functionName.c_str(), object->DefaultValue( true ).ToString().c_str() );
@@ -1169,12 +1242,22 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 			}
 			case Action_ConstantPool:
 			{
+				// the pool is already loaded if we ran the same bytecode last time
+				const byte* source = bitstream.Ptr() + bitstream.Tell();
+				if( source == constantsSource )
+				{
+					bitstream.Seek( recordLength );
+					break;
+				}
 				constants.Clear();
 				uint16_t numConstants = bitstream.ReadU16();
 				for( int i = 0; i < numConstants; i++ )
 				{
-					constants.Append( idSWFScriptString::Alloc( bitstream.ReadString() ) );
+					idSWFScriptString* constant = idSWFScriptString::Alloc( bitstream.ReadString() );
+					constant->Intern();
+					constants.Append( constant );
 				}
+				constantsSource = source;
 				break;
 			}
 			case Action_DefineFunction:
@@ -1328,6 +1411,10 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					{
 						stack.B() = object->Get( stack.A().ToInteger() );
 					}
+					else if( stack.A().GetScriptString() != NULL )
+					{
+						stack.B() = object->Get( stack.A().GetScriptString(), GetInlineCache( bitstream.Ptr() + bitstream.Tell() ) );
+					}
 					else
 					{
 						stack.B() = object->Get( stack.A().ToString() );
@@ -1396,6 +1483,10 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 					{
 						object->Set( stack.B().ToInteger(), stack.A() );
 					}
+					else if( stack.B().GetScriptString() != NULL )
+					{
+						object->Set( stack.B().GetScriptString(), stack.A(), GetInlineCache( bitstream.Ptr() + bitstream.Tell() ) );
+					}
 					else
 					{
 						object->Set( stack.B().ToString(), stack.A() );
@@ -1675,6 +1766,12 @@ idSWFScriptVar idSWFScriptFunction_Script::Run( idSWFScriptObject* thisObject, i
 			}
 			case Action_DefineLocal:
 			{
+				if( stack.B().GetScriptString() != NULL )
+				{
+					scope[scope.Num() - 1]->Set( stack.B().GetScriptString(), stack.A() );
+					stack.Pop( 2 );
+					break;
+				}
 				scope[scope.Num() - 1]->Set( stack.B().ToString(), stack.A() );
 				stack.Pop( 2 );
 				break;
@@ -185,7 +185,7 @@ idSWFScriptFunction_Script is a script function that's implemented in action scr
 class idSWFScriptFunction_Script : public idSWFScriptFunction
 {
 public:
-	idSWFScriptFunction_Script() : refCount( 1 ), flags( 0 ), data( NULL ), length( 0 ), prototype( NULL ), defaultSprite( NULL )
+	idSWFScriptFunction_Script() : refCount( 1 ), flags( 0 ), data( NULL ), length( 0 ), prototype( NULL ), defaultSprite( NULL ), constantsSource( NULL )
 	{
 		registers.SetNum( 4 );
 	}
@@ -221,6 +221,7 @@ public:
 	void	SetConstants( const idSWFConstantPool& _constants )
 	{
 		constants.Copy( _constants );
+		constantsSource = NULL;
 	}
 	void	SetDefaultSprite( idSWFSpriteInstance* _sprite )
 	{
@@ -253,6 +254,10 @@ public:
 
 	virtual idSWFScriptVar	Call( idSWFScriptObject* thisObject, const idSWFParmList& parms );
 
+	// inline cache statistics, reported by swfScriptBenchmark
+	static int	inlineCacheHits;
+	static int	inlineCacheMisses;
+
 	// RB begin
 	idStr CallToScript( idSWFScriptObject* thisObject, const idSWFParmList& parms, const char* filename, int characterID, int actionID );
 
@@ -293,8 +298,22 @@ private:
 	idList< idSWFScriptObject*, TAG_SWF > scope;
 
 	idSWFConstantPool	constants;
+	const byte* 		constantsSource;	// bytecode the constant pool was loaded from
 	idList< idSWFScriptVar, TAG_SWF > registers;
 
+	// member lookups are cached per call site, keyed on the bytecode address of the action
+	struct inlineCacheEntry_t
+	{
+		inlineCacheEntry_t() : site( NULL ) { }
+
+		const byte* 		site;
+		swfInlineCache_t	cache;
+	};
+	static const int INLINE_CACHE_SIZE = 32;
+	idList< inlineCacheEntry_t, TAG_SWF > inlineCaches;
+
+	swfInlineCache_t* 	GetInlineCache( const byte* site );
+
 	struct parmInfo_t
 	{
 		const char* name;
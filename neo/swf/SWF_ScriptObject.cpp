@@ -30,6 +30,8 @@ If you have questions concerning this license or the applicable additional terms
 
 idCVar swf_debugShowAddress( "swf_debugShowAddress", "0", CVAR_BOOL, "shows addresses along with object types when they are serialized" );
 
+idSysInterlockedInteger idSWFScriptObject::shapeCounter;
+
 
 /*
 ========================
@@ -52,6 +54,8 @@ idSWFScriptObject::swfNamedVar_t& idSWFScriptObject::swfNamedVar_t::operator=( c
 		index = other.index;
 		name = other.name;
 		hashNext = other.hashNext;
+		nameHash = other.nameHash;
+		atom = other.atom;
 		value = other.value;
 		native = other.native;
 		flags = other.flags;
@@ -64,7 +68,7 @@ idSWFScriptObject::swfNamedVar_t& idSWFScriptObject::swfNamedVar_t::operator=( c
 idSWFScriptObject::idSWFScriptObject
 ========================
 */
-idSWFScriptObject::idSWFScriptObject() : refCount( 1 ), noAutoDelete( false ), prototype( NULL ), objectType( SWF_OBJECT_OBJECT )
+idSWFScriptObject::idSWFScriptObject() : refCount( 1 ), noAutoDelete( false ), shape( -1 ), prototype( NULL ), objectType( SWF_OBJECT_OBJECT )
 {
 	data.sprite = NULL;
 	data.text = NULL;
@@ -130,6 +134,7 @@ void idSWFScriptObject::Clear()
 	{
 		variablesHash[i] = -1;
 	}
+	shape = NewShape();
 }
 
 /*
@@ -331,10 +336,11 @@ void idSWFScriptObject::Set( const char* name, const idSWFScriptVar& value )
 			}
 			for( int i = 0; i < variables.Num(); i++ )
 			{
-				int hash = idStr::Hash( variables[i].name.c_str() ) & ( VARIABLE_HASH_BUCKETS - 1 );
+				int hash = variables[i].nameHash & ( VARIABLE_HASH_BUCKETS - 1 );
 				variables[i].hashNext = variablesHash[hash];
 				variablesHash[hash] = i;
 			}
+			shape = NewShape();
 		}
 		else
 		{
@@ -397,6 +403,74 @@ void idSWFScriptObject::Set( int index, const idSWFScriptVar& value )
 	}
 }
 
+/*
+========================
+idSWFScriptObject::HasProperty
+========================
+*/
+bool idSWFScriptObject::HasProperty( const idSWFScriptString* name )
+{
+	if( !name->IsInterned() )
+	{
+		return HasProperty( name->c_str() );
+	}
+	return ( GetVariable( name, false, NULL ) != NULL );
+}
+
+/*
+========================
+idSWFScriptObject::Get
+========================
+*/
+idSWFScriptVar idSWFScriptObject::Get( const idSWFScriptString* name, swfInlineCache_t* cache )
+{
+	if( !name->IsInterned() )
+	{
+		return Get( name->c_str() );
+	}
+	swfNamedVar_t* variable = GetVariable( name, false, cache );
+	if( variable == NULL )
+	{
+		return idSWFScriptVar();
+	}
+	else
+	{
+		if( variable->native )
+		{
+			return variable->native->Get( this );
+		}
+		else
+		{
+			return variable->value;
+		}
+	}
+}
+
+/*
+========================
+idSWFScriptObject::Set
+========================
+*/
+void idSWFScriptObject::Set( const idSWFScriptString* name, const idSWFScriptVar& value, swfInlineCache_t* cache )
+{
+	if( !name->IsInterned() || objectType == SWF_OBJECT_ARRAY )
+	{
+		// arrays have to maintain their length
+		Set( name->c_str(), value );
+		return;
+	}
+
+	swfNamedVar_t* variable = GetVariable( name, true, cache );
+	if( variable->native )
+	{
+		variable->native->Set( this, value );
+	}
+	else if( ( variable->flags & SWF_VAR_FLAG_READONLY ) == 0 )
+	{
+		variable->value = value;
+	}
+}
+
 /*
 ========================
 idSWFScriptObject::SetNative
@@ -486,6 +560,30 @@ idSWFScriptVar idSWFScriptObject::DefaultValue( bool stringHint )
 	return idSWFScriptVar( "[unknown]" );
 }
 
+/*
+========================
+idSWFScriptObject::CreateVariable
+
+atom is -1 for names that aren't interned, those variables are only found by the
+string compare fallback of the atom lookup
+========================
+*/
+idSWFScriptObject::swfNamedVar_t* idSWFScriptObject::CreateVariable( const char* name, int nameHash, int index, int atom )
+{
+	swfNamedVar_t* variable = &variables.Alloc();
+	variable->flags = SWF_VAR_FLAG_NONE;
+	variable->index = index;
+	variable->name = name;
+	variable->nameHash = nameHash;
+	variable->atom = atom;
+	variable->native = NULL;
+	int hash = nameHash & ( VARIABLE_HASH_BUCKETS - 1 );
+	variable->hashNext = variablesHash[hash];
+	variablesHash[hash] = variables.Num() - 1;
+	shape = NewShape();
+	return variable;
+}
+
 /*
 ========================
 idSWFScriptObject::GetVariable
@@ -502,15 +600,9 @@ idSWFScriptObject::swfNamedVar_t* idSWFScriptObject::GetVariable( int index, boo
 	}
 	if( create )
 	{
-		swfNamedVar_t* variable = &variables.Alloc();
-		variable->flags = SWF_VAR_FLAG_NONE;
-		variable->index = index;
-		variable->name = va( "%d", index );
-		variable->native = NULL;
-		int hash = idStr::Hash( variable->name ) & ( VARIABLE_HASH_BUCKETS - 1 );
-		variable->hashNext = variablesHash[hash];
-		variablesHash[hash] = variables.Num() - 1;
-		return variable;
+		// array elements never get an atom
+		const char* name = va( "%d", index );
+		return CreateVariable( name, idStr::Hash( name ), index, -1 );
 	}
 	return NULL;
 }
@@ -522,20 +614,116 @@ idSWFScriptObject::GetVariable
 */
 idSWFScriptObject::swfNamedVar_t* idSWFScriptObject::GetVariable( const char* name, bool create )
 {
-	int hash = idStr::Hash( name ) & ( VARIABLE_HASH_BUCKETS - 1 );
+	return GetVariable( name, idStr::Hash( name ), create );
+}
+
+/*
+========================
+idSWFScriptObject::GetVariable
+========================
+*/
+idSWFScriptObject::swfNamedVar_t* idSWFScriptObject::GetVariable( const char* name, int nameHash, bool create )
+{
+	int hash = nameHash & ( VARIABLE_HASH_BUCKETS - 1 );
+	for( int i = variablesHash[hash]; i >= 0; i = variables[i].hashNext )
+	{
+		if( variables[i].nameHash == nameHash && variables[i].name == name )
+		{
+			return &variables[i];
+		}
+	}
+
+	if( prototype != NULL )
+	{
+		swfNamedVar_t* variable = prototype->GetVariable( name, nameHash, false );
+		if( ( variable != NULL ) && ( variable->native || !create ) )
+		{
+			// If the variable is native, we want to pull it from the prototype even if we're going to set it
+			return variable;
+		}
+	}
+
+	if( create )
+	{
+		int index = atoi( name );
+		if( index == 0 && idStr::Cmp( name, "0" ) != 0 )
+		{
+			index = -1;
+		}
+		// only names that are already interned by a constant pool get an atom, dynamic
+		// names would grow the global atom table forever
+		return CreateVariable( name, nameHash, index, ( index >= 0 ) ? -1 : idSWFScriptAtoms::Find( name, nameHash ) );
+	}
+	return NULL;
+}
+
+/*
+========================
+idSWFScriptObject::GetVariable
+
+Same as above but compares atoms instead of strings and remembers where the variable
+was found in the call site's inline cache. Only own variables and variables of the
+direct prototype are cached, deeper lookups always take the slow path.
+========================
+*/
+idSWFScriptObject::swfNamedVar_t* idSWFScriptObject::GetVariable( const idSWFScriptString* name, bool create, swfInlineCache_t* cache )
+{
+	const int atom = name->GetAtom();
+	assert( atom >= 0 );
+
+	if( cache != NULL && cache->atom == atom && cache->shape == shape )
+	{
+		if( cache->protoShape == -1 )
+		{
+			idSWFScriptFunction_Script::inlineCacheHits++;
+			return &variables[ cache->index ];
+		}
+		if( prototype != NULL && prototype->shape == cache->protoShape )
+		{
+			swfNamedVar_t* variable = &prototype->variables[ cache->index ];
+			if( variable->native || !create )
+			{
+				idSWFScriptFunction_Script::inlineCacheHits++;
+				return variable;
+			}
+		}
+	}
+
+	if( cache != NULL )
+	{
+		idSWFScriptFunction_Script::inlineCacheMisses++;
+	}
+
+	int hash = name->GetHash() & ( VARIABLE_HASH_BUCKETS - 1 );
 	for( int i = variablesHash[hash]; i >= 0; i = variables[i].hashNext )
 	{
-		if( variables[i].name == name )
+		// variables created before their name was interned have no atom
+		if( variables[i].atom == atom || ( variables[i].atom < 0 && variables[i].nameHash == name->GetHash() && variables[i].name == name->c_str() ) )
 		{
+			if( cache != NULL )
+			{
+				cache->atom = atom;
+				cache->shape = shape;
+				cache->protoShape = -1;
+				cache->index = i;
+			}
 			return &variables[i];
 		}
 	}
 
 	if( prototype != NULL )
 	{
-		swfNamedVar_t* variable = prototype->GetVariable( name, false );
+		swfNamedVar_t* variable = prototype->GetVariable( name, false, NULL );
 		if( ( variable != NULL ) && ( variable->native || !create ) )
 		{
+			const int protoIndex = variable - prototype->variables.Ptr();
+			if( cache != NULL && protoIndex >= 0 && protoIndex < prototype->variables.Num() )
+			{
+				cache->atom = atom;
+				cache->shape = shape;
+				cache->protoShape = prototype->shape;
+				cache->index = protoIndex;
+			}
 			// If the variable is native, we want to pull it from the prototype even if we're going to set it
 			return variable;
 		}
@@ -543,18 +731,12 @@ idSWFScriptObject::swfNamedVar_t* idSWFScriptObject::GetVariable( const char* na
 
 	if( create )
 	{
-		swfNamedVar_t* variable = &variables.Alloc();
-		variable->flags = SWF_VAR_FLAG_NONE;
-		variable->index = atoi( name );
-		if( variable->index == 0 && idStr::Cmp( name, "0" ) != 0 )
+		int index = atoi( name->c_str() );
+		if( index == 0 && name->Cmp( "0" ) != 0 )
 		{
-			variable->index = -1;
+			index = -1;
 		}
-		variable->name = name;
-		variable->native = NULL;
-		variable->hashNext = variablesHash[hash];
-		variablesHash[hash] = variables.Num() - 1;
-		return variable;
+		return CreateVariable( name->c_str(), name->GetHash(), index, atom );
 	}
 	return NULL;
 }
@@ -97,6 +97,23 @@ protected:
 		idSWFScriptVar Get( class idSWFScriptObject * object ) { return pThis->z; }	\
 	} swfScriptVar_##x;
 
+/*
+========================
+Per call site cache of a property lookup.
+The shape of an object changes whenever a variable is added or removed, and shapes are
+never reused, so a matching shape means the variable is still at the cached index.
+========================
+*/
+struct swfInlineCache_t
+{
+	swfInlineCache_t() : atom( -1 ), shape( -1 ), protoShape( -1 ), index( -1 ) { }
+
+	int		atom;
+	int		shape;			// shape of the object the lookup started on
+	int		protoShape;		// shape of the prototype the variable was found on, -1 if it's an own variable
+	int		index;
+};
+
 /*
 ========================
 An object in an action script is a collection of variables. functions are also variables.
@@ -150,6 +167,7 @@ public:
 		assert( prototype == NULL );
 		prototype = _prototype;
 		prototype->AddRef();
+		shape = NewShape();
 	}
 	idSWFScriptVar			Get( int index );
 	idSWFScriptVar			Get( const char* name );
@@ -164,6 +182,11 @@ public:
 	void					SetNative( const char* name, idSWFScriptNativeVariable* native );
 	bool					HasProperty( const char* name );
 	bool					HasValidProperty( const char* name );
+
+	// fast paths for interned names, used by the script interpreter
+	idSWFScriptVar			Get( const idSWFScriptString* name, swfInlineCache_t* cache = NULL );
+	void					Set( const idSWFScriptString* name, const idSWFScriptVar& value, swfInlineCache_t* cache = NULL );
+	bool					HasProperty( const idSWFScriptString* name );
 	idSWFScriptVar			DefaultValue( bool stringHint );
 
 	// This is to implement for-in (fixme: respect DONTENUM flag)
@@ -201,6 +224,8 @@ private:
 
 		int							index;
 		int							hashNext;
+		int							nameHash;
+		int							atom;
 		idStr						name;
 		idSWFScriptVar				value;
 		idSWFScriptNativeVariable* 	native;
@@ -211,6 +236,14 @@ private:
 	static const int VARIABLE_HASH_BUCKETS = 16;
 	int	variablesHash[VARIABLE_HASH_BUCKETS];
 
+	int						shape;
+	static idSysInterlockedInteger	shapeCounter;
+
+	static int				NewShape()
+	{
+		return shapeCounter.Increment();
+	}
+
 	idSWFScriptObject* 		prototype;
 
 	enum swfObjectType_t
@@ -229,6 +262,9 @@ private:
 
 	swfNamedVar_t* 	GetVariable( int index, bool create );
 	swfNamedVar_t* 	GetVariable( const char* name, bool create );
+	swfNamedVar_t* 	GetVariable( const char* name, int nameHash, bool create );
+	swfNamedVar_t* 	GetVariable( const idSWFScriptString* name, bool create, swfInlineCache_t* cache );
+	swfNamedVar_t* 	CreateVariable( const char* name, int nameHash, int index, int atom );
 };
 
 #endif // !__SWF_SCRIPTOBJECT_H__
@@ -30,6 +30,75 @@ If you have questions concerning this license or the applicable additional terms
 
 extern idCVar swf_debugShowAddress;
 
+static idSysMutex	atomMutex;
+static idStrList	atomNames;
+static idHashIndex	atomHash;
+
+/*
+========================
+idSWFScriptAtoms::Intern
+========================
+*/
+int idSWFScriptAtoms::Intern( const char* name, int hash )
+{
+	idScopedCriticalSection lock( atomMutex );
+
+	for( int i = atomHash.First( hash ); i != -1; i = atomHash.Next( i ) )
+	{
+		if( atomNames[i].Cmp( name ) == 0 )
+		{
+			return i;
+		}
+	}
+	int atom = atomNames.Append( name );
+	atomHash.Add( hash, atom );
+	return atom;
+}
+
+/*
+========================
+idSWFScriptAtoms::Find
+========================
+*/
+int idSWFScriptAtoms::Find( const char* name, int hash )
+{
+	idScopedCriticalSection lock( atomMutex );
+
+	for( int i = atomHash.First( hash ); i != -1; i = atomHash.Next( i ) )
+	{
+		if( atomNames[i].Cmp( name ) == 0 )
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/*
+========================
+idSWFScriptAtoms::Num
+========================
+*/
+int idSWFScriptAtoms::Num()
+{
+	idScopedCriticalSection lock( atomMutex );
+	return atomNames.Num();
+}
+
+/*
+========================
+idSWFScriptString::Intern
+========================
+*/
+void idSWFScriptString::Intern()
+{
+	if( atom < 0 )
+	{
+		hash = idStr::Hash( c_str() );
+		atom = idSWFScriptAtoms::Intern( c_str(), hash );
+	}
+}
+
 /*
 ========================
 idSWFScriptVar::idSWFScriptVar
@@ -39,7 +39,7 @@ A reference counted string
 class idSWFScriptString : public idStr
 {
 public:
-	idSWFScriptString( const idStr& s ) : idStr( s ), refCount( 1 ) { }
+	idSWFScriptString( const idStr& s ) : idStr( s ), refCount( 1 ), atom( -1 ), hash( 0 ) { }
 
 	static idSWFScriptString* Alloc( const idStr& s )
 	{
@@ -57,8 +57,41 @@ public:
 		}
 	}
 
+	// property names from the constant pool are interned when the pool is loaded
+	// so the interpreter can look them up without hashing or comparing strings
+	void			Intern();
+	bool			IsInterned() const
+	{
+		return ( atom >= 0 );
+	}
+	int				GetAtom() const
+	{
+		return atom;
+	}
+	int				GetHash() const
+	{
+		return hash;
+	}
+
 private:
 	std::atomic<int> refCount;
+	int				atom;
+	int				hash;
+};
+
+/*
+========================
+Global table of interned property names
+========================
+*/
+class idSWFScriptAtoms
+{
+public:
+	// returns the atom for name, creating it if it doesn't exist yet
+	static int		Intern( const char* name, int hash );
+	// returns the atom for name, or -1 if it was never interned
+	static int		Find( const char* name, int hash );
+	static int		Num();
 };
 
 /*
@@ -191,6 +224,12 @@ public:
 	bool	ToBool() const;
 	int32_t	ToInteger() const;
 
+	// returns NULL if this isn't a reference counted string
+	idSWFScriptString* 		GetScriptString() const
+	{
+		return ( type == SWF_VAR_STRING ) ? value.string : NULL;
+	}
+
 	idSWFScriptObject* 		GetObject()
 	{
 		assert( type == SWF_VAR_OBJECT );
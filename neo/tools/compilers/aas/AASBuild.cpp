@@ -55,6 +55,9 @@ idAASBuild::idAASBuild()
 	numMergedLeafNodes = 0;
 	numLedgeSubdivisions = 0;
 	ledgeMap = NULL;
+	mapFile = NULL;
+	startTime = 0;
+	memset( phaseTime, 0, sizeof( phaseTime ) );
 }
 
 /*
@@ -80,6 +83,13 @@ void idAASBuild::Shutdown()
 		delete file;
 		file = NULL;
 	}
+	if( mapFile )
+	{
+		delete mapFile;
+		mapFile = NULL;
+	}
+	brushList.Free();
+	entityClassNames.Clear();
 	DeleteProcBSP();
 	numGravitationalSubdivisions = 0;
 	numMergedLeafNodes = 0;
@@ -804,38 +814,180 @@ void idAASBuild::ChangeMultipleBoundingBoxContents_r( idBrushBSPNode* node, int
 	}
 }
 
+//===============================================================
+//
+//	Parallel builds
+//
+//===============================================================
+
+#define AAS_REACH_JOB_AREAS		32
+
+static int aasNumThreads = 0;		// 0 = all cores, 1 = serial
+
+struct aasReachJob_t
+{
+	idAASBuild* 			build;
+	int						firstArea;
+	int						numAreas;
+	uint64_t				time;
+};
+
 /*
 ============
-idAASBuild::Build
+AASReachJob
 ============
 */
-bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
+static void AASReachJob( aasReachJob_t* job )
 {
-	int i, bit, mask, startTime;
-	idMapFile* mapFile;
-	idBrushList brushList;
-	idList<idBrushList*> expandedBrushes;
-	idBrush* b;
-	idBrushBSP bsp;
-	idStr name;
-	idAASReach reach;
-	idAASCluster cluster;
-	idStrList entityClassNames;
+	const uint64_t start = Sys_Microseconds();
+	for( int i = 0; i < job->numAreas; i++ )
+	{
+		job->build->BuildAreaReachability( job->firstArea + i );
+	}
+	job->time = Sys_Microseconds() - start;
+}
+
+REGISTER_PARALLEL_JOB( AASReachJob, "AASReachJob" );
+
+/*
+============
+AAS_BuildReachability
+
+Calculates the reachabilities of all builds in one job list. An area only adds
+reachabilities to itself, so the result does not depend on the job order.
+The reachability times of parallel builds are summed over the job threads.
+============
+*/
+static void AAS_BuildReachability( idAASBuild** builds, int numBuilds )
+{
+	int numAreas = 0;
+	for( int i = 0; i < numBuilds; i++ )
+	{
+		numAreas += builds[i]->GetNumAreas() - 1;
+	}
+
+	common->DmapPacifierCompileProgressTotal( numAreas );
+
+	if( aasNumThreads == 1 )
+	{
+		for( int i = 0; i < numBuilds; i++ )
+		{
+			const uint64_t start = Sys_Microseconds();
+			int lastPercent = -1;
+			for( int j = 1; j < builds[i]->GetNumAreas(); j++, common->DmapPacifierCompileProgressIncrement( 1 ) )
+			{
+				builds[i]->BuildAreaReachability( j );
+
+#if !defined( DMAP )
+				int percent = 100 * j / builds[i]->GetNumAreas();
+				if( percent > lastPercent )
+				{
+					common->Printf( "\r%6d%%", percent );
+					lastPercent = percent;
+				}
+#endif
+			}
+			builds[i]->AddPhaseTime( AAS_PHASE_REACHABILITY, Sys_Microseconds() - start );
+		}
+		return;
+	}
+
+	idList<aasReachJob_t> jobs;
+	for( int i = 0; i < numBuilds; i++ )
+	{
+		for( int j = 1; j < builds[i]->GetNumAreas(); j += AAS_REACH_JOB_AREAS )
+		{
+			aasReachJob_t& job = jobs.Alloc();
+			job.build = builds[i];
+			job.firstArea = j;
+			job.numAreas = Min( AAS_REACH_JOB_AREAS, builds[i]->GetNumAreas() - j );
+			job.time = 0;
+		}
+	}
+
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, Max( jobs.Num(), 1 ), 0, NULL );
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		jobList->AddJob( ( jobRun_t )AASReachJob, &jobs[i] );
+	}
+	jobList->Submit( NULL, ( aasNumThreads > 0 ) ? aasNumThreads : JOBLIST_PARALLELISM_MAX_CORES );
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		jobs[i].build->AddPhaseTime( AAS_PHASE_REACHABILITY, jobs[i].time );
+	}
+
+	common->DmapPacifierCompileProgressIncrement( numAreas );
+}
+
+/*
+============
+idAASBuild::EndPhase
+
+Adds the time since start to the phase and returns the current time for the next phase
+============
+*/
+uint64_t idAASBuild::EndPhase( aasBuildPhase_t phase, uint64_t start )
+{
+	const uint64_t now = Sys_Microseconds();
+	phaseTime[phase] += now - start;
+	return now;
+}
+
+/*
+============
+idAASBuild::PrintPhaseTimes
+============
+*/
+void idAASBuild::PrintPhaseTimes() const
+{
+	static const char* phaseNames[AAS_NUM_PHASES] =
+	{
+		"Load Map",
+		"Brush BSP",
+		"Subdivision",
+		"Store AAS",
+		"Reachability",
+		"Clustering",
+		"Write AAS"
+	};
+
+	common->Printf( "----- AAS phases (%s) -----\n", aasSettings->fileExtension.c_str() );
+	for( int i = 0; i < AAS_NUM_PHASES; i++ )
+	{
+		common->Printf( "%9.1f ms %s\n", phaseTime[i] * 0.001f, phaseNames[i] );
+	}
+}
+
+/*
+============
+idAASBuild::LoadMap
+
+Returns false if the map has no entities that use this AAS file
+============
+*/
+bool idAASBuild::LoadMap( const idStr& fileName, const idAASSettings* settings )
+{
+	uint64_t phaseStart = Sys_Microseconds();
 
 	startTime = Sys_Milliseconds();
 
 	Shutdown();
+	memset( phaseTime, 0, sizeof( phaseTime ) );
 
 	aasSettings = settings;
 
-	name = fileName;
-	name.SetFileExtension( "map" );
+	mapName = fileName;
+	mapName.SetFileExtension( "map" );
 
 	mapFile = new idMapFile;
-	if( !mapFile->Parse( name ) )
+	if( !mapFile->Parse( mapName ) )
 	{
 		delete mapFile;
-		common->Error( "Couldn't load map file: '%s'", name.c_str() );
+		mapFile = NULL;
+		common->Error( "Couldn't load map file: '%s'", mapName.c_str() );
 		return false;
 	}
 
@@ -843,13 +995,14 @@ bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
 	if( !CheckForEntities( mapFile, entityClassNames ) )
 	{
 		delete mapFile;
+		mapFile = NULL;
 		common->Printf( "no entities in map that use %s\n", settings->fileExtension.c_str() );
-		return true;
+		return false;
 	}
 
-	name.SetFileExtension( aasSettings->fileExtension );
-	common->DmapPacifierFilename( name, "Compiling AAS" );
-	name.SetFileExtension( "map" );
+	mapName.SetFileExtension( aasSettings->fileExtension );
+	common->DmapPacifierFilename( mapName, "Compiling AAS" );
+	mapName.SetFileExtension( "map" );
 
 	// load map file brushes
 	brushList = AddBrushesForMapFile( mapFile, brushList );
@@ -858,7 +1011,8 @@ bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
 	if( brushList.Num() == 0 )
 	{
 		delete mapFile;
-		common->Error( "%s is empty", name.c_str() );
+		mapFile = NULL;
+		common->Error( "%s is empty", mapName.c_str() );
 		return false;
 	}
 
@@ -872,6 +1026,26 @@ bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
 		DeleteProcBSP();
 	}
 
+	EndPhase( AAS_PHASE_LOAD_MAP, phaseStart );
+
+	return true;
+}
+
+/*
+============
+idAASBuild::BuildAreas
+
+Builds the areas from the loaded map brushes, returns false if the map leaks
+============
+*/
+bool idAASBuild::BuildAreas()
+{
+	int i, bit, mask;
+	idList<idBrushList*> expandedBrushes;
+	idBrush* b;
+	idBrushBSP bsp;
+	uint64_t phaseStart = Sys_Microseconds();
+
 	// make copies of the brush list
 	expandedBrushes.Append( &brushList );
 	for( i = 1; i < aasSettings->numBoundingBoxes; i++ )
@@ -901,11 +1075,12 @@ bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
 
 	if( aasSettings->writeBrushMap )
 	{
-		bsp.WriteBrushMap( fileName, "_" + aasSettings->fileExtension, AREACONTENTS_SOLID );
+		bsp.WriteBrushMap( mapName, "_" + aasSettings->fileExtension, AREACONTENTS_SOLID );
 	}
 
-	// build BSP tree from brushes
+	// build BSP tree from brushes, the tree takes over the brushes
 	bsp.Build( brushList, AREACONTENTS_SOLID, ExpandedChopAllowed, ExpandedMergeAllowed );
+	brushList.Clear();
 
 	// only solid nodes with all bits set for all bounding boxes need to stay solid
 	ChangeMultipleBoundingBoxContents_r( bsp.GetRootNode(), mask );
@@ -916,12 +1091,23 @@ bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
 	// remove subspaces not reachable by entities
 	if( !bsp.RemoveOutside( mapFile, AREACONTENTS_SOLID, entityClassNames ) )
 	{
-		bsp.LeakFile( name );
-		delete mapFile;
-		common->Printf( "%s has no outside", name.c_str() );
+		if( AAS_BuildLogActive() )
+		{
+			// the file system is not thread safe, but the main thread only waits for the jobs
+			static idSysMutex leakFileMutex;
+			idScopedCriticalSection lock( leakFileMutex );
+			bsp.LeakFile( mapName );
+		}
+		else
+		{
+			bsp.LeakFile( mapName );
+		}
+		AAS_Printf( "%s has no outside", mapName.c_str() );
 		return false;
 	}
 
+	phaseStart = EndPhase( AAS_PHASE_BSP, phaseStart );
+
 	// gravitational subdivision
 	GravitationalSubdivision( bsp );
 
@@ -933,7 +1119,7 @@ bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
 
 	if( aasSettings->writeBrushMap )
 	{
-		WriteLedgeMap( fileName, "_" + aasSettings->fileExtension + "_ledge" );
+		WriteLedgeMap( mapName, "_" + aasSettings->fileExtension + "_ledge" );
 	}
 
 	// ledge subdivisions
@@ -948,12 +1134,62 @@ bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
 	// melt portal windings
 	bsp.MeltPortals( AREACONTENTS_SOLID );
 
+	phaseStart = EndPhase( AAS_PHASE_SUBDIVISION, phaseStart );
+
 	// store the file from the bsp tree
 	StoreFile( bsp );
 	file->settings = *aasSettings;
 
-	// calculate reachability
-	reach.Build( mapFile, file );
+	EndPhase( AAS_PHASE_STORE, phaseStart );
+
+	return true;
+}
+
+/*
+============
+idAASBuild::BeginReachability
+============
+*/
+void idAASBuild::BeginReachability()
+{
+	uint64_t phaseStart = Sys_Microseconds();
+	reach.BeginBuild( mapFile, file );
+	EndPhase( AAS_PHASE_REACHABILITY, phaseStart );
+}
+
+/*
+============
+idAASBuild::BuildAreaReachability
+
+Thread safe for different areas, the time is added by the caller
+============
+*/
+void idAASBuild::BuildAreaReachability( int areaNum )
+{
+	reach.BuildArea( areaNum );
+}
+
+/*
+============
+idAASBuild::FinishReachability
+============
+*/
+void idAASBuild::FinishReachability()
+{
+	uint64_t phaseStart = Sys_Microseconds();
+	reach.FinishBuild();
+	EndPhase( AAS_PHASE_REACHABILITY, phaseStart );
+}
+
+/*
+============
+idAASBuild::BuildClusters
+============
+*/
+void idAASBuild::BuildClusters()
+{
+	idAASCluster cluster;
+	uint64_t phaseStart = Sys_Microseconds();
 
 	// build clusters
 	cluster.Build( file );
@@ -964,15 +1200,63 @@ bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
 		file->Optimize();
 	}
 
+	EndPhase( AAS_PHASE_CLUSTERING, phaseStart );
+}
+
+/*
+============
+idAASBuild::WriteFile
+============
+*/
+void idAASBuild::WriteFile()
+{
+	idStr name;
+	uint64_t phaseStart = Sys_Microseconds();
+
 	// write the file
+	name = mapName;
 	name.SetFileExtension( aasSettings->fileExtension );
 	file->Write( name, mapFile->GetGeometryCRC() );
 
 	// delete the map file
 	delete mapFile;
+	mapFile = NULL;
+
+	EndPhase( AAS_PHASE_WRITE, phaseStart );
 
 	common->Printf( "%6d seconds to create AAS\n", ( Sys_Milliseconds() - startTime ) / 1000 );
 	common->DmapPacifierInfo( "%6d seconds to create AAS\n", ( Sys_Milliseconds() - startTime ) / 1000 );
+}
+
+/*
+============
+idAASBuild::Build
+============
+*/
+bool idAASBuild::Build( const idStr& fileName, const idAASSettings* settings )
+{
+	idAASBuild* build = this;
+
+	if( !LoadMap( fileName, settings ) )
+	{
+		return true;
+	}
+
+	if( !BuildAreas() )
+	{
+		Shutdown();
+		return false;
+	}
+
+	BeginReachability();
+	AAS_BuildReachability( &build, 1 );
+	FinishReachability();
+
+	BuildClusters();
+
+	WriteFile();
+
+	PrintPhaseTimes();
 
 	return true;
 }
@@ -984,33 +1268,37 @@ idAASBuild::BuildReachability
 */
 bool idAASBuild::BuildReachability( const idStr& fileName, const idAASSettings* settings )
 {
-	int startTime;
-	idMapFile* mapFile;
 	idStr name;
-	idAASReach reach;
 	idAASCluster cluster;
+	idAASBuild* build = this;
+
+	Shutdown();
+	memset( phaseTime, 0, sizeof( phaseTime ) );
 
 	startTime = Sys_Milliseconds();
 
 	aasSettings = settings;
 
-	name = fileName;
-	name.SetFileExtension( "map" );
+	mapName = fileName;
+	mapName.SetFileExtension( "map" );
 
 	mapFile = new idMapFile;
-	if( !mapFile->Parse( name ) )
+	if( !mapFile->Parse( mapName ) )
 	{
 		delete mapFile;
-		common->Error( "Couldn't load map file: '%s'", name.c_str() );
+		mapFile = NULL;
+		common->Error( "Couldn't load map file: '%s'", mapName.c_str() );
 		return false;
 	}
 
 	file = new idAASFileLocal();
 
+	name = mapName;
 	name.SetFileExtension( aasSettings->fileExtension );
 	if( !file->Load( name, 0 ) )
 	{
 		delete mapFile;
+		mapFile = NULL;
 		common->Error( "Couldn't load AAS file: '%s'", name.c_str() );
 		return false;
 	}
@@ -1018,7 +1306,9 @@ bool idAASBuild::BuildReachability( const idStr& fileName, const idAASSettings*
 	file->settings = *aasSettings;
 
 	// calculate reachability
-	reach.Build( mapFile, file );
+	BeginReachability();
+	AAS_BuildReachability( &build, 1 );
+	FinishReachability();
 
 	// build clusters
 	cluster.Build( file );
@@ -1028,6 +1318,7 @@ bool idAASBuild::BuildReachability( const idStr& fileName, const idAASSettings*
 
 	// delete the map file
 	delete mapFile;
+	mapFile = NULL;
 
 	common->Printf( "%6d seconds to calculate reachability\n", ( Sys_Milliseconds() - startTime ) / 1000 );
 
@@ -1074,6 +1365,203 @@ int ParseOptions( const idCmdArgs& args, idAASSettings& settings )
 	return args.Argc() - 1;
 }
 
+/*
+============
+ParseThreads
+
+The threads option is not part of the AAS settings
+============
+*/
+static void ParseThreads( const idCmdArgs& args )
+{
+	idStr str;
+
+	aasNumThreads = 0;
+	for( int i = 1; i < args.Argc() - 1; i++ )
+	{
+		str = args.Argv( i );
+		str.StripLeading( '-' );
+
+		if( str.Icmp( "threads" ) == 0 )
+		{
+			aasNumThreads = Max( atoi( args.Argv( i + 1 ) ), 0 );
+			common->Printf( "threads = %i\n", aasNumThreads );
+		}
+	}
+}
+
+struct aasBuildJob_t
+{
+	idAASBuild* 			build;
+	aasBuildLog_t			log;		// prints of the build, flushed in size order
+	bool					failed;		// nothing to build, leaked or error
+};
+
+/*
+============
+AASBuildAreasJob
+============
+*/
+static void AASBuildAreasJob( aasBuildJob_t* job )
+{
+	AAS_SetBuildLog( &job->log );
+	try
+	{
+		if( job->build->BuildAreas() )
+		{
+			job->build->BeginReachability();
+		}
+		else
+		{
+			job->failed = true;
+		}
+	}
+	catch( idException& ex )
+	{
+		job->log.error = ex.GetError();
+		job->failed = true;
+	}
+	AAS_SetBuildLog( NULL );
+}
+
+REGISTER_PARALLEL_JOB( AASBuildAreasJob, "AASBuildAreasJob" );
+
+/*
+============
+AASBuildClustersJob
+============
+*/
+static void AASBuildClustersJob( aasBuildJob_t* job )
+{
+	AAS_SetBuildLog( &job->log );
+	try
+	{
+		job->build->FinishReachability();
+		job->build->BuildClusters();
+	}
+	catch( idException& ex )
+	{
+		job->log.error = ex.GetError();
+		job->failed = true;
+	}
+	AAS_SetBuildLog( NULL );
+}
+
+REGISTER_PARALLEL_JOB( AASBuildClustersJob, "AASBuildClustersJob" );
+
+/*
+============
+RunBuildJobs
+============
+*/
+static void RunBuildJobs( idList<aasBuildJob_t>& jobs, jobRun_t function )
+{
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, jobs.Num(), 0, NULL );
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		if( !jobs[i].failed )
+		{
+			jobList->AddJob( function, &jobs[i] );
+		}
+	}
+	jobList->Submit( NULL, ( aasNumThreads > 0 ) ? aasNumThreads : JOBLIST_PARALLELISM_MAX_CORES );
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+}
+
+/*
+============
+BuildAAS
+
+Builds the AAS files for all bounding box sizes of the map. The sizes are
+independent of each other so their builds run in parallel jobs, the map
+loading and file writing stay on the main thread. The output of each build
+is printed afterwards in the order of the sizes, just like a serial run.
+============
+*/
+static void BuildAAS( const idStr& mapName, const idList<idAASSettings>& settings )
+{
+	bool serial = ( aasNumThreads == 1 || settings.Num() < 2 );
+	for( int i = 0; i < settings.Num(); i++ )
+	{
+		// the brush maps are written from the middle of the build
+		serial |= settings[i].writeBrushMap;
+	}
+
+	if( serial )
+	{
+		idAASBuild aas;
+		for( int i = 0; i < settings.Num(); i++ )
+		{
+			if( i )
+			{
+				common->Printf( "=======================================================\n" );
+			}
+			aas.Build( mapName, &settings[i] );
+		}
+		return;
+	}
+
+	const uint64_t startTime = Sys_Microseconds();
+
+	idList<aasBuildJob_t> jobs;
+	jobs.SetNum( settings.Num() );
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		jobs[i].build = new idAASBuild;
+		jobs[i].failed = !jobs[i].build->LoadMap( mapName, &settings[i] );
+	}
+
+	RunBuildJobs( jobs, ( jobRun_t )AASBuildAreasJob );
+
+	idList<idAASBuild*> reachBuilds;
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		if( !jobs[i].failed )
+		{
+			reachBuilds.Append( jobs[i].build );
+		}
+	}
+	AAS_BuildReachability( reachBuilds.Ptr(), reachBuilds.Num() );
+
+	RunBuildJobs( jobs, ( jobRun_t )AASBuildClustersJob );
+
+	idStr error;
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		if( i )
+		{
+			common->Printf( "=======================================================\n" );
+		}
+		AAS_FlushBuildLog( jobs[i].log );
+
+		// report the error of the first failing size, like the serial run would have
+		if( !jobs[i].log.error.IsEmpty() )
+		{
+			error = jobs[i].log.error;
+			break;
+		}
+		if( !jobs[i].failed )
+		{
+			jobs[i].build->WriteFile();
+			jobs[i].build->PrintPhaseTimes();
+		}
+	}
+
+	for( int i = 0; i < jobs.Num(); i++ )
+	{
+		delete jobs[i].build;
+	}
+
+	if( !error.IsEmpty() )
+	{
+		common->Error( "%s", error.c_str() );
+	}
+
+	common->Printf( "%5.1f seconds to create all AAS files (%s)\n", ( Sys_Microseconds() - startTime ) * 0.000001f,
+					( aasNumThreads > 0 ) ? va( "%i threads", aasNumThreads ) : "all cores" );
+}
+
 // RB begin
 static const idDict* FindEntityDefDict( const char* name, bool makeDefault )
 {
@@ -1094,8 +1582,8 @@ RunAAS_f
 void RunAAS_f( const idCmdArgs& args )
 {
 	int i;
-	idAASBuild aas;
 	idAASSettings settings;
+	idList<idAASSettings> allSettings;
 	idStr mapName;
 
 	if( args.Argc() <= 1 )
@@ -1104,7 +1592,8 @@ void RunAAS_f( const idCmdArgs& args )
 						"options:\n"
 						"  -usePatches        = use bezier patches for collision detection.\n"
 						"  -writeBrushMap     = write a brush map with the AAS geometry.\n"
-						"  -playerFlood       = use player spawn points as valid AAS positions.\n" );
+						"  -playerFlood       = use player spawn points as valid AAS positions.\n"
+						"  -threads <n>       = number of threads, 1 builds the sizes one by one (default all cores).\n" );
 		return;
 	}
 
@@ -1112,6 +1601,8 @@ void RunAAS_f( const idCmdArgs& args )
 
 	common->SetRefreshOnPrint( true );
 
+	ParseThreads( args );
+
 	// get the aas settings definitions
 	const idDict* dict = FindEntityDefDict( "aas_types", false );
 	if( !dict )
@@ -1137,15 +1628,14 @@ void RunAAS_f( const idCmdArgs& args )
 			{
 				mapName = "maps/" + mapName;
 			}
-			aas.Build( mapName, &settings );
+			allSettings.Append( settings );
 		}
 
 		kv = dict->MatchPrefix( "type", kv );
-		if( kv )
-		{
-			common->Printf( "=======================================================\n" );
-		}
 	}
+
+	BuildAAS( mapName, allSettings );
+
 	common->SetRefreshOnPrint( false );
 	common->PrintWarnings();
 }
@@ -1158,8 +1648,8 @@ RunAASDir_f
 void RunAASDir_f( const idCmdArgs& args )
 {
 	int i;
-	idAASBuild aas;
 	idAASSettings settings;
+	idList<idAASSettings> allSettings;
 	idFileList* mapFiles;
 
 	if( args.Argc() <= 1 )
@@ -1172,6 +1662,8 @@ void RunAASDir_f( const idCmdArgs& args )
 
 	common->SetRefreshOnPrint( true );
 
+	ParseThreads( args );
+
 	// get the aas settings definitions
 	const idDict* dict = FindEntityDefDict( "aas_types", false );
 	if( !dict )
@@ -1179,6 +1671,23 @@ void RunAASDir_f( const idCmdArgs& args )
 		common->Error( "Unable to find entityDef for 'aas_types'" );
 	}
 
+	const idKeyValue* kv = dict->MatchPrefix( "type" );
+	while( kv != NULL )
+	{
+		const idDict* settingsDict = FindEntityDefDict( kv->GetValue(), false );
+		if( !settingsDict )
+		{
+			common->Warning( "Unable to find '%s' in def/aas.def", kv->GetValue().c_str() );
+		}
+		else
+		{
+			settings.FromDict( kv->GetValue(), settingsDict );
+			allSettings.Append( settings );
+		}
+
+		kv = dict->MatchPrefix( "type", kv );
+	}
+
 	// scan for .map files
 	mapFiles = fileSystem->ListFiles( idStr( "maps/" ) + args.Argv( 1 ), ".map" );
 
@@ -1190,26 +1699,7 @@ void RunAASDir_f( const idCmdArgs& args )
 			common->Printf( "=======================================================\n" );
 		}
 
-		const idKeyValue* kv = dict->MatchPrefix( "type" );
-		while( kv != NULL )
-		{
-			const idDict* settingsDict = FindEntityDefDict( kv->GetValue(), false );
-			if( !settingsDict )
-			{
-				common->Warning( "Unable to find '%s' in def/aas.def", kv->GetValue().c_str() );
-			}
-			else
-			{
-				settings.FromDict( kv->GetValue(), settingsDict );
-				aas.Build( idStr( "maps/" ) + args.Argv( 1 ) + "/" + mapFiles->GetFile( i ), &settings );
-			}
-
-			kv = dict->MatchPrefix( "type", kv );
-			if( kv )
-			{
-				common->Printf( "=======================================================\n" );
-			}
-		}
+		BuildAAS( idStr( "maps/" ) + args.Argv( 1 ) + "/" + mapFiles->GetFile( i ), allSettings );
 	}
 
 	fileSystem->FreeFileList( mapFiles );
@@ -1239,6 +1729,8 @@ void RunReach_f( const idCmdArgs& args )
 
 	common->SetRefreshOnPrint( true );
 
+	ParseThreads( args );
+
 	// get the aas settings definitions
 	const idDict* dict = FindEntityDefDict( "aas_types", false );
 	if( !dict )
@@ -42,10 +42,11 @@ If you have questions concerning this license or the applicable additional terms
 #define AAS_PLANE_DIST_EPSILON			0.01f
 
 
-idHashIndex* aas_vertexHash;
-idHashIndex* aas_edgeHash;
-idBounds aas_vertexBounds;
-int aas_vertexShift;
+// per thread, the AAS files for the different bounding box sizes may be stored in parallel
+static thread_local idHashIndex* aas_vertexHash;
+static thread_local idHashIndex* aas_edgeHash;
+static thread_local idBounds aas_vertexBounds;
+static thread_local int aas_vertexShift;
 
 /*
 ================
@@ -518,7 +519,7 @@ bool idAASBuild::StoreFile( const idBrushBSP& bsp )
 	aasArea_t area;
 	aasNode_t node;
 
-	common->Printf( "[Store AAS]\n" );
+	AAS_Printf( "[Store AAS]\n" );
 
 	SetupHash();
 	ClearHash( bsp.GetTreeBounds() );
@@ -553,7 +554,7 @@ bool idAASBuild::StoreFile( const idBrushBSP& bsp )
 
 	ShutdownHash();
 
-	common->Printf( "\r%6d areas\n", file->areas.Num() );
+	AAS_Printf( "\r%6d areas\n", file->areas.Num() );
 
 	return true;
 }
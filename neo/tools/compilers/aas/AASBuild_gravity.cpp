@@ -412,10 +412,10 @@ void idAASBuild::GravitationalSubdivision( idBrushBSP& bsp )
 {
 	numGravitationalSubdivisions = 0;
 
-	common->Printf( "[Gravitational Subdivision]\n" );
+	AAS_Printf( "[Gravitational Subdivision]\n" );
 
 	SetPortalFlags_r( bsp.GetRootNode() );
 	GravSubdiv_r( bsp.GetRootNode() );
 
-	common->Printf( "\r%6d subdivisions\n", numGravitationalSubdivisions );
+	AAS_Printf( "\r%6d subdivisions\n", numGravitationalSubdivisions );
 }
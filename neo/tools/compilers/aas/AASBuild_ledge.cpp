@@ -638,15 +638,15 @@ void idAASBuild::LedgeSubdivision( idBrushBSP& bsp )
 	numLedgeSubdivisions = 0;
 	ledgeList.Clear();
 
-	common->Printf( "[Ledge Subdivision]\n" );
+	AAS_Printf( "[Ledge Subdivision]\n" );
 
 	bsp.GetRootNode()->RemoveFlagRecurse( NODE_VISITED );
 	FindLedges_r( bsp.GetRootNode(), bsp.GetRootNode() );
 	bsp.GetRootNode()->RemoveFlagRecurse( NODE_VISITED );
 
-	common->Printf( "\r%6d ledges\n", ledgeList.Num() );
+	AAS_Printf( "\r%6d ledges\n", ledgeList.Num() );
 
 	LedgeSubdiv( bsp.GetRootNode() );
 
-	common->Printf( "\r%6d subdivisions\n", numLedgeSubdivisions );
+	AAS_Printf( "\r%6d subdivisions\n", numLedgeSubdivisions );
 }
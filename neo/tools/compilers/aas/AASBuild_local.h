@@ -76,6 +76,18 @@ public:
 };
 
 
+enum aasBuildPhase_t
+{
+	AAS_PHASE_LOAD_MAP,
+	AAS_PHASE_BSP,
+	AAS_PHASE_SUBDIVISION,
+	AAS_PHASE_STORE,
+	AAS_PHASE_REACHABILITY,
+	AAS_PHASE_CLUSTERING,
+	AAS_PHASE_WRITE,
+	AAS_NUM_PHASES
+};
+
 class idAASBuild
 {
 
@@ -86,9 +98,41 @@ public:
 	bool					BuildReachability( const idStr& fileName, const idAASSettings* settings );
 	void					Shutdown();
 
+	// the phases of Build, RunAAS_f runs them for all bounding box sizes
+	// at once in parallel jobs, LoadMap and WriteFile are not thread safe
+	// and only BuildAreaReachability may run in several jobs at once
+	bool					LoadMap( const idStr& fileName, const idAASSettings* settings );
+	bool					BuildAreas();
+	void					BeginReachability();
+	void					BuildAreaReachability( int areaNum );
+	void					FinishReachability();
+	void					BuildClusters();
+	void					WriteFile();
+
+	int						GetNumAreas() const
+	{
+		return file->areas.Num();
+	}
+	const idAASSettings* 	GetSettings() const
+	{
+		return aasSettings;
+	}
+	void					AddPhaseTime( aasBuildPhase_t phase, uint64_t time )
+	{
+		phaseTime[phase] += time;
+	}
+	void					PrintPhaseTimes() const;
+
 private:
 	const idAASSettings* 	aasSettings;
 	idAASFileLocal* 		file;
+	idStr					mapName;
+	idMapFile* 				mapFile;
+	idStrList				entityClassNames;
+	idBrushList				brushList;
+	idAASReach				reach;
+	int						startTime;
+	uint64_t				phaseTime[AAS_NUM_PHASES];
 	aasProcNode_t* 			procNodes;
 	int						numProcNodes;
 	int						numGravitationalSubdivisions;
@@ -97,6 +141,9 @@ private:
 	idList<idLedge>			ledgeList;
 	idBrushMap* 			ledgeMap;
 
+private:
+	uint64_t				EndPhase( aasBuildPhase_t phase, uint64_t start );
+
 private:	// map loading
 	void					ParseProcNodes( idLexer* src );
 	bool					LoadProcBSP( const char* name, ID_TIME_T minFileTime );
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../../../aas/AASFile.h"
 #include "../../../aas/AASFile_local.h"
+#include "Brush.h"
 #include "AASCluster.h"
 
 
@@ -55,7 +56,7 @@ bool idAASCluster::UpdatePortal( int areaNum, int clusterNum )
 
 	if( portalNum >= file->portals.Num() )
 	{
-		common->Error( "no portal for area %d", areaNum );
+		AAS_Error( "no portal for area %d", areaNum );
 		return true;
 	}
 
@@ -118,7 +119,7 @@ bool idAASCluster::FloodClusterAreas_r( int areaNum, int clusterNum )
 			return true;
 		}
 		// there's a reachability going from one cluster to another only in one direction
-		common->Error( "cluster %d touched cluster %d at area %d\r\n", clusterNum, file->areas[areaNum].cluster, areaNum );
+		AAS_Error( "cluster %d touched cluster %d at area %d\r\n", clusterNum, file->areas[areaNum].cluster, areaNum );
 		return false;
 	}
 
@@ -532,7 +533,26 @@ void idAASCluster::RemoveInvalidPortals()
 		}
 	}
 
-	common->Printf( "\r%6d invalid portals removed\n", numInvalidPortals );
+	AAS_Printf( "\r%6d invalid portals removed\n", numInvalidPortals );
+}
+
+/*
+================
+AAS_ReportRoutingEfficiency
+
+Same report as idAASFileLocal::ReportRoutingEfficiency, but through AAS_Printf
+so it ends up in the build log when the clusters are built in a job.
+================
+*/
+static void AAS_ReportRoutingEfficiency( const idAASFileLocal* file )
+{
+	int numReachableAreas, numReachabilities, maxRoutingCacheKB;
+
+	file->GetRoutingEfficiency( numReachableAreas, numReachabilities, maxRoutingCacheKB );
+
+	AAS_Printf( "%6d reachable areas\n", numReachableAreas );
+	AAS_Printf( "%6d reachabilities\n", numReachabilities );
+	AAS_Printf( "%6d KB max routing cache\n", maxRoutingCacheKB );
 }
 
 /*
@@ -543,7 +563,7 @@ idAASCluster::Build
 bool idAASCluster::Build( idAASFileLocal* file )
 {
 
-	common->Printf( "[Clustering]\n" );
+	AAS_Printf( "[Clustering]\n" );
 
 	this->file = file;
 	this->noFaceFlood = true;
@@ -559,7 +579,7 @@ bool idAASCluster::Build( idAASFileLocal* file )
 		// create the portals from the portal areas
 		CreatePortals();
 
-		common->Printf( "\r%6d", file->portals.Num() );
+		AAS_Printf( "\r%6d", file->portals.Num() );
 
 		// find the clusters
 		if( !FindClusters() )
@@ -576,15 +596,15 @@ bool idAASCluster::Build( idAASFileLocal* file )
 		break;
 	}
 
-	common->Printf( "\r%6d portals\n", file->portals.Num() );
-	common->Printf( "%6d clusters\n", file->clusters.Num() );
+	AAS_Printf( "\r%6d portals\n", file->portals.Num() );
+	AAS_Printf( "%6d clusters\n", file->clusters.Num() );
 
 	for( int i = 0; i < file->clusters.Num(); i++ )
 	{
-		common->Printf( "%6d reachable areas in cluster %d\n", file->clusters[i].numReachableAreas, i );
+		AAS_Printf( "%6d reachable areas in cluster %d\n", file->clusters[i].numReachableAreas, i );
 	}
 
-	file->ReportRoutingEfficiency();
+	AAS_ReportRoutingEfficiency( file );
 
 	return true;
 }
@@ -599,7 +619,7 @@ bool idAASCluster::BuildSingleCluster( idAASFileLocal* file )
 	int i, numAreas;
 	aasCluster_t cluster;
 
-	common->Printf( "[Clustering]\n" );
+	AAS_Printf( "[Clustering]\n" );
 
 	this->file = file;
 
@@ -631,15 +651,15 @@ bool idAASCluster::BuildSingleCluster( idAASFileLocal* file )
 	}
 	file->clusters.Append( cluster );
 
-	common->Printf( "%6d portals\n", file->portals.Num() );
-	common->Printf( "%6d clusters\n", file->clusters.Num() );
+	AAS_Printf( "%6d portals\n", file->portals.Num() );
+	AAS_Printf( "%6d clusters\n", file->clusters.Num() );
 
 	for( i = 0; i < file->clusters.Num(); i++ )
 	{
-		common->Printf( "%6d reachable areas in cluster %d\n", file->clusters[i].numReachableAreas, i );
+		AAS_Printf( "%6d reachable areas in cluster %d\n", file->clusters[i].numReachableAreas, i );
 	}
 
-	file->ReportRoutingEfficiency();
+	AAS_ReportRoutingEfficiency( file );
 
 	return true;
 }
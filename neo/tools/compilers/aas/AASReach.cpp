@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../../../aas/AASFile.h"
 #include "../../../aas/AASFile_local.h"
+#include "Brush.h"
 #include "AASReach.h"
 
 #define INSIDEUNITS							2.0f
@@ -104,7 +105,6 @@ void idAASReach::AddReachabilityToArea( idReachability* reach, int areaNum )
 	area = &file->areas[areaNum];
 	reach->next = area->reach;
 	area->reach = reach;
-	numReachabilities++;
 }
 
 /*
@@ -990,57 +990,56 @@ void idAASReach::FlagReachableAreas( idAASFileLocal* file )
 		numReachableAreas++;
 	}
 
-	common->Printf( "%6d reachable areas\n", numReachableAreas );
+	AAS_Printf( "%6d reachable areas\n", numReachableAreas );
 }
 
 /*
 ================
-idAASReach::Build
+idAASReach::BeginBuild
 ================
 */
-bool idAASReach::Build( const idMapFile* mapFile, idAASFileLocal* file )
+void idAASReach::BeginBuild( const idMapFile* mapFile, idAASFileLocal* file )
 {
-	int i, j, lastPercent;
-
 	this->mapFile = mapFile;
 	this->file = file;
 	numReachabilities = 0;
 
-	common->Printf( "[Reachability]\n" );
-	common->DmapPacifierInfo( "[Reachability]\n" );
+	AAS_Printf( "[Reachability]\n" );
+	if( !AAS_BuildLogActive() )
+	{
+		common->DmapPacifierInfo( "[Reachability]\n" );
+	}
 
 	// delete all existing reachabilities
 	file->DeleteReachabilities();
 
 	FlagReachableAreas( file );
+}
 
-	for( i = 1; i < file->areas.Num(); i++ )
-	{
-		if( !( file->areas[i].flags & AREA_REACHABLE_WALK ) )
-		{
-			continue;
-		}
-		if( file->GetSettings().allowSwimReachabilities )
-		{
-			Reachability_Swim( i );
-		}
-		Reachability_EqualFloorHeight( i );
-	}
+/*
+================
+idAASReach::BuildArea
 
-	common->DmapPacifierCompileProgressTotal( file->areas.Num() - 1 );
+  All reachabilities are added to the area itself and only the reachabilities
+  of the area itself are tested, so areas can be processed in any order or in
+  parallel and the result stays the same.
+================
+*/
+void idAASReach::BuildArea( int areaNum )
+{
+	int j;
 
-	lastPercent = -1;
-	for( i = 1; i < file->areas.Num(); i++, common->DmapPacifierCompileProgressIncrement( 1 ) )
+	if( file->areas[areaNum].flags & AREA_REACHABLE_WALK )
 	{
-
-		if( !( file->areas[i].flags & AREA_REACHABLE_WALK ) )
+		if( file->GetSettings().allowSwimReachabilities )
 		{
-			continue;
+			Reachability_Swim( areaNum );
 		}
+		Reachability_EqualFloorHeight( areaNum );
 
 		for( j = 0; j < file->areas.Num(); j++ )
 		{
-			if( i == j )
+			if( areaNum == j )
 			{
 				continue;
 			}
@@ -1050,17 +1049,66 @@ bool idAASReach::Build( const idMapFile* mapFile, idAASFileLocal* file )
 				continue;
 			}
 
-			if( ReachabilityExists( i, j ) )
+			if( ReachabilityExists( areaNum, j ) )
 			{
 				continue;
 			}
-			if( Reachability_Step_Barrier_WaterJump_WalkOffLedge( i, j ) )
+			if( Reachability_Step_Barrier_WaterJump_WalkOffLedge( areaNum, j ) )
 			{
 				continue;
 			}
 		}
 
-		//Reachability_WalkOffLedge( i );
+		//Reachability_WalkOffLedge( areaNum );
+	}
+
+	if( file->GetSettings().allowFlyReachabilities )
+	{
+		Reachability_Fly( areaNum );
+	}
+}
+
+/*
+================
+idAASReach::FinishBuild
+================
+*/
+void idAASReach::FinishBuild()
+{
+	idReachability* reach;
+
+	file->LinkReversedReachability();
+
+	// count afterwards, the areas may have been built by several threads
+	numReachabilities = 0;
+	for( int i = 0; i < file->areas.Num(); i++ )
+	{
+		for( reach = file->areas[i].reach; reach; reach = reach->next )
+		{
+			numReachabilities++;
+		}
+	}
+
+	AAS_Printf( "\r%6d reachabilities\n", numReachabilities );
+}
+
+/*
+================
+idAASReach::Build
+================
+*/
+bool idAASReach::Build( const idMapFile* mapFile, idAASFileLocal* file )
+{
+	int i, lastPercent;
+
+	BeginBuild( mapFile, file );
+
+	common->DmapPacifierCompileProgressTotal( file->areas.Num() - 1 );
+
+	lastPercent = -1;
+	for( i = 1; i < file->areas.Num(); i++, common->DmapPacifierCompileProgressIncrement( 1 ) )
+	{
+		BuildArea( i );
 
 #if !defined( DMAP )
 		int percent = 100 * i / file->areas.Num();
@@ -1072,17 +1120,7 @@ bool idAASReach::Build( const idMapFile* mapFile, idAASFileLocal* file )
 #endif
 	}
 
-	if( file->GetSettings().allowFlyReachabilities )
-	{
-		for( i = 1; i < file->areas.Num(); i++ )
-		{
-			Reachability_Fly( i );
-		}
-	}
-
-	file->LinkReversedReachability();
-
-	common->Printf( "\r%6d reachabilities\n", numReachabilities );
+	FinishBuild();
 
 	return true;
 }
@@ -43,6 +43,16 @@ class idAASReach
 public:
 	bool					Build( const idMapFile* mapFile, idAASFileLocal* file );
 
+	// Build split up so the areas can be processed by parallel jobs,
+	// BuildArea may run for different areas at the same time
+	void					BeginBuild( const idMapFile* mapFile, idAASFileLocal* file );
+	void					BuildArea( int areaNum );
+	void					FinishBuild();
+	int						GetNumAreas() const
+	{
+		return file->areas.Num();
+	}
+
 private:
 	const idMapFile* 		mapFile;
 	idAASFileLocal* 		file;
@@ -39,6 +39,144 @@ If you have questions concerning this license or the applicable additional terms
 
 //#define OUTPUT_CHOP_STATS
 
+// set while a job thread runs an AAS build
+static thread_local aasBuildLog_t* aasBuildLog = NULL;
+
+/*
+============
+AAS_SetBuildLog
+============
+*/
+void AAS_SetBuildLog( aasBuildLog_t* log )
+{
+	aasBuildLog = log;
+}
+
+/*
+============
+AAS_BuildLogActive
+============
+*/
+bool AAS_BuildLogActive()
+{
+	return ( aasBuildLog != NULL );
+}
+
+/*
+============
+AAS_FlushBuildLog
+
+Printf truncates long messages, so print the collected text a line at a time
+============
+*/
+void AAS_FlushBuildLog( aasBuildLog_t& log )
+{
+	for( int i = 0; i < log.entries.Num(); i++ )
+	{
+		const idStr& text = log.entries[i].text;
+		if( log.entries[i].warning )
+		{
+			common->Warning( "%s", text.c_str() );
+			continue;
+		}
+		int start = 0;
+		while( start < text.Length() )
+		{
+			int end = text.Find( '\n', start );
+			end = ( end == -1 ) ? text.Length() : end + 1;
+			common->Printf( "%s", text.Mid( start, end - start ).c_str() );
+			start = end;
+		}
+	}
+	log.entries.Clear();
+}
+
+/*
+============
+AAS_AddToBuildLog
+============
+*/
+static void AAS_AddToBuildLog( const char* text, bool warning )
+{
+	idList<aasBuildLogEntry_t>& entries = aasBuildLog->entries;
+	if( !warning && entries.Num() && !entries[entries.Num() - 1].warning )
+	{
+		entries[entries.Num() - 1].text += text;
+		return;
+	}
+	aasBuildLogEntry_t& entry = entries.Alloc();
+	entry.text = text;
+	entry.warning = warning;
+}
+
+/*
+============
+AAS_Printf
+============
+*/
+void AAS_Printf( const char* fmt, ... )
+{
+	va_list argptr;
+	char text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if( aasBuildLog != NULL )
+	{
+		AAS_AddToBuildLog( text, false );
+		return;
+	}
+	common->Printf( "%s", text );
+}
+
+/*
+============
+AAS_Warning
+============
+*/
+void AAS_Warning( const char* fmt, ... )
+{
+	va_list argptr;
+	char text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if( aasBuildLog != NULL )
+	{
+		AAS_AddToBuildLog( text, true );
+		return;
+	}
+	common->Warning( "%s", text );
+}
+
+/*
+============
+AAS_Error
+
+common->Error is not safe on the job threads, there the error unwinds to the
+job which stores it in the build log
+============
+*/
+void AAS_Error( const char* fmt, ... )
+{
+	va_list argptr;
+	char text[MAX_STRING_CHARS];
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if( aasBuildLog != NULL )
+	{
+		throw idException( text );
+	}
+	common->Error( "%s", text );
+}
+
 /*
 ============
 DisplayRealTimeString
@@ -51,6 +189,12 @@ void DisplayRealTimeString( const char* string, ... )
 	static int lastUpdateTime;
 	int time;
 
+	// progress counters are of no use in a log printed afterwards
+	if( aasBuildLog != NULL )
+	{
+		return;
+	}
+
 	time = Sys_Milliseconds();
 	if( time > lastUpdateTime + OUTPUT_UPDATE_TIME )
 	{
@@ -327,7 +471,7 @@ void idBrush::BoundBrush( const idBrush* original )
 			bm->WriteBrush( original );
 			delete bm;
 		}
-		common->Error( "idBrush::BoundBrush: brush %d on entity %d without windings", primitiveNum, entityNum );
+		AAS_Error( "idBrush::BoundBrush: brush %d on entity %d without windings", primitiveNum, entityNum );
 	}
 
 	for( i = 0; i < 3; i++ )
@@ -340,7 +484,7 @@ void idBrush::BoundBrush( const idBrush* original )
 				bm->WriteBrush( original );
 				delete bm;
 			}
-			common->Error( "idBrush::BoundBrush: brush %d on entity %d is unbounded", primitiveNum, entityNum );
+			AAS_Error( "idBrush::BoundBrush: brush %d on entity %d is unbounded", primitiveNum, entityNum );
 		}
 	}
 }
@@ -824,10 +968,10 @@ int idBrush::Split( const idPlane& plane, int planeNum, idBrush** front, idBrush
 		else if( mid->IsHuge() )
 		{
 			// if the winding is huge then the brush is unbounded
-			common->Warning( "brush %d on entity %d is unbounded"
-							 "( %1.2f %1.2f %1.2f )-( %1.2f %1.2f %1.2f )-( %1.2f %1.2f %1.2f )", primitiveNum, entityNum,
-							 bounds[0][0], bounds[0][1], bounds[0][2], bounds[1][0], bounds[1][1], bounds[1][2],
-							 bounds[1][0] - bounds[0][0], bounds[1][1] - bounds[0][1], bounds[1][2] - bounds[0][2] );
+			AAS_Warning( "brush %d on entity %d is unbounded"
+						 "( %1.2f %1.2f %1.2f )-( %1.2f %1.2f %1.2f )-( %1.2f %1.2f %1.2f )", primitiveNum, entityNum,
+						 bounds[0][0], bounds[0][1], bounds[0][2], bounds[1][0], bounds[1][1], bounds[1][2],
+						 bounds[1][0] - bounds[0][0], bounds[1][1] - bounds[0][1], bounds[1][2] - bounds[0][2] );
 			delete mid;
 			mid = NULL;
 		}
@@ -1137,7 +1281,7 @@ void idBrush::ExpandForAxialBox( const idBounds& bounds )
 
 	if( !CreateWindings() )
 	{
-		common->Error( "idBrush::ExpandForAxialBox: brush %d on entity %d imploded", primitiveNum, entityNum );
+		AAS_Error( "idBrush::ExpandForAxialBox: brush %d on entity %d imploded", primitiveNum, entityNum );
 	}
 
 	/*
@@ -1486,8 +1630,8 @@ void idBrushList::Chop( bool ( *ChopAllowed )( idBrush* b1, idBrush* b2 ) )
 	idPlaneSet planeList;
 
 #ifdef OUTPUT_CHOP_STATS
-	common->Printf( "[Brush CSG]\n" );
-	common->Printf( "%6d original brushes\n", this->Num() );
+	AAS_Printf( "[Brush CSG]\n" );
+	AAS_Printf( "%6d original brushes\n", this->Num() );
 #endif
 
 	CreatePlaneList( planeList );
@@ -1620,7 +1764,7 @@ void idBrushList::Chop( bool ( *ChopAllowed )( idBrush* b1, idBrush* b2 ) )
 	*this = keep;
 
 #ifdef OUTPUT_CHOP_STATS
-	common->Printf( "\r%6d output brushes\n", Num() );
+	AAS_Printf( "\r%6d output brushes\n", Num() );
 #endif
 }
 
@@ -1636,8 +1780,8 @@ void idBrushList::Merge( bool ( *MergeAllowed )( idBrush* b1, idBrush* b2 ) )
 	idBrush* b1, *b2, *nextb2;
 	int numMerges;
 
-	common->Printf( "[Brush Merge]\n" );
-	common->Printf( "%6d original brushes\n", Num() );
+	AAS_Printf( "[Brush Merge]\n" );
+	AAS_Printf( "%6d original brushes\n", Num() );
 
 	CreatePlaneList( planeList );
 
@@ -1668,7 +1812,7 @@ void idBrushList::Merge( bool ( *MergeAllowed )( idBrush* b1, idBrush* b2 ) )
 		}
 	}
 
-	common->Printf( "\r%6d brushes merged\n", numMerges );
+	AAS_Printf( "\r%6d brushes merged\n", numMerges );
 }
 
 /*
@@ -1764,12 +1908,12 @@ idBrushMap::idBrushMap( const idStr& fileName, const idStr& ext )
 	qpath += ext;
 	qpath.SetFileExtension( "map" );
 
-	common->Printf( "writing %s...\n", qpath.c_str() );
+	AAS_Printf( "writing %s...\n", qpath.c_str() );
 
 	fp = fileSystem->OpenFileWrite( qpath, "fs_devpath" );
 	if( !fp )
 	{
-		common->Error( "Couldn't open %s\n", qpath.c_str() );
+		AAS_Error( "Couldn't open %s\n", qpath.c_str() );
 		return;
 	}
 
@@ -48,6 +48,27 @@ class idBrushList;
 
 void DisplayRealTimeString( const char* string, ... ) ID_STATIC_ATTRIBUTE_PRINTF( 1, 2 );
 
+// AAS builds running in parallel jobs collect their output in a build log which
+// is printed on the main thread afterwards, without a log the output goes to common
+struct aasBuildLogEntry_t
+{
+	idStr					text;
+	bool					warning;
+};
+
+struct aasBuildLog_t
+{
+	idList<aasBuildLogEntry_t>	entries;
+	idStr					error;		// set if the build hit an error
+};
+
+void AAS_SetBuildLog( aasBuildLog_t* log );
+bool AAS_BuildLogActive();
+void AAS_FlushBuildLog( aasBuildLog_t& log );
+void AAS_Printf( const char* fmt, ... ) ID_STATIC_ATTRIBUTE_PRINTF( 1, 2 );
+void AAS_Warning( const char* fmt, ... ) ID_STATIC_ATTRIBUTE_PRINTF( 1, 2 );
+void AAS_Error( const char* fmt, ... ) ID_STATIC_ATTRIBUTE_PRINTF( 1, 2 );
+
 
 //===============================================================
 //
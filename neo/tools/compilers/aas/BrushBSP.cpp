@@ -87,7 +87,7 @@ void idBrushBSPPortal::AddToNodes( idBrushBSPNode* front, idBrushBSPNode* back )
 {
 	if( nodes[0] || nodes[1] )
 	{
-		common->Error( "AddToNode: allready included" );
+		AAS_Error( "AddToNode: allready included" );
 	}
 
 	assert( front && back );
@@ -117,7 +117,7 @@ void idBrushBSPPortal::RemoveFromNode( idBrushBSPNode* l )
 		t = *pp;
 		if( !t )
 		{
-			common->Error( "idBrushBSPPortal::RemoveFromNode: portal not in node" );
+			AAS_Error( "idBrushBSPPortal::RemoveFromNode: portal not in node" );
 		}
 
 		if( t == this )
@@ -135,7 +135,7 @@ void idBrushBSPPortal::RemoveFromNode( idBrushBSPNode* l )
 		}
 		else
 		{
-			common->Error( "idBrushBSPPortal::RemoveFromNode: portal not bounding node" );
+			AAS_Error( "idBrushBSPPortal::RemoveFromNode: portal not bounding node" );
 		}
 	}
 
@@ -151,7 +151,7 @@ void idBrushBSPPortal::RemoveFromNode( idBrushBSPNode* l )
 	}
 	else
 	{
-		common->Error( "idBrushBSPPortal::RemoveFromNode: mislinked portal" );
+		AAS_Error( "idBrushBSPPortal::RemoveFromNode: mislinked portal" );
 	}
 }
 
@@ -988,8 +988,8 @@ idBrushBSPNode* idBrushBSP::ProcessGridCell( idBrushBSPNode* node, int skipConte
 	bool* testedPlanes;
 
 #ifdef OUPUT_BSP_STATS_PER_GRID_CELL
-	common->Printf( "[Grid Cell %d]\n", ++numGridCells );
-	common->Printf( "%6d brushes\n", node->brushList.Num() );
+	AAS_Printf( "[Grid Cell %d]\n", ++numGridCells );
+	AAS_Printf( "%6d brushes\n", node->brushList.Num() );
 #endif
 
 	numGridCellSplits = 0;
@@ -1004,7 +1004,7 @@ idBrushBSPNode* idBrushBSP::ProcessGridCell( idBrushBSPNode* node, int skipConte
 	node->brushList.CreatePlaneList( planeList );
 
 #ifdef OUPUT_BSP_STATS_PER_GRID_CELL
-	common->Printf( "[Grid Cell BSP]\n" );
+	AAS_Printf( "[Grid Cell BSP]\n" );
 #endif
 
 	testedPlanes = new bool[planeList.Num()];
@@ -1014,7 +1014,7 @@ idBrushBSPNode* idBrushBSP::ProcessGridCell( idBrushBSPNode* node, int skipConte
 	delete testedPlanes;
 
 #ifdef OUPUT_BSP_STATS_PER_GRID_CELL
-	common->Printf( "\r%6d splits\n", numGridCellSplits );
+	AAS_Printf( "\r%6d splits\n", numGridCellSplits );
 #endif
 
 	return node;
@@ -1104,8 +1104,8 @@ void idBrushBSP::Build( idBrushList brushList, int skipContents,
 	int i;
 	idList<idBrushBSPNode*> gridCells;
 
-	common->Printf( "[Brush BSP]\n" );
-	common->Printf( "%6d brushes\n", brushList.Num() );
+	AAS_Printf( "[Brush BSP]\n" );
+	AAS_Printf( "%6d brushes\n", brushList.Num() );
 
 	BrushChopAllowed = ChopAllowed;
 	BrushMergeAllowed = MergeAllowed;
@@ -1120,7 +1120,7 @@ void idBrushBSP::Build( idBrushList brushList, int skipContents,
 
 	BuildGrid_r( gridCells, root );
 
-	common->Printf( "\r%6d grid cells\n", gridCells.Num() );
+	AAS_Printf( "\r%6d grid cells\n", gridCells.Num() );
 
 #ifdef OUPUT_BSP_STATS_PER_GRID_CELL
 	for( i = 0; i < gridCells.Num(); i++ )
@@ -1128,16 +1128,16 @@ void idBrushBSP::Build( idBrushList brushList, int skipContents,
 		ProcessGridCell( gridCells[i], skipContents );
 	}
 #else
-	common->Printf( "\r%6d %%", 0 );
+	AAS_Printf( "\r%6d %%", 0 );
 	for( i = 0; i < gridCells.Num(); i++ )
 	{
 		DisplayRealTimeString( "\r%6d", i * 100 / gridCells.Num() );
 		ProcessGridCell( gridCells[i], skipContents );
 	}
-	common->Printf( "\r%6d %%\n", 100 );
+	AAS_Printf( "\r%6d %%\n", 100 );
 #endif
 
-	common->Printf( "\r%6d splits\n", numSplits );
+	AAS_Printf( "\r%6d splits\n", numSplits );
 
 	if( brushMap )
 	{
@@ -1218,9 +1218,9 @@ idBrushBSP::PruneTree
 void idBrushBSP::PruneTree( int contents )
 {
 	numPrunedSplits = 0;
-	common->Printf( "[Prune BSP]\n" );
+	AAS_Printf( "[Prune BSP]\n" );
 	PruneTree_r( root, contents );
-	common->Printf( "%6d splits pruned\n", numPrunedSplits );
+	AAS_Printf( "%6d splits pruned\n", numPrunedSplits );
 }
 
 /*
@@ -1288,7 +1288,7 @@ void idBrushBSP::MakeNodePortal( idBrushBSPNode* node )
 		}
 		else
 		{
-			common->Error( "MakeNodePortal: mislinked portal" );
+			AAS_Error( "MakeNodePortal: mislinked portal" );
 		}
 	}
 
@@ -1342,7 +1342,7 @@ void idBrushBSP::SplitNodePortals( idBrushBSPNode* node )
 		}
 		else
 		{
-			common->Error( "idBrushBSP::SplitNodePortals: mislinked portal" );
+			AAS_Error( "idBrushBSP::SplitNodePortals: mislinked portal" );
 		}
 		nextPortal = p->next[side];
 
@@ -1446,7 +1446,7 @@ void idBrushBSP::MakeTreePortals_r( idBrushBSPNode* node )
 	{
 		if( bounds[0][i] < MIN_WORLD_COORD || bounds[1][i] > MAX_WORLD_COORD )
 		{
-			common->Warning( "node with unbounded volume" );
+			AAS_Warning( "node with unbounded volume" );
 			break;
 		}
 	}
@@ -1483,7 +1483,7 @@ void idBrushBSP::MakeOutsidePortals()
 	{
 		if( bounds[0][i] > bounds[1][i] )
 		{
-			common->Error( "empty BSP tree" );
+			AAS_Error( "empty BSP tree" );
 		}
 	}
 
@@ -1533,12 +1533,12 @@ idBrushBSP::Portalize
 */
 void idBrushBSP::Portalize()
 {
-	common->Printf( "[Portalize BSP]\n" );
-	common->Printf( "%6d nodes\n", ( numSplits - numPrunedSplits ) * 2 + 1 );
+	AAS_Printf( "[Portalize BSP]\n" );
+	AAS_Printf( "%6d nodes\n", ( numSplits - numPrunedSplits ) * 2 + 1 );
 	numPortals = 0;
 	MakeOutsidePortals();
 	MakeTreePortals_r( root );
-	common->Printf( "\r%6d nodes portalized\n", numPortals );
+	AAS_Printf( "\r%6d nodes portalized\n", numPortals );
 }
 
 /*
@@ -1566,12 +1566,12 @@ void idBrushBSP::LeakFile( const idStr& fileName )
 	qpath = fileName;
 	qpath.SetFileExtension( "lin" );
 
-	common->Printf( "writing %s...\n", qpath.c_str() );
+	AAS_Printf( "writing %s...\n", qpath.c_str() );
 
 	lineFile = fileSystem->OpenFileWrite( qpath, "fs_devpath" );
 	if( !lineFile )
 	{
-		common->Error( "Couldn't open %s\n", qpath.c_str() );
+		AAS_Error( "Couldn't open %s\n", qpath.c_str() );
 		return;
 	}
 
@@ -1616,11 +1616,11 @@ void idBrushBSP::FloodThroughPortals_r( idBrushBSPNode* node, int contents, int
 
 	if( node->occupied )
 	{
-		common->Error( "FloodThroughPortals_r: node already occupied\n" );
+		AAS_Error( "FloodThroughPortals_r: node already occupied\n" );
 	}
 	if( !node )
 	{
-		common->Error( "FloodThroughPortals_r: NULL node\n" );
+		AAS_Error( "FloodThroughPortals_r: NULL node\n" );
 	}
 
 	node->occupied = depth;
@@ -1762,11 +1762,11 @@ bool idBrushBSP::FloodFromEntities( const idMapFile* mapFile, int contents, cons
 
 	if( !inside )
 	{
-		common->Warning( "no entities inside" );
+		AAS_Warning( "no entities inside" );
 	}
 	else if( outside->occupied )
 	{
-		common->Warning( "reached outside from entity %d (%s)", i, classname.c_str() );
+		AAS_Warning( "reached outside from entity %d (%s)", i, classname.c_str() );
 	}
 
 	return ( inside && !outside->occupied );
@@ -1817,7 +1817,7 @@ idBrushBSP::RemoveOutside
 */
 bool idBrushBSP::RemoveOutside( const idMapFile* mapFile, int contents, const idStrList& classNames )
 {
-	common->Printf( "[Remove Outside]\n" );
+	AAS_Printf( "[Remove Outside]\n" );
 
 	solidLeafNodes = outsideLeafNodes = insideLeafNodes = 0;
 
@@ -1828,9 +1828,9 @@ bool idBrushBSP::RemoveOutside( const idMapFile* mapFile, int contents, const id
 
 	RemoveOutside_r( root, contents );
 
-	common->Printf( "%6d solid leaf nodes\n", solidLeafNodes );
-	common->Printf( "%6d outside leaf nodes\n", outsideLeafNodes );
-	common->Printf( "%6d inside leaf nodes\n", insideLeafNodes );
+	AAS_Printf( "%6d solid leaf nodes\n", solidLeafNodes );
+	AAS_Printf( "%6d outside leaf nodes\n", outsideLeafNodes );
+	AAS_Printf( "%6d inside leaf nodes\n", insideLeafNodes );
 
 	//PruneTree( contents );
 
@@ -2071,10 +2071,10 @@ idBrushBSP::MergePortals
 void idBrushBSP::MergePortals( int skipContents )
 {
 	numMergedPortals = 0;
-	common->Printf( "[Merge Portals]\n" );
+	AAS_Printf( "[Merge Portals]\n" );
 	SetPortalPlanes();
 	MergePortals_r( root, skipContents );
-	common->Printf( "%6d portals merged\n", numMergedPortals );
+	AAS_Printf( "%6d portals merged\n", numMergedPortals );
 }
 
 /*
@@ -2459,9 +2459,9 @@ void idBrushBSP::MeltPortals( int skipContents )
 	idVectorSet<idVec3, 3> vertexList;
 
 	numInsertedPoints = 0;
-	common->Printf( "[Melt Portals]\n" );
+	AAS_Printf( "[Melt Portals]\n" );
 	RemoveColinearPoints_r( root, skipContents );
 	MeltPortals_r( root, skipContents, vertexList );
 	root->RemoveFlagRecurse( NODE_DONE );
-	common->Printf( "\r%6d points inserted\n", numInsertedPoints );
+	AAS_Printf( "\r%6d points inserted\n", numInsertedPoints );
 }
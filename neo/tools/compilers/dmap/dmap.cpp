@@ -36,6 +36,257 @@ idCVar dmap_verbose( "dmap_verbose", "0", CVAR_BOOL | CVAR_SYSTEM | CVAR_NEW, "d
 
 dmapGlobals_t	dmapGlobals;
 
+/*
+==============================================================================
+
+	Per area jobs
+
+==============================================================================
+*/
+
+struct dmapAreaJob_t
+{
+	dmapAreaFunc_t	areaFunc;
+	uEntity_t*		entity;
+	int				areaNum;
+	idStr			log;		// prints of the job, flushed in area order
+	idStr			error;		// set if the job hit an error
+};
+
+// set while a job thread runs an area, prints and errors are collected instead of going to common
+static thread_local dmapAreaJob_t* dmapCurrentJob = NULL;
+
+/*
+============
+DmapAreaJob
+============
+*/
+static void DmapAreaJob( dmapAreaJob_t* job )
+{
+	dmapCurrentJob = job;
+	try
+	{
+		job->areaFunc( job->entity, job->areaNum );
+	}
+	catch( idException& ex )
+	{
+		job->error = ex.GetError();
+	}
+	dmapCurrentJob = NULL;
+}
+
+REGISTER_PARALLEL_JOB( DmapAreaJob, "DmapAreaJob" );
+
+/*
+============
+FlushJobLog
+
+Printf truncates long messages, so print the collected log a line at a time
+============
+*/
+static void FlushJobLog( const idStr& log )
+{
+	int start = 0;
+	while( start < log.Length() )
+	{
+		int end = log.Find( '\n', start );
+		end = ( end == -1 ) ? log.Length() : end + 1;
+		common->Printf( "%s", log.Mid( start, end - start ).c_str() );
+		start = end;
+	}
+}
+
+/*
+============
+RunAreaJobs
+============
+*/
+void RunAreaJobs( uEntity_t* e, dmapAreaFunc_t areaFunc )
+{
+	// the debug drawing is not thread safe
+	if( dmapGlobals.numThreads == 1 || dmapGlobals.drawflag || e->numAreas < 2 )
+	{
+		for( int i = 0 ; i < e->numAreas ; i++ )
+		{
+			areaFunc( e, i );
+		}
+		return;
+	}
+
+	idList<dmapAreaJob_t> jobs;
+	jobs.SetNum( e->numAreas );
+
+	idParallelJobList* jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, e->numAreas, 0, NULL );
+	for( int i = 0 ; i < e->numAreas ; i++ )
+	{
+		jobs[i].areaFunc = areaFunc;
+		jobs[i].entity = e;
+		jobs[i].areaNum = i;
+		jobList->AddJob( ( jobRun_t )DmapAreaJob, &jobs[i] );
+	}
+	jobList->Submit( NULL, ( dmapGlobals.numThreads > 0 ) ? dmapGlobals.numThreads : JOBLIST_PARALLELISM_MAX_CORES );
+	jobList->Wait();
+	parallelJobManager->FreeJobList( jobList );
+
+	for( int i = 0 ; i < e->numAreas ; i++ )
+	{
+		FlushJobLog( jobs[i].log );
+	}
+
+	// report the error of the first failing area, like the serial run would have
+	for( int i = 0 ; i < e->numAreas ; i++ )
+	{
+		if( !jobs[i].error.IsEmpty() )
+		{
+			common->Error( "%s", jobs[i].error.c_str() );
+		}
+	}
+}
+
+/*
+============
+DmapVPrintf
+============
+*/
+static void DmapVPrintf( const char* fmt, va_list argptr )
+{
+	char text[MAX_STRING_CHARS];
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+
+	if( dmapCurrentJob != NULL )
+	{
+		dmapCurrentJob->log += text;
+	}
+	else
+	{
+		common->Printf( "%s", text );
+	}
+}
+
+/*
+============
+DmapPrintf
+============
+*/
+void DmapPrintf( const char* fmt, ... )
+{
+	va_list argptr;
+	va_start( argptr, fmt );
+	DmapVPrintf( fmt, argptr );
+	va_end( argptr );
+}
+
+/*
+============
+DmapVerbosePrintf
+============
+*/
+void DmapVerbosePrintf( const char* fmt, ... )
+{
+	if( !dmap_verbose.GetBool() )
+	{
+		return;
+	}
+
+	va_list argptr;
+	va_start( argptr, fmt );
+	DmapVPrintf( fmt, argptr );
+	va_end( argptr );
+}
+
+/*
+============
+DmapError
+
+common->Error is not safe on the job threads, there the error unwinds to
+DmapAreaJob and is raised again on the main thread by RunAreaJobs
+============
+*/
+void DmapError( const char* fmt, ... )
+{
+	char		text[MAX_STRING_CHARS];
+	va_list		argptr;
+
+	va_start( argptr, fmt );
+	idStr::vsnPrintf( text, sizeof( text ), fmt, argptr );
+	va_end( argptr );
+
+	if( dmapCurrentJob != NULL )
+	{
+		throw idException( text );
+	}
+	common->Error( "%s", text );
+}
+
+/*
+==============================================================================
+
+	Stage timings
+
+==============================================================================
+*/
+
+enum dmapStage_t
+{
+	STAGE_FACE_BSP,
+	STAGE_TREE_PORTALS,
+	STAGE_FILTER_INTO_TREE,
+	STAGE_FLOOD_ENTITIES,
+	STAGE_CLIP_SIDES,
+	STAGE_FLOOD_AREAS,
+	STAGE_PUT_PRIMITIVES,
+	STAGE_PRELIGHT,
+	STAGE_OPTIMIZE,
+	STAGE_GLOBAL_TJUNCTIONS,
+	STAGE_WRITE_OUTPUT,
+	NUM_DMAP_STAGES
+};
+
+static const char* dmapStageNames[NUM_DMAP_STAGES] =
+{
+	"FaceBSP",
+	"MakeTreePortals",
+	"FilterIntoTree",
+	"FloodEntities",
+	"ClipSidesByTree",
+	"FloodAreas",
+	"PutPrimitivesInAreas",
+	"Prelight",
+	"Optimize / TJunctions",
+	"FixGlobalTjunctions",
+	"WriteOutputFile"
+};
+
+static uint64_t dmapStageTime[NUM_DMAP_STAGES];
+
+/*
+============
+EndStage
+
+Adds the time since start to the stage and returns the current time for the next stage
+============
+*/
+static uint64_t EndStage( dmapStage_t stage, uint64_t start )
+{
+	const uint64_t now = Sys_Microseconds();
+	dmapStageTime[stage] += now - start;
+	return now;
+}
+
+/*
+============
+PrintStageTimes
+============
+*/
+static void PrintStageTimes()
+{
+	common->Printf( "----- dmap stages (%s) -----\n", ( dmapGlobals.numThreads > 0 ) ? va( "%i threads", dmapGlobals.numThreads ) : "all cores" );
+	for( int i = 0 ; i < NUM_DMAP_STAGES ; i++ )
+	{
+		common->Printf( "%9.1f ms %s\n", dmapStageTime[i] * 0.001f, dmapStageNames[i] );
+	}
+}
+
 /*
 ============
 ProcessModel
@@ -44,6 +295,7 @@ ProcessModel
 bool ProcessModel( uEntity_t* e, bool floodFill )
 {
 	bspface_t*	faces;
+	uint64_t	stageStart = Sys_Microseconds();
 
 	// build a bsp tree using all of the sides
 	// of all of the structural brushes
@@ -57,10 +309,12 @@ bool ProcessModel( uEntity_t* e, bool floodFill )
 	// RB end
 
 	e->tree = FaceBSP( faces );
+	stageStart = EndStage( STAGE_FACE_BSP, stageStart );
 
 	// create portals at every leaf intersection
 	// to allow flood filling
 	MakeTreePortals( e->tree );
+	stageStart = EndStage( STAGE_TREE_PORTALS, stageStart );
 
 	// RB: calculate node numbers for split plane analysis
 	NumberNodes_r( e->tree->headnode, 0 );
@@ -70,6 +324,7 @@ bool ProcessModel( uEntity_t* e, bool floodFill )
 
 	// RB: use mapTri_t by MapPolygonMesh primitives in case we don't use brushes
 	FilterMeshesIntoTree( e );
+	stageStart = EndStage( STAGE_FILTER_INTO_TREE, stageStart );
 
 	// see if the bsp is completely enclosed
 	if( floodFill && !dmapGlobals.noFlood )
@@ -78,6 +333,7 @@ bool ProcessModel( uEntity_t* e, bool floodFill )
 		{
 			// set the outside leafs to opaque
 			FillOutside( e );
+			stageStart = EndStage( STAGE_FLOOD_ENTITIES, stageStart );
 		}
 		else
 		{
@@ -96,21 +352,25 @@ bool ProcessModel( uEntity_t* e, bool floodFill )
 	// this must be done before creating area portals,
 	// because the visible hull is used as the portal
 	ClipSidesByTree( e );
+	stageStart = EndStage( STAGE_CLIP_SIDES, stageStart );
 
 	// determine areas before clipping tris into the
 	// tree, so tris will never cross area boundaries
 	FloodAreas( e );
+	stageStart = EndStage( STAGE_FLOOD_AREAS, stageStart );
 
 	// we now have a BSP tree with solid and non-solid leafs marked with areas
 	// all primitives will now be clipped into this, throwing away
 	// fragments in the solid areas
 	PutPrimitivesInAreas( e );
+	stageStart = EndStage( STAGE_PUT_PRIMITIVES, stageStart );
 
 	// now build shadow volumes for the lights and split
 	// the optimize lists by the light beam trees
 	// so there won't be unneeded overdraw in the static
 	// case
 	Prelight( e );
+	stageStart = EndStage( STAGE_PRELIGHT, stageStart );
 
 	// optimizing is a superset of fixing tjunctions
 	if( !dmapGlobals.noOptimize )
@@ -121,9 +381,11 @@ bool ProcessModel( uEntity_t* e, bool floodFill )
 	{
 		FixEntityTjunctions( e );
 	}
+	stageStart = EndStage( STAGE_OPTIMIZE, stageStart );
 
 	// now fix t junctions across areas
 	FixGlobalTjunctions( e );
+	EndStage( STAGE_GLOBAL_TJUNCTIONS, stageStart );
 
 	return true;
 }
@@ -194,6 +456,7 @@ void DmapHelp()
 		"noCurves          = don't process curves\n"
 		"noCM              = don't create collision map\n"
 		"noAAS             = don't create AAS files\n"
+		"threads <n>       = number of threads for the per area stages and AAS builds, 1 runs serially (default all cores)\n"
 
 	);
 }
@@ -230,6 +493,9 @@ void ResetDmapGlobals()
 	dmapGlobals.drawflag = false;
 	dmapGlobals.totalShadowTriangles = 0;
 	dmapGlobals.totalShadowVerts = 0;
+	dmapGlobals.numThreads = 0;
+
+	memset( dmapStageTime, 0, sizeof( dmapStageTime ) );
 }
 
 /*
@@ -366,6 +632,12 @@ void Dmap( const idCmdArgs& args )
 			noAAS = true;
 			common->Printf( "noAAS = true\n" );
 		}
+		else if( !idStr::Icmp( s, "threads" ) )
+		{
+			dmapGlobals.numThreads = Max( atoi( args.Argv( i + 1 ) ), 0 );
+			common->Printf( "threads = %i\n", dmapGlobals.numThreads );
+			i += 1;
+		}
 		else
 		{
 			break;
@@ -433,7 +705,9 @@ void Dmap( const idCmdArgs& args )
 
 	if( ProcessModels() )
 	{
+		uint64_t stageStart = Sys_Microseconds();
 		WriteOutputFile();
+		EndStage( STAGE_WRITE_OUTPUT, stageStart );
 
 		// RB: dump BSP after nodes being pruned and optimized
 		if( dmapGlobals.glview )
@@ -454,6 +728,8 @@ void Dmap( const idCmdArgs& args )
 	common->Printf( "%i total shadow triangles\n", dmapGlobals.totalShadowTriangles );
 	common->Printf( "%i total shadow verts\n", dmapGlobals.totalShadowVerts );
 
+	PrintStageTimes();
+
 	end = Sys_Milliseconds();
 	common->Printf( "-----------------------\n" );
 	common->Printf( "%5.0f seconds for dmap\n", ( end - start ) * 0.001f );
@@ -298,12 +298,25 @@ typedef struct
 
 	int		totalShadowTriangles;
 	int		totalShadowVerts;
+
+	int		numThreads;			// 0 = all cores, 1 = run every stage serially
 } dmapGlobals_t;
 
 extern dmapGlobals_t dmapGlobals;
 
 int FindFloatPlane( const idPlane& plane, bool* fixedDegeneracies = NULL );
 
+// runs areaFunc for every area of the entity, on the job threads unless dmapGlobals.numThreads is 1
+// or drawing is enabled. areaFunc may only modify its own area, output of the
+// Dmap* print functions below is collected per area and printed in area order afterwards,
+// so the log and the written files are the same as a serial run
+typedef void ( *dmapAreaFunc_t )( uEntity_t* e, int areaNum );
+void		RunAreaJobs( uEntity_t* e, dmapAreaFunc_t areaFunc );
+
+void		DmapPrintf( VERIFY_FORMAT_STRING const char* fmt, ... ) ID_STATIC_ATTRIBUTE_PRINTF( 1, 2 );
+void		DmapVerbosePrintf( VERIFY_FORMAT_STRING const char* fmt, ... ) ID_STATIC_ATTRIBUTE_PRINTF( 1, 2 );
+void		DmapError( VERIFY_FORMAT_STRING const char* fmt, ... ) ID_STATIC_ATTRIBUTE_PRINTF( 1, 2 );
+
 
 //=============================================================================
 
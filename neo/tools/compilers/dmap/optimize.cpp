@@ -47,15 +47,17 @@ If you have questions concerning this license or the applicable additional terms
 
 */
 
-idBounds	optBounds;
+// the work space is per thread, so several areas can be optimized at
+// once, the vertex and edge arrays only live during OptimizeGroupList
+static thread_local idBounds	optBounds;
 
 #define	MAX_OPT_VERTEXES	0x10000
-int			numOptVerts;
-optVertex_t optVerts[MAX_OPT_VERTEXES];
+static thread_local int			numOptVerts;
+static thread_local optVertex_t* optVerts;
 
 #define	MAX_OPT_EDGES		0x40000
-static	int		numOptEdges;
-static	optEdge_t	optEdges[MAX_OPT_EDGES];
+static thread_local int			numOptEdges;
+static thread_local optEdge_t*	optEdges;
 
 static bool IsTriangleValid( const optVertex_t* v1, const optVertex_t* v2, const optVertex_t* v3 );
 static bool IsTriangleDegenerate( const optVertex_t* v1, const optVertex_t* v2, const optVertex_t* v3 );
@@ -89,7 +91,7 @@ static void ValidateEdgeCounts( optIsland_t* island )
 			}
 			else
 			{
-				common->Error( "ValidateEdgeCounts: mislinked" );
+				DmapError( "ValidateEdgeCounts: mislinked" );
 			}
 		}
 		if( c != 2 && c != 0 )
@@ -112,7 +114,7 @@ static optEdge_t*	AllocEdge()
 
 	if( numOptEdges == MAX_OPT_EDGES )
 	{
-		common->Error( "MAX_OPT_EDGES" );
+		DmapError( "MAX_OPT_EDGES" );
 	}
 	e = &optEdges[ numOptEdges ];
 	numOptEdges++;
@@ -151,7 +153,7 @@ static	void RemoveEdgeFromVert( optEdge_t* e1, optVertex_t* vert )
 			}
 			else
 			{
-				common->Error( "RemoveEdgeFromVert: vert not found" );
+				DmapError( "RemoveEdgeFromVert: vert not found" );
 			}
 			return;
 		}
@@ -166,7 +168,7 @@ static	void RemoveEdgeFromVert( optEdge_t* e1, optVertex_t* vert )
 		}
 		else
 		{
-			common->Error( "RemoveEdgeFromVert: vert not found" );
+			DmapError( "RemoveEdgeFromVert: vert not found" );
 		}
 	}
 }
@@ -192,7 +194,7 @@ static	void UnlinkEdge( optEdge_t* e, optIsland_t* island )
 		}
 	}
 
-	common->Error( "RemoveEdgeFromIsland: couldn't free edge" );
+	DmapError( "RemoveEdgeFromIsland: couldn't free edge" );
 }
 
 
@@ -236,7 +238,7 @@ static optVertex_t* FindOptVertex( idDrawVert* v, optimizeGroup_t* opt )
 
 	if( numOptVerts >= MAX_OPT_VERTEXES )
 	{
-		common->Error( "MAX_OPT_VERTEXES" );
+		DmapError( "MAX_OPT_VERTEXES" );
 		return NULL;
 	}
 
@@ -670,8 +672,8 @@ static	void AddInteriorEdges( optIsland_t* island )
 		}
 	}
 
-	common->VerbosePrintf( "%6i tested segments\n", numLengths );
-	common->VerbosePrintf( "%6i added interior edges\n", c_addedEdges );
+	DmapVerbosePrintf( "%6i tested segments\n", numLengths );
+	DmapVerbosePrintf( "%6i added interior edges\n", c_addedEdges );
 
 	Mem_Free( lengths );
 }
@@ -726,7 +728,7 @@ static	void RemoveIfColinear( optVertex_t* ov, optIsland_t* island )
 		}
 		else
 		{
-			common->Error( "RemoveIfColinear: mislinked edge" );
+			DmapError( "RemoveIfColinear: mislinked edge" );
 		}
 	}
 
@@ -740,7 +742,7 @@ static	void RemoveIfColinear( optVertex_t* ov, optIsland_t* island )
 	{
 		// this may still happen legally when a tiny triangle is
 		// the only thing in a group
-		common->VerbosePrintf( "WARNING: vertex with only one edge\n" );
+		DmapVerbosePrintf( "WARNING: vertex with only one edge\n" );
 		return;
 	}
 
@@ -754,7 +756,7 @@ static	void RemoveIfColinear( optVertex_t* ov, optIsland_t* island )
 	}
 	else
 	{
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		DmapError( "RemoveIfColinear: mislinked edge" );
 	}
 	if( e2->v1 == v2 )
 	{
@@ -766,12 +768,12 @@ static	void RemoveIfColinear( optVertex_t* ov, optIsland_t* island )
 	}
 	else
 	{
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		DmapError( "RemoveIfColinear: mislinked edge" );
 	}
 
 	if( v1 == v3 )
 	{
-		common->Error( "RemoveIfColinear: mislinked edge" );
+		DmapError( "RemoveIfColinear: mislinked edge" );
 	}
 
 	// they must point in opposite directions
@@ -820,7 +822,7 @@ static	void RemoveIfColinear( optVertex_t* ov, optIsland_t* island )
 	// v2 should have no edges now
 	if( v2->edges )
 	{
-		common->Error( "RemoveIfColinear: didn't remove properly" );
+		DmapError( "RemoveIfColinear: didn't remove properly" );
 	}
 
 
@@ -876,7 +878,7 @@ static	void CombineColinearEdges( optIsland_t* island )
 	{
 		c_edges++;
 	}
-	common->VerbosePrintf( "%6i original exterior edges\n", c_edges );
+	DmapVerbosePrintf( "%6i original exterior edges\n", c_edges );
 
 	for( ov = island->verts ; ov ; ov = ov->islandLink )
 	{
@@ -888,7 +890,7 @@ static	void CombineColinearEdges( optIsland_t* island )
 	{
 		c_edges++;
 	}
-	common->VerbosePrintf( "%6i optimized exterior edges\n", c_edges );
+	DmapVerbosePrintf( "%6i optimized exterior edges\n", c_edges );
 }
 
 
@@ -1038,7 +1040,7 @@ static void LinkTriToEdge( optTri_t* optTri, optEdge_t* edge )
 	{
 		if( edge->backTri )
 		{
-			common->VerbosePrintf( "Warning: LinkTriToEdge: already in use\n" );
+			DmapVerbosePrintf( "Warning: LinkTriToEdge: already in use\n" );
 			return;
 		}
 		edge->backTri = optTri;
@@ -1050,13 +1052,13 @@ static void LinkTriToEdge( optTri_t* optTri, optEdge_t* edge )
 	{
 		if( edge->frontTri )
 		{
-			common->VerbosePrintf( "Warning: LinkTriToEdge: already in use\n" );
+			DmapVerbosePrintf( "Warning: LinkTriToEdge: already in use\n" );
 			return;
 		}
 		edge->frontTri = optTri;
 		return;
 	}
-	common->Error( "LinkTriToEdge: edge not found on tri" );
+	DmapError( "LinkTriToEdge: edge not found on tri" );
 }
 
 /*
@@ -1081,7 +1083,7 @@ static void CreateOptTri( optVertex_t* first, optEdge_t* e1, optEdge_t* e2, optI
 	}
 	else
 	{
-		common->Error( "CreateOptTri: mislinked edge" );
+		DmapError( "CreateOptTri: mislinked edge" );
 	}
 
 	if( e2->v1 == first )
@@ -1094,12 +1096,12 @@ static void CreateOptTri( optVertex_t* first, optEdge_t* e1, optEdge_t* e2, optI
 	}
 	else
 	{
-		common->Error( "CreateOptTri: mislinked edge" );
+		DmapError( "CreateOptTri: mislinked edge" );
 	}
 
 	if( !IsTriangleValid( first, second, third ) )
 	{
-		common->Error( "CreateOptTri: invalid" );
+		DmapError( "CreateOptTri: invalid" );
 	}
 
 //DrawEdges( island );
@@ -1139,13 +1141,13 @@ static void CreateOptTri( optVertex_t* first, optEdge_t* e1, optEdge_t* e2, optI
 		}
 		else
 		{
-			common->Error( "BuildOptTriangles: mislinked edge" );
+			DmapError( "BuildOptTriangles: mislinked edge" );
 		}
 	}
 
 	if( !opposite )
 	{
-		common->VerbosePrintf( "Warning: BuildOptTriangles: couldn't locate opposite\n" );
+		DmapVerbosePrintf( "Warning: BuildOptTriangles: couldn't locate opposite\n" );
 		return;
 	}
 
@@ -1303,7 +1305,7 @@ static void BuildOptTriangles( optIsland_t* island )
 			}
 			else
 			{
-				common->Error( "BuildOptTriangles: mislinked edge" );
+				DmapError( "BuildOptTriangles: mislinked edge" );
 			}
 
 			// if the vertex has already been used, it can't be used again
@@ -1326,7 +1328,7 @@ static void BuildOptTriangles( optIsland_t* island )
 				}
 				else
 				{
-					common->Error( "BuildOptTriangles: mislinked edge" );
+					DmapError( "BuildOptTriangles: mislinked edge" );
 				}
 				if( e2 == e1 )
 				{
@@ -1361,7 +1363,7 @@ static void BuildOptTriangles( optIsland_t* island )
 					}
 					else
 					{
-						common->Error( "BuildOptTriangles: mislinked edge" );
+						DmapError( "BuildOptTriangles: mislinked edge" );
 					}
 
 					if( check == e1 || check == e2 )
@@ -1432,7 +1434,7 @@ static	void	RegenerateTriangles( optIsland_t* island )
 		{
 			// this can happen reasonably when a triangle is nearly degenerate in
 			// optimization planar space, and winds up being degenerate in 3D space
-			common->VerbosePrintf( "WARNING: backwards triangle generated!\n" );
+			DmapVerbosePrintf( "WARNING: backwards triangle generated!\n" );
 			// discard it
 			FreeTri( tri );
 			continue;
@@ -1445,7 +1447,7 @@ static	void	RegenerateTriangles( optIsland_t* island )
 
 	FreeOptTriangles( island );
 
-	common->VerbosePrintf( "%6i tris out\n", c_out );
+	DmapVerbosePrintf( "%6i tris out\n", c_out );
 }
 
 //===========================================================================
@@ -1500,8 +1502,8 @@ static	void RemoveInteriorEdges( optIsland_t* island )
 		c_exteriorEdges++;
 	}
 
-	common->VerbosePrintf( "%6i original interior edges\n", c_interiorEdges );
-	common->VerbosePrintf( "%6i original exterior edges\n", c_exteriorEdges );
+	DmapVerbosePrintf( "%6i original interior edges\n", c_interiorEdges );
+	DmapVerbosePrintf( "%6i original exterior edges\n", c_exteriorEdges );
 }
 
 //==================================================================================
@@ -1537,7 +1539,7 @@ void AddEdgeIfNotAlready( optVertex_t* v1, optVertex_t* v2 )
 		}
 		else
 		{
-			common->Error( "SplitEdgeByList: bad edge link" );
+			DmapError( "SplitEdgeByList: bad edge link" );
 		}
 	}
 
@@ -1591,8 +1593,8 @@ typedef struct edgeCrossing_s
 	optVertex_t*		ov;
 } edgeCrossing_t;
 
-static	originalEdges_t*	originalEdges;
-static	int				numOriginalEdges;
+static thread_local originalEdges_t*	originalEdges;
+static thread_local int				numOriginalEdges;
 
 /*
 =================
@@ -1607,7 +1609,7 @@ static void AddOriginalTriangle( optVertex_t* v[3] )
 	// ignore it completely
 	if( !IsTriangleValid( v[0], v[1], v[2] ) )
 	{
-		common->VerbosePrintf( "WARNING: backwards triangle in input!\n" );
+		DmapVerbosePrintf( "WARNING: backwards triangle in input!\n" );
 		return;
 	}
 
@@ -1657,8 +1659,8 @@ static	void AddOriginalEdges( optimizeGroup_t* opt )
 	optVertex_t*		v[3];
 	int				numTris;
 
-	common->VerbosePrintf( "----\n" );
-	common->VerbosePrintf( "%6i original tris\n", CountTriList( opt->triList ) );
+	DmapVerbosePrintf( "----\n" );
+	DmapVerbosePrintf( "%6i original tris\n", CountTriList( opt->triList ) );
 
 	optBounds.Clear();
 
@@ -1695,13 +1697,16 @@ void SplitOriginalEdgesAtCrossings( optimizeGroup_t* opt )
 	// now split any crossing edges and create optEdges
 	// linked to the vertexes
 
-	// debug drawing bounds
-	dmapGlobals.drawBounds = optBounds;
+	// debug drawing bounds, drawing always runs on the main thread
+	if( dmapGlobals.drawflag )
+	{
+		dmapGlobals.drawBounds = optBounds;
 
-	dmapGlobals.drawBounds[0][0] -= 2;
-	dmapGlobals.drawBounds[0][1] -= 2;
-	dmapGlobals.drawBounds[1][0] += 2;
-	dmapGlobals.drawBounds[1][1] += 2;
+		dmapGlobals.drawBounds[0][0] -= 2;
+		dmapGlobals.drawBounds[0][1] -= 2;
+		dmapGlobals.drawBounds[1][0] += 2;
+		dmapGlobals.drawBounds[1][1] += 2;
+	}
 
 	// generate crossing points between all the original edges
 	crossings = ( edgeCrossing_t** )Mem_ClearedAlloc( numOriginalEdges * sizeof( *crossings ), TAG_TOOLS );
@@ -1884,15 +1889,15 @@ void SplitOriginalEdgesAtCrossings( optimizeGroup_t* opt )
 			if( ( optEdges[i].v1 == optEdges[j].v1 && optEdges[i].v2 == optEdges[j].v2 )
 					|| ( optEdges[i].v1 == optEdges[j].v2 && optEdges[i].v2 == optEdges[j].v1 ) )
 			{
-				common->Printf( "duplicated optEdge\n" );
+				DmapPrintf( "duplicated optEdge\n" );
 			}
 		}
 	}
 
-	common->VerbosePrintf( "%6i original edges\n", numOriginalEdges );
-	common->VerbosePrintf( "%6i edges after splits\n", numOptEdges );
-	common->VerbosePrintf( "%6i original vertexes\n", numOriginalVerts );
-	common->VerbosePrintf( "%6i vertexes after splits\n", numOptVerts );
+	DmapVerbosePrintf( "%6i original edges\n", numOriginalEdges );
+	DmapVerbosePrintf( "%6i edges after splits\n", numOptEdges );
+	DmapVerbosePrintf( "%6i original vertexes\n", numOriginalVerts );
+	DmapVerbosePrintf( "%6i vertexes after splits\n", numOptVerts );
 }
 
 //=================================================================
@@ -1947,8 +1952,8 @@ static void CullUnusedVerts( optIsland_t* island )
 		}
 	}
 
-	common->VerbosePrintf( "%6i verts kept\n", c_keep );
-	common->VerbosePrintf( "%6i verts freed\n", c_free );
+	DmapVerbosePrintf( "%6i verts kept\n", c_keep );
+	DmapVerbosePrintf( "%6i verts freed\n", c_free );
 }
 
 
@@ -2041,7 +2046,7 @@ static void AddVertexToIsland_r( optVertex_t* vert, optIsland_t* island )
 			e = e->v2link;
 			continue;
 		}
-		common->Error( "AddVertexToIsland_r: mislinked vert" );
+		DmapError( "AddVertexToIsland_r: mislinked vert" );
 	}
 
 }
@@ -2156,6 +2161,9 @@ void	OptimizeGroupList( optimizeGroup_t* groupList )
 
 	c_in = CountGroupListTris( groupList );
 
+	optVerts = ( optVertex_t* )Mem_Alloc( MAX_OPT_VERTEXES * sizeof( *optVerts ), TAG_TOOLS );
+	optEdges = ( optEdge_t* )Mem_Alloc( MAX_OPT_EDGES * sizeof( *optEdges ), TAG_TOOLS );
+
 	// optimize and remove colinear edges, which will
 	// re-introduce some t junctions
 	for( group = groupList ; group ; group = group->nextGroup )
@@ -2164,6 +2172,11 @@ void	OptimizeGroupList( optimizeGroup_t* groupList )
 	}
 	c_edge = CountGroupListTris( groupList );
 
+	Mem_Free( optVerts );
+	Mem_Free( optEdges );
+	optVerts = NULL;
+	optEdges = NULL;
+
 	// fix t junctions again
 	FixAreaGroupsTjunctions( groupList );
 	FreeTJunctionHash();
@@ -2171,13 +2184,23 @@ void	OptimizeGroupList( optimizeGroup_t* groupList )
 
 	SetGroupTriPlaneNums( groupList );
 
-	common->VerbosePrintf( "----- OptimizeAreaGroups Results -----\n" );
-	common->VerbosePrintf( "%6i tris in\n", c_in );
-	common->VerbosePrintf( "%6i tris after edge removal optimization\n", c_edge );
-	common->VerbosePrintf( "%6i tris after final t junction fixing\n", c_tjunc2 );
+	DmapVerbosePrintf( "----- OptimizeAreaGroups Results -----\n" );
+	DmapVerbosePrintf( "%6i tris in\n", c_in );
+	DmapVerbosePrintf( "%6i tris after edge removal optimization\n", c_edge );
+	DmapVerbosePrintf( "%6i tris after final t junction fixing\n", c_tjunc2 );
 }
 
 
+/*
+==================
+OptimizeArea
+==================
+*/
+static void OptimizeArea( uEntity_t* e, int areaNum )
+{
+	OptimizeGroupList( e->areas[areaNum].groups );
+}
+
 /*
 ==================
 OptimizeEntity
@@ -2185,11 +2208,6 @@ OptimizeEntity
 */
 void	OptimizeEntity( uEntity_t* e )
 {
-	int		i;
-
 	common->VerbosePrintf( "----- OptimizeEntity -----\n" );
-	for( i = 0 ; i < e->numAreas ; i++ )
-	{
-		OptimizeGroupList( e->areas[i].groups );
-	}
+	RunAreaJobs( e, OptimizeArea );
 }
@@ -94,11 +94,12 @@ typedef struct hashVert_s
 	int					iv[3];
 } hashVert_t;
 
-static idBounds	hashBounds;
-static idVec3	hashScale;
-static hashVert_t*	hashVerts[HASH_BINS][HASH_BINS][HASH_BINS];
-static int		numHashVerts, numTotalVerts;
-static int		hashIntMins[3], hashIntScale[3];
+// per thread, so the areas of an entity can be fixed on several threads at once
+static thread_local idBounds	hashBounds;
+static thread_local idVec3		hashScale;
+static thread_local hashVert_t*	hashVerts[HASH_BINS][HASH_BINS][HASH_BINS];
+static thread_local int			numHashVerts, numTotalVerts;
+static thread_local int			hashIntMins[3], hashIntScale[3];
 
 /*
 ===============
@@ -540,8 +541,8 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t* groupList )
 
 	startCount = CountGroupListTris( groupList );
 
-	common->VerbosePrintf( "----- FixAreaGroupsTjunctions -----\n" );
-	common->VerbosePrintf( "%6i triangles in\n", startCount );
+	DmapVerbosePrintf( "----- FixAreaGroupsTjunctions -----\n" );
+	DmapVerbosePrintf( "%6i triangles in\n", startCount );
 
 	HashTriangles( groupList );
 
@@ -564,10 +565,21 @@ void	FixAreaGroupsTjunctions( optimizeGroup_t* groupList )
 	}
 
 	endCount = CountGroupListTris( groupList );
-	common->VerbosePrintf( "%6i triangles out\n", endCount );
+	DmapVerbosePrintf( "%6i triangles out\n", endCount );
 }
 
 
+/*
+==================
+FixAreaTjunctions
+==================
+*/
+static void FixAreaTjunctions( uEntity_t* e, int areaNum )
+{
+	FixAreaGroupsTjunctions( e->areas[areaNum].groups );
+	FreeTJunctionHash();
+}
+
 /*
 ==================
 FixEntityTjunctions
@@ -575,13 +587,7 @@ FixEntityTjunctions
 */
 void	FixEntityTjunctions( uEntity_t* e )
 {
-	int		i;
-
-	for( i = 0 ; i < e->numAreas ; i++ )
-	{
-		FixAreaGroupsTjunctions( e->areas[i].groups );
-		FreeTJunctionHash();
-	}
+	RunAreaJobs( e, FixAreaTjunctions );
 }
 
 /*
@@ -1054,92 +1054,102 @@ Divide each group into an inside group and an outside group, based
 on which fragments are illuminated by the light's beam tree
 ====================
 */
-static void CarveGroupsByLight( uEntity_t* e, mapLight_t* light )
+static void CarveGroupsByLight( uArea_t* area, mapLight_t* light )
 {
-	int			i;
 	optimizeGroup_t*	group, *newGroup, *carvedGroups, *nextGroup;
 	mapTri_t*	tri, *inside, *outside;
-	uArea_t*		area;
 
-	for( i = 0 ; i < e->numAreas ; i++ )
+	carvedGroups = NULL;
+
+	// we will be either freeing or reassigning the groups as we go
+	for( group = area->groups ; group ; group = nextGroup )
 	{
-		area = &e->areas[i];
-		carvedGroups = NULL;
+		nextGroup = group->nextGroup;
 
-		// we will be either freeing or reassigning the groups as we go
-		for( group = area->groups ; group ; group = nextGroup )
+		// if the surface doesn't get lit, don't carve it up
+		if( ( light->def.lightShader->IsFogLight() && !group->material->ReceivesFog() )
+				|| ( !light->def.lightShader->IsFogLight() && !group->material->ReceivesLighting() )
+				|| !group->bounds.IntersectsBounds( light->def.globalLightBounds ) )
 		{
-			nextGroup = group->nextGroup;
 
-			// if the surface doesn't get lit, don't carve it up
-			if( ( light->def.lightShader->IsFogLight() && !group->material->ReceivesFog() )
-					|| ( !light->def.lightShader->IsFogLight() && !group->material->ReceivesLighting() )
-					|| !group->bounds.IntersectsBounds( light->def.globalLightBounds ) )
-			{
+			group->nextGroup = carvedGroups;
+			carvedGroups = group;
+			continue;
+		}
 
-				group->nextGroup = carvedGroups;
-				carvedGroups = group;
-				continue;
-			}
+		if( group->numGroupLights == MAX_GROUP_LIGHTS )
+		{
+			DmapError( "MAX_GROUP_LIGHTS around %f %f %f",
+					   group->triList->v[0].xyz[0], group->triList->v[0].xyz[1], group->triList->v[0].xyz[2] );
+		}
 
-			if( group->numGroupLights == MAX_GROUP_LIGHTS )
-			{
-				common->Error( "MAX_GROUP_LIGHTS around %f %f %f",
-							   group->triList->v[0].xyz[0], group->triList->v[0].xyz[1], group->triList->v[0].xyz[2] );
-			}
+		// if the group doesn't face the light,
+		// it won't get carved at all
+		if( !light->def.lightShader->LightEffectsBackSides() &&
+				!group->material->ReceivesLightingOnBackSides() &&
+				dmapGlobals.mapPlanes[ group->planeNum ].Distance( light->def.parms.origin ) <= 0 )
+		{
 
-			// if the group doesn't face the light,
-			// it won't get carved at all
-			if( !light->def.lightShader->LightEffectsBackSides() &&
-					!group->material->ReceivesLightingOnBackSides() &&
-					dmapGlobals.mapPlanes[ group->planeNum ].Distance( light->def.parms.origin ) <= 0 )
-			{
+			group->nextGroup = carvedGroups;
+			carvedGroups = group;
+			continue;
+		}
 
-				group->nextGroup = carvedGroups;
-				carvedGroups = group;
-				continue;
-			}
+		// split into lists for hit-by-light, and not-hit-by-light
+		inside = NULL;
+		outside = NULL;
 
-			// split into lists for hit-by-light, and not-hit-by-light
-			inside = NULL;
-			outside = NULL;
+		for( tri = group->triList ; tri ; tri = tri->next )
+		{
+			mapTri_t*	in, *out;
 
-			for( tri = group->triList ; tri ; tri = tri->next )
-			{
-				mapTri_t*	in, *out;
+			ClipTriByLight( light, tri, &in, &out );
+			inside = MergeTriLists( inside, in );
+			outside = MergeTriLists( outside, out );
+		}
 
-				ClipTriByLight( light, tri, &in, &out );
-				inside = MergeTriLists( inside, in );
-				outside = MergeTriLists( outside, out );
-			}
+		if( inside )
+		{
+			newGroup = ( optimizeGroup_t* )Mem_Alloc( sizeof( *newGroup ), TAG_TOOLS );
+			*newGroup = *group;
+			newGroup->groupLights[newGroup->numGroupLights] = light;
+			newGroup->numGroupLights++;
+			newGroup->triList = inside;
+			newGroup->nextGroup = carvedGroups;
+			carvedGroups = newGroup;
+		}
 
-			if( inside )
-			{
-				newGroup = ( optimizeGroup_t* )Mem_Alloc( sizeof( *newGroup ), TAG_TOOLS );
-				*newGroup = *group;
-				newGroup->groupLights[newGroup->numGroupLights] = light;
-				newGroup->numGroupLights++;
-				newGroup->triList = inside;
-				newGroup->nextGroup = carvedGroups;
-				carvedGroups = newGroup;
-			}
+		if( outside )
+		{
+			newGroup = ( optimizeGroup_t* )Mem_Alloc( sizeof( *newGroup ), TAG_TOOLS );
+			*newGroup = *group;
+			newGroup->triList = outside;
+			newGroup->nextGroup = carvedGroups;
+			carvedGroups = newGroup;
+		}
 
-			if( outside )
-			{
-				newGroup = ( optimizeGroup_t* )Mem_Alloc( sizeof( *newGroup ), TAG_TOOLS );
-				*newGroup = *group;
-				newGroup->triList = outside;
-				newGroup->nextGroup = carvedGroups;
-				carvedGroups = newGroup;
-			}
+		// free the original
+		group->nextGroup = NULL;
+		FreeOptimizeGroupList( group );
+	}
 
-			// free the original
-			group->nextGroup = NULL;
-			FreeOptimizeGroupList( group );
-		}
+	// replace this area's group list with the new one
+	area->groups = carvedGroups;
+}
 
-		// replace this area's group list with the new one
-		area->groups = carvedGroups;
+/*
+====================
+CarveAreaByLights
+
+Carving each area by all lights in order gives the same groups as carving all
+areas light by light, because an area only ever touches its own groups
+====================
+*/
+static void CarveAreaByLights( uEntity_t* e, int areaNum )
+{
+	for( int i = 0 ; i < dmapGlobals.mapLights.Num() ; i++ )
+	{
+		CarveGroupsByLight( &e->areas[areaNum], dmapGlobals.mapLights[i] );
 	}
 }
 
@@ -1155,7 +1165,6 @@ void Prelight( uEntity_t* e )
 {
 	int			i;
 	int			start, end;
-	mapLight_t*	light;
 
 	// don't prelight anything but the world entity
 	if( dmapGlobals.entityNum != 0 )
@@ -1190,11 +1199,7 @@ void Prelight( uEntity_t* e )
 		start = Sys_Milliseconds();
 		// now subdivide the optimize groups into additional groups for
 		// each light that illuminates them
-		for( i = 0 ; i < dmapGlobals.mapLights.Num() ; i++ )
-		{
-			light = dmapGlobals.mapLights[i];
-			CarveGroupsByLight( e, light );
-		}
+		RunAreaJobs( e, CarveAreaByLights );
 
 		end = Sys_Milliseconds();
 		common->VerbosePrintf( "%5.1f seconds for CarveGroupsByLight\n", ( end - start ) / 1000.0 );
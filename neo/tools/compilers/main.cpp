@@ -465,6 +465,43 @@ int Sys_Milliseconds()
 	return timeGetTime() - sys_timeBase;
 }
 
+/*
+================
+Sys_Microseconds
+================
+*/
+uint64_t Sys_Microseconds()
+{
+	static LARGE_INTEGER frequency;
+	static LARGE_INTEGER start;
+	if( frequency.QuadPart == 0 )
+	{
+		QueryPerformanceFrequency( &frequency );
+		QueryPerformanceCounter( &start );
+	}
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter( &now );
+	return ( uint64_t )( ( now.QuadPart - start.QuadPart ) * 1000000 / frequency.QuadPart );
+}
+
+/*
+================
+Sys_CPUCount
+
+the job threads of dmap only care about the number of logical cores
+================
+*/
+void Sys_CPUCount( int& numLogicalCPUCores, int& numPhysicalCPUCores, int& numCPUPackages )
+{
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+
+	numLogicalCPUCores = Max( ( int )info.dwNumberOfProcessors, 1 );
+	numPhysicalCPUCores = numLogicalCPUCores;
+	numCPUPackages = 1;
+}
+
 class idSysCmdline : public idSys
 {
 public:
@@ -1090,9 +1127,12 @@ int Dmap_NoGui( int argc, char** argv )
 
 	fileSystem->Init();
 	declManager->InitTool();
+	parallelJobManager->Init();
 
 	Dmap_f( args );
 
+	parallelJobManager->Shutdown();
+
 	return 0;
 }
 
@@ -1231,9 +1271,12 @@ int main( int argc, char** argv )
 
 	fileSystem->Init();
 	declManager->InitTool();
+	parallelJobManager->Init();
 
 	Dmap_f( args );
 
+	parallelJobManager->Shutdown();
+
 #if 0
 	while( true )
 	{
@@ -622,6 +622,41 @@ int Sys_Milliseconds()
 	// DG end
 }
 
+/*
+================
+Sys_Microseconds
+================
+*/
+uint64_t Sys_Microseconds()
+{
+	static uint64_t sys_microTimeBase = 0;
+
+	struct timespec ts;
+	clock_gettime( D3_CLOCK_TO_USE, &ts );
+
+	const uint64_t curtime = ( uint64_t )ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	if( !sys_microTimeBase )
+	{
+		sys_microTimeBase = curtime;
+	}
+
+	return curtime - sys_microTimeBase;
+}
+
+/*
+================
+Sys_CPUCount
+
+the job threads of dmap only care about the number of logical cores
+================
+*/
+void Sys_CPUCount( int& numLogicalCPUCores, int& numPhysicalCPUCores, int& numCPUPackages )
+{
+	numLogicalCPUCores = Max( ( int )sysconf( _SC_NPROCESSORS_ONLN ), 1 );
+	numPhysicalCPUCores = numLogicalCPUCores;
+	numCPUPackages = 1;
+}
+
 class idSysCmdline : public idSys
 {
 public:
@@ -1247,9 +1282,12 @@ int Dmap_NoGui( int argc, char** argv )
 
 	fileSystem->Init();
 	declManager->InitTool();
+	parallelJobManager->Init();
 
 	Dmap_f( args );
 
+	parallelJobManager->Shutdown();
+
 	return 0;
 }
 
@@ -1388,9 +1426,12 @@ int main( int argc, char** argv )
 
 	fileSystem->Init();
 	declManager->InitTool();
+	parallelJobManager->Init();
 
 	Dmap_f( args );
 
+	parallelJobManager->Shutdown();
+
 #if 0
 	while( true )
 	{
@@ -469,6 +469,60 @@ bool idGuiScript::Parse( idTokenParser* src )
 	return true;
 }
 
+/*
+=========================
+idGuiScriptList::IsJobSafe
+
+Sounds, cinematics, the command buffer and the focus reach outside the gui.
+Setting or transitioning a variable that is bound to the gui state writes to
+the shared string pools of idDict.
+=========================
+*/
+bool idGuiScriptList::IsJobSafe( bool transitionsOnly ) const
+{
+	for( int i = 0; i < list.Num(); i++ )
+	{
+		const idGuiScript* gs = list[i];
+		const bool writesState = gs->parms.Num() > 0 && gs->parms[0].var != NULL && gs->parms[0].var->GetDict() != NULL;
+
+		if( gs->handler == Script_Transition )
+		{
+			if( writesState )
+			{
+				return false;
+			}
+		}
+		else if( !transitionsOnly )
+		{
+			if( gs->handler == Script_Set )
+			{
+				if( writesState )
+				{
+					return false;
+				}
+			}
+			else if( gs->handler != NULL &&
+					 gs->handler != Script_ShowCursor &&
+					 gs->handler != Script_RunScript &&
+					 gs->handler != Script_EvalRegs &&
+					 gs->handler != Script_ResetTime )
+			{
+				return false;
+			}
+		}
+
+		if( gs->ifList != NULL && !gs->ifList->IsJobSafe( transitionsOnly ) )
+		{
+			return false;
+		}
+		if( gs->elseList != NULL && !gs->elseList->IsJobSafe( transitionsOnly ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 /*
 =========================
 idGuiScriptList::Execute
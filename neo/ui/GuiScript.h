@@ -98,6 +98,9 @@ public:
 		list.DeleteContents( true );
 	};
 	void Execute( idWindow* win );
+	// true if the scripts only change their own gui, so guis can run them in parallel jobs,
+	// with transitionsOnly just checks that no transition writes to the gui state dict
+	bool IsJobSafe( bool transitionsOnly = false ) const;
 	void Append( idGuiScript* gs )
 	{
 		list.Append( gs );
@@ -347,6 +347,7 @@ idUserInterfaceLocal::idUserInterfaceLocal()
 	active = false;
 	interactive = false;
 	uniqued = false;
+	timeEventsJobSafe = false;
 	bindHandler = NULL;
 	//so the reg eval in gui parsing doesn't get bogus values
 	time = 0;
@@ -465,6 +466,7 @@ bool idUserInterfaceLocal::InitFromFile( const char* qpath, bool rebuild, bool c
 	}
 
 	interactive = desktop->Interactive();
+	timeEventsJobSafe = desktop->TimeEventsAreJobSafe();
 
 	if( uiManagerLocal.guis.Find( this ) == NULL )
 	{
@@ -530,6 +532,21 @@ void idUserInterfaceLocal::Redraw( int _time, bool hud )
 	}
 }
 
+void idUserInterfaceLocal::RunTimeEvents( int _time )
+{
+	// same conditions as Redraw and idWindow::Redraw
+	const int skipGuiShaders = r_skipGuiShaders.GetInteger();
+	if( skipGuiShaders == 1 || skipGuiShaders == 3 || skipGuiShaders > 5 || dc == NULL )
+	{
+		return;
+	}
+	if( !loading && desktop )
+	{
+		time = _time;
+		desktop->RunTimeEvents( time );
+	}
+}
+
 void idUserInterfaceLocal::DrawCursor()
 {
 	if( !desktop || desktop->GetFlags() & WIN_MENUGUI )
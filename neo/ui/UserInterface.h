@@ -71,6 +71,13 @@ public:
 	// repaints the ui
 	virtual void				Redraw( int time, bool hud = false ) = 0;
 
+	// runs the time events, frame scripts and expressions that Redraw would run first,
+	// a following Redraw with the same time doesn't run them again
+	virtual void				RunTimeEvents( int time ) = 0;
+
+	// true if RunTimeEvents only changes this gui, so different guis can run it in parallel jobs
+	virtual bool				TimeEventsAreJobSafe() const = 0;
+
 	// repaints the cursor
 	virtual void				DrawCursor() = 0;
 
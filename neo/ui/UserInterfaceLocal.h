@@ -42,6 +42,11 @@ public:
 	virtual const char* 		HandleEvent( const sysEvent_t* event, int time, bool* updateVisuals );
 	virtual void				HandleNamedEvent( const char* namedEvent );
 	virtual void				Redraw( int time, bool hud );
+	virtual void				RunTimeEvents( int time );
+	virtual bool				TimeEventsAreJobSafe() const
+	{
+		return timeEventsJobSafe;
+	}
 	virtual void				DrawCursor();
 	virtual const idDict& 		State() const;
 	virtual void				DeleteStateVar( const char* varName );
@@ -146,6 +151,7 @@ private:
 	bool						loading;
 	bool						interactive;
 	bool						uniqued;
+	bool						timeEventsJobSafe;
 
 	idDict						state;
 	idWindow* 					desktop;
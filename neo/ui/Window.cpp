@@ -113,6 +113,7 @@ void idWindow::CommonInit()
 	childID = 0;
 	flags = 0;
 	lastTimeRun = 0;
+	regsEvaluated = 0;
 	origin.Zero();
 	font = renderSystem->RegisterFont( "" );
 	timeLine = -1;
@@ -681,6 +682,53 @@ bool idWindow::RunTimeEvents( int time )
 	return true;
 }
 
+/*
+================
+idWindow::TimeEventsAreJobSafe
+
+True if the frame and time line scripts of this window and all its children
+only change this gui, see idUserInterface::RunTimeEvents. Transitions run in
+the time events no matter which script started them, so all scripts are checked
+for those.
+================
+*/
+bool idWindow::TimeEventsAreJobSafe() const
+{
+	for( int i = 0; i < SCRIPT_COUNT; i++ )
+	{
+		if( scripts[i] != NULL && !scripts[i]->IsJobSafe( i != ON_FRAME ) )
+		{
+			return false;
+		}
+	}
+
+	for( int i = 0; i < timeLineEvents.Num(); i++ )
+	{
+		if( timeLineEvents[i]->event != NULL && !timeLineEvents[i]->event->IsJobSafe() )
+		{
+			return false;
+		}
+	}
+
+	for( int i = 0; i < namedEvents.Num(); i++ )
+	{
+		if( namedEvents[i]->mEvent != NULL && !namedEvents[i]->mEvent->IsJobSafe( true ) )
+		{
+			return false;
+		}
+	}
+
+	for( int i = 0; i < children.Num(); i++ )
+	{
+		if( !children[i]->TimeEventsAreJobSafe() )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /*
 ================
 idWindow::RunNamedEvent
@@ -1280,15 +1328,20 @@ idWindow::EvalRegs
 */
 float idWindow::EvalRegs( int test, bool force )
 {
-	static float regs[MAX_EXPRESSION_REGISTERS];
-	static idWindow* lastEval = NULL;
+	// the registers of the last evaluated window are kept per thread,
+	// so different guis can be evaluated from several jobs at once,
+	// they are only reused if no other thread evaluated the window since
+	static thread_local float regs[MAX_EXPRESSION_REGISTERS];
+	static thread_local idWindow* lastEval = NULL;
+	static thread_local int lastEvaluated = 0;
 
-	if( !force && test >= 0 && test < MAX_EXPRESSION_REGISTERS && lastEval == this )
+	if( !force && test >= 0 && test < MAX_EXPRESSION_REGISTERS && lastEval == this && lastEvaluated == regsEvaluated )
 	{
 		return regs[test];
 	}
 
 	lastEval = this;
+	lastEvaluated = ++regsEvaluated;
 
 	if( expressionRegisters.Num() )
 	{
@@ -380,6 +380,7 @@ protected:
 	void Transition();
 	void Time();
 	bool RunTimeEvents( int time );
+	bool TimeEventsAreJobSafe() const;
 	void Dump();
 
 	int ExpressionTemporary();
@@ -406,6 +407,7 @@ protected:
 	int	  childID;					// this childs id
 	unsigned int flags;             // visible, focus, mouseover, cursor, border, etc..
 	int lastTimeRun;				//
+	int regsEvaluated;				// counts EvalRegs evaluations, to validate the per thread register cache
 	idRectangle drawRect;			// overall rect
 	idRectangle clientRect;			// client area
 	idVec2	origin;